@@ -0,0 +1,980 @@
+#include "benchmarkcli.h"
+#include "iocore.h"
+#include "nvmepassthrough.h"
+#include "patterngenerator.h"
+#include "smartctljsonparser.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSysInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QDebug>
+
+#include <csignal>
+#include <cstdio>
+#include <limits>
+
+namespace {
+// 当前运行的引擎，信号处理函数通过它取消测试
+WorkloadEngine *g_runningEngine = nullptr;
+bool g_verbose = false;
+QtMessageHandler g_defaultHandler = nullptr;
+
+void handleSignal(int) {
+    // cancel()只置位原子变量，可以在信号处理函数中调用
+    if (g_runningEngine) {
+        g_runningEngine->cancel();
+    }
+}
+
+// 非verbose模式下丢弃调试日志，警告以上仍交给Qt默认处理（输出到标准错误）
+void filterMessages(QtMsgType type, const QMessageLogContext &context, const QString &message) {
+    if (!g_verbose && (type == QtDebugMsg || type == QtInfoMsg)) {
+        return;
+    }
+    g_defaultHandler(type, context, message);
+}
+
+struct ModeDefinition {
+    const char *mode;
+    const char *rw;
+    bool random;
+    int readPercent;        // -1表示使用rwmixread
+};
+
+const ModeDefinition kModes[] = {
+    {"seq-read", "read", false, 100},
+    {"seq-write", "write", false, 0},
+    {"rand-read", "randread", true, 100},
+    {"rand-write", "randwrite", true, 0},
+    {"rand-rw", "randrw", true, -1}
+};
+
+const qint64 kDefaultFileSize = 1024LL * 1024 * 1024;
+
+// 解析基准中判断NVMe输出的键
+const char kNvmeLogKey[] = "nvme_smart_health_information_log";
+
+// 解析基准默认使用源码中录制的smartctl -x -j输出
+QString defaultTestdataDirectory(const char *name) {
+#ifdef DISKTOOLBOX_TESTDATA_DIR
+    return QString(DISKTOOLBOX_TESTDATA_DIR "/") + name;
+#else
+    return QString("testdata/") + name;
+#endif
+}
+
+// 与流式解析器的readInteger一致：小数部分截断，超出qint64时饱和，不是数字时返回false
+bool jsonInteger(const QJsonValue &value, qint64 &result) {
+    if (!value.isDouble()) {
+        return false;
+    }
+    const double number = value.toDouble();
+    const double limit = static_cast<double>(std::numeric_limits<qint64>::max());
+    if (number >= limit) {
+        result = std::numeric_limits<qint64>::max();
+    } else if (number <= -limit) {
+        result = -std::numeric_limits<qint64>::max();
+    } else {
+        result = static_cast<qint64>(number);
+    }
+    return true;
+}
+
+// 与流式解析器相同，原始值取raw.string开头的数字
+bool leadingNumber(const QString &text, long long &value) {
+    int i = 0;
+    while (i < text.size() && text.at(i) == ' ') {
+        ++i;
+    }
+    bool found = false;
+    value = 0;
+    for (; i < text.size() && text.at(i).isDigit() && text.at(i).unicode() < 128; ++i) {
+        value = value * 10 + (text.at(i).unicode() - '0');
+        found = true;
+    }
+    return found;
+}
+
+// 用QJsonDocument取出与SmartctlJsonParser相同的字段，作为解析基准的对照组，
+// 同时用来核对流式解析器的结果
+bool parseAtaWithJsonDocument(const QByteArray &json, SmartctlAtaReport &report) {
+    QJsonDocument document = QJsonDocument::fromJson(json);
+    if (!document.isObject()) {
+        return false;
+    }
+    QJsonObject root = document.object();
+    qint64 number = 0;
+    report.model = root.value("model_name").toString().trimmed();
+    report.serialNumber = root.value("serial_number").toString().trimmed();
+    report.firmware = root.value("firmware_version").toString().trimmed();
+    QJsonValue passed = root.value("smart_status").toObject().value("passed");
+    report.hasStatus = passed.isBool();
+    if (report.hasStatus) {
+        report.passed = passed.toBool();
+    }
+    if (jsonInteger(root.value("temperature").toObject().value("current"), number)) {
+        report.temperature = static_cast<int>(number);
+    }
+    if (jsonInteger(root.value("power_on_time").toObject().value("hours"), number)) {
+        report.powerOnHours = number;
+    }
+    if (jsonInteger(root.value("power_cycle_count"), number)) {
+        report.powerCycleCount = number;
+    }
+
+    report.attributes.clear();
+    const QJsonArray table = root.value("ata_smart_attributes").toObject().value("table").toArray();
+    for (const QJsonValue &entry : table) {
+        if (!entry.isObject()) {
+            continue;
+        }
+        QJsonObject object = entry.toObject();
+        SmartAttribute attr;
+        attr.id = jsonInteger(object.value("id"), number) ? static_cast<int>(number) : 0;
+        attr.name = object.value("name").toString().trimmed();
+        attr.current = jsonInteger(object.value("value"), number) ? static_cast<int>(number) : 0;
+        attr.worst = jsonInteger(object.value("worst"), number) ? static_cast<int>(number) : 0;
+        attr.threshold = jsonInteger(object.value("thresh"), number) ? static_cast<int>(number) : 0;
+        QJsonObject raw = object.value("raw").toObject();
+        long long rawFromString = 0;
+        if (raw.value("string").isString() && leadingNumber(raw.value("string").toString(), rawFromString)) {
+            attr.raw = rawFromString;
+        } else {
+            attr.raw = jsonInteger(raw.value("value"), number) ? number : 0;
+        }
+        if (attr.id > 0) {
+            report.attributes.append(attr);
+        }
+    }
+    return !report.attributes.isEmpty();
+}
+
+bool parseNvmeWithJsonDocument(const QByteArray &json, SmartctlNvmeReport &report) {
+    QJsonDocument document = QJsonDocument::fromJson(json);
+    if (!document.isObject()) {
+        return false;
+    }
+    QJsonObject root = document.object();
+    report.model = root.value("model_name").toString().trimmed();
+    report.serialNumber = root.value("serial_number").toString().trimmed();
+    report.firmware = root.value("firmware_version").toString().trimmed();
+    QJsonValue passed = root.value("smart_status").toObject().value("passed");
+    report.hasStatus = passed.isBool();
+    if (report.hasStatus) {
+        report.passed = passed.toBool();
+    }
+
+    report.hasLog = root.value(kNvmeLogKey).isObject();
+    QJsonObject object = root.value(kNvmeLogKey).toObject();
+    NvmeSmartLog &log = report.log;
+    qint64 number = 0;
+    struct CounterField {
+        const char *name;
+        quint64 *target;
+    };
+    const CounterField counters[] = {
+        {"data_units_read", &log.dataUnitsRead},
+        {"data_units_written", &log.dataUnitsWritten},
+        {"host_reads", &log.hostReadCommands},
+        {"host_writes", &log.hostWriteCommands},
+        {"controller_busy_time", &log.controllerBusyTime},
+        {"power_cycles", &log.powerCycles},
+        {"power_on_hours", &log.powerOnHours},
+        {"unsafe_shutdowns", &log.unsafeShutdowns},
+        {"media_errors", &log.mediaErrors},
+        {"num_err_log_entries", &log.errorLogEntries}
+    };
+    for (const CounterField &counter : counters) {
+        if (jsonInteger(object.value(counter.name), number)) {
+            *counter.target = static_cast<quint64>(qMax<qint64>(0, number));
+        }
+    }
+    if (jsonInteger(object.value("critical_warning"), number)) {
+        log.criticalWarning = static_cast<int>(number);
+    }
+    if (jsonInteger(object.value("temperature"), number)) {
+        log.temperature = static_cast<int>(number);
+    }
+    report.hasSpare = jsonInteger(object.value("available_spare"), number);
+    if (report.hasSpare) {
+        log.availableSpare = static_cast<int>(number);
+    }
+    if (jsonInteger(object.value("available_spare_threshold"), number)) {
+        log.availableSpareThreshold = static_cast<int>(number);
+    }
+    report.hasPercentageUsed = jsonInteger(object.value("percentage_used"), number);
+    if (report.hasPercentageUsed) {
+        log.percentageUsed = static_cast<int>(number);
+    }
+    if (jsonInteger(object.value("warning_temp_time"), number)) {
+        log.warningTempMinutes = static_cast<quint32>(number);
+    }
+    if (jsonInteger(object.value("critical_comp_time"), number)) {
+        log.criticalTempMinutes = static_cast<quint32>(number);
+    }
+    const QJsonArray sensors = object.value("temperature_sensors").toArray();
+    for (int i = 0; i < sensors.size(); ++i) {
+        if (jsonInteger(sensors.at(i), number) && number > 0) {
+            log.temperatureSensors[i + 1] = static_cast<int>(number);
+        }
+    }
+    return report.hasLog;
+}
+
+// 逐字段比较两组结果，记录不一致的字段
+class ReportComparison {
+public:
+    ReportComparison(const QString &leftName, const QString &rightName) : m_leftName(leftName), m_rightName(rightName) {}
+
+    template <typename T>
+    void check(const QString &field, const T &left, const T &right) {
+        ++m_fields;
+        if (!(left == right)) {
+            // 值中可能有%，不用arg()拼接
+            m_mismatches.append(field + ": " + m_leftName + "=" + text(left) + ", " + m_rightName + "=" + text(right));
+        }
+    }
+
+    void fail(const QString &message) { m_mismatches.append(message); }
+
+    int fields() const { return m_fields; }
+    const QStringList &mismatches() const { return m_mismatches; }
+
+private:
+    static QString text(const QString &value) { return "\"" + value + "\""; }
+    static QString text(bool value) { return value ? "true" : "false"; }
+    template <typename T>
+    static QString text(T value) { return QString::number(value); }
+
+    QString m_leftName;
+    QString m_rightName;
+    int m_fields = 0;
+    QStringList m_mismatches;
+};
+
+void compareReports(const SmartctlAtaReport &stream, const SmartctlAtaReport &document, ReportComparison &result) {
+    result.check("model_name", stream.model, document.model);
+    result.check("serial_number", stream.serialNumber, document.serialNumber);
+    result.check("firmware_version", stream.firmware, document.firmware);
+    result.check("smart_status", stream.hasStatus, document.hasStatus);
+    result.check("smart_status.passed", stream.passed, document.passed);
+    result.check("temperature.current", stream.temperature, document.temperature);
+    result.check("power_on_time.hours", stream.powerOnHours, document.powerOnHours);
+    result.check("power_cycle_count", stream.powerCycleCount, document.powerCycleCount);
+    result.check("ata_smart_attributes.table", stream.attributes.size(), document.attributes.size());
+    for (int i = 0; i < stream.attributes.size() && i < document.attributes.size(); ++i) {
+        const SmartAttribute &a = stream.attributes[i];
+        const SmartAttribute &b = document.attributes[i];
+        const QString prefix = QString("table[%1].").arg(i);
+        result.check(prefix + "id", a.id, b.id);
+        result.check(prefix + "name", a.name, b.name);
+        result.check(prefix + "value", a.current, b.current);
+        result.check(prefix + "worst", a.worst, b.worst);
+        result.check(prefix + "thresh", a.threshold, b.threshold);
+        result.check(prefix + "raw", a.raw, b.raw);
+    }
+}
+
+void compareReports(const SmartctlNvmeReport &stream, const SmartctlNvmeReport &document, ReportComparison &result) {
+    const NvmeSmartLog &a = stream.log;
+    const NvmeSmartLog &b = document.log;
+    result.check("model_name", stream.model, document.model);
+    result.check("serial_number", stream.serialNumber, document.serialNumber);
+    result.check("firmware_version", stream.firmware, document.firmware);
+    result.check("smart_status", stream.hasStatus, document.hasStatus);
+    result.check("smart_status.passed", stream.passed, document.passed);
+    result.check("available_spare存在", stream.hasSpare, document.hasSpare);
+    result.check("percentage_used存在", stream.hasPercentageUsed, document.hasPercentageUsed);
+    result.check("critical_warning", a.criticalWarning, b.criticalWarning);
+    result.check("temperature", a.temperature, b.temperature);
+    result.check("available_spare", a.availableSpare, b.availableSpare);
+    result.check("available_spare_threshold", a.availableSpareThreshold, b.availableSpareThreshold);
+    result.check("percentage_used", a.percentageUsed, b.percentageUsed);
+    result.check("data_units_read", a.dataUnitsRead, b.dataUnitsRead);
+    result.check("data_units_written", a.dataUnitsWritten, b.dataUnitsWritten);
+    result.check("host_reads", a.hostReadCommands, b.hostReadCommands);
+    result.check("host_writes", a.hostWriteCommands, b.hostWriteCommands);
+    result.check("controller_busy_time", a.controllerBusyTime, b.controllerBusyTime);
+    result.check("power_cycles", a.powerCycles, b.powerCycles);
+    result.check("power_on_hours", a.powerOnHours, b.powerOnHours);
+    result.check("unsafe_shutdowns", a.unsafeShutdowns, b.unsafeShutdowns);
+    result.check("media_errors", a.mediaErrors, b.mediaErrors);
+    result.check("num_err_log_entries", a.errorLogEntries, b.errorLogEntries);
+    result.check("warning_temp_time", a.warningTempMinutes, b.warningTempMinutes);
+    result.check("critical_comp_time", a.criticalTempMinutes, b.criticalTempMinutes);
+    result.check("temperature_sensors", a.temperatureSensors.size(), b.temperatureSensors.size());
+    for (auto it = a.temperatureSensors.constBegin(); it != a.temperatureSensors.constEnd(); ++it) {
+        result.check(QString("temperature_sensors[%1]").arg(it.key()), it.value(), b.temperatureSensors.value(it.key(), -1));
+    }
+}
+
+// 期望值中超过2^53的计数器写成字符串，避免double丢失精度
+QString expectedText(const QJsonValue &value) {
+    if (value.isString()) {
+        return value.toString();
+    }
+    return QString::number(static_cast<qint64>(value.toDouble()));
+}
+
+void checkIdentify(const NvmeControllerInfo &info, const QJsonObject &expected, ReportComparison &result) {
+    result.check<QString>("model", info.model, expected.value("model").toString());
+    result.check<QString>("serial_number", info.serialNumber, expected.value("serial_number").toString());
+    result.check<QString>("firmware", info.firmware, expected.value("firmware").toString());
+    result.check<QString>("error_log_page_entries", QString::number(info.errorLogPageEntries),
+                          expectedText(expected.value("error_log_page_entries")));
+    result.check<QString>("warning_temp_threshold", QString::number(info.warningTempThreshold),
+                          expectedText(expected.value("warning_temp_threshold")));
+    result.check<QString>("critical_temp_threshold", QString::number(info.criticalTempThreshold),
+                          expectedText(expected.value("critical_temp_threshold")));
+}
+
+void checkSmartLog(const NvmeSmartLog &log, const QJsonObject &expected, ReportComparison &result) {
+    const QList<QPair<const char *, QString>> fields = {
+        {"critical_warning", QString::number(log.criticalWarning)},
+        {"temperature", QString::number(log.temperature)},
+        {"available_spare", QString::number(log.availableSpare)},
+        {"available_spare_threshold", QString::number(log.availableSpareThreshold)},
+        {"percentage_used", QString::number(log.percentageUsed)},
+        {"data_units_read", QString::number(log.dataUnitsRead)},
+        {"data_units_written", QString::number(log.dataUnitsWritten)},
+        {"host_reads", QString::number(log.hostReadCommands)},
+        {"host_writes", QString::number(log.hostWriteCommands)},
+        {"controller_busy_time", QString::number(log.controllerBusyTime)},
+        {"power_cycles", QString::number(log.powerCycles)},
+        {"power_on_hours", QString::number(log.powerOnHours)},
+        {"unsafe_shutdowns", QString::number(log.unsafeShutdowns)},
+        {"media_errors", QString::number(log.mediaErrors)},
+        {"num_err_log_entries", QString::number(log.errorLogEntries)},
+        {"warning_temp_time", QString::number(log.warningTempMinutes)},
+        {"critical_comp_time", QString::number(log.criticalTempMinutes)}
+    };
+    for (const auto &field : fields) {
+        result.check<QString>(field.first, field.second, expectedText(expected.value(field.first)));
+    }
+
+    const QJsonObject sensors = expected.value("temperature_sensors").toObject();
+    result.check("temperature_sensors", log.temperatureSensors.size(), sensors.size());
+    for (auto it = sensors.constBegin(); it != sensors.constEnd(); ++it) {
+        result.check<QString>("temperature_sensors[" + it.key() + "]",
+                              QString::number(log.temperatureSensors.value(it.key().toInt(), -1)),
+                              expectedText(it.value()));
+    }
+}
+
+void checkErrorLog(const QList<NvmeErrorLogEntry> &entries, const QJsonArray &expected, ReportComparison &result) {
+    result.check("error_log", entries.size(), expected.size());
+    for (int i = 0; i < entries.size() && i < expected.size(); ++i) {
+        const NvmeErrorLogEntry &entry = entries[i];
+        const QJsonObject object = expected.at(i).toObject();
+        const QString prefix = QString("error_log[%1].").arg(i);
+        result.check<QString>(prefix + "error_count", QString::number(entry.errorCount),
+                              expectedText(object.value("error_count")));
+        result.check<QString>(prefix + "submission_queue_id", QString::number(entry.submissionQueueId),
+                              expectedText(object.value("submission_queue_id")));
+        result.check<QString>(prefix + "command_id", QString::number(entry.commandId),
+                              expectedText(object.value("command_id")));
+        result.check<QString>(prefix + "status_field", QString::number(entry.statusField),
+                              expectedText(object.value("status_field")));
+        result.check<QString>(prefix + "lba", QString::number(entry.lba), expectedText(object.value("lba")));
+        result.check<QString>(prefix + "nsid", QString::number(entry.namespaceId), expectedText(object.value("nsid")));
+    }
+    // 与期望值无关，解码结果本身必须按错误序号从新到旧排列
+    for (int i = 1; i < entries.size(); ++i) {
+        if (entries[i].errorCount >= entries[i - 1].errorCount) {
+            result.fail(QString("error_log[%1]: 错误序号%2没有排在%3之后")
+                        .arg(i).arg(entries[i].errorCount).arg(entries[i - 1].errorCount));
+        }
+    }
+}
+
+bool isBlockDevice(const QString &path) {
+    if (!QFileInfo::exists(path) || QFileInfo(path).isDir()) {
+        return false;
+    }
+    IoFile probe;
+    return probe.open(path, IoFile::ReadOnly) && probe.isBlockDevice();
+}
+}
+
+int BenchmarkCli::run(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("硬盘工具箱速度测试命令行版本，结果以JSON格式输出。\n"
+                                     "退出码: 0成功, 1测试失败, 2参数错误, 3被中断");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("target", "测试目标：目录（在其中创建临时测试文件）、文件或块设备（只允许读测试）");
+    parser.addOptions({
+        {{"m", "mode"}, "测试模式，逗号分隔：seq-read, seq-write, rand-read, rand-write, rand-rw 或 all。"
+                        "默认目录/文件为 seq-write,seq-read,rand-write,rand-read，块设备为 seq-read,rand-read", "modes"},
+        {"job-file", "按fio作业文件运行，忽略--mode等负载参数", "file"},
+        {"bs", "块大小，默认顺序1M、随机4K", "size"},
+        {"size", "每个作业的I/O范围，默认文件1G、块设备整个设备", "size"},
+        {"iodepth", "队列深度，默认顺序8、随机32", "n"},
+        {"numjobs", "并发作业数", "n", "1"},
+        {"runtime", "每个作业的运行时间，0表示按size运行一遍", "time", "10"},
+        {"ramp-time", "预热时间，不计入统计", "time", "0"},
+        {"rwmixread", "rand-rw的读比例(%)", "percent", "70"},
+        {"buffer-compress-percentage", "写入数据的可压缩比例(%)，默认0即完全不可压缩", "percent", "0"},
+        {"dedupe-percentage", "写入数据中可去重的4K块比例(%)", "percent", "0"},
+        {"ioengine", "I/O引擎：libaio（Linux内核异步I/O，其他平台自动退化）或 sync", "engine", "libaio"},
+        {"buffered", "使用系统缓存（默认O_DIRECT/无缓冲I/O）"},
+        {{"o", "output"}, "把JSON写入文件而不是标准输出", "file"},
+        {"pretty", "输出带缩进的JSON"},
+        {"parse-bench", "解析基准：对target目录（默认为源码中的testdata/smartctl）中录制的smartctl -x -j输出(*.json)"
+                        "比较流式解析和QJsonDocument的耗时，两者取出的字段不一致时失败，不运行I/O测试"},
+        {"iterations", "解析基准中每个文件的解析次数", "n", "1000"},
+        {"nvme-replay", "NVMe直通检查：回放target目录（默认为源码中的testdata/nvme）中录制的Identify和日志页，"
+                        "与expected.json比较解码结果，不访问硬件"},
+        {{"v", "verbose"}, "在标准错误输出调试日志"}
+    });
+
+    QJsonObject report;
+    report["tool"] = "disktoolbox-cli";
+    report["version"] = QCoreApplication::applicationVersion();
+    report["hostname"] = QSysInfo::machineHostName();
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["data_generator"] = PatternGenerator::implementationName();
+
+    BenchmarkCliOptions options;
+    QString error;
+    if (!parser.parse(arguments)) {
+        error = parser.errorText();
+    } else if (parser.isSet("help")) {
+        QTextStream(stdout) << parser.helpText();
+        return ExitSuccess;
+    } else if (parser.isSet("version")) {
+        QTextStream(stdout) << QCoreApplication::applicationName() << " " << QCoreApplication::applicationVersion() << "\n";
+        return ExitSuccess;
+    } else if (parser.isSet("parse-bench")) {
+        return runParseBenchmark(parser, report);
+    } else if (parser.isSet("nvme-replay")) {
+        return runNvmeReplayCheck(parser, report);
+    } else {
+        readOptions(parser, options, error);
+    }
+
+    g_verbose = options.verbose;
+    g_defaultHandler = qInstallMessageHandler(filterMessages);
+
+    QList<FioJob> jobs;
+    QStringList warnings;
+    if (error.isEmpty()) {
+        if (!options.jobFile.isEmpty()) {
+            if (FioJobParser::parseFile(options.jobFile, jobs, error, &warnings)) {
+                // 作业文件没有写filename时放到target目录下
+                for (FioJob &job : jobs) {
+                    if (job.filename.isEmpty() && job.directory.isEmpty() && QFileInfo(options.target).isDir()) {
+                        job.directory = options.target;
+                    }
+                }
+            }
+        } else {
+            buildJobs(options, jobs, error);
+        }
+    }
+
+    report["target"] = options.target;
+    if (!warnings.isEmpty()) {
+        report["warnings"] = QJsonArray::fromStringList(warnings);
+    }
+
+    if (!error.isEmpty()) {
+        QTextStream(stderr) << "错误: " << error << "\n";
+        report["success"] = false;
+        report["error"] = error;
+        report["exit_code"] = ExitUsageError;
+        report["jobs"] = QJsonArray();
+        writeOutput(report, options);
+        return ExitUsageError;
+    }
+
+    QString defaultDirectory = QFileInfo(options.target).isDir() ? options.target : QDir::currentPath();
+    WorkloadEngine engine(jobs, defaultDirectory);
+
+    g_runningEngine = &engine;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    qDebug() << "命令行测试开始, 目标:" << options.target << "作业数:" << jobs.size();
+    WorkloadRunResult run = engine.run();
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    g_runningEngine = nullptr;
+
+    QJsonArray jobArray;
+    for (int i = 0; i < run.jobs.size() && i < jobs.size(); ++i) {
+        jobArray.append(jobToJson(run.jobs[i], jobs[i]));
+    }
+
+    int exitCode = ExitSuccess;
+    if (run.canceled) {
+        exitCode = ExitCanceled;
+        run.errorMessage = "测试被中断";
+    } else if (!run.success) {
+        exitCode = ExitRunFailed;
+    }
+
+    report["success"] = run.success;
+    report["canceled"] = run.canceled;
+    if (!run.errorMessage.isEmpty()) {
+        report["error"] = run.errorMessage;
+        QTextStream(stderr) << "错误: " << run.errorMessage << "\n";
+    }
+    report["exit_code"] = exitCode;
+    report["jobs"] = jobArray;
+
+    if (!writeOutput(report, options) && exitCode == ExitSuccess) {
+        exitCode = ExitRunFailed;
+    }
+    return exitCode;
+}
+
+int BenchmarkCli::runParseBenchmark(const QCommandLineParser &parser, QJsonObject &report) {
+    BenchmarkCliOptions options;
+    options.pretty = parser.isSet("pretty");
+    options.outputPath = parser.value("output");
+    options.verbose = parser.isSet("verbose");
+    g_verbose = options.verbose;
+    g_defaultHandler = qInstallMessageHandler(filterMessages);
+
+    const QStringList positional = parser.positionalArguments();
+    QDir dir(positional.isEmpty() ? defaultTestdataDirectory("smartctl") : positional.first());
+    bool ok = false;
+    int iterations = parser.value("iterations").toInt(&ok);
+    QString error;
+    if (!ok || iterations < 1) {
+        error = QString("iterations应为正整数: %1").arg(parser.value("iterations"));
+    } else if (!dir.exists()) {
+        error = QString("目录不存在: %1").arg(dir.path());
+    }
+    QStringList files = error.isEmpty() ? dir.entryList(QStringList() << "*.json", QDir::Files, QDir::Name) : QStringList();
+    if (error.isEmpty() && files.isEmpty()) {
+        error = QString("目录中没有smartctl JSON输出(*.json): %1").arg(dir.path());
+    }
+
+    report["target"] = dir.path();
+    report["iterations"] = iterations;
+    if (!error.isEmpty()) {
+        QTextStream(stderr) << "错误: " << error << "\n";
+        report["success"] = false;
+        report["error"] = error;
+        report["exit_code"] = ExitUsageError;
+        writeOutput(report, options);
+        return ExitUsageError;
+    }
+
+    QJsonArray fileArray;
+    bool allParsed = true;
+    volatile int sink = 0;  // 防止解析结果被优化掉
+    for (const QString &name : files) {
+        QFile file(dir.filePath(name));
+        QJsonObject entry;
+        entry["file"] = name;
+        if (!file.open(QIODevice::ReadOnly)) {
+            entry["success"] = false;
+            entry["error"] = file.errorString();
+            fileArray.append(entry);
+            allParsed = false;
+            continue;
+        }
+        const QByteArray json = file.readAll();
+        const bool nvme = json.contains(kNvmeLogKey);
+        entry["type"] = nvme ? "nvme" : "ata";
+        entry["bytes"] = json.size();
+
+        // 先解析一次确认内容有效，并核对两种解析方式取出的字段数和值
+        SmartctlAtaReport ataReport;
+        SmartctlNvmeReport nvmeReport;
+        QString parseError;
+        bool parsed = nvme ? SmartctlJsonParser::parseNvme(json, nvmeReport, parseError)
+                           : SmartctlJsonParser::parseAta(json, ataReport, parseError);
+        if (!parsed) {
+            entry["success"] = false;
+            entry["error"] = parseError;
+            fileArray.append(entry);
+            allParsed = false;
+            continue;
+        }
+        ReportComparison comparison("流式", "QJsonDocument");
+        bool documentParsed = false;
+        if (nvme) {
+            SmartctlNvmeReport documentReport;
+            documentParsed = parseNvmeWithJsonDocument(json, documentReport);
+            compareReports(nvmeReport, documentReport, comparison);
+        } else {
+            SmartctlAtaReport documentReport;
+            documentParsed = parseAtaWithJsonDocument(json, documentReport);
+            compareReports(ataReport, documentReport, comparison);
+            entry["attributes"] = ataReport.attributes.size();
+        }
+        entry["fields"] = comparison.fields();
+        if (!documentParsed || !comparison.mismatches().isEmpty()) {
+            entry["success"] = false;
+            entry["error"] = documentParsed ? QString("流式解析与QJsonDocument的结果不一致")
+                                            : QString("QJsonDocument解析失败");
+            entry["mismatches"] = QJsonArray::fromStringList(comparison.mismatches());
+            fileArray.append(entry);
+            allParsed = false;
+            continue;
+        }
+        entry["success"] = true;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            if (nvme) {
+                SmartctlNvmeReport result;
+                SmartctlJsonParser::parseNvme(json, result, parseError);
+                sink = sink + static_cast<int>(result.log.powerOnHours);
+            } else {
+                SmartctlAtaReport result;
+                SmartctlJsonParser::parseAta(json, result, parseError);
+                sink = sink + result.attributes.size();
+            }
+        }
+        const qint64 streamNs = timer.nsecsElapsed();
+
+        timer.restart();
+        for (int i = 0; i < iterations; ++i) {
+            if (nvme) {
+                SmartctlNvmeReport result;
+                parseNvmeWithJsonDocument(json, result);
+                sink = sink + static_cast<int>(result.log.powerOnHours);
+            } else {
+                SmartctlAtaReport result;
+                parseAtaWithJsonDocument(json, result);
+                sink = sink + result.attributes.size();
+            }
+        }
+        const qint64 documentNs = timer.nsecsElapsed();
+
+        const double streamUs = streamNs / 1000.0 / iterations;
+        const double documentUs = documentNs / 1000.0 / iterations;
+        entry["stream_us_per_parse"] = streamUs;
+        entry["qjsondocument_us_per_parse"] = documentUs;
+        entry["stream_mb_per_s"] = streamNs > 0 ? json.size() * static_cast<double>(iterations) * 1000.0 / streamNs : 0.0;
+        entry["speedup"] = streamUs > 0 ? documentUs / streamUs : 0.0;
+        fileArray.append(entry);
+    }
+
+    int exitCode = allParsed ? ExitSuccess : ExitRunFailed;
+    report["success"] = allParsed;
+    report["exit_code"] = exitCode;
+    report["files"] = fileArray;
+    if (!writeOutput(report, options) && exitCode == ExitSuccess) {
+        exitCode = ExitRunFailed;
+    }
+    return exitCode;
+}
+
+int BenchmarkCli::runNvmeReplayCheck(const QCommandLineParser &parser, QJsonObject &report) {
+    BenchmarkCliOptions options;
+    options.pretty = parser.isSet("pretty");
+    options.outputPath = parser.value("output");
+    options.verbose = parser.isSet("verbose");
+    g_verbose = options.verbose;
+    g_defaultHandler = qInstallMessageHandler(filterMessages);
+
+    const QStringList positional = parser.positionalArguments();
+    QDir dir(positional.isEmpty() ? defaultTestdataDirectory("nvme") : positional.first());
+    report["target"] = dir.path();
+
+    QString error;
+    QJsonObject expected;
+    QFile expectedFile(dir.filePath("expected.json"));
+    if (!expectedFile.open(QIODevice::ReadOnly)) {
+        error = QString("无法读取期望值 %1: %2").arg(expectedFile.fileName(), expectedFile.errorString());
+    } else {
+        expected = QJsonDocument::fromJson(expectedFile.readAll()).object();
+        if (expected.isEmpty()) {
+            error = QString("期望值文件格式错误: %1").arg(expectedFile.fileName());
+        }
+    }
+    if (!error.isEmpty()) {
+        QTextStream(stderr) << "错误: " << error << "\n";
+        report["success"] = false;
+        report["error"] = error;
+        report["exit_code"] = ExitUsageError;
+        writeOutput(report, options);
+        return ExitUsageError;
+    }
+
+    // 经由NvmeHealthReader发出与真实设备相同的管理命令，覆盖命令构造和解码两部分
+    RecordedNvmeTransport transport(dir.path());
+    NvmeHealthReader reader(&transport);
+    ReportComparison comparison("解码", "期望");
+
+    NvmeControllerInfo info;
+    if (reader.identifyController(info, error)) {
+        checkIdentify(info, expected.value("identify_controller").toObject(), comparison);
+    } else {
+        comparison.fail("Identify Controller: " + error);
+    }
+
+    NvmeSmartLog log;
+    if (reader.readSmartLog(log, error)) {
+        checkSmartLog(log, expected.value("smart_log").toObject(), comparison);
+    } else {
+        comparison.fail("SMART/Health日志页: " + error);
+    }
+
+    QList<NvmeErrorLogEntry> entries;
+    if (reader.readErrorLog(info.errorLogPageEntries, entries, error)) {
+        checkErrorLog(entries, expected.value("error_log").toArray(), comparison);
+    } else {
+        comparison.fail("错误信息日志页: " + error);
+    }
+
+    const bool passed = comparison.mismatches().isEmpty();
+    int exitCode = passed ? ExitSuccess : ExitRunFailed;
+    report["success"] = passed;
+    report["exit_code"] = exitCode;
+    report["fields"] = comparison.fields();
+    if (!passed) {
+        report["mismatches"] = QJsonArray::fromStringList(comparison.mismatches());
+        for (const QString &mismatch : comparison.mismatches()) {
+            QTextStream(stderr) << "不一致: " << mismatch << "\n";
+        }
+    }
+    if (!writeOutput(report, options) && exitCode == ExitSuccess) {
+        exitCode = ExitRunFailed;
+    }
+    return exitCode;
+}
+
+bool BenchmarkCli::readOptions(const QCommandLineParser &parser, BenchmarkCliOptions &options, QString &errorMessage) {
+    options.verbose = parser.isSet("verbose");
+    options.pretty = parser.isSet("pretty");
+    options.outputPath = parser.value("output");
+    options.jobFile = parser.value("job-file");
+    options.direct = !parser.isSet("buffered");
+
+    QStringList positional = parser.positionalArguments();
+    if (positional.size() > 1) {
+        errorMessage = "只能指定一个测试目标";
+        return false;
+    }
+    if (positional.isEmpty() && options.jobFile.isEmpty()) {
+        errorMessage = "缺少测试目标（目录、文件或块设备）";
+        return false;
+    }
+    options.target = positional.isEmpty() ? QString() : positional.first();
+
+    if (parser.isSet("bs") && (!FioJobParser::parseSize(parser.value("bs"), options.blockSize) || options.blockSize <= 0)) {
+        errorMessage = QString("无效的块大小: %1").arg(parser.value("bs"));
+        return false;
+    }
+    if (parser.isSet("size") && !FioJobParser::parseSize(parser.value("size"), options.size)) {
+        errorMessage = QString("无效的大小: %1").arg(parser.value("size"));
+        return false;
+    }
+    if (!FioJobParser::parseTime(parser.value("runtime"), options.runtimeMs)
+        || !FioJobParser::parseTime(parser.value("ramp-time"), options.rampTimeMs)) {
+        errorMessage = "无效的runtime或ramp-time";
+        return false;
+    }
+
+    bool ok = true;
+    if (parser.isSet("iodepth")) {
+        options.ioDepth = parser.value("iodepth").toInt(&ok);
+        if (!ok || options.ioDepth < 1 || options.ioDepth > 1024) {
+            errorMessage = QString("iodepth应在1-1024之间: %1").arg(parser.value("iodepth"));
+            return false;
+        }
+    }
+    options.numJobs = parser.value("numjobs").toInt(&ok);
+    if (!ok || options.numJobs < 1 || options.numJobs > 64) {
+        errorMessage = QString("numjobs应在1-64之间: %1").arg(parser.value("numjobs"));
+        return false;
+    }
+    options.rwMixRead = parser.value("rwmixread").toInt(&ok);
+    if (!ok || options.rwMixRead < 0 || options.rwMixRead > 100) {
+        errorMessage = QString("rwmixread应在0-100之间: %1").arg(parser.value("rwmixread"));
+        return false;
+    }
+
+    options.bufferCompressPercent = parser.value("buffer-compress-percentage").toInt(&ok);
+    options.dedupePercent = ok ? parser.value("dedupe-percentage").toInt(&ok) : 0;
+    if (!ok || options.bufferCompressPercent < 0 || options.bufferCompressPercent > 100
+        || options.dedupePercent < 0 || options.dedupePercent > 100) {
+        errorMessage = "buffer-compress-percentage和dedupe-percentage应在0-100之间";
+        return false;
+    }
+
+    QString engine = parser.value("ioengine").toLower();
+    if (engine == "libaio") {
+        options.engine = FioJob::NativeAio;
+    } else if (engine == "sync" || engine == "psync") {
+        options.engine = FioJob::Sync;
+    } else {
+        errorMessage = QString("不支持的ioengine: %1").arg(engine);
+        return false;
+    }
+
+    QString modes = parser.value("mode").trimmed().toLower();
+    if (modes == "all") {
+        options.modes = QStringList{"seq-write", "seq-read", "rand-write", "rand-read", "rand-rw"};
+    } else if (!modes.isEmpty()) {
+        for (const QString &mode : modes.split(',', Qt::SkipEmptyParts)) {
+            options.modes.append(mode.trimmed());
+        }
+    }
+    return true;
+}
+
+bool BenchmarkCli::buildJobs(const BenchmarkCliOptions &options, QList<FioJob> &jobs, QString &errorMessage) {
+    QFileInfo info(options.target);
+    bool blockDevice = isBlockDevice(options.target);
+
+    QStringList modes = options.modes;
+    if (modes.isEmpty()) {
+        modes = blockDevice ? QStringList{"seq-read", "rand-read"}
+                            : QStringList{"seq-write", "seq-read", "rand-write", "rand-read"};
+    }
+
+    // 目录目标：所有作业共用一个临时文件，只铺设一次，运行结束后由引擎删除
+    QString filename = options.target;
+    if (info.isDir()) {
+        filename = QDir(options.target).filePath(QString("disktoolbox_cli_%1.dat").arg(QCoreApplication::applicationPid()));
+    }
+
+    qint64 size = options.size;
+    if (size < 0) {
+        size = blockDevice ? 0 : kDefaultFileSize;
+    }
+
+    for (const QString &mode : modes) {
+        const ModeDefinition *definition = nullptr;
+        for (const ModeDefinition &candidate : kModes) {
+            if (mode == candidate.mode) {
+                definition = &candidate;
+                break;
+            }
+        }
+        if (!definition) {
+            errorMessage = QString("未知的测试模式: %1").arg(mode);
+            return false;
+        }
+
+        FioJob job;
+        job.name = mode;
+        job.rw = definition->rw;
+        job.filename = filename;
+        job.random = definition->random;
+        job.rwMixRead = options.rwMixRead;
+        job.readPercent = definition->readPercent < 0 ? options.rwMixRead : definition->readPercent;
+        job.blockSize = options.blockSize > 0 ? options.blockSize : (job.random ? 4096 : 1024 * 1024);
+        job.ioDepth = options.ioDepth > 0 ? options.ioDepth : (job.random ? 32 : 8);
+        job.numJobs = options.numJobs;
+        job.size = size;
+        job.runtimeMs = options.runtimeMs;
+        job.rampTimeMs = options.rampTimeMs;
+        job.timeBased = options.runtimeMs > 0;
+        job.direct = options.direct;
+        job.engine = options.engine;
+        job.endFsync = job.hasWrites();
+        job.bufferCompressPercent = options.bufferCompressPercent;
+        job.dedupePercent = options.dedupePercent;
+
+        if (job.blockSize % 512 != 0 || (job.direct && job.blockSize % 4096 != 0)) {
+            errorMessage = QString("块大小必须是4K的整数倍（--buffered时为512字节）: %1").arg(job.blockSize);
+            return false;
+        }
+        if (job.size > 0 && job.size < job.blockSize) {
+            errorMessage = "size不能小于块大小";
+            return false;
+        }
+        if (blockDevice && job.hasWrites()) {
+            errorMessage = QString("为防止破坏数据，不允许对块设备执行写入测试: %1").arg(mode);
+            return false;
+        }
+        jobs.append(job);
+    }
+    return true;
+}
+
+QJsonObject BenchmarkCli::directionToJson(qint64 bytes, qint64 ios, double mbps, double iops,
+                                          const LatencyHistogram &latency) {
+    QJsonObject object;
+    object["bytes"] = bytes;
+    object["ios"] = ios;
+    object["bw_mbps"] = mbps;
+    object["iops"] = iops;
+
+    QJsonObject latencyObject;
+    latencyObject["min"] = latency.minNs();
+    latencyObject["mean"] = latency.meanNs();
+    latencyObject["max"] = latency.maxNs();
+    const double percentiles[] = {50, 90, 95, 99, 99.9, 99.99};
+    QJsonObject percentileObject;
+    for (double percentile : percentiles) {
+        percentileObject[QString::number(percentile)] = latency.percentileNs(percentile);
+    }
+    latencyObject["percentiles"] = percentileObject;
+    object["lat_ns"] = latencyObject;
+    return object;
+}
+
+QJsonObject BenchmarkCli::jobToJson(const WorkloadJobResult &result, const FioJob &job) {
+    QJsonObject object;
+    object["name"] = result.jobName;
+    object["rw"] = result.rw;
+    object["block_size"] = result.blockSize;
+    object["iodepth"] = result.ioDepth;
+    object["numjobs"] = result.numJobs;
+    object["direct"] = result.directIo;
+    object["ioengine"] = result.nativeAio ? "libaio" : "sync";
+    object["success"] = result.success;
+    if (!result.success) {
+        object["error"] = result.errorMessage;
+        return object;
+    }
+
+    object["elapsed_sec"] = result.elapsedSec;
+    if (job.hasReads()) {
+        object["read"] = directionToJson(result.readBytes, result.readIos, result.readMBps(), result.readIops(),
+                                         result.readLatency);
+    }
+    if (job.hasWrites()) {
+        object["write"] = directionToJson(result.writeBytes, result.writeIos, result.writeMBps(), result.writeIops(),
+                                          result.writeLatency);
+    }
+    // 与fio的sync段对应：fsync/fdatasync的次数和耗时
+    if (result.syncLatency.count() > 0) {
+        QJsonObject sync = directionToJson(0, static_cast<qint64>(result.syncLatency.count()), 0, 0, result.syncLatency);
+        sync.remove("bytes");
+        sync.remove("bw_mbps");
+        sync.remove("iops");
+        object["sync"] = sync;
+    }
+    return object;
+}
+
+bool BenchmarkCli::writeOutput(const QJsonObject &report, const BenchmarkCliOptions &options) {
+    QByteArray json = QJsonDocument(report).toJson(options.pretty ? QJsonDocument::Indented : QJsonDocument::Compact);
+    if (!options.pretty) {
+        json.append('\n');
+    }
+
+    if (options.outputPath.isEmpty()) {
+        fwrite(json.constData(), 1, json.size(), stdout);
+        fflush(stdout);
+        return true;
+    }
+
+    QFile file(options.outputPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        QTextStream(stderr) << "无法写入输出文件: " << options.outputPath << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef BENCHMARKCLI_H
+#define BENCHMARKCLI_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QJsonObject>
+
+#include "fiojob.h"
+#include "workloadengine.h"
+
+class QCommandLineParser;
+
+// 命令行参数
+struct BenchmarkCliOptions {
+    QString target;         // 目录、文件或块设备
+    QStringList modes;      // seq-read/seq-write/rand-read/rand-write/rand-rw
+    QString jobFile;        // 指定后忽略modes，按fio作业文件运行
+    qint64 blockSize;       // 0表示按模式取默认值（顺序1M，随机4K）
+    qint64 size;            // 每个作业的I/O范围，-1表示自动（文件1G，块设备整个设备）
+    int ioDepth;            // 0表示按模式取默认值（顺序8，随机32）
+    int numJobs;
+    qint64 runtimeMs;       // 大于0时按时间运行
+    qint64 rampTimeMs;
+    int rwMixRead;          // rand-rw的读比例
+    int bufferCompressPercent;  // 写入数据可压缩比例
+    int dedupePercent;      // 可去重的4K块比例
+    FioJob::Engine engine;
+    bool direct;            // 默认O_DIRECT/无缓冲I/O
+    QString outputPath;     // 为空时输出到标准输出
+    bool pretty;
+    bool verbose;
+
+    BenchmarkCliOptions()
+        : blockSize(0), size(-1), ioDepth(0), numJobs(1), runtimeMs(0), rampTimeMs(0), rwMixRead(70),
+          bufferCompressPercent(0), dedupePercent(0),
+          engine(FioJob::NativeAio), direct(true), pretty(false), verbose(false) {}
+};
+
+// 无界面的速度测试命令行工具
+// 不创建QApplication，直接用WorkloadEngine同步执行顺序/随机读写或fio作业文件，
+// 结果以JSON输出到标准输出（或--output指定的文件），方便Ansible等批量采集。
+// 日志默认关闭，--verbose时输出到标准错误，不会混入JSON。
+class BenchmarkCli
+{
+public:
+    // 进程退出码
+    enum ExitCode {
+        ExitSuccess = 0,        // 所有作业成功
+        ExitRunFailed = 1,      // 有作业失败（打开失败、I/O错误等）
+        ExitUsageError = 2,     // 参数或作业文件错误
+        ExitCanceled = 3        // 被SIGINT/SIGTERM中断
+    };
+
+    // arguments包含程序名，与QCoreApplication::arguments()一致
+    static int run(const QStringList &arguments);
+
+private:
+    // --parse-bench：对录制的smartctl JSON输出比较流式解析器和QJsonDocument的解析耗时，
+    // 并核对两者取出的字段，不一致时按失败退出
+    static int runParseBenchmark(const QCommandLineParser &parser, QJsonObject &report);
+    // --nvme-replay：用录制的Identify和日志页回放NVMe管理命令，核对解码结果
+    static int runNvmeReplayCheck(const QCommandLineParser &parser, QJsonObject &report);
+    static bool readOptions(const QCommandLineParser &parser, BenchmarkCliOptions &options, QString &errorMessage);
+    static bool buildJobs(const BenchmarkCliOptions &options, QList<FioJob> &jobs, QString &errorMessage);
+    static QJsonObject jobToJson(const WorkloadJobResult &result, const FioJob &job);
+    static QJsonObject directionToJson(qint64 bytes, qint64 ios, double mbps, double iops,
+                                       const LatencyHistogram &latency);
+    static bool writeOutput(const QJsonObject &report, const BenchmarkCliOptions &options);
+};
+
+#endif // BENCHMARKCLI_H
@@ -0,0 +1,14 @@
+#include <QCoreApplication>
+#include "benchmarkcli.h"
+
+// 命令行版速度测试入口，只依赖QtCore，可在没有图形环境的服务器上运行
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("disktoolbox-cli");
+    app.setApplicationVersion("0.1");
+    app.setOrganizationName("DiskToolbox");
+
+    // 测试在主线程同步执行，不需要进入事件循环
+    return BenchmarkCli::run(app.arguments());
+}
@@ -0,0 +1,481 @@
+#include "atapassthrough.h"
+#include <QDebug>
+#include <QMap>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <scsi/sg.h>
+#endif
+
+namespace {
+// ATA命令
+const quint8 kAtaIdentifyDevice = 0xEC;
+const quint8 kAtaSmart = 0xB0;
+// SMART子命令（写入特性寄存器）
+const quint8 kSmartReadData = 0xD0;
+const quint8 kSmartReadThresholds = 0xD1;
+const quint8 kSmartReturnStatus = 0xDA;
+// SMART命令要求的LBA Mid/High签名，RETURN STATUS报告超过阈值时设备改为返回0xF4/0x2C
+const quint8 kSmartLbaMid = 0x4F;
+const quint8 kSmartLbaHigh = 0xC2;
+const quint8 kSmartFailLbaMid = 0xF4;
+const quint8 kSmartFailLbaHigh = 0x2C;
+
+// SMART数据结构中的属性表：从偏移2开始，30项，每项12字节
+const int kAttributeTableOffset = 2;
+const int kAttributeCount = 30;
+const int kAttributeEntrySize = 12;
+
+#ifdef Q_OS_LINUX
+// SCSI ATA PASS-THROUGH(16)
+const quint8 kAtaPassThrough16 = 0x85;
+const int kProtocolNonData = 3;
+const int kProtocolPioDataIn = 4;
+// 命令超时（毫秒），SMART命令通常在几毫秒内完成，休眠的机械硬盘需要先起转
+const unsigned int kCommandTimeoutMs = 15000;
+// SCSI状态
+const unsigned char kScsiCheckCondition = 0x02;
+// 描述符格式sense数据中的ATA返回描述符
+const unsigned char kSenseDescriptorFormat = 0x72;
+const unsigned char kAtaReturnDescriptor = 0x09;
+
+QString sgErrorString(const QString &devicePath, const sg_io_hdr_t &header, const unsigned char *sense)
+{
+    return QString("%1: SG_IO命令失败 (status=0x%2, host=0x%3, driver=0x%4, sense key=0x%5)")
+        .arg(devicePath)
+        .arg(header.status, 0, 16)
+        .arg(header.host_status, 0, 16)
+        .arg(header.driver_status, 0, 16)
+        .arg(header.sb_len_wr > 2 ? (sense[1] & 0x0F) : 0, 0, 16);
+}
+#endif
+
+// IDENTIFY中的字符串每个字内高低字节互换，末尾以空格填充
+QString identifyString(const QByteArray &sector, int firstWord, int wordCount)
+{
+    QByteArray text;
+    for (int word = firstWord; word < firstWord + wordCount; ++word) {
+        text.append(sector[word * 2 + 1]);
+        text.append(sector[word * 2]);
+    }
+    return QString::fromLatin1(text).trimmed();
+}
+
+quint16 identifyWord(const QByteArray &sector, int word)
+{
+    return static_cast<quint8>(sector[word * 2]) | (static_cast<quint8>(sector[word * 2 + 1]) << 8);
+}
+}
+
+// ===== SgIoAtaTransport =====
+
+SgIoAtaTransport::SgIoAtaTransport() : m_fd(-1)
+{
+}
+
+SgIoAtaTransport::~SgIoAtaTransport()
+{
+    close();
+}
+
+bool SgIoAtaTransport::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SgIoAtaTransport::open(const QString &devicePath, QString &errorMessage)
+{
+    close();
+    m_devicePath = devicePath;
+#ifdef Q_OS_LINUX
+    // SG_IO只需要读权限，O_NONBLOCK避免在可移动设备没有介质时阻塞
+    m_fd = ::open(devicePath.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK);
+    if (m_fd < 0) {
+        errorMessage = QString("无法打开设备 %1: %2").arg(devicePath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    return true;
+#else
+    errorMessage = "当前平台不支持SG_IO";
+    return false;
+#endif
+}
+
+void SgIoAtaTransport::close()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+}
+
+bool SgIoAtaTransport::pioIn(const AtaTaskFile &taskFile, QByteArray &buffer, QString &errorMessage)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0) {
+        errorMessage = "设备未打开";
+        return false;
+    }
+
+    const int sectors = qMax<int>(1, taskFile.count);
+    buffer.fill(0, sectors * AtaSmartReader::kSectorSize);
+
+    unsigned char cdb[16] = {};
+    cdb[0] = kAtaPassThrough16;
+    cdb[1] = kProtocolPioDataIn << 1;
+    // T_DIR=1(设备到主机) BYT_BLOK=1(按块计数) T_LENGTH=2(长度在扇区数字段)
+    cdb[2] = 0x0E;
+    cdb[4] = taskFile.feature;
+    cdb[6] = taskFile.count;
+    cdb[8] = taskFile.lbaLow;
+    cdb[10] = taskFile.lbaMid;
+    cdb[12] = taskFile.lbaHigh;
+    cdb[13] = taskFile.device;
+    cdb[14] = taskFile.command;
+
+    unsigned char sense[32] = {};
+    sg_io_hdr_t header;
+    memset(&header, 0, sizeof(header));
+    header.interface_id = 'S';
+    header.dxfer_direction = SG_DXFER_FROM_DEV;
+    header.cmd_len = sizeof(cdb);
+    header.cmdp = cdb;
+    header.mx_sb_len = sizeof(sense);
+    header.sbp = sense;
+    header.dxfer_len = static_cast<unsigned int>(buffer.size());
+    header.dxferp = buffer.data();
+    header.timeout = kCommandTimeoutMs;
+
+    if (ioctl(m_fd, SG_IO, &header) < 0) {
+        errorMessage = QString("%1: SG_IO调用失败: %2").arg(m_devicePath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    // 部分SAT实现在成功时也返回带"已恢复错误"的CHECK CONDITION
+    bool recovered = header.status == kScsiCheckCondition && header.sb_len_wr > 2 && (sense[1] & 0x0F) <= 1;
+    if ((header.status != 0 && !recovered) || header.host_status != 0 || (header.driver_status & 0x0F) > 0x08) {
+        errorMessage = sgErrorString(m_devicePath, header, sense);
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(taskFile);
+    Q_UNUSED(buffer);
+    errorMessage = "当前平台不支持SG_IO";
+    return false;
+#endif
+}
+
+bool SgIoAtaTransport::nonData(const AtaTaskFile &taskFile, AtaTaskFile &result, QString &errorMessage)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0) {
+        errorMessage = "设备未打开";
+        return false;
+    }
+
+    unsigned char cdb[16] = {};
+    cdb[0] = kAtaPassThrough16;
+    cdb[1] = kProtocolNonData << 1;
+    // CK_COND=1：完成后以sense数据返回ATA寄存器
+    cdb[2] = 0x20;
+    cdb[4] = taskFile.feature;
+    cdb[6] = taskFile.count;
+    cdb[8] = taskFile.lbaLow;
+    cdb[10] = taskFile.lbaMid;
+    cdb[12] = taskFile.lbaHigh;
+    cdb[13] = taskFile.device;
+    cdb[14] = taskFile.command;
+
+    unsigned char sense[32] = {};
+    sg_io_hdr_t header;
+    memset(&header, 0, sizeof(header));
+    header.interface_id = 'S';
+    header.dxfer_direction = SG_DXFER_NONE;
+    header.cmd_len = sizeof(cdb);
+    header.cmdp = cdb;
+    header.mx_sb_len = sizeof(sense);
+    header.sbp = sense;
+    header.timeout = kCommandTimeoutMs;
+
+    if (ioctl(m_fd, SG_IO, &header) < 0) {
+        errorMessage = QString("%1: SG_IO调用失败: %2").arg(m_devicePath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+
+    // 寄存器在描述符格式sense数据的ATA返回描述符中：8字节头之后
+    const unsigned char *descriptor = sense + 8;
+    if (header.sb_len_wr < 8 + 14 || sense[0] != kSenseDescriptorFormat || descriptor[0] != kAtaReturnDescriptor) {
+        errorMessage = sgErrorString(m_devicePath, header, sense);
+        return false;
+    }
+    result.feature = descriptor[3];
+    result.count = descriptor[5];
+    result.lbaLow = descriptor[7];
+    result.lbaMid = descriptor[9];
+    result.lbaHigh = descriptor[11];
+    result.device = descriptor[12];
+    result.command = descriptor[13];
+    return true;
+#else
+    Q_UNUSED(taskFile);
+    Q_UNUSED(result);
+    errorMessage = "当前平台不支持SG_IO";
+    return false;
+#endif
+}
+
+// ===== AtaSmartReader =====
+
+AtaSmartReader::AtaSmartReader(AtaTransport *transport) : m_transport(transport)
+{
+}
+
+bool AtaSmartReader::identify(AtaIdentifyInfo &info, QString &errorMessage)
+{
+    AtaTaskFile taskFile;
+    taskFile.command = kAtaIdentifyDevice;
+    taskFile.count = 1;
+
+    QByteArray sector;
+    if (!m_transport->pioIn(taskFile, sector, errorMessage)) {
+        return false;
+    }
+    return decodeIdentify(sector, info, errorMessage);
+}
+
+bool AtaSmartReader::readAttributes(QList<SmartAttribute> &attributes, QString &errorMessage)
+{
+    AtaTaskFile taskFile;
+    taskFile.command = kAtaSmart;
+    taskFile.feature = kSmartReadData;
+    taskFile.count = 1;
+    taskFile.lbaMid = kSmartLbaMid;
+    taskFile.lbaHigh = kSmartLbaHigh;
+
+    QByteArray data;
+    if (!m_transport->pioIn(taskFile, data, errorMessage)) {
+        return false;
+    }
+
+    // 阈值读取失败不影响属性值本身，部分新硬盘已不再支持这个命令
+    QByteArray thresholds;
+    QString thresholdError;
+    taskFile.feature = kSmartReadThresholds;
+    if (!m_transport->pioIn(taskFile, thresholds, thresholdError)) {
+        qDebug() << "读取SMART阈值失败，阈值按0处理:" << thresholdError;
+        thresholds.clear();
+    }
+
+    return decodeAttributes(data, thresholds, attributes, errorMessage);
+}
+
+bool AtaSmartReader::returnStatus(bool &passed, QString &errorMessage)
+{
+    AtaTaskFile taskFile;
+    taskFile.command = kAtaSmart;
+    taskFile.feature = kSmartReturnStatus;
+    taskFile.lbaMid = kSmartLbaMid;
+    taskFile.lbaHigh = kSmartLbaHigh;
+
+    AtaTaskFile result;
+    if (!m_transport->nonData(taskFile, result, errorMessage)) {
+        return false;
+    }
+    if (result.lbaMid == kSmartLbaMid && result.lbaHigh == kSmartLbaHigh) {
+        passed = true;
+    } else if (result.lbaMid == kSmartFailLbaMid && result.lbaHigh == kSmartFailLbaHigh) {
+        passed = false;
+    } else {
+        errorMessage = QString("SMART RETURN STATUS返回了无法识别的签名 0x%1/0x%2")
+                           .arg(result.lbaMid, 2, 16, QChar('0'))
+                           .arg(result.lbaHigh, 2, 16, QChar('0'));
+        return false;
+    }
+    return true;
+}
+
+bool AtaSmartReader::checksumValid(const QByteArray &sector)
+{
+    if (sector.size() < kSectorSize) {
+        return false;
+    }
+    quint8 sum = 0;
+    for (int i = 0; i < kSectorSize; ++i) {
+        sum += static_cast<quint8>(sector[i]);
+    }
+    return sum == 0;
+}
+
+bool AtaSmartReader::decodeIdentify(const QByteArray &sector, AtaIdentifyInfo &info, QString &errorMessage)
+{
+    if (sector.size() < kSectorSize) {
+        errorMessage = QString("IDENTIFY数据长度不足: %1 字节").arg(sector.size());
+        return false;
+    }
+    // 第255字低字节为0xA5时高字节是校验和
+    if (static_cast<quint8>(sector[510]) == 0xA5 && !checksumValid(sector)) {
+        errorMessage = "IDENTIFY数据校验和错误";
+        return false;
+    }
+
+    info.serialNumber = identifyString(sector, 10, 10);
+    info.firmware = identifyString(sector, 23, 4);
+    info.model = identifyString(sector, 27, 20);
+
+    // 第83字bit10表示支持48位寻址，此时容量在第100-103字
+    if (identifyWord(sector, 83) & (1 << 10)) {
+        info.sectors = 0;
+        for (int word = 103; word >= 100; --word) {
+            info.sectors = (info.sectors << 16) | identifyWord(sector, word);
+        }
+    } else {
+        info.sectors = identifyWord(sector, 60) | (static_cast<qint64>(identifyWord(sector, 61)) << 16);
+    }
+
+    // 第106字：bit14=1、bit15=0时有效，bit12表示逻辑扇区大于256字
+    quint16 sectorSizeInfo = identifyWord(sector, 106);
+    if ((sectorSizeInfo & 0xC000) == 0x4000 && (sectorSizeInfo & (1 << 12))) {
+        quint32 words = identifyWord(sector, 117) | (static_cast<quint32>(identifyWord(sector, 118)) << 16);
+        info.logicalSectorSize = static_cast<int>(words * 2);
+    } else {
+        info.logicalSectorSize = 512;
+    }
+
+    info.rotationRate = identifyWord(sector, 217);
+    info.smartSupported = identifyWord(sector, 82) & 0x0001;
+    info.smartEnabled = identifyWord(sector, 85) & 0x0001;
+
+    if (info.model.isEmpty()) {
+        errorMessage = "IDENTIFY数据中没有型号信息";
+        return false;
+    }
+    return true;
+}
+
+bool AtaSmartReader::decodeAttributes(const QByteArray &data, const QByteArray &thresholds,
+                                      QList<SmartAttribute> &attributes, QString &errorMessage)
+{
+    if (data.size() < kSectorSize) {
+        errorMessage = QString("SMART数据长度不足: %1 字节").arg(data.size());
+        return false;
+    }
+    if (!checksumValid(data)) {
+        errorMessage = "SMART数据校验和错误";
+        return false;
+    }
+
+    // 阈值表与属性表的项按ID对应，顺序不一定相同
+    QMap<int, int> thresholdById;
+    if (thresholds.size() >= kSectorSize && checksumValid(thresholds)) {
+        for (int i = 0; i < kAttributeCount; ++i) {
+            const int offset = kAttributeTableOffset + i * kAttributeEntrySize;
+            int id = static_cast<quint8>(thresholds[offset]);
+            if (id != 0) {
+                thresholdById[id] = static_cast<quint8>(thresholds[offset + 1]);
+            }
+        }
+    } else if (!thresholds.isEmpty()) {
+        qDebug() << "SMART阈值数据无效，阈值按0处理";
+    }
+
+    attributes.clear();
+    for (int i = 0; i < kAttributeCount; ++i) {
+        const int offset = kAttributeTableOffset + i * kAttributeEntrySize;
+        const int id = static_cast<quint8>(data[offset]);
+        if (id == 0) {
+            continue;
+        }
+
+        // 项结构：ID(1) 标志(2) 当前值(1) 最差值(1) 原始值(6, 小端) 保留(1)
+        SmartAttribute attr;
+        attr.id = id;
+        attr.name = attributeName(id);
+        attr.current = static_cast<quint8>(data[offset + 3]);
+        attr.worst = static_cast<quint8>(data[offset + 4]);
+        attr.threshold = thresholdById.value(id, 0);
+
+        quint64 raw = 0;
+        for (int byte = 5; byte >= 0; --byte) {
+            raw = (raw << 8) | static_cast<quint8>(data[offset + 5 + byte]);
+        }
+        // 与smartctl默认显示一致：温度只取最低字节（高字节是最低/最高温度），通电时间只取低32位
+        if (id == 190 || id == 194) {
+            raw &= 0xFF;
+        } else if (id == 9) {
+            raw &= 0xFFFFFFFFULL;
+        }
+        attr.raw = static_cast<long long>(raw);
+        attributes.append(attr);
+    }
+
+    if (attributes.isEmpty()) {
+        errorMessage = "SMART数据中没有任何属性";
+        return false;
+    }
+    return true;
+}
+
+QString AtaSmartReader::attributeName(int id)
+{
+    static const QMap<int, QString> names = {
+        {1, "Raw_Read_Error_Rate"},
+        {2, "Throughput_Performance"},
+        {3, "Spin_Up_Time"},
+        {4, "Start_Stop_Count"},
+        {5, "Reallocated_Sector_Ct"},
+        {7, "Seek_Error_Rate"},
+        {8, "Seek_Time_Performance"},
+        {9, "Power_On_Hours"},
+        {10, "Spin_Retry_Count"},
+        {11, "Calibration_Retry_Count"},
+        {12, "Power_Cycle_Count"},
+        {13, "Read_Soft_Error_Rate"},
+        {170, "Available_Reservd_Space"},
+        {171, "Program_Fail_Count"},
+        {172, "Erase_Fail_Count"},
+        {173, "Wear_Leveling_Count"},
+        {174, "Unexpect_Power_Loss_Ct"},
+        {175, "Program_Fail_Count_Chip"},
+        {176, "Erase_Fail_Count_Chip"},
+        {177, "Wear_Leveling_Count"},
+        {179, "Used_Rsvd_Blk_Cnt_Tot"},
+        {180, "Unused_Rsvd_Blk_Cnt_Tot"},
+        {181, "Program_Fail_Cnt_Total"},
+        {182, "Erase_Fail_Count_Total"},
+        {183, "Runtime_Bad_Block"},
+        {184, "End-to-End_Error"},
+        {187, "Reported_Uncorrect"},
+        {188, "Command_Timeout"},
+        {189, "High_Fly_Writes"},
+        {190, "Airflow_Temperature_Cel"},
+        {191, "G-Sense_Error_Rate"},
+        {192, "Power-Off_Retract_Count"},
+        {193, "Load_Cycle_Count"},
+        {194, "Temperature_Celsius"},
+        {195, "Hardware_ECC_Recovered"},
+        {196, "Reallocated_Event_Count"},
+        {197, "Current_Pending_Sector"},
+        {198, "Offline_Uncorrectable"},
+        {199, "UDMA_CRC_Error_Count"},
+        {200, "Multi_Zone_Error_Rate"},
+        {231, "SSD_Life_Left"},
+        {232, "Available_Reservd_Space"},
+        {233, "Media_Wearout_Indicator"},
+        {235, "POR_Recovery_Count"},
+        {240, "Head_Flying_Hours"},
+        {241, "Total_LBAs_Written"},
+        {242, "Total_LBAs_Read"},
+        {254, "Free_Fall_Sensor"}
+    };
+    return names.value(id, "Unknown_Attribute");
+}
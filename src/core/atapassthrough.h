@@ -0,0 +1,107 @@
+#ifndef ATAPASSTHROUGH_H
+#define ATAPASSTHROUGH_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+#include "smartdata.h"
+
+// ATA命令寄存器（28位寻址）
+struct AtaTaskFile {
+    quint8 feature;     // 输入为特性寄存器，输出为错误寄存器
+    quint8 count;       // 扇区数
+    quint8 lbaLow;
+    quint8 lbaMid;
+    quint8 lbaHigh;
+    quint8 device;
+    quint8 command;     // 输入为命令，输出为状态寄存器
+
+    AtaTaskFile() : feature(0), count(0), lbaLow(0), lbaMid(0), lbaHigh(0), device(0), command(0) {}
+};
+
+// 向ATA设备发送命令的底层接口
+// 真实设备使用SgIoAtaTransport，测试时可以实现一个返回固定扇区内容的版本，不需要硬件
+class AtaTransport
+{
+public:
+    virtual ~AtaTransport() {}
+
+    // PIO读取命令，读取taskFile.count个512字节扇区到buffer
+    virtual bool pioIn(const AtaTaskFile &taskFile, QByteArray &buffer, QString &errorMessage) = 0;
+
+    // 无数据传输的命令，result为命令完成后设备返回的寄存器
+    virtual bool nonData(const AtaTaskFile &taskFile, AtaTaskFile &result, QString &errorMessage) = 0;
+};
+
+// 通过Linux SG_IO ioctl发送ATA PASS-THROUGH(16)命令
+// 适用于libata管理的SATA磁盘(/dev/sdX)和大多数支持SAT转换的USB硬盘盒；需要root权限或磁盘组权限。
+// 其他平台上open总是失败，由调用方退回smartctl。
+class SgIoAtaTransport : public AtaTransport
+{
+public:
+    SgIoAtaTransport();
+    ~SgIoAtaTransport() override;
+
+    bool open(const QString &devicePath, QString &errorMessage);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    bool pioIn(const AtaTaskFile &taskFile, QByteArray &buffer, QString &errorMessage) override;
+    bool nonData(const AtaTaskFile &taskFile, AtaTaskFile &result, QString &errorMessage) override;
+
+    // 当前平台是否支持SG_IO
+    static bool isSupported();
+
+private:
+    int m_fd;
+    QString m_devicePath;
+};
+
+// IDENTIFY DEVICE返回的设备信息
+struct AtaIdentifyInfo {
+    QString model;
+    QString serialNumber;
+    QString firmware;
+    qint64 sectors;             // 用户可寻址扇区数
+    int logicalSectorSize;      // 逻辑扇区大小（字节）
+    int rotationRate;           // 转速，1表示固态硬盘，0表示未报告
+    bool smartSupported;
+    bool smartEnabled;
+
+    AtaIdentifyInfo() : sectors(0), logicalSectorSize(512), rotationRate(0), smartSupported(false), smartEnabled(false) {}
+};
+
+// 用ATA SMART命令直接读取和解码SMART数据，不经过smartctl进程
+class AtaSmartReader
+{
+public:
+    explicit AtaSmartReader(AtaTransport *transport);
+
+    // IDENTIFY DEVICE
+    bool identify(AtaIdentifyInfo &info, QString &errorMessage);
+
+    // SMART READ DATA + SMART READ THRESHOLDS
+    bool readAttributes(QList<SmartAttribute> &attributes, QString &errorMessage);
+
+    // SMART RETURN STATUS，passed为false表示设备报告已超过阈值
+    bool returnStatus(bool &passed, QString &errorMessage);
+
+    // 以下解码函数只依赖扇区内容，可以直接用保存的数据测试
+    static bool decodeIdentify(const QByteArray &sector, AtaIdentifyInfo &info, QString &errorMessage);
+    // thresholds为空时阈值全部为0；status和description由调用方填写
+    static bool decodeAttributes(const QByteArray &data, const QByteArray &thresholds,
+                                 QList<SmartAttribute> &attributes, QString &errorMessage);
+    // 512字节结构的校验和，所有字节之和为0时有效
+    static bool checksumValid(const QByteArray &sector);
+    // 与smartctl一致的属性名称，未知属性为"Unknown_Attribute"
+    static QString attributeName(int id);
+
+    static const int kSectorSize = 512;
+
+private:
+    AtaTransport *m_transport;
+};
+
+#endif // ATAPASSTHROUGH_H
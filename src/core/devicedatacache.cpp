@@ -0,0 +1,195 @@
+#include "devicedatacache.h"
+#include "diskutils.h"
+#include "smartfactory.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFutureInterface>
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+namespace {
+// 默认有效期：SMART属性变化慢，温度跟随仪表盘的5秒刷新周期
+const int kDefaultSmartTtlMs = 60000;
+const int kDefaultTemperatureTtlMs = 5000;
+
+template <typename T>
+QFuture<T> readyFuture(const T &value)
+{
+    QFutureInterface<T> futureInterface;
+    futureInterface.reportStarted();
+    futureInterface.reportResult(value);
+    futureInterface.reportFinished();
+    return futureInterface.future();
+}
+}
+
+DeviceDataCache::DeviceDataCache(QObject *parent) : QObject(parent),
+    m_smartTtl(kDefaultSmartTtlMs),
+    m_temperatureTtl(kDefaultTemperatureTtlMs)
+{
+    m_clock.start();
+}
+
+DeviceDataCache *DeviceDataCache::instance()
+{
+    // 在第一次使用时创建，随QCoreApplication一起销毁
+    static DeviceDataCache *cache = new DeviceDataCache(QCoreApplication::instance());
+    return cache;
+}
+
+QString DeviceDataCache::deviceKey(const QString &diskPath)
+{
+    return DiskUtils::smartDevicePath(diskPath);
+}
+
+void DeviceDataCache::setTimeToLive(Field field, int msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    if (field == SmartField) {
+        m_smartTtl = msecs;
+    } else {
+        m_temperatureTtl = msecs;
+    }
+}
+
+int DeviceDataCache::timeToLive(Field field) const
+{
+    QMutexLocker locker(&m_mutex);
+    return field == SmartField ? m_smartTtl : m_temperatureTtl;
+}
+
+QSharedPointer<SmartData> DeviceDataCache::smartData(const QString &diskPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.value(deviceKey(diskPath)).smartData;
+}
+
+int DeviceDataCache::temperature(const QString &diskPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.value(deviceKey(diskPath)).temperature;
+}
+
+bool DeviceDataCache::isFresh(const QString &diskPath, Field field) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Entry entry = m_entries.value(deviceKey(diskPath));
+    return isFresh(field == SmartField ? entry.smartFetchedAt : entry.temperatureFetchedAt, field);
+}
+
+bool DeviceDataCache::isFresh(qint64 fetchedAt, Field field) const
+{
+    if (fetchedAt < 0) {
+        return false;
+    }
+    return m_clock.elapsed() - fetchedAt < (field == SmartField ? m_smartTtl : m_temperatureTtl);
+}
+
+QFuture<QSharedPointer<SmartData>> DeviceDataCache::requestSmartData(const QString &diskPath, bool force)
+{
+    const QString key = deviceKey(diskPath);
+    QMutexLocker locker(&m_mutex);
+    Entry &entry = m_entries[key];
+
+    // 正在读取时合并请求
+    if (entry.smartPending) {
+        return entry.smartFuture;
+    }
+    if (!force && entry.smartData && isFresh(entry.smartFetchedAt, SmartField)) {
+        return readyFuture(entry.smartData);
+    }
+
+    qDebug() << "---缓存调试---读取SMART数据:" << key;
+    entry.smartPending = true;
+    // 持有锁时启动，工作线程写回结果前一定能看到smartFuture
+    entry.smartFuture = QtConcurrent::run([this, key, diskPath]() {
+        return fetchSmartData(key, diskPath);
+    });
+    return entry.smartFuture;
+}
+
+QFuture<int> DeviceDataCache::requestTemperature(const QString &diskPath, bool force)
+{
+    const QString key = deviceKey(diskPath);
+    QMutexLocker locker(&m_mutex);
+    Entry &entry = m_entries[key];
+
+    if (entry.temperaturePending) {
+        return entry.temperatureFuture;
+    }
+    if (!force && entry.temperature > 0 && isFresh(entry.temperatureFetchedAt, TemperatureField)) {
+        return readyFuture(entry.temperature);
+    }
+
+    entry.temperaturePending = true;
+    entry.temperatureFuture = QtConcurrent::run([this, key, diskPath]() {
+        return fetchTemperature(key, diskPath);
+    });
+    return entry.temperatureFuture;
+}
+
+void DeviceDataCache::invalidate(const QString &diskPath)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(deviceKey(diskPath));
+    if (it != m_entries.end()) {
+        it->smartFetchedAt = -1;
+        it->temperatureFetchedAt = -1;
+    }
+}
+
+QSharedPointer<SmartData> DeviceDataCache::fetchSmartData(const QString &key, const QString &diskPath)
+{
+    // 在工作线程中创建和加载，完成后交给缓存所在线程，最后一个持有者释放时在那里删除
+    SmartData *data = SmartFactory::createSmartData(diskPath);
+    if (!data->loadFromDisk(diskPath)) {
+        qDebug() << "---缓存调试---加载SMART数据失败，缓存模拟数据:" << key;
+    }
+    data->moveToThread(thread());
+    QSharedPointer<SmartData> shared(data, &QObject::deleteLater);
+
+    const int temperature = data->temperature();
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry &entry = m_entries[key];
+        entry.smartData = shared;
+        entry.smartFetchedAt = m_clock.elapsed();
+        entry.smartPending = false;
+        entry.smartFuture = QFuture<QSharedPointer<SmartData>>();
+        // SMART数据中带有温度，顺带刷新温度字段
+        if (temperature > 0) {
+            entry.temperature = temperature;
+            entry.temperatureFetchedAt = entry.smartFetchedAt;
+        }
+    }
+
+    QMetaObject::invokeMethod(this, [this, key, temperature]() {
+        emit smartDataUpdated(key);
+        if (temperature > 0) {
+            emit temperatureUpdated(key, temperature);
+        }
+    }, Qt::QueuedConnection);
+    return shared;
+}
+
+int DeviceDataCache::fetchTemperature(const QString &key, const QString &diskPath)
+{
+    const int temperature = DiskUtils::getDiskTemperature(diskPath);
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry &entry = m_entries[key];
+        entry.temperaturePending = false;
+        entry.temperatureFuture = QFuture<int>();
+        if (temperature > 0) {
+            entry.temperature = temperature;
+            entry.temperatureFetchedAt = m_clock.elapsed();
+        }
+    }
+
+    if (temperature > 0) {
+        QMetaObject::invokeMethod(this, [this, key, temperature]() {
+            emit temperatureUpdated(key, temperature);
+        }, Qt::QueuedConnection);
+    }
+    return temperature;
+}
@@ -0,0 +1,85 @@
+#ifndef DEVICEDATACACHE_H
+#define DEVICEDATACACHE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include "smartdata.h"
+
+// 进程内共享的设备数据缓存
+// 仪表盘、SMART页等界面都从这里取数据，同一块硬盘在有效期内只读取一次：
+// - 以设备身份(DiskUtils::smartDevicePath映射后的路径)为键，\\.\PhysicalDrive0和/dev/sda是同一项
+// - SMART数据和温度分别设置有效期，读取SMART时顺带刷新温度
+// - 同一项正在读取时，后来的请求直接返回同一个QFuture，不会重复执行smartctl或直通命令
+// - 读取完成后在主线程发出smartDataUpdated/temperatureUpdated信号
+// 所有方法都可以在任意线程调用。
+class DeviceDataCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 分别设置有效期的字段
+    enum Field {
+        SmartField,         // 完整SMART数据（属性、健康度、警告）
+        TemperatureField    // 温度
+    };
+
+    static DeviceDataCache *instance();
+
+    // 设备身份，用于比较信号中的键
+    static QString deviceKey(const QString &diskPath);
+
+    void setTimeToLive(Field field, int msecs);
+    int timeToLive(Field field) const;
+
+    // 缓存中的数据，不触发读取；没有数据时返回空指针/-1
+    QSharedPointer<SmartData> smartData(const QString &diskPath) const;
+    int temperature(const QString &diskPath) const;
+    bool isFresh(const QString &diskPath, Field field) const;
+
+    // 数据过期或force为true时在后台读取，否则返回已完成的future
+    // 正在读取时总是返回同一个future，force不会再启动一次读取
+    QFuture<QSharedPointer<SmartData>> requestSmartData(const QString &diskPath, bool force = false);
+    QFuture<int> requestTemperature(const QString &diskPath, bool force = false);
+
+    // 标记为过期，下次请求时重新读取，已有数据仍可显示
+    void invalidate(const QString &diskPath);
+
+signals:
+    void smartDataUpdated(const QString &deviceKey);
+    void temperatureUpdated(const QString &deviceKey, int temperature);
+
+private:
+    explicit DeviceDataCache(QObject *parent = nullptr);
+
+    struct Entry {
+        QSharedPointer<SmartData> smartData;
+        qint64 smartFetchedAt;          // 读取完成时刻(ms)，-1表示过期
+        bool smartPending;
+        QFuture<QSharedPointer<SmartData>> smartFuture;
+        int temperature;                // -1表示没有
+        qint64 temperatureFetchedAt;
+        bool temperaturePending;
+        QFuture<int> temperatureFuture;
+
+        Entry() : smartFetchedAt(-1), smartPending(false), temperature(-1), temperatureFetchedAt(-1),
+                  temperaturePending(false) {}
+    };
+
+    QSharedPointer<SmartData> fetchSmartData(const QString &key, const QString &diskPath);
+    int fetchTemperature(const QString &key, const QString &diskPath);
+    bool isFresh(qint64 fetchedAt, Field field) const;
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    QElapsedTimer m_clock;
+    int m_smartTtl;
+    int m_temperatureTtl;
+};
+
+#endif // DEVICEDATACACHE_H
@@ -1,4 +1,6 @@
 #include "diskdetector.h"
+#include "diskutils.h"
+#include "sysfsdiskenumerator.h"
 #include <QDebug>
 #include <QProcess>
 #include <QRegularExpression>
@@ -15,6 +17,23 @@ QList<DiskSMARTInfo> DiskDetector::detectDisks()
 {
     QList<DiskSMARTInfo> diskList;
     
+    // Linux上从sysfs读取，类型按总线判断
+    if (SysfsDiskEnumerator::isSupported()) {
+        for (const SysfsDiskInfo &disk : SysfsDiskEnumerator().enumerate()) {
+            DiskSMARTInfo diskInfo;
+            diskInfo.diskPath = disk.devicePath;
+            diskInfo.diskType = disk.diskType;
+            diskInfo.model = disk.model.isEmpty() ? "Unknown Model" : disk.model;
+            diskInfo.serialNumber = disk.serialNumber;
+            diskInfo.size = disk.sizeBytes;
+            diskList.append(diskInfo);
+        }
+        if (!diskList.isEmpty()) {
+            return diskList;
+        }
+        qDebug() << "---磁盘检测调试---sysfs中没有物理硬盘";
+    }
+    
     // 使用Windows命令检测系统中的所有物理硬盘
     QProcess wmicProcess;
     qDebug() << "开始使用wmic命令检测物理硬盘...";
@@ -169,6 +188,15 @@ DiskType DiskDetector::detectDiskType(const QString &diskPath)
     // 根据磁盘路径确定类型
     qDebug() << "---磁盘检测调试---检测磁盘类型，路径:" << diskPath;
     
+    // Linux上直接从sysfs读取总线类型
+    if (SysfsDiskEnumerator::isSupported()) {
+        SysfsDiskInfo disk;
+        if (SysfsDiskEnumerator().readDisk(DiskUtils::smartDevicePath(diskPath), disk)) {
+            qDebug() << "---磁盘检测调试---sysfs总线类型:" << disk.transport;
+            return disk.diskType;
+        }
+    }
+    
     // 在Windows中，使用WMI获取更详细的设备信息
     QProcess wmicProcess;
     QString query = QString("wmic path Win32_DiskDrive where DeviceID='%1' get InterfaceType").arg(diskPath);
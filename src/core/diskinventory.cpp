@@ -0,0 +1,349 @@
+#include "diskinventory.h"
+#include "devicedatacache.h"
+#include "sysfsdiskenumerator.h"
+#include "volumeresolver.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QtConcurrent>
+
+#ifdef Q_OS_LINUX
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+// 插入硬盘时内核会连续发出硬盘和各个分区的事件，等一小段时间后一起处理
+const int kCoalesceDelayMs = 200;
+#ifdef Q_OS_LINUX
+// 内核广播uevent的多播组，udev重新广播的消息在组2，格式不同
+const unsigned int kKernelEventGroup = 1;
+const int kReceiveBufferSize = 1024 * 1024;
+// 单条uevent最大约2KB(UEVENT_BUFFER_SIZE)
+const int kMessageBufferSize = 8192;
+#endif
+}
+
+DiskInventory::DiskInventory(QObject *parent) : QObject(parent),
+    m_started(false),
+    m_socket(-1),
+    m_notifier(nullptr),
+    m_pendingFull(false),
+    m_scanRunning(false)
+{
+    m_coalesceTimer = new QTimer(this);
+    m_coalesceTimer->setSingleShot(true);
+    m_coalesceTimer->setInterval(kCoalesceDelayMs);
+    connect(m_coalesceTimer, &QTimer::timeout, this, &DiskInventory::processPending);
+}
+
+DiskInventory::~DiskInventory()
+{
+#ifdef Q_OS_LINUX
+    if (m_socket >= 0) {
+        ::close(m_socket);
+    }
+#endif
+}
+
+DiskInventory *DiskInventory::instance()
+{
+    static DiskInventory *inventory = new DiskInventory(QCoreApplication::instance());
+    return inventory;
+}
+
+void DiskInventory::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+
+    // 挂载、卸载后硬盘的卷列表变化，重新比较一次
+    connect(VolumeResolver::instance(), &VolumeResolver::mountsChanged, this, &DiskInventory::refresh);
+
+    // 先开始监听再枚举，枚举期间发生的插拔不会漏掉
+    openUeventSocket();
+    m_disks = DiskUtils::getAllDisks();
+    qDebug() << "硬盘清单初始化完成，磁盘数量:" << m_disks.size()
+             << (isMonitoring() ? "，已监听热插拔事件" : "，不支持热插拔通知");
+}
+
+QList<DiskInfo> DiskInventory::disks() const
+{
+    return m_disks;
+}
+
+bool DiskInventory::contains(const QString &diskPath) const
+{
+    return indexOf(diskPath) >= 0;
+}
+
+bool DiskInventory::isMonitoring() const
+{
+    return m_socket >= 0;
+}
+
+void DiskInventory::refresh()
+{
+    // 没有热插拔通知的平台上卷与硬盘的关系也可能已经变化
+    VolumeResolver::instance()->invalidate();
+    m_pendingFull = true;
+    processPending();
+}
+
+bool DiskInventory::openUeventSocket()
+{
+#ifdef Q_OS_LINUX
+    int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        qDebug() << "无法创建uevent套接字:" << strerror(errno);
+        return false;
+    }
+
+    // 带很多分区的硬盘插入时事件较多，放大接收缓冲区，失败时使用默认值
+    int bufferSize = kReceiveBufferSize;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = kKernelEventGroup;
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        qDebug() << "无法绑定uevent套接字:" << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    m_socket = fd;
+    m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    // activated在Qt 5.15中有两个带私有参数的重载，只能用字符串形式连接
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(onUeventReadable()));
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DiskInventory::onUeventReadable()
+{
+#ifdef Q_OS_LINUX
+    char buffer[kMessageBufferSize];
+    for (;;) {
+        sockaddr_nl sender;
+        socklen_t senderLength = sizeof(sender);
+        const ssize_t length = ::recvfrom(m_socket, buffer, sizeof(buffer), 0,
+                                          reinterpret_cast<sockaddr *>(&sender), &senderLength);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                // 接收缓冲区溢出，丢失了事件，只能全量比较一次
+                qDebug() << "uevent缓冲区溢出，重新枚举硬盘";
+                refresh();
+                continue;
+            }
+            break;      // EAGAIN：已读完
+        }
+        // 只接受内核发出的消息，忽略其他进程发到这个组的伪造消息
+        if (sender.nl_pid != 0) {
+            continue;
+        }
+        handleUevent(QByteArray(buffer, static_cast<int>(length)));
+    }
+#endif
+}
+
+void DiskInventory::handleUevent(const QByteArray &message)
+{
+    // 内核消息格式："add@/devices/...\0ACTION=add\0DEVPATH=...\0SUBSYSTEM=block\0DEVTYPE=disk\0..."
+    const QList<QByteArray> fields = message.split('\0');
+    if (fields.isEmpty() || !fields.first().contains('@')) {
+        return;
+    }
+
+    QHash<QByteArray, QByteArray> properties;
+    for (int i = 1; i < fields.size(); i++) {
+        const int separator = fields[i].indexOf('=');
+        if (separator > 0) {
+            properties.insert(fields[i].left(separator), fields[i].mid(separator + 1));
+        }
+    }
+    if (properties.value("SUBSYSTEM") != "block") {
+        return;
+    }
+    // 包括dm、md在内的任何块设备变化都可能改变卷与硬盘的对应关系
+    VolumeResolver::instance()->invalidate();
+
+    // 回环、dm等虚拟设备不在清单中，它们的change事件很频繁；DEVPATH是/sys下的设备路径
+    const QString devicePath = QString::fromLatin1(properties.value("DEVPATH"));
+    if (devicePath.isEmpty() || SysfsDiskEnumerator::isVirtualDevicePath(devicePath)) {
+        return;
+    }
+
+    // 分区的变化会影响所属硬盘的分区和卷列表，DEVPATH形如.../block/sda/sda1
+    const QByteArray deviceType = properties.value("DEVTYPE");
+    QString diskName;
+    if (deviceType == "disk") {
+        diskName = devicePath.section('/', -1);
+    } else if (deviceType == "partition") {
+        diskName = devicePath.section('/', -2, -2);
+    } else {
+        return;
+    }
+
+    qDebug() << "---热插拔调试---" << properties.value("ACTION") << deviceType << devicePath.section('/', -1);
+    scheduleDisk(diskName);
+}
+
+void DiskInventory::scheduleDisk(const QString &name)
+{
+    m_pendingNames.insert(name);
+    // 不重新计时，持续的事件流也不会无限推迟处理
+    if (!m_coalesceTimer->isActive()) {
+        m_coalesceTimer->start();
+    }
+}
+
+void DiskInventory::processPending()
+{
+    // 同一时间只进行一次读取，完成后再处理期间积累的事件
+    if (m_scanRunning || (m_pendingNames.isEmpty() && !m_pendingFull)) {
+        return;
+    }
+
+    const bool full = m_pendingFull;
+    const QStringList names = full ? QStringList() : m_pendingNames.values();
+    m_pendingFull = false;
+    m_pendingNames.clear();
+    m_scanRunning = true;
+
+    QFutureWatcher<ScanResult> *watcher = new QFutureWatcher<ScanResult>(this);
+    connect(watcher, &QFutureWatcher<ScanResult>::finished, this, [this, watcher]() {
+        m_scanRunning = false;
+        applyScan(watcher->result());
+        watcher->deleteLater();
+        processPending();
+    });
+    watcher->setFuture(QtConcurrent::run(&DiskInventory::scanDisks, names, full));
+}
+
+DiskInventory::ScanResult DiskInventory::scanDisks(const QStringList &names, bool full)
+{
+    ScanResult result;
+    result.full = full;
+    if (full) {
+        result.disks = DiskUtils::getAllDisks();
+        return result;
+    }
+
+    for (const QString &name : names) {
+        DiskInfo disk;
+        if (DiskUtils::readSysfsDisk(name, disk)) {
+            result.disks.append(disk);
+        } else {
+            result.missing.append("/dev/" + name);
+        }
+    }
+    return result;
+}
+
+void DiskInventory::applyScan(const ScanResult &result)
+{
+    if (result.full) {
+        QStringList removed;
+        for (const DiskInfo &disk : m_disks) {
+            bool found = false;
+            for (const DiskInfo &scanned : result.disks) {
+                if (scanned.diskPath == disk.diskPath) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                removed.append(disk.diskPath);
+            }
+        }
+        for (const QString &diskPath : removed) {
+            removeDisk(diskPath);
+        }
+    }
+
+    for (const DiskInfo &disk : result.disks) {
+        updateDisk(disk);
+    }
+    for (const QString &diskPath : result.missing) {
+        removeDisk(diskPath);
+    }
+}
+
+void DiskInventory::updateDisk(const DiskInfo &disk)
+{
+    DiskInfo updated = disk;
+    const int position = indexOf(disk.diskPath);
+    if (position >= 0) {
+        // 已有的硬盘保持原来的序号，界面中的选择不受影响
+        updated.index = m_disks[position].index;
+        if (sameDisk(m_disks[position], updated)) {
+            return;
+        }
+        m_disks[position] = updated;
+        qDebug() << "硬盘信息变化:" << updated.diskPath << updated.model;
+        emit diskChanged(updated);
+        return;
+    }
+
+    // 新硬盘使用未被占用的序号
+    int maxIndex = -1;
+    bool indexUsed = false;
+    for (const DiskInfo &existing : m_disks) {
+        maxIndex = qMax(maxIndex, existing.index);
+        indexUsed = indexUsed || existing.index == updated.index;
+    }
+    if (updated.index < 0 || indexUsed) {
+        updated.index = maxIndex + 1;
+    }
+
+    m_disks.append(updated);
+    // 设备名可能被之前拔出的硬盘用过，不能沿用缓存的SMART数据
+    DeviceDataCache::instance()->invalidate(updated.diskPath);
+    qDebug() << "硬盘已接入:" << updated.diskPath << updated.model;
+    emit diskAdded(updated);
+}
+
+void DiskInventory::removeDisk(const QString &diskPath)
+{
+    const int position = indexOf(diskPath);
+    if (position < 0) {
+        return;
+    }
+    const DiskInfo removed = m_disks.takeAt(position);
+    DeviceDataCache::instance()->invalidate(diskPath);
+    qDebug() << "硬盘已移除:" << removed.diskPath << removed.model;
+    emit diskRemoved(removed);
+}
+
+int DiskInventory::indexOf(const QString &diskPath) const
+{
+    for (int i = 0; i < m_disks.size(); i++) {
+        if (m_disks[i].diskPath == diskPath) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool DiskInventory::sameDisk(const DiskInfo &a, const DiskInfo &b)
+{
+    return a.diskName == b.diskName && a.model == b.model && a.serialNumber == b.serialNumber
+        && a.firmwareVersion == b.firmwareVersion && a.type == b.type && a.interfaceSpeed == b.interfaceSpeed
+        && a.diskSize == b.diskSize && a.sectorSize == b.sectorSize
+        && a.volumes == b.volumes && a.mainVolume == b.mainVolume;
+}
@@ -0,0 +1,87 @@
+#ifndef DISKINVENTORY_H
+#define DISKINVENTORY_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "diskutils.h"
+
+class QSocketNotifier;
+class QTimer;
+
+// 进程内共享的硬盘清单
+// 启动时枚举一次，之后只按变化增量更新，并以diskAdded/diskRemoved/diskChanged信号通知界面：
+// - Linux上监听内核uevent(NETLINK_KOBJECT_UEVENT)，硬盘插拔、分区表变化后只重新读取相关的那块硬盘
+// - 短时间内的多个事件合并处理，读取在工作线程中进行
+// - 其他平台或无法创建netlink套接字时没有热插拔通知，由调用者定时调用refresh()全量比较
+// 只能在主线程使用。
+class DiskInventory : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DiskInventory *instance();
+
+    // 同步枚举一次硬盘并开始监听热插拔事件，重复调用无效果
+    void start();
+
+    // 当前的硬盘列表
+    QList<DiskInfo> disks() const;
+    bool contains(const QString &diskPath) const;
+
+    // 是否能收到热插拔通知，为false时需要定时refresh()
+    bool isMonitoring() const;
+
+    // 在后台重新枚举全部硬盘，与当前列表比较后发出变化信号
+    void refresh();
+
+signals:
+    void diskAdded(const DiskInfo &disk);
+    void diskRemoved(const DiskInfo &disk);
+    void diskChanged(const DiskInfo &disk);
+
+private slots:
+    void onUeventReadable();
+    void processPending();
+
+private:
+    explicit DiskInventory(QObject *parent = nullptr);
+    ~DiskInventory();
+
+    // 一次后台读取的结果
+    struct ScanResult {
+        bool full;                  // 全量枚举，不在disks中的硬盘都已移除
+        QList<DiskInfo> disks;      // 读取到的硬盘
+        QStringList missing;        // 增量读取时已经不存在的设备路径
+
+        ScanResult() : full(false) {}
+    };
+
+    bool openUeventSocket();
+    void handleUevent(const QByteArray &message);
+    void scheduleDisk(const QString &name);
+    void applyScan(const ScanResult &result);
+    void updateDisk(const DiskInfo &disk);
+    void removeDisk(const QString &diskPath);
+    int indexOf(const QString &diskPath) const;
+
+    static ScanResult scanDisks(const QStringList &names, bool full);
+    static bool sameDisk(const DiskInfo &a, const DiskInfo &b);
+
+    QList<DiskInfo> m_disks;
+    bool m_started;
+
+    int m_socket;                       // netlink套接字，-1表示没有
+    QSocketNotifier *m_notifier;
+
+    // 等待处理的事件：硬盘设备名或全量刷新
+    QSet<QString> m_pendingNames;
+    bool m_pendingFull;
+    bool m_scanRunning;
+    QTimer *m_coalesceTimer;
+};
+
+#endif // DISKINVENTORY_H
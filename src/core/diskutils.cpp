@@ -1,4 +1,7 @@
 #include "diskutils.h"
+#include "atapassthrough.h"
+#include "sysfsdiskenumerator.h"
+#include "volumeresolver.h"
 #include <QDebug>
 #include <QDir>
 #include <QStorageInfo>
@@ -16,9 +19,24 @@
 #include <algorithm>
 #include <cmath>
 
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 // 获取所有磁盘信息 - 返回物理硬盘
 QList<DiskInfo> DiskUtils::getAllDisks()
 {
+    // Linux上直接读取sysfs，不启动wmic/PowerShell
+    if (SysfsDiskEnumerator::isSupported()) {
+        QList<DiskInfo> sysfsDisks = getSysfsDisks();
+        if (!sysfsDisks.isEmpty()) {
+            return sysfsDisks;
+        }
+        qDebug() << "sysfs中没有物理磁盘";
+    }
+    
     // 尝试获取物理硬盘信息
     QList<DiskInfo> physicalDisks = getPhysicalDisks();
     
@@ -42,6 +60,50 @@ QList<DiskInfo> DiskUtils::getAllDisks()
     return physicalDisks;
 }
 
+// 从sysfs获取物理磁盘，按分区设备关联已挂载的卷
+QList<DiskInfo> DiskUtils::getSysfsDisks()
+{
+    QList<SysfsDiskInfo> sysfsDisks = SysfsDiskEnumerator().enumerate();
+    QList<DiskInfo> disks;
+    for (int i = 0; i < sysfsDisks.size(); i++) {
+        disks.append(SysfsDiskEnumerator::toDiskInfo(sysfsDisks[i], i));
+    }
+    attachMountedVolumes(disks);
+    return disks;
+}
+
+// 从sysfs读取单块硬盘，热插拔时只更新变化的那块
+bool DiskUtils::readSysfsDisk(const QString& name, DiskInfo& disk)
+{
+    SysfsDiskInfo sysfsDisk;
+    if (!SysfsDiskEnumerator::isSupported() || !SysfsDiskEnumerator().readDisk(name, sysfsDisk)) {
+        return false;
+    }
+    
+    QList<DiskInfo> disks;
+    disks.append(SysfsDiskEnumerator::toDiskInfo(sysfsDisk, -1));
+    attachMountedVolumes(disks);
+    disk = disks.first();
+    return true;
+}
+
+void DiskUtils::attachMountedVolumes(QList<DiskInfo>& disks)
+{
+    // 经分区、LVM、加密卷、RAID挂载的卷都能对应到底层硬盘
+    VolumeResolver *resolver = VolumeResolver::instance();
+    for (int i = 0; i < disks.size(); i++) {
+        DiskInfo &disk = disks[i];
+        for (const MountedVolume &volume : resolver->volumesOnDisk(disk.diskPath)) {
+            disk.volumes.append(volume.rootPath);
+            // 优先把根分区作为主分区
+            if (disk.mainVolume.isEmpty() || volume.rootPath == "/") {
+                disk.mainVolume = volume.rootPath;
+                disk.volumePath = volume.rootPath;
+            }
+        }
+    }
+}
+
 // 获取所有分区信息
 QList<VolumeInfo> DiskUtils::getVolumes()
 {
@@ -133,10 +195,36 @@ DiskInfo DiskUtils::getDiskInfo(const QString& diskPath)
     return DiskInfo();
 }
 
-// 获取卷的使用情况
+// 获取卷的使用情况，传入硬盘路径时汇总硬盘上所有已挂载的卷
 DiskUsage DiskUtils::getDiskUsage(const QString& volumePath)
 {
     DiskUsage usage;
+    const QList<MountedVolume> diskVolumes = VolumeResolver::instance()->volumesOnDisk(volumePath);
+    if (!diskVolumes.isEmpty()) {
+        // 同一文件系统的绑定挂载、btrfs子卷只计算一次
+        QStringList countedDevices;
+        for (const MountedVolume &volume : diskVolumes) {
+            if (countedDevices.contains(volume.blockDevice)) {
+                continue;
+            }
+            countedDevices.append(volume.blockDevice);
+            QStorageInfo storage(volume.rootPath);
+            if (storage.isValid() && storage.isReady()) {
+                usage.totalSpace += storage.bytesTotal();
+                usage.freeSpace += storage.bytesAvailable();
+            }
+        }
+        usage.usedSpace = usage.totalSpace - usage.freeSpace;
+        if (usage.totalSpace > 0) {
+            usage.usedPercent = (double)usage.usedSpace / usage.totalSpace * 100.0;
+        }
+        return usage;
+    }
+    // 没有挂载任何卷的硬盘，不能按/dev所在的文件系统计算
+    if (volumePath.startsWith("/dev/") || volumePath.startsWith("\\\\.\\PhysicalDrive")) {
+        return usage;
+    }
+    
     QStorageInfo storage(volumePath);
     
     if (storage.isValid() && storage.isReady()) {
@@ -168,6 +256,24 @@ void DiskUtils::associateVolumesToDisks(QList<DiskInfo>& disks, const QList<Volu
         disks[i].volumePath.clear();
     }
     
+    // 优先使用卷的磁盘区段得到的精确关系
+    bool resolved = false;
+    VolumeResolver *resolver = VolumeResolver::instance();
+    for (int i = 0; i < disks.size(); i++) {
+        for (const MountedVolume &volume : resolver->volumesOnDisk(disks[i].diskPath)) {
+            const QString drive = volume.rootPath.left(2);
+            disks[i].volumes.append(drive);
+            if (disks[i].mainVolume.isEmpty() || drive.startsWith("C:", Qt::CaseInsensitive)) {
+                disks[i].mainVolume = drive;
+                disks[i].volumePath = volume.rootPath;
+            }
+            resolved = true;
+        }
+    }
+    if (resolved) {
+        return;
+    }
+    
     // 如果使用WMI获取到了硬盘，但是具体分区关系不明确
     // 我们使用更合理的启发式方法来关联分区与物理磁盘
     
@@ -536,26 +642,40 @@ QStringList DiskUtils::parseCSVLine(const QString& line)
 int DiskUtils::getDiskTemperature(const QString& diskPath)
 {
     // 检查是否是物理磁盘路径
-    bool isPhysicalDisk = diskPath.startsWith("\\\\.\\PhysicalDrive");
+    bool isPhysicalDisk = diskPath.startsWith("\\\\.\\PhysicalDrive") || diskPath.startsWith("/dev/");
     
     // 如果是分区路径，先找到对应的物理磁盘
     QString physicalDiskPath = diskPath;
     if (!isPhysicalDisk) {
-        QList<DiskInfo> allDisks = getAllDisks();
-        for (const DiskInfo& disk : allDisks) {
-            if (disk.volumes.contains(diskPath.left(2)) || disk.volumePath == diskPath) {
-                physicalDiskPath = disk.diskPath;
-                break;
-            }
+        const QString resolvedDisk = VolumeResolver::instance()->diskForVolume(diskPath);
+        if (!resolvedDisk.isEmpty()) {
+            physicalDiskPath = resolvedDisk;
         }
     }
     
-    qDebug() << "尝试获取磁盘温度:" << physicalDiskPath;
+    QString devicePath = smartDevicePath(physicalDiskPath);
+    qDebug() << "尝试获取磁盘温度:" << physicalDiskPath << "设备:" << devicePath;
+    
+    // 优先通过ATA直通读取温度属性，不需要启动smartctl进程
+    SgIoAtaTransport transport;
+    QString errorMessage;
+    if (SgIoAtaTransport::isSupported() && transport.open(devicePath, errorMessage)) {
+        QList<SmartAttribute> attributes;
+        if (AtaSmartReader(&transport).readAttributes(attributes, errorMessage)) {
+            for (const SmartAttribute &attr : attributes) {
+                if (attr.id == 194 || attr.id == 190) {
+                    qDebug() << "通过ATA直通获取到磁盘温度:" << attr.raw << "°C";
+                    return static_cast<int>(attr.raw);
+                }
+            }
+        } else {
+            qDebug() << "ATA直通读取SMART属性失败，改用smartctl:" << errorMessage;
+        }
+    }
     
-    // 直接使用smartctl获取SMART信息中的温度数据
+    // 使用smartctl获取SMART信息中的温度数据
     QProcess smartProcess;
-    QString command = QString("smartctl -A -d ata /dev/sda");
-    smartProcess.start("smartctl", QStringList() << "-A" << "-d" << "ata" << "/dev/sda");
+    smartProcess.start("smartctl", QStringList() << "-A" << "-d" << "ata" << devicePath);
     
     if (smartProcess.waitForFinished(3000)) {
         QString output = QString::fromLocal8Bit(smartProcess.readAllStandardOutput());
@@ -627,6 +747,26 @@ int DiskUtils::getDiskTemperature(const QString& diskPath)
     return finalTemp;
 }
 
+// 转换为SMART工具使用的设备路径
+QString DiskUtils::smartDevicePath(const QString& diskPath)
+{
+    QRegularExpression driveNumRe("PhysicalDrive(\\d+)", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch match = driveNumRe.match(diskPath);
+    if (!match.hasMatch()) {
+        // 已经是设备路径（如/dev/sdb）时原样使用
+        return diskPath;
+    }
+    
+    // 与内核命名一致：sda..sdz之后是sdaa..sdaz
+    int driveIndex = match.captured(1).toInt();
+    QString letters;
+    do {
+        letters.prepend(QChar('a' + driveIndex % 26));
+        driveIndex = driveIndex / 26 - 1;
+    } while (driveIndex >= 0);
+    return QString("/dev/sd%1").arg(letters);
+}
+
 // 运行磁盘速度测试
 SpeedTestResult DiskUtils::runSpeedTest(const QString& diskPath, int blockSize, int fileSize)
 {
@@ -635,16 +775,13 @@ SpeedTestResult DiskUtils::runSpeedTest(const QString& diskPath, int blockSize,
     // 获取测试目标路径
     // 如果是物理磁盘路径，找到其关联的卷用于测试
     QString testPath = diskPath;
-    bool isPhysicalDisk = diskPath.startsWith("\\\\.\\PhysicalDrive");
+    bool isPhysicalDisk = diskPath.startsWith("\\\\.\\PhysicalDrive") || diskPath.startsWith("/dev/");
     
     if (isPhysicalDisk) {
         // 查找物理磁盘关联的卷
-        QList<DiskInfo> allDisks = getAllDisks();
-        for (const DiskInfo& disk : allDisks) {
-            if (disk.diskPath == diskPath && !disk.volumePath.isEmpty()) {
-                testPath = disk.volumePath;
-                break;
-            }
+        const QList<MountedVolume> volumes = VolumeResolver::instance()->volumesOnDisk(diskPath);
+        if (!volumes.isEmpty()) {
+            testPath = volumes.first().rootPath;
         }
     }
     
@@ -681,7 +818,16 @@ SpeedTestResult DiskUtils::runSpeedTest(const QString& diskPath, int blockSize,
             bytesWritten += written;
         }
         
+        // flush()只是把Qt的缓冲交给系统，数据还在系统缓存里，落盘后才停止计时
         testFile.flush();
+#ifdef Q_OS_WIN
+        bool synced = ::_commit(testFile.handle()) == 0;
+#else
+        bool synced = ::fsync(testFile.handle()) == 0;
+#endif
+        if (!synced) {
+            qDebug() << "写入测试同步到磁盘失败：" << testPath;
+        }
         double elapsedSecs = timer.elapsed() / 1000.0;
         if (elapsedSecs > 0 && bytesWritten > 0) {
             result.writeSpeed = (bytesWritten / 1024.0 / 1024.0) / elapsedSecs;
@@ -69,6 +69,9 @@ public:
     // 获取所有物理磁盘信息
     static QList<DiskInfo> getAllDisks();
     
+    // 从sysfs读取一块硬盘及其已挂载的卷（Linux），name可以是sda或/dev/sda，硬盘不存在时返回false
+    static bool readSysfsDisk(const QString& name, DiskInfo& disk);
+    
     // 获取所有分区信息
     static QList<VolumeInfo> getVolumes();
     
@@ -81,7 +84,10 @@ public:
     // 获取磁盘温度(摄氏度)
     static int getDiskTemperature(const QString& diskPath);
     
-    // 运行磁盘速度测试
+    // 转换为smartctl和SG_IO使用的设备路径，\\.\PhysicalDriveN映射为/dev/sd{a,b,...}
+    static QString smartDevicePath(const QString& diskPath);
+    
+    // 运行磁盘速度测试，写入速度包含结束时fsync落盘的时间
     static SpeedTestResult runSpeedTest(const QString& diskPath, int blockSize, int fileSize);
     
     // 获取卷信息
@@ -103,6 +109,12 @@ private:
     // 获取物理磁盘信息
     static QList<DiskInfo> getPhysicalDisks();
     
+    // 通过sysfs获取物理磁盘信息（Linux）
+    static QList<DiskInfo> getSysfsDisks();
+    
+    // 按卷索引把已挂载的卷关联到硬盘
+    static void attachMountedVolumes(QList<DiskInfo>& disks);
+    
     // 关联物理磁盘和逻辑分区
     static void associateVolumesToDisks(QList<DiskInfo>& disks, const QList<VolumeInfo>& volumes);
     
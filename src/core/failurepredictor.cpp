@@ -0,0 +1,377 @@
+#include "failurepredictor.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kSecondsPerDay = 86400.0;
+// 近期变化率的时间常数，一次跳变的影响约一周后衰减到1/e
+const double kEwmaDays = 7.0;
+// 至少3个样本、跨越1天才外推，刚开始记录时的斜率没有意义
+const quint64 kMinSamples = 3;
+const double kMinSpanDays = 1.0;
+// 启动时载入的历史范围，与每日汇总的保留时间一致
+const int kHistoryDays = 365;
+// 预测在这个范围内才提醒，斜率很小时外推出的多年后的结果没有参考意义
+const double kAttentionDays = 90.0;
+
+struct TrackedMetric {
+    quint16 metric;
+    const char *name;
+    double warningLevel;
+    double failureLevel;
+};
+
+// 计数类指标出现即需要关注，极限值为经验值
+const TrackedMetric kTrackedMetrics[] = {
+    {5, "重映射扇区", 1, 100},
+    {197, "待映射扇区", 1, 50},
+    {198, "无法校正扇区", 1, 50},
+    {SmartHistoryStore::WearMetric, "已用寿命(%)", 90, 100}
+};
+
+const TrackedMetric *findMetric(quint16 metric)
+{
+    for (const TrackedMetric &tracked : kTrackedMetrics) {
+        if (tracked.metric == metric) {
+            return &tracked;
+        }
+    }
+    return nullptr;
+}
+
+double projectDays(double current, double level, double rate)
+{
+    if (current >= level) {
+        return 0;
+    }
+    if (rate <= 0) {
+        return -1;
+    }
+    return (level - current) / rate;
+}
+
+QString formatDays(double days)
+{
+    if (days < 1) {
+        return "不足1天";
+    }
+    if (days > 3650) {
+        return "超过10年";
+    }
+    return QString("约%1天").arg(qRound(days));
+}
+
+QJsonValue optionalDays(double days)
+{
+    return days < 0 ? QJsonValue() : QJsonValue(days);
+}
+}
+
+void TrendStatistics::add(double time, double value)
+{
+    if (count == 0) {
+        originTime = time;
+    } else if (time <= lastTime) {
+        return;
+    } else {
+        // 按实际间隔计算权重，采样不均匀时一次跳变对速率的影响仍约为 变化量/时间常数
+        const double elapsedDays = (time - lastTime) / kSecondsPerDay;
+        const double rate = (value - lastValue) / elapsedDays;
+        const double alpha = 1.0 - std::exp(-elapsedDays / kEwmaDays);
+        ewmaRate += alpha * (rate - ewmaRate);
+    }
+
+    // Welford式的增量均值和协方差
+    const double t = (time - originTime) / kSecondsPerDay;
+    count++;
+    const double deltaTime = t - meanTime;
+    meanTime += deltaTime / count;
+    meanValue += (value - meanValue) / count;
+    timeM2 += deltaTime * (t - meanTime);
+    coMoment += deltaTime * (value - meanValue);
+    lastTime = time;
+    lastValue = value;
+}
+
+double TrendStatistics::slope() const
+{
+    return timeM2 > 0 ? coMoment / timeM2 : 0;
+}
+
+double TrendStatistics::spanDays() const
+{
+    return (lastTime - originTime) / kSecondsPerDay;
+}
+
+FailurePredictor::FailurePredictor(QObject *parent) : QObject(parent),
+    m_started(false),
+    m_loading(false)
+{
+}
+
+FailurePredictor *FailurePredictor::instance()
+{
+    static FailurePredictor *predictor = new FailurePredictor(QCoreApplication::instance());
+    return predictor;
+}
+
+void FailurePredictor::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+
+    SmartHistoryStore *store = SmartHistoryStore::instance();
+    connect(store, &SmartHistoryStore::samplesRecorded, this, &FailurePredictor::onSamplesRecorded);
+
+    // 历史文件在后台读取，期间到达的样本先暂存
+    m_loading = true;
+    QFutureWatcher<StatisticsMap> *watcher = new QFutureWatcher<StatisticsMap>(this);
+    connect(watcher, &QFutureWatcher<StatisticsMap>::finished, this, [this, watcher]() {
+        applyHistory(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&FailurePredictor::loadHistory, store->disks()));
+}
+
+FailurePredictor::StatisticsMap FailurePredictor::loadHistory(const QStringList &disks)
+{
+    StatisticsMap statistics;
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    const QDateTime from = now.addDays(-kHistoryDays);
+    for (const QString &diskKey : disks) {
+        for (const TrackedMetric &tracked : kTrackedMetrics) {
+            const QVector<HistoryPoint> points = SmartHistoryStore::instance()->query(diskKey, tracked.metric, from, now);
+            for (const HistoryPoint &point : points) {
+                addSample(statistics, diskKey,
+                          HistorySample(static_cast<quint32>(point.timestamp), tracked.metric, point.average));
+            }
+        }
+    }
+    return statistics;
+}
+
+bool FailurePredictor::addSample(StatisticsMap &statistics, const QString &diskKey, const HistorySample &sample)
+{
+    if (!findMetric(sample.metric)) {
+        return false;
+    }
+    statistics[diskKey][sample.metric].add(sample.timestamp, sample.value);
+    return true;
+}
+
+void FailurePredictor::applyHistory(const StatisticsMap &statistics)
+{
+    m_statistics = statistics;
+    m_loading = false;
+
+    // 已经写入历史文件的样本时间不晚于载入的最后一个样本，不会重复计入
+    for (const auto &pending : m_pendingSamples) {
+        for (const HistorySample &sample : pending.second) {
+            addSample(m_statistics, pending.first, sample);
+        }
+    }
+    m_pendingSamples.clear();
+
+    qDebug() << "故障预测已载入历史，硬盘数量:" << m_statistics.size();
+    for (auto it = m_statistics.constBegin(); it != m_statistics.constEnd(); ++it) {
+        emit predictionUpdated(it.key());
+    }
+}
+
+void FailurePredictor::onSamplesRecorded(const QString &diskKey, const QList<HistorySample> &samples)
+{
+    if (m_loading) {
+        m_pendingSamples.append(qMakePair(diskKey, samples));
+        return;
+    }
+
+    bool changed = false;
+    for (const HistorySample &sample : samples) {
+        changed = addSample(m_statistics, diskKey, sample) || changed;
+    }
+    if (changed) {
+        emit predictionUpdated(diskKey);
+    }
+}
+
+FailurePrediction FailurePredictor::prediction(const QString &diskKey) const
+{
+    FailurePrediction result;
+    result.diskKey = diskKey;
+    auto disk = m_statistics.constFind(diskKey);
+    if (disk == m_statistics.constEnd()) {
+        return result;
+    }
+
+    double lastTime = 0;
+    for (const TrackedMetric &tracked : kTrackedMetrics) {
+        auto it = disk->constFind(tracked.metric);
+        if (it == disk->constEnd() || it->count == 0) {
+            continue;
+        }
+        const TrendStatistics &statistics = it.value();
+
+        MetricPrediction metric;
+        metric.metric = tracked.metric;
+        metric.name = tracked.name;
+        metric.current = statistics.lastValue;
+        metric.warningLevel = tracked.warningLevel;
+        metric.failureLevel = tracked.failureLevel;
+        metric.slopePerDay = statistics.slope();
+        metric.ewmaPerDay = statistics.ewmaRate;
+        metric.samples = statistics.count;
+        metric.spanDays = statistics.spanDays();
+
+        // 样本不足时只判断是否已经达到，否则按长期和近期趋势中较快的一个外推
+        const bool enough = statistics.count >= kMinSamples && metric.spanDays >= kMinSpanDays;
+        const double rate = enough ? qMax(metric.slopePerDay, metric.ewmaPerDay) : 0;
+        metric.daysToWarning = projectDays(metric.current, metric.warningLevel, rate);
+        metric.daysToFailure = projectDays(metric.current, metric.failureLevel, rate);
+        result.metrics.append(metric);
+        lastTime = qMax(lastTime, statistics.lastTime);
+
+        if (metric.daysToWarning >= 0 && (result.daysToThreshold < 0 || metric.daysToWarning < result.daysToThreshold)) {
+            result.daysToThreshold = metric.daysToWarning;
+            result.thresholdMetric = metric.name;
+        }
+        if (metric.daysToFailure >= 0 && (result.daysToEndOfLife < 0 || metric.daysToFailure < result.daysToEndOfLife)) {
+            result.daysToEndOfLife = metric.daysToFailure;
+            result.endOfLifeMetric = metric.name;
+        }
+    }
+
+    if (lastTime > 0) {
+        result.lastSample = QDateTime::fromSecsSinceEpoch(static_cast<qint64>(lastTime), Qt::UTC);
+    }
+    return result;
+}
+
+QList<FailurePrediction> FailurePredictor::predictions() const
+{
+    QStringList disks = m_statistics.keys();
+    std::sort(disks.begin(), disks.end());
+
+    QList<FailurePrediction> result;
+    for (const QString &diskKey : disks) {
+        result.append(prediction(diskKey));
+    }
+    return result;
+}
+
+QString FailurePredictor::describe(const FailurePrediction &prediction)
+{
+    if (!prediction.isValid()) {
+        return "暂无历史记录";
+    }
+    if (prediction.daysToThreshold < 0 && prediction.daysToEndOfLife < 0) {
+        return "各项指标无上升趋势";
+    }
+
+    QStringList parts;
+    if (prediction.daysToThreshold == 0) {
+        parts << QString("%1已达到警戒值").arg(prediction.thresholdMetric);
+    } else if (prediction.daysToThreshold > 0) {
+        parts << QString("%1%2后达到警戒值").arg(prediction.thresholdMetric, formatDays(prediction.daysToThreshold));
+    }
+    if (prediction.daysToEndOfLife == 0) {
+        parts << QString("%1已达到寿命极限").arg(prediction.endOfLifeMetric);
+    } else if (prediction.daysToEndOfLife > 0) {
+        parts << QString("预计%1后寿命耗尽（%2）").arg(formatDays(prediction.daysToEndOfLife), prediction.endOfLifeMetric);
+    }
+    return parts.join("，");
+}
+
+bool FailurePredictor::needsAttention(const FailurePrediction &prediction)
+{
+    return (prediction.daysToThreshold >= 0 && prediction.daysToThreshold < kAttentionDays)
+           || (prediction.daysToEndOfLife >= 0 && prediction.daysToEndOfLife < kAttentionDays);
+}
+
+QJsonObject FailurePredictor::toJson(const FailurePrediction &prediction)
+{
+    QJsonObject object;
+    object["disk"] = prediction.diskKey;
+    object["lastSample"] = prediction.lastSample.isValid() ? QJsonValue(prediction.lastSample.toString(Qt::ISODate))
+                                                           : QJsonValue();
+    object["daysToThreshold"] = optionalDays(prediction.daysToThreshold);
+    object["thresholdMetric"] = prediction.thresholdMetric;
+    object["daysToEndOfLife"] = optionalDays(prediction.daysToEndOfLife);
+    object["endOfLifeMetric"] = prediction.endOfLifeMetric;
+    object["summary"] = describe(prediction);
+
+    QJsonArray metrics;
+    for (const MetricPrediction &metric : prediction.metrics) {
+        QJsonObject item;
+        item["id"] = static_cast<int>(metric.metric);
+        item["name"] = metric.name;
+        item["current"] = metric.current;
+        item["warningLevel"] = metric.warningLevel;
+        item["failureLevel"] = metric.failureLevel;
+        item["slopePerDay"] = metric.slopePerDay;
+        item["ewmaPerDay"] = metric.ewmaPerDay;
+        item["samples"] = static_cast<double>(metric.samples);
+        item["spanDays"] = metric.spanDays;
+        item["daysToWarning"] = optionalDays(metric.daysToWarning);
+        item["daysToFailure"] = optionalDays(metric.daysToFailure);
+        metrics.append(item);
+    }
+    object["metrics"] = metrics;
+    return object;
+}
+
+bool FailurePredictor::exportJson(const QString &filePath, QString &errorMessage) const
+{
+    QJsonArray disks;
+    for (const FailurePrediction &prediction : predictions()) {
+        disks.append(toJson(prediction));
+    }
+    QJsonObject report;
+    report["generated"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["disks"] = disks;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = QString("无法打开文件进行写入: %1").arg(filePath);
+        return false;
+    }
+    file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        errorMessage = QString("保存故障预测失败: %1").arg(file.errorString());
+        return false;
+    }
+    return true;
+}
+
+int FailurePredictor::healthScore(const QList<SmartAttribute> &attributes, DiskType type, int baseHealth)
+{
+    int score = baseHealth;
+    for (const SmartAttribute &attr : attributes) {
+        if (attr.raw <= 0) {
+            continue;
+        }
+        // NVMe的已用寿命直接限制健康度上限
+        if (attr.id == 177) {
+            if (type == DiskType::NVMe) {
+                score = qMin(score, 100 - static_cast<int>(qMin<long long>(attr.raw, 100)));
+            }
+            continue;
+        }
+        const TrackedMetric *tracked = findMetric(static_cast<quint16>(attr.id));
+        if (!tracked) {
+            continue;
+        }
+        // 出现即扣分，接近极限值时扣满
+        const double fraction = qMin(1.0, attr.raw / tracked->failureLevel);
+        score -= 10 + qRound(30 * fraction);
+    }
+    return qBound(0, score, 100);
+}
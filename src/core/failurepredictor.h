@@ -0,0 +1,120 @@
+#ifndef FAILUREPREDICTOR_H
+#define FAILUREPREDICTOR_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+#include "smartdata.h"
+#include "smarthistorystore.h"
+
+// 一个指标的增量统计，每个样本O(1)更新，不保留样本
+// 同时维护对时间的线性回归（长期趋势）和变化率的指数加权平均（近期趋势）
+struct TrendStatistics {
+    quint64 count;
+    double originTime;      // 第一个样本的时间(秒)，回归使用相对天数，避免精度损失
+    double meanTime;        // 天
+    double meanValue;
+    double timeM2;          // Σ(t - 平均t)²
+    double coMoment;        // Σ(t - 平均t)(v - 平均v)
+    double lastTime;        // 秒
+    double lastValue;
+    double ewmaRate;        // 每天的变化量
+
+    TrendStatistics() : count(0), originTime(0), meanTime(0), meanValue(0), timeM2(0), coMoment(0),
+                        lastTime(0), lastValue(0), ewmaRate(0) {}
+
+    // 时间不晚于上一个样本的样本被忽略，载入历史和实时样本重叠时不会重复计入
+    void add(double time, double value);
+    double slope() const;           // 回归斜率，每天的变化量
+    double spanDays() const;
+};
+
+// 单个指标的预测
+struct MetricPrediction {
+    quint16 metric;
+    QString name;
+    double current;
+    double warningLevel;    // 达到后需要关注
+    double failureLevel;    // 达到后视为寿命耗尽
+    double slopePerDay;
+    double ewmaPerDay;
+    quint64 samples;
+    double spanDays;
+    double daysToWarning;   // -1表示没有上升趋势或样本不足
+    double daysToFailure;
+
+    MetricPrediction() : metric(0), current(0), warningLevel(0), failureLevel(0), slopePerDay(0), ewmaPerDay(0),
+                         samples(0), spanDays(0), daysToWarning(-1), daysToFailure(-1) {}
+};
+
+// 一块硬盘的预测，取各指标中最早的
+struct FailurePrediction {
+    QString diskKey;
+    QDateTime lastSample;
+    QList<MetricPrediction> metrics;
+    double daysToThreshold;     // 最早有指标达到警戒值，-1表示无法预测
+    double daysToEndOfLife;     // 最早有指标达到寿命极限
+    QString thresholdMetric;    // 决定上面两个值的指标名称
+    QString endOfLifeMetric;
+
+    FailurePrediction() : daysToThreshold(-1), daysToEndOfLife(-1) {}
+    bool isValid() const { return !metrics.isEmpty(); }
+};
+
+// 基于SMART历史的故障预测
+// 跟踪重映射扇区(5)、待映射扇区(197，NVMe为媒体错误)、无法校正扇区(198)和NVMe已用寿命，
+// 启动时从历史库载入一次，之后每个新样本只更新增量统计。
+// 预测按回归斜率和近期变化率中较大的一个外推，两者都不上升时不做预测。
+class FailurePredictor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static FailurePredictor *instance();
+
+    // 载入历史并开始跟踪SmartHistoryStore记录的新样本
+    void start();
+
+    FailurePrediction prediction(const QString &diskKey) const;
+    QList<FailurePrediction> predictions() const;
+
+    // 仪表盘上的一行说明
+    static QString describe(const FailurePrediction &prediction);
+    // 已达到警戒值，或预计90天内达到警戒值/寿命极限
+    static bool needsAttention(const FailurePrediction &prediction);
+
+    // 导出接口
+    static QJsonObject toJson(const FailurePrediction &prediction);
+    bool exportJson(const QString &filePath, QString &errorMessage) const;
+
+    // 根据当前属性值计算的健康度，baseHealth为SMART自检结论对应的上限
+    static int healthScore(const QList<SmartAttribute> &attributes, DiskType type, int baseHealth);
+
+signals:
+    void predictionUpdated(const QString &diskKey);
+
+private slots:
+    void onSamplesRecorded(const QString &diskKey, const QList<HistorySample> &samples);
+
+private:
+    explicit FailurePredictor(QObject *parent = nullptr);
+
+    typedef QHash<QString, QHash<quint16, TrendStatistics>> StatisticsMap;
+
+    static StatisticsMap loadHistory(const QStringList &disks);
+    static bool addSample(StatisticsMap &statistics, const QString &diskKey, const HistorySample &sample);
+    void applyHistory(const StatisticsMap &statistics);
+
+    StatisticsMap m_statistics;
+    bool m_started;
+    bool m_loading;
+    QList<QPair<QString, QList<HistorySample>>> m_pendingSamples;   // 载入历史期间到达的样本
+};
+
+#endif // FAILUREPREDICTOR_H
@@ -1,4 +1,7 @@
 #include "nvmedata.h"
+#include "nvmepassthrough.h"
+#include "diskutils.h"
+#include "smartctljsonparser.h"
 #include <QDebug>
 #include <QProcess>
 #include <QRegularExpression>
@@ -16,7 +19,8 @@ NVMeData::NVMeData(QObject *parent) : SmartData(parent),
     m_controllerBusyTime(0),
     m_unsafeShutdowns(0),
     m_mediaErrors(0),
-    m_errorLogEntries(0)
+    m_errorLogEntries(0),
+    m_nvmeTransport(nullptr)
 {
     m_diskType = DiskType::NVMe;
     m_temperatures.clear();
@@ -26,6 +30,11 @@ NVMeData::~NVMeData()
 {
 }
 
+void NVMeData::setNvmeTransport(NvmeTransport *transport)
+{
+    m_nvmeTransport = transport;
+}
+
 bool NVMeData::detectDiskType(const QString &diskPath)
 {
     qDebug() << "---NVMe类调试---覆盖实现的detectDiskType被调用，路径:" << diskPath;
@@ -37,34 +46,22 @@ bool NVMeData::detectDiskType(const QString &diskPath)
 
 bool NVMeData::loadSmartData(const QString &diskPath)
 {
-    QProcess smartctlProcess;
-    
     // Windows和Linux下不同的设备路径映射方式
-    QString deviceMapping;
-    if (diskPath.contains("PhysicalDrive")) {
-        // 将Windows物理设备路径映射为smartctl兼容格式
-        QRegularExpression driveNumRe("PhysicalDrive(\\d+)", QRegularExpression::CaseInsensitiveOption);
-        QRegularExpressionMatch match = driveNumRe.match(diskPath);
-        if (match.hasMatch()) {
-            int driveIndex = match.captured(1).toInt();
-            // 在Windows下，使用/dev/sd{a,b,c,...}格式，NVMe通常从b开始
-            char driveLetter = 'b' + driveIndex - 1; // -1是因为NVMe通常是第二个设备
-            deviceMapping = QString("/dev/sd%1").arg(driveLetter);
-            qDebug() << "---NVMe命令调试---将Windows设备路径映射为:" << deviceMapping;
-        } else {
-            deviceMapping = "/dev/sdb"; // 默认
-            qDebug() << "---NVMe命令调试---无法解析驱动器索引，使用默认映射:" << deviceMapping;
-        }
-    } else {
-        deviceMapping = diskPath; // 使用原始路径
+    QString deviceMapping = DiskUtils::smartDevicePath(diskPath);
+    qDebug() << "---NVMe命令调试---实际磁盘路径:" << diskPath << "映射为:" << deviceMapping;
+    
+    // 优先直接发送NVMe管理命令，省去启动smartctl进程的开销
+    if (loadNativeSmartData(deviceMapping)) {
+        return true;
     }
     
-    // 构建smartctl参数
+    QProcess smartctlProcess;
+    
+    // 构建smartctl参数，-j输出JSON，省去逐行正则匹配
     QStringList args;
-    args << "-a" << "-d" << "nvme" << "/dev/sdb";
+    args << "-x" << "-j" << "-d" << "nvme" << deviceMapping;
 
     qDebug() << "执行命令(NVMe):" << "smartctl" << args.join(" ");
-    qDebug() << "---NVMe命令调试---实际磁盘路径:" << diskPath << "映射为:" << deviceMapping;
     
     // 启动进程并等待完成
     smartctlProcess.start("smartctl", args);
@@ -77,6 +74,22 @@ bool NVMeData::loadSmartData(const QString &diskPath)
         return false;
     }
     
+    // 解析smartctl输出，JSON直接在原始字节上解析
+    QByteArray output = smartctlProcess.readAllStandardOutput();
+    
+    // 7.0之前的smartctl不认识-j，输出的是参数错误提示，改用原来的-a参数重新读取文本报告
+    if (!SmartctlJsonParser::looksLikeJson(output)) {
+        QStringList legacyArgs;
+        legacyArgs << "-a" << "-d" << "nvme" << deviceMapping;
+        qDebug() << "---NVMe命令调试---smartctl未输出JSON，改用旧版参数:" << legacyArgs.join(" ");
+        smartctlProcess.start("smartctl", legacyArgs);
+        if (!smartctlProcess.waitForFinished(5000)) {
+            qDebug() << "---NVMe命令调试---命令执行超时(5秒)";
+            return false;
+        }
+        output = smartctlProcess.readAllStandardOutput();
+    }
+    
     // 检查退出状态，特殊处理非零值但可能含有有用信息的情况
     int exitCode = smartctlProcess.exitCode();
     qDebug() << "---NVMe命令调试---命令退出码:" << exitCode;
@@ -100,9 +113,6 @@ bool NVMeData::loadSmartData(const QString &diskPath)
         qDebug() << "---NVMe命令调试---退出码为1或2，继续尝试解析输出";
     }
     
-    // 解析smartctl输出
-    QString output = QString::fromLocal8Bit(smartctlProcess.readAllStandardOutput());
-    
     if (output.isEmpty()) {
         qDebug() << "未获取到NVMe设备SMART数据输出";
         qDebug() << "---NVMe命令调试---命令标准输出为空";
@@ -110,10 +120,89 @@ bool NVMeData::loadSmartData(const QString &diskPath)
     }
     
     qDebug() << "NVMe设备smartctl输出长度:" << output.length();
-    qDebug() << "---NVMe命令调试---命令标准输出的前200个字符:" << output.left(200);
+    qDebug() << "---NVMe命令调试---命令标准输出的前200个字符:" << QString::fromLocal8Bit(output.left(200));
+    
+    // 解析NVMe设备输出，旧版smartctl按-a的文本报告解析
+    if (SmartctlJsonParser::looksLikeJson(output)) {
+        return parseNVMeJson(output);
+    }
+    return parseNVMeOutput(QString::fromLocal8Bit(output));
+}
+
+bool NVMeData::parseNVMeJson(const QByteArray &output)
+{
+    SmartctlNvmeReport report;
+    QString errorMessage;
+    if (!SmartctlJsonParser::parseNvme(output, report, errorMessage)) {
+        qDebug() << "---NVMe解析调试---JSON解析失败:" << errorMessage;
+        return false;
+    }
+    qDebug() << "---NVMe解析调试---设备:" << report.model << "序列号:" << report.serialNumber << "固件:" << report.firmware;
+    
+    m_attributes.clear();
+    m_warnings.clear();
+    // 没有smart_status时与文本解析一样按关键警告判断
+    bool passed = report.hasStatus ? report.passed : report.log.criticalWarning == 0;
+    applySmartLog(report.log, passed, report.hasSpare, report.hasPercentageUsed);
+    
+    qDebug() << "成功解析" << m_attributes.size() << "个NVMe设备属性(JSON)";
+    return !m_attributes.isEmpty();
+}
+
+bool NVMeData::loadNativeSmartData(const QString &devicePath)
+{
+    IoctlNvmeTransport deviceTransport;
+    NvmeTransport *transport = m_nvmeTransport;
+    QString errorMessage;
+    if (!transport) {
+        if (!IoctlNvmeTransport::isSupported()) {
+            return false;
+        }
+        if (!deviceTransport.open(devicePath, errorMessage)) {
+            qDebug() << "---NVMe直读调试---无法打开设备，改用smartctl:" << errorMessage;
+            return false;
+        }
+        transport = &deviceTransport;
+    }
+    
+    NvmeHealthReader reader(transport);
+    NvmeControllerInfo controllerInfo;
+    if (!reader.identifyController(controllerInfo, errorMessage)) {
+        qDebug() << "---NVMe直读调试---Identify Controller失败，改用smartctl:" << errorMessage;
+        return false;
+    }
+    qDebug() << "---NVMe直读调试---控制器:" << controllerInfo.model << "序列号:" << controllerInfo.serialNumber
+             << "固件:" << controllerInfo.firmware;
+    
+    NvmeSmartLog log;
+    if (!reader.readSmartLog(log, errorMessage)) {
+        qDebug() << "---NVMe直读调试---读取SMART/Health日志失败，改用smartctl:" << errorMessage;
+        return false;
+    }
+    
+    m_attributes.clear();
+    m_warnings.clear();
+    applySmartLog(log, log.criticalWarning == 0);
+    
+    // 错误日志只在控制器记录过错误时读取，内容用于提示最近一次错误
+    if (log.errorLogEntries > 0 && controllerInfo.errorLogPageEntries > 0) {
+        QList<NvmeErrorLogEntry> entries;
+        if (reader.readErrorLog(controllerInfo.errorLogPageEntries, entries, errorMessage)) {
+            if (!entries.isEmpty()) {
+                const NvmeErrorLogEntry &latest = entries.first();
+                m_warnings.append(QString("注意: NVMe错误日志共 %1 条，最近一次状态码 0x%2 (队列 %3，LBA %4)")
+                                      .arg(log.errorLogEntries)
+                                      .arg(latest.statusField, 0, 16)
+                                      .arg(latest.submissionQueueId)
+                                      .arg(latest.lba));
+            }
+        } else {
+            qDebug() << "---NVMe直读调试---读取错误信息日志失败:" << errorMessage;
+        }
+    }
     
-    // 解析NVMe设备输出
-    return parseNVMeOutput(output);
+    qDebug() << "通过NVMe管理命令读取到" << m_attributes.size() << "个NVMe设备属性";
+    return !m_attributes.isEmpty();
 }
 
 bool NVMeData::parseNVMeOutput(const QString &output)
@@ -124,457 +213,225 @@ bool NVMeData::parseNVMeOutput(const QString &output)
     // 清除之前的数据
     m_attributes.clear();
     m_warnings.clear();
-    m_temperatures.clear();
     
-    // 查找SMART整体健康状态
-    QRegularExpression healthRe("SMART overall-health self-assessment test result: (\\w+)");
+    // 正则表达式只编译一次，重复轮询时不再重新构建
+    static const QRegularExpression healthRe("SMART overall-health self-assessment test result: (\\w+)");
+    static const QRegularExpression criticalWarningRe("Critical Warning:\\s+0x([0-9a-fA-F]+)");
+    static const QRegularExpression tempRe("^\\s*Temperature:\\s+(\\d+) Celsius", QRegularExpression::MultilineOption);
+    static const QRegularExpression sensorTempRe("Temperature Sensor (\\d+):\\s+(\\d+) Celsius");
+    static const QRegularExpression spareRe("Available Spare:\\s+(\\d+)%");
+    static const QRegularExpression threshRe("Available Spare Threshold:\\s+(\\d+)%");
+    static const QRegularExpression percentRe("Percentage Used:\\s+(\\d+)%");
+    static const QRegularExpression unitsReadRe("Data Units Read:\\s+([0-9,]+)");
+    static const QRegularExpression unitsWrittenRe("Data Units Written:\\s+([0-9,]+)");
+    static const QRegularExpression hostReadRe("Host Read Commands:\\s+([0-9,]+)");
+    static const QRegularExpression hostWriteRe("Host Write Commands:\\s+([0-9,]+)");
+    static const QRegularExpression busyRe("Controller Busy Time:\\s+([0-9,]+)");
+    static const QRegularExpression cyclesRe("Power Cycles:\\s+([0-9,]+)");
+    static const QRegularExpression hoursRe("Power On Hours:\\s+([0-9,]+)");
+    static const QRegularExpression unsafeRe("Unsafe Shutdowns:\\s+([0-9,]+)");
+    static const QRegularExpression mediaErrorRe("Media and Data Integrity Errors:\\s+([0-9,]+)");
+    static const QRegularExpression errorEntriesRe("Error Information Log Entries:\\s+([0-9,]+)");
+    
+    // 读取带千位分隔符的计数，found记录是否找到
+    auto counter = [&output](const QRegularExpression &re, bool *found = nullptr) -> quint64 {
+        QRegularExpressionMatch match = re.match(output);
+        if (found) {
+            *found = match.hasMatch();
+        }
+        return match.hasMatch() ? match.captured(1).remove(',').toULongLong() : 0;
+    };
+    
+    // 把文本输出转换为与日志页相同的结构，之后和直接读取走同一套逻辑
+    NvmeSmartLog log;
+    bool hasSpare = false;
+    bool hasPercentageUsed = false;
+    log.temperature = static_cast<int>(counter(tempRe));
+    log.availableSpare = static_cast<int>(counter(spareRe, &hasSpare));
+    log.availableSpareThreshold = static_cast<int>(counter(threshRe));
+    log.percentageUsed = static_cast<int>(counter(percentRe, &hasPercentageUsed));
+    log.dataUnitsRead = counter(unitsReadRe);
+    log.dataUnitsWritten = counter(unitsWrittenRe);
+    log.hostReadCommands = counter(hostReadRe);
+    log.hostWriteCommands = counter(hostWriteRe);
+    log.controllerBusyTime = counter(busyRe);
+    log.powerCycles = counter(cyclesRe);
+    log.powerOnHours = counter(hoursRe);
+    log.unsafeShutdowns = counter(unsafeRe);
+    log.mediaErrors = counter(mediaErrorRe);
+    log.errorLogEntries = counter(errorEntriesRe);
+    
+    QRegularExpressionMatchIterator sensors = sensorTempRe.globalMatch(output);
+    while (sensors.hasNext()) {
+        QRegularExpressionMatch match = sensors.next();
+        log.temperatureSensors[match.captured(1).toInt()] = match.captured(2).toInt();
+    }
+    
+    // 整体健康状态，NVMe设备可能没有明确的PASSED/FAILED，此时检查关键警告
+    bool passed = true;
     QRegularExpressionMatch healthMatch = healthRe.match(output);
     if (healthMatch.hasMatch()) {
-        QString healthStatus = healthMatch.captured(1);
-        qDebug() << "---NVMe解析调试---找到健康状态:" << healthStatus;
-        if (healthStatus.contains("PASSED", Qt::CaseInsensitive)) {
-            m_overallHealth = 90 + QRandomGenerator::global()->bounded(11); // 90-100
-            qDebug() << "SMART自测通过，健康度设置为:" << m_overallHealth;
-        } else {
-            m_overallHealth = 10 + QRandomGenerator::global()->bounded(50); // 10-59
-            m_warnings.append("警告: SMART自检失败！建议立即备份数据");
-            qDebug() << "SMART自测失败，健康度设置为:" << m_overallHealth;
-        }
+        qDebug() << "---NVMe解析调试---找到健康状态:" << healthMatch.captured(1);
+        passed = healthMatch.captured(1).contains("PASSED", Qt::CaseInsensitive);
     } else {
-        qDebug() << "---NVMe解析调试---未找到SMART健康状态，检查关键警告";
-        // NVMe设备可能没有明确的PASSED/FAILED，检查关键警告
-        QRegularExpression criticalWarningRe("Critical Warning:\\s+0x([0-9a-fA-F]+)");
         QRegularExpressionMatch criticalMatch = criticalWarningRe.match(output);
         if (criticalMatch.hasMatch()) {
-            QString warningValue = criticalMatch.captured(1);
-            qDebug() << "---NVMe解析调试---找到关键警告值:" << warningValue;
-            if (warningValue == "00") {
-                m_overallHealth = 90 + QRandomGenerator::global()->bounded(11); // 90-100
-                qDebug() << "NVMe无关键警告，健康度设置为:" << m_overallHealth;
-            } else {
-                m_overallHealth = 10 + QRandomGenerator::global()->bounded(50); // 10-59
-                m_warnings.append("警告: NVMe设备报告关键警告！建议立即备份数据");
-                qDebug() << "NVMe有关键警告，健康度设置为:" << m_overallHealth;
-            }
+            log.criticalWarning = criticalMatch.captured(1).toInt(nullptr, 16);
+            qDebug() << "---NVMe解析调试---找到关键警告值:" << criticalMatch.captured(1);
         } else {
-            qDebug() << "---NVMe解析调试---未找到关键警告信息";
+            qDebug() << "---NVMe解析调试---未找到健康状态和关键警告信息";
         }
+        passed = log.criticalWarning == 0;
     }
     
-    // 收集NVMe特定属性
-    QVector<SmartAttribute> attributes;
+    // 文本中缺少备用空间和寿命字段时不生成对应属性
+    applySmartLog(log, passed, hasSpare, hasPercentageUsed);
     
-    // 使用QStringList对输出进行分割
-    QStringList lines = output.split('\n');
-    qDebug() << "---NVMe解析调试---输出分割为" << lines.size() << "行";
-    
-    // 输出前20行内容以便调试
-    int lineCount = qMin(20, lines.size());
-    for (int i = 0; i < lineCount; i++) {
-        qDebug() << "---NVMe解析调试---行" << i << ":" << lines[i];
+    if (!m_attributes.isEmpty()) {
+        qDebug() << "成功收集" << m_attributes.size() << "个NVMe设备属性";
+        return true;
+    } else {
+        qDebug() << "未收集到任何NVMe设备属性";
+        qDebug() << "---NVMe解析调试---属性列表为空";
+        return false;
+    }
+}
+
+void NVMeData::applySmartLog(const NvmeSmartLog &log, bool passed, bool hasSpare, bool hasPercentageUsed)
+{
+    // 整体健康度
+    if (passed) {
+        m_overallHealth = 100; // 最终健康度在读取属性后按已用寿命和媒体错误扣减
+        qDebug() << "NVMe健康检查通过，健康度设置为:" << m_overallHealth;
+    } else {
+        m_overallHealth = 50;
+        m_warnings.append("警告: NVMe设备报告关键警告！建议立即备份数据");
+        qDebug() << "NVMe健康检查未通过，健康度设置为:" << m_overallHealth;
     }
     
-    // 解析SMART/Health信息部分
-    bool inSmartHealthSection = false;
+    m_availableSpare = log.availableSpare;
+    m_availableSpareThreshold = log.availableSpareThreshold;
+    m_percentageUsed = log.percentageUsed;
+    m_dataUnitsRead = static_cast<long long>(log.dataUnitsRead);
+    m_dataUnitsWritten = static_cast<long long>(log.dataUnitsWritten);
+    m_hostReadCommands = static_cast<long long>(log.hostReadCommands);
+    m_hostWriteCommands = static_cast<long long>(log.hostWriteCommands);
+    m_controllerBusyTime = static_cast<long long>(log.controllerBusyTime);
+    m_unsafeShutdowns = static_cast<long long>(log.unsafeShutdowns);
+    m_mediaErrors = static_cast<long long>(log.mediaErrors);
+    m_errorLogEntries = static_cast<long long>(log.errorLogEntries);
+    m_powerOnHours = static_cast<int>(log.powerOnHours);
+    m_powerCycleCount = static_cast<int>(log.powerCycles);
+    m_temperature = log.temperature;
+    m_temperatures.clear();
     
-    for (int i = 0; i < lines.size(); i++) {
-        QString line = lines[i].trimmed();
-        
-        if (line.contains("SMART/Health Information")) {
-            inSmartHealthSection = true;
-            qDebug() << "---NVMe解析调试---在行" << i << "找到SMART/Health信息段";
-            continue;
-        }
-        
-        if (inSmartHealthSection) {
-            if (line.isEmpty() || line.startsWith("===")) {
-                inSmartHealthSection = false;
-                qDebug() << "---NVMe解析调试---在行" << i << "结束SMART/Health信息段";
-                continue;
-            }
-            
-            qDebug() << "---NVMe解析调试---处理SMART/Health信息行:" << line;
-            
-            // 温度
-            QRegularExpression tempRe("Temperature:\\s+(\\d+) Celsius");
-            QRegularExpressionMatch tempMatch = tempRe.match(line);
-            if (tempMatch.hasMatch()) {
-                m_temperature = tempMatch.captured(1).toInt();
-                m_temperatures.append(m_temperature);
-                qDebug() << "---NVMe解析调试---找到温度:" << m_temperature << "°C";
-                
-                // 添加温度属性
-                SmartAttribute tempAttr;
-                tempAttr.id = 194; // 与SATA兼容
-                tempAttr.name = "Temperature";
-                tempAttr.current = 100;
-                tempAttr.worst = 100;
-                tempAttr.threshold = 0;
-                tempAttr.raw = m_temperature;
-                tempAttr.description = QString("%1 °C").arg(m_temperature);
-                
-                if (m_temperature > 70) {
-                    tempAttr.status = "危险";
-                    m_warnings.append(QString("警告: NVMe温度过高 (%1°C)").arg(m_temperature));
-                } else if (m_temperature > 60) {
-                    tempAttr.status = "警告";
-                    m_warnings.append(QString("警告: NVMe温度偏高 (%1°C)").arg(m_temperature));
-                } else {
-                    tempAttr.status = "正常";
-                }
-                
-                attributes.append(tempAttr);
-                qDebug() << "---NVMe解析调试---添加温度属性:" << tempAttr.id << tempAttr.name << tempAttr.status;
-                continue;
-            }
-            
-            // 温度传感器
-            QRegularExpression sensorTempRe("Temperature Sensor (\\d+):\\s+(\\d+) Celsius");
-            QRegularExpressionMatch sensorTempMatch = sensorTempRe.match(line);
-            if (sensorTempMatch.hasMatch()) {
-                int sensorNum = sensorTempMatch.captured(1).toInt();
-                int sensorTemp = sensorTempMatch.captured(2).toInt();
-                m_temperatures.append(sensorTemp);
-                qDebug() << "---NVMe解析调试---找到温度传感器" << sensorNum << ":" << sensorTemp << "°C";
-                
-                // 添加温度传感器属性
-                SmartAttribute sensorTempAttr;
-                sensorTempAttr.id = 194 + sensorNum; // 使用194+传感器编号
-                sensorTempAttr.name = QString("Temperature_Sensor_%1").arg(sensorNum);
-                sensorTempAttr.current = 100;
-                sensorTempAttr.worst = 100;
-                sensorTempAttr.threshold = 0;
-                sensorTempAttr.raw = sensorTemp;
-                sensorTempAttr.description = QString("传感器 %1: %2 °C").arg(sensorNum).arg(sensorTemp);
-                
-                if (sensorTemp > 70) {
-                    sensorTempAttr.status = "危险";
-                } else if (sensorTemp > 60) {
-                    sensorTempAttr.status = "警告";
-                } else {
-                    sensorTempAttr.status = "正常";
-                }
-                
-                attributes.append(sensorTempAttr);
-                qDebug() << "---NVMe解析调试---添加温度传感器属性:" << sensorTempAttr.id << sensorTempAttr.name << sensorTempAttr.status;
-                continue;
-            }
+    QList<SmartAttribute> attributes;
+    auto makeAttribute = [](int id, const QString &name, long long raw, const QString &description) {
+        SmartAttribute attr;
+        attr.id = id;
+        attr.name = name;
+        attr.current = 100;
+        attr.worst = 100;
+        attr.threshold = 0;
+        attr.raw = raw;
+        attr.status = "正常";
+        attr.description = description;
+        return attr;
+    };
+    
+    // 温度
+    if (log.temperature > 0) {
+        m_temperatures.append(log.temperature);
+        SmartAttribute tempAttr = makeAttribute(194, "Temperature", log.temperature, QString("%1 °C").arg(log.temperature)); // 与SATA兼容
+        if (log.temperature > 70) {
+            tempAttr.status = "危险";
+            m_warnings.append(QString("警告: NVMe温度过高 (%1°C)").arg(log.temperature));
+        } else if (log.temperature > 60) {
+            tempAttr.status = "警告";
+            m_warnings.append(QString("警告: NVMe温度偏高 (%1°C)").arg(log.temperature));
         }
+        attributes.append(tempAttr);
     }
     
-    // 解析更多NVMe属性
-    qDebug() << "---NVMe解析调试---处理其他NVMe特定属性";
+    // 温度传感器
+    for (auto it = log.temperatureSensors.constBegin(); it != log.temperatureSensors.constEnd(); ++it) {
+        const int sensorNum = it.key();
+        const int sensorTemp = it.value();
+        m_temperatures.append(sensorTemp);
+        SmartAttribute sensorTempAttr = makeAttribute(194 + sensorNum, QString("Temperature_Sensor_%1").arg(sensorNum), // 使用194+传感器编号
+                                                      sensorTemp, QString("传感器 %1: %2 °C").arg(sensorNum).arg(sensorTemp));
+        if (sensorTemp > 70) {
+            sensorTempAttr.status = "危险";
+        } else if (sensorTemp > 60) {
+            sensorTempAttr.status = "警告";
+        }
+        attributes.append(sensorTempAttr);
+    }
     
     // 可用备用空间
-    QRegularExpression spareRe("Available Spare:\\s+(\\d+)%");
-    QRegularExpressionMatch spareMatch = spareRe.match(output);
-    if (spareMatch.hasMatch()) {
-        m_availableSpare = spareMatch.captured(1).toLongLong();
-        qDebug() << "---NVMe解析调试---找到可用备用空间:" << m_availableSpare << "%";
-        
-        // 添加可用备用空间属性
-        SmartAttribute spareAttr;
-        spareAttr.id = 231;
-        spareAttr.name = "Available_Spare";
-        spareAttr.current = m_availableSpare;
-        spareAttr.worst = m_availableSpare;
-        spareAttr.threshold = m_availableSpareThreshold;
-        spareAttr.raw = m_availableSpare;
-        spareAttr.description = QString("%1%").arg(m_availableSpare);
-        
-        if (m_availableSpare <= m_availableSpareThreshold) {
+    if (hasSpare) {
+        SmartAttribute spareAttr = makeAttribute(231, "Available_Spare", log.availableSpare, QString("%1%").arg(log.availableSpare));
+        spareAttr.current = log.availableSpare;
+        spareAttr.worst = log.availableSpare;
+        spareAttr.threshold = log.availableSpareThreshold;
+        if (log.availableSpare <= log.availableSpareThreshold) {
             spareAttr.status = "危险";
-            m_warnings.append(QString("警告: NVMe可用备用空间低于阈值 (%1%)").arg(m_availableSpare));
-        } else if (m_availableSpare < 20) {
+            m_warnings.append(QString("警告: NVMe可用备用空间低于阈值 (%1%)").arg(log.availableSpare));
+        } else if (log.availableSpare < 20) {
             spareAttr.status = "警告";
-            m_warnings.append(QString("警告: NVMe可用备用空间较低 (%1%)").arg(m_availableSpare));
-        } else {
-            spareAttr.status = "正常";
+            m_warnings.append(QString("警告: NVMe可用备用空间较低 (%1%)").arg(log.availableSpare));
         }
-        
         attributes.append(spareAttr);
-        qDebug() << "---NVMe解析调试---添加可用备用空间属性:" << spareAttr.id << spareAttr.name << spareAttr.status;
-    } else {
-        qDebug() << "---NVMe解析调试---未找到可用备用空间信息";
-    }
-    
-    // 可用备用空间阈值
-    QRegularExpression threshRe("Available Spare Threshold:\\s+(\\d+)%");
-    QRegularExpressionMatch threshMatch = threshRe.match(output);
-    if (threshMatch.hasMatch()) {
-        m_availableSpareThreshold = threshMatch.captured(1).toLongLong();
-        qDebug() << "---NVMe解析调试---找到可用备用空间阈值:" << m_availableSpareThreshold << "%";
-    } else {
-        qDebug() << "---NVMe解析调试---未找到可用备用空间阈值信息";
     }
     
     // 寿命百分比
-    QRegularExpression percentRe("Percentage Used:\\s+(\\d+)%");
-    QRegularExpressionMatch percentMatch = percentRe.match(output);
-    if (percentMatch.hasMatch()) {
-        m_percentageUsed = percentMatch.captured(1).toLongLong();
-        qDebug() << "---NVMe解析调试---找到寿命百分比:" << m_percentageUsed << "%";
-        
-        // 添加寿命百分比属性
-        SmartAttribute percentAttr;
-        percentAttr.id = 177; // 类似于SATA的磨损均衡计数
-        percentAttr.name = "Percentage_Used";
-        percentAttr.current = 100 - m_percentageUsed; // 转换为剩余寿命
+    if (hasPercentageUsed) {
+        SmartAttribute percentAttr = makeAttribute(177, "Percentage_Used", log.percentageUsed, // 类似于SATA的磨损均衡计数
+                                                   QString("已使用 %1%").arg(log.percentageUsed));
+        percentAttr.current = qMax(0, 100 - log.percentageUsed); // 转换为剩余寿命
         percentAttr.worst = percentAttr.current;
         percentAttr.threshold = 10; // 假设10%为阈值
-        percentAttr.raw = m_percentageUsed;
-        percentAttr.description = QString("已使用 %1%").arg(m_percentageUsed);
-        
         if (percentAttr.current <= percentAttr.threshold) {
             percentAttr.status = "危险";
             m_warnings.append("警告: NVMe设备寿命即将耗尽，请及时备份数据");
         } else if (percentAttr.current < 30) {
             percentAttr.status = "警告";
             m_warnings.append("警告: NVMe设备寿命剩余不足30%");
-        } else {
-            percentAttr.status = "正常";
         }
-        
         attributes.append(percentAttr);
-        qDebug() << "---NVMe解析调试---添加寿命百分比属性:" << percentAttr.id << percentAttr.name << percentAttr.status;
     }
     
-    // 检查是否有内存通电小时数
-    QRegularExpression hoursRe("Power On Hours:\\s+([0-9,]+)");
-    QRegularExpressionMatch hoursMatch = hoursRe.match(output);
-    if (hoursMatch.hasMatch()) {
-        QString hoursStr = hoursMatch.captured(1);
-        hoursStr.remove(','); // 移除千位分隔符
-        m_powerOnHours = hoursStr.toInt();
-        qDebug() << "---NVMe解析调试---找到通电小时数:" << m_powerOnHours;
-        
-        // 添加通电小时数属性
-        SmartAttribute hoursAttr;
-        hoursAttr.id = 9; // 与SATA兼容
-        hoursAttr.name = "Power_On_Hours";
-        hoursAttr.current = 100;
-        hoursAttr.worst = 100;
-        hoursAttr.threshold = 0;
-        hoursAttr.raw = m_powerOnHours;
-        hoursAttr.status = "正常";
-        hoursAttr.description = QString("%1 小时").arg(m_powerOnHours);
-        
-        attributes.append(hoursAttr);
-        qDebug() << "---NVMe解析调试---添加通电小时数属性:" << hoursAttr.id << hoursAttr.name << hoursAttr.status;
-    } else {
-        qDebug() << "---NVMe解析调试---未找到通电小时数信息";
-    }
+    attributes.append(makeAttribute(9, "Power_On_Hours", m_powerOnHours, QString("%1 小时").arg(m_powerOnHours)));
+    attributes.append(makeAttribute(12, "Power_Cycles", m_powerCycleCount, QString("%1 次").arg(m_powerCycleCount)));
     
-    // 通电次数
-    QRegularExpression cyclesRe("Power Cycles:\\s+([0-9,]+)");
-    QRegularExpressionMatch cyclesMatch = cyclesRe.match(output);
-    if (cyclesMatch.hasMatch()) {
-        QString cyclesStr = cyclesMatch.captured(1);
-        cyclesStr.remove(','); // 移除千位分隔符
-        m_powerCycleCount = cyclesStr.toInt();
-        
-        // 添加通电次数属性
-        SmartAttribute cyclesAttr;
-        cyclesAttr.id = 12; // 与SATA兼容
-        cyclesAttr.name = "Power_Cycles";
-        cyclesAttr.current = 100;
-        cyclesAttr.worst = 100;
-        cyclesAttr.threshold = 0;
-        cyclesAttr.raw = m_powerCycleCount;
-        cyclesAttr.status = "正常";
-        cyclesAttr.description = QString("%1 次").arg(m_powerCycleCount);
-        
-        attributes.append(cyclesAttr);
-        qDebug() << "---NVMe解析调试---添加通电次数属性:" << cyclesAttr.id << cyclesAttr.name << cyclesAttr.status;
-    }
-    
-    // 数据读取量
-    QRegularExpression readRe("Data Units Read:\\s+([0-9,]+)\\s+\\[([0-9.]+)\\s+(\\w+)\\]");
-    QRegularExpressionMatch readMatch = readRe.match(output);
-    if (readMatch.hasMatch()) {
-        QString unitsRead = readMatch.captured(1);
-        unitsRead.remove(','); // 移除千位分隔符
-        m_dataUnitsRead = unitsRead.toLongLong();
-        QString readAmount = readMatch.captured(2);
-        QString readUnit = readMatch.captured(3);
-        
-        // 添加数据读取量属性
-        SmartAttribute readAttr;
-        readAttr.id = 241; // 类似于SATA的总读取扇区数
-        readAttr.name = "Data_Units_Read";
-        readAttr.current = 100;
-        readAttr.worst = 100;
-        readAttr.threshold = 0;
-        readAttr.raw = m_dataUnitsRead;
-        readAttr.status = "正常";
-        readAttr.description = QString("%1 %2").arg(readAmount).arg(readUnit);
-        
-        attributes.append(readAttr);
-        qDebug() << "---NVMe解析调试---添加数据读取量属性:" << readAttr.id << readAttr.name << readAttr.status;
-    }
-    
-    // 数据写入量
-    QRegularExpression writeRe("Data Units Written:\\s+([0-9,]+)\\s+\\[([0-9.]+)\\s+(\\w+)\\]");
-    QRegularExpressionMatch writeMatch = writeRe.match(output);
-    if (writeMatch.hasMatch()) {
-        QString unitsWritten = writeMatch.captured(1);
-        unitsWritten.remove(','); // 移除千位分隔符
-        m_dataUnitsWritten = unitsWritten.toLongLong();
-        QString writeAmount = writeMatch.captured(2);
-        QString writeUnit = writeMatch.captured(3);
-        
-        // 添加数据写入量属性
-        SmartAttribute writeAttr;
-        writeAttr.id = 242; // 类似于SATA的总写入扇区数
-        writeAttr.name = "Data_Units_Written";
-        writeAttr.current = 100;
-        writeAttr.worst = 100;
-        writeAttr.threshold = 0;
-        writeAttr.raw = m_dataUnitsWritten;
-        writeAttr.status = "正常";
-        writeAttr.description = QString("%1 %2").arg(writeAmount).arg(writeUnit);
-        
-        attributes.append(writeAttr);
-        qDebug() << "---NVMe解析调试---添加数据写入量属性:" << writeAttr.id << writeAttr.name << writeAttr.status;
-    }
-    
-    // 主机读取命令数
-    QRegularExpression hostReadRe("Host Read Commands:\\s+([0-9,]+)");
-    QRegularExpressionMatch hostReadMatch = hostReadRe.match(output);
-    if (hostReadMatch.hasMatch()) {
-        QString hostReadStr = hostReadMatch.captured(1);
-        hostReadStr.remove(','); // 移除千位分隔符
-        m_hostReadCommands = hostReadStr.toLongLong();
-        
-        // 添加主机读取命令数属性
-        SmartAttribute hostReadAttr;
-        hostReadAttr.id = 243;
-        hostReadAttr.name = "Host_Read_Commands";
-        hostReadAttr.current = 100;
-        hostReadAttr.worst = 100;
-        hostReadAttr.threshold = 0;
-        hostReadAttr.raw = m_hostReadCommands;
-        hostReadAttr.status = "正常";
-        hostReadAttr.description = QString("%1 次").arg(m_hostReadCommands);
-        
-        attributes.append(hostReadAttr);
-        qDebug() << "---NVMe解析调试---添加主机读取命令数属性:" << hostReadAttr.id << hostReadAttr.name << hostReadAttr.status;
-    }
-    
-    // 主机写入命令数
-    QRegularExpression hostWriteRe("Host Write Commands:\\s+([0-9,]+)");
-    QRegularExpressionMatch hostWriteMatch = hostWriteRe.match(output);
-    if (hostWriteMatch.hasMatch()) {
-        QString hostWriteStr = hostWriteMatch.captured(1);
-        hostWriteStr.remove(','); // 移除千位分隔符
-        m_hostWriteCommands = hostWriteStr.toLongLong();
-        
-        // 添加主机写入命令数属性
-        SmartAttribute hostWriteAttr;
-        hostWriteAttr.id = 244;
-        hostWriteAttr.name = "Host_Write_Commands";
-        hostWriteAttr.current = 100;
-        hostWriteAttr.worst = 100;
-        hostWriteAttr.threshold = 0;
-        hostWriteAttr.raw = m_hostWriteCommands;
-        hostWriteAttr.status = "正常";
-        hostWriteAttr.description = QString("%1 次").arg(m_hostWriteCommands);
-        
-        attributes.append(hostWriteAttr);
-        qDebug() << "---NVMe解析调试---添加主机写入命令数属性:" << hostWriteAttr.id << hostWriteAttr.name << hostWriteAttr.status;
-    }
-    
-    // 控制器忙碌时间
-    QRegularExpression busyRe("Controller Busy Time:\\s+([0-9,]+)");
-    QRegularExpressionMatch busyMatch = busyRe.match(output);
-    if (busyMatch.hasMatch()) {
-        QString busyStr = busyMatch.captured(1);
-        busyStr.remove(','); // 移除千位分隔符
-        m_controllerBusyTime = busyStr.toLongLong();
-        
-        // 添加控制器忙碌时间属性
-        SmartAttribute busyAttr;
-        busyAttr.id = 245;
-        busyAttr.name = "Controller_Busy_Time";
-        busyAttr.current = 100;
-        busyAttr.worst = 100;
-        busyAttr.threshold = 0;
-        busyAttr.raw = m_controllerBusyTime;
-        busyAttr.status = "正常";
-        busyAttr.description = QString("%1 分钟").arg(m_controllerBusyTime);
-        
-        attributes.append(busyAttr);
-        qDebug() << "---NVMe解析调试---添加控制器忙碌时间属性:" << busyAttr.id << busyAttr.name << busyAttr.status;
-    }
+    // 数据读写量，每个单位为1000个512字节块
+    attributes.append(makeAttribute(241, "Data_Units_Read", m_dataUnitsRead, // 类似于SATA的总读取扇区数
+                                    DiskUtils::formatSize(m_dataUnitsRead * NvmeSmartLog::kDataUnitBytes)));
+    attributes.append(makeAttribute(242, "Data_Units_Written", m_dataUnitsWritten, // 类似于SATA的总写入扇区数
+                                    DiskUtils::formatSize(m_dataUnitsWritten * NvmeSmartLog::kDataUnitBytes)));
+    attributes.append(makeAttribute(243, "Host_Read_Commands", m_hostReadCommands, QString("%1 次").arg(m_hostReadCommands)));
+    attributes.append(makeAttribute(244, "Host_Write_Commands", m_hostWriteCommands, QString("%1 次").arg(m_hostWriteCommands)));
+    attributes.append(makeAttribute(245, "Controller_Busy_Time", m_controllerBusyTime, QString("%1 分钟").arg(m_controllerBusyTime)));
     
     // 不安全关机次数
-    QRegularExpression unsafeRe("Unsafe Shutdowns:\\s+([0-9,]+)");
-    QRegularExpressionMatch unsafeMatch = unsafeRe.match(output);
-    if (unsafeMatch.hasMatch()) {
-        QString shutdowns = unsafeMatch.captured(1);
-        shutdowns.remove(','); // 移除千位分隔符
-        m_unsafeShutdowns = shutdowns.toLongLong();
-        
-        // 添加不安全关机属性
-        SmartAttribute shutdownAttr;
-        shutdownAttr.id = 192; // 类似于SATA的突然断电计数
-        shutdownAttr.name = "Unsafe_Shutdowns";
-        shutdownAttr.current = 100;
-        shutdownAttr.worst = 100;
-        shutdownAttr.threshold = 0;
-        shutdownAttr.raw = m_unsafeShutdowns;
-        shutdownAttr.status = "正常";
-        shutdownAttr.description = QString("%1 次").arg(m_unsafeShutdowns);
-        
-        if (m_unsafeShutdowns > 10) {
-            m_warnings.append(QString("注意: NVMe设备存在较多不安全关机 (%1 次)").arg(m_unsafeShutdowns));
-        }
-        
-        attributes.append(shutdownAttr);
-        qDebug() << "---NVMe解析调试---添加不安全关机属性:" << shutdownAttr.id << shutdownAttr.name << shutdownAttr.status;
+    attributes.append(makeAttribute(192, "Unsafe_Shutdowns", m_unsafeShutdowns, QString("%1 次").arg(m_unsafeShutdowns))); // 类似于SATA的突然断电计数
+    if (m_unsafeShutdowns > 10) {
+        m_warnings.append(QString("注意: NVMe设备存在较多不安全关机 (%1 次)").arg(m_unsafeShutdowns));
     }
     
     // 媒体与数据完整性错误
-    QRegularExpression errorRe("Media and Data Integrity Errors:\\s+([0-9,]+)");
-    QRegularExpressionMatch errorMatch = errorRe.match(output);
-    if (errorMatch.hasMatch()) {
-        QString errors = errorMatch.captured(1);
-        errors.remove(','); // 移除千位分隔符
-        m_mediaErrors = errors.toLongLong();
-        
-        // 添加错误属性
-        SmartAttribute errorAttr;
-        errorAttr.id = 197; // 类似于SATA的当前挂起扇区
-        errorAttr.name = "Media_Errors";
-        errorAttr.current = (m_mediaErrors > 0) ? 0 : 100;
-        errorAttr.worst = errorAttr.current;
-        errorAttr.threshold = 0;
-        errorAttr.raw = m_mediaErrors;
-        errorAttr.description = QString("%1 次").arg(m_mediaErrors);
-        
-        if (m_mediaErrors > 0) {
-            errorAttr.status = "危险";
-            m_warnings.append(QString("警告: NVMe设备存在媒体错误 (%1 个)").arg(m_mediaErrors));
-        } else {
-            errorAttr.status = "正常";
-        }
-        
-        attributes.append(errorAttr);
-        qDebug() << "---NVMe解析调试---添加媒体错误属性:" << errorAttr.id << errorAttr.name << errorAttr.status;
+    SmartAttribute errorAttr = makeAttribute(197, "Media_Errors", m_mediaErrors, QString("%1 次").arg(m_mediaErrors)); // 类似于SATA的当前挂起扇区
+    errorAttr.current = (m_mediaErrors > 0) ? 0 : 100;
+    errorAttr.worst = errorAttr.current;
+    if (m_mediaErrors > 0) {
+        errorAttr.status = "危险";
+        m_warnings.append(QString("警告: NVMe设备存在媒体错误 (%1 个)").arg(m_mediaErrors));
     }
+    attributes.append(errorAttr);
     
-    // 一次性添加所有属性
-    if (!attributes.isEmpty()) {
-        m_attributes = attributes.toList();
-        qDebug() << "成功收集" << attributes.size() << "个NVMe设备属性";
-        for (const SmartAttribute &attr : attributes) {
-            qDebug() << "---NVMe解析调试---最终属性:" << attr.id << attr.name << attr.status << attr.description;
-        }
-        return true;
-    } else {
-        qDebug() << "未收集到任何NVMe设备属性";
-        qDebug() << "---NVMe解析调试---属性列表为空";
-        return false;
+    m_attributes = attributes;
+    for (const SmartAttribute &attr : m_attributes) {
+        qDebug() << "---NVMe解析调试---最终属性:" << attr.id << attr.name << attr.status << attr.description;
     }
 }
 
@@ -3,6 +3,9 @@
 
 #include "smartdata.h"
 
+class NvmeTransport;
+struct NvmeSmartLog;
+
 class NVMeData : public SmartData
 {
     Q_OBJECT
@@ -11,6 +14,9 @@ public:
     explicit NVMeData(QObject *parent = nullptr);
     virtual ~NVMeData();
 
+    // 指定发送管理命令的设备层（不转移所有权），用于没有真实硬盘时测试；未指定时在Linux上使用ioctl
+    void setNvmeTransport(NvmeTransport *transport);
+
 protected:
     // 检测NVMe设备类型
     virtual bool detectDiskType(const QString &diskPath) override;
@@ -18,9 +24,19 @@ protected:
     // 加载NVMe设备SMART数据
     virtual bool loadSmartData(const QString &diskPath) override;
     
-    // 解析NVMe设备输出
+    // 通过NVMe管理命令直接读取SMART/Health日志，失败时由调用方退回smartctl
+    bool loadNativeSmartData(const QString &devicePath);
+    
+    // 解析smartctl -j输出
+    bool parseNVMeJson(const QByteArray &output);
+    
+    // 解析NVMe设备输出（smartctl文本格式）
     bool parseNVMeOutput(const QString &output);
     
+    // 根据SMART/Health日志设置各项指标、属性和警告，passed为整体健康检查结果
+    // smartctl输出中可能缺少备用空间和寿命字段，此时不生成对应属性
+    void applySmartLog(const NvmeSmartLog &log, bool passed, bool hasSpare = true, bool hasPercentageUsed = true);
+    
     // 为NVMe设备创建模拟数据
     virtual void createSimulatedData() override;
     
@@ -37,6 +53,7 @@ protected:
     long long m_mediaErrors;              // 媒体错误数
     long long m_errorLogEntries;          // 错误日志条目数
     QList<int> m_temperatures;            // 多个温度传感器值
+    NvmeTransport *m_nvmeTransport;       // 外部指定的设备层，为空时自动打开设备
 };
 
 #endif // NVMEDATA_H 
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "nvmepassthrough.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/nvme_ioctl.h>
+#endif
+
+namespace {
+// 管理命令
+const quint8 kNvmeAdminGetLogPage = 0x02;
+const quint8 kNvmeAdminIdentify = 0x06;
+// Identify的CNS值
+const quint32 kIdentifyController = 0x01;
+// 日志页
+const quint8 kLogErrorInformation = 0x01;
+const quint8 kLogSmartHealth = 0x02;
+// 控制器范围的日志使用全1命名空间ID
+const quint32 kAllNamespaces = 0xFFFFFFFF;
+// 开尔文转摄氏度
+const int kKelvinOffset = 273;
+// 错误日志最多读取的条目数，控制器通常保留64-256条
+const int kMaxErrorLogEntries = 256;
+
+#ifdef Q_OS_LINUX
+const quint32 kCommandTimeoutMs = 5000;
+#endif
+
+quint64 readLe(const QByteArray &data, int offset, int bytes)
+{
+    quint64 value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | static_cast<quint8>(data[offset + i]);
+    }
+    return value;
+}
+
+// 日志页中的计数器是128位的，超过64位时按最大值处理
+quint64 readLe128(const QByteArray &data, int offset)
+{
+    if (readLe(data, offset + 8, 8) != 0) {
+        return ~0ULL;
+    }
+    return readLe(data, offset, 8);
+}
+
+QString readAscii(const QByteArray &data, int offset, int length)
+{
+    return QString::fromLatin1(data.mid(offset, length)).trimmed();
+}
+
+// 温度字段为开尔文，0表示未报告
+int kelvinToCelsius(quint64 kelvin)
+{
+    return kelvin > 0 ? static_cast<int>(kelvin) - kKelvinOffset : 0;
+}
+
+// Get Log Page的CDW10：低8位为日志ID，高16位为读取的双字数减1
+quint32 logPageCdw10(quint8 logId, int bytes)
+{
+    quint32 dwords = static_cast<quint32>(bytes / 4 - 1);
+    return logId | ((dwords & 0xFFFF) << 16);
+}
+}
+
+// ===== IoctlNvmeTransport =====
+
+IoctlNvmeTransport::IoctlNvmeTransport() : m_fd(-1)
+{
+}
+
+IoctlNvmeTransport::~IoctlNvmeTransport()
+{
+    close();
+}
+
+bool IoctlNvmeTransport::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool IoctlNvmeTransport::open(const QString &devicePath, QString &errorMessage)
+{
+    close();
+    m_devicePath = devicePath;
+#ifdef Q_OS_LINUX
+    m_fd = ::open(devicePath.toLocal8Bit().constData(), O_RDONLY);
+    if (m_fd < 0) {
+        errorMessage = QString("无法打开设备 %1: %2").arg(devicePath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    return true;
+#else
+    errorMessage = "当前平台不支持NVMe管理命令直通";
+    return false;
+#endif
+}
+
+void IoctlNvmeTransport::close()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+}
+
+bool IoctlNvmeTransport::adminCommand(quint8 opcode, quint32 namespaceId, quint32 cdw10, quint32 cdw11,
+                                      QByteArray &data, QString &errorMessage)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0) {
+        errorMessage = "设备未打开";
+        return false;
+    }
+
+    struct nvme_admin_cmd command;
+    memset(&command, 0, sizeof(command));
+    command.opcode = opcode;
+    command.nsid = namespaceId;
+    command.addr = reinterpret_cast<quint64>(data.data());
+    command.data_len = static_cast<quint32>(data.size());
+    command.cdw10 = cdw10;
+    command.cdw11 = cdw11;
+    command.timeout_ms = kCommandTimeoutMs;
+
+    int status = ioctl(m_fd, NVME_IOCTL_ADMIN_CMD, &command);
+    if (status < 0) {
+        // 块设备不是NVMe时返回ENOTTY
+        errorMessage = QString("%1: NVMe管理命令0x%2调用失败: %3")
+                           .arg(m_devicePath).arg(opcode, 2, 16, QChar('0'))
+                           .arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    if (status > 0) {
+        // 正值为NVMe完成状态（状态码类型和状态码）
+        errorMessage = QString("%1: NVMe管理命令0x%2返回状态0x%3")
+                           .arg(m_devicePath).arg(opcode, 2, 16, QChar('0')).arg(status, 0, 16);
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(opcode);
+    Q_UNUSED(namespaceId);
+    Q_UNUSED(cdw10);
+    Q_UNUSED(cdw11);
+    Q_UNUSED(data);
+    errorMessage = "当前平台不支持NVMe管理命令直通";
+    return false;
+#endif
+}
+
+// ===== RecordedNvmeTransport =====
+
+RecordedNvmeTransport::RecordedNvmeTransport(const QString &directory) : m_directory(directory)
+{
+}
+
+bool RecordedNvmeTransport::adminCommand(quint8 opcode, quint32 namespaceId, quint32 cdw10, quint32 cdw11,
+                                         QByteArray &data, QString &errorMessage)
+{
+    Q_UNUSED(namespaceId);
+    Q_UNUSED(cdw11);
+
+    QString fileName;
+    if (opcode == kNvmeAdminIdentify && (cdw10 & 0xFF) == kIdentifyController) {
+        fileName = "identify-controller.bin";
+    } else if (opcode == kNvmeAdminGetLogPage) {
+        // 与真实设备一样检查CDW10中的读取长度
+        const int requested = static_cast<int>(((cdw10 >> 16) & 0xFFFF) + 1) * 4;
+        if (requested != data.size()) {
+            errorMessage = QString("日志页读取长度%1与缓冲区大小%2不符").arg(requested).arg(data.size());
+            return false;
+        }
+        fileName = QString("log-%1.bin").arg(cdw10 & 0xFF, 2, 16, QChar('0'));
+    } else {
+        errorMessage = QString("录制数据中没有管理命令0x%1").arg(opcode, 2, 16, QChar('0'));
+        return false;
+    }
+
+    QFile file(QDir(m_directory).filePath(fileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法读取录制数据 %1: %2").arg(file.fileName(), file.errorString());
+        return false;
+    }
+    const QByteArray recorded = file.read(data.size());
+    data.fill('\0');
+    data.replace(0, recorded.size(), recorded);
+    return true;
+}
+
+// ===== NvmeHealthReader =====
+
+NvmeHealthReader::NvmeHealthReader(NvmeTransport *transport) : m_transport(transport)
+{
+}
+
+bool NvmeHealthReader::identifyController(NvmeControllerInfo &info, QString &errorMessage)
+{
+    QByteArray data(kIdentifySize, '\0');
+    if (!m_transport->adminCommand(kNvmeAdminIdentify, 0, kIdentifyController, 0, data, errorMessage)) {
+        return false;
+    }
+    return decodeIdentifyController(data, info, errorMessage);
+}
+
+bool NvmeHealthReader::readSmartLog(NvmeSmartLog &log, QString &errorMessage)
+{
+    QByteArray data(kSmartLogSize, '\0');
+    if (!m_transport->adminCommand(kNvmeAdminGetLogPage, kAllNamespaces,
+                                   logPageCdw10(kLogSmartHealth, kSmartLogSize), 0, data, errorMessage)) {
+        return false;
+    }
+    return decodeSmartLog(data, log, errorMessage);
+}
+
+bool NvmeHealthReader::readErrorLog(int maxEntries, QList<NvmeErrorLogEntry> &entries, QString &errorMessage)
+{
+    const int count = qBound(1, maxEntries, kMaxErrorLogEntries);
+    QByteArray data(count * kErrorLogEntrySize, '\0');
+    if (!m_transport->adminCommand(kNvmeAdminGetLogPage, kAllNamespaces,
+                                   logPageCdw10(kLogErrorInformation, data.size()), 0, data, errorMessage)) {
+        return false;
+    }
+    entries = decodeErrorLog(data);
+    return true;
+}
+
+bool NvmeHealthReader::decodeIdentifyController(const QByteArray &data, NvmeControllerInfo &info, QString &errorMessage)
+{
+    if (data.size() < kIdentifySize) {
+        errorMessage = QString("Identify Controller数据长度不足: %1 字节").arg(data.size());
+        return false;
+    }
+
+    info.serialNumber = readAscii(data, 4, 20);
+    info.model = readAscii(data, 24, 40);
+    info.firmware = readAscii(data, 64, 8);
+    info.errorLogPageEntries = static_cast<quint8>(data[262]) + 1;
+    info.warningTempThreshold = kelvinToCelsius(readLe(data, 266, 2));
+    info.criticalTempThreshold = kelvinToCelsius(readLe(data, 268, 2));
+
+    if (info.model.isEmpty()) {
+        errorMessage = "Identify Controller数据中没有型号信息";
+        return false;
+    }
+    return true;
+}
+
+bool NvmeHealthReader::decodeSmartLog(const QByteArray &data, NvmeSmartLog &log, QString &errorMessage)
+{
+    if (data.size() < kSmartLogSize) {
+        errorMessage = QString("SMART/Health日志页长度不足: %1 字节").arg(data.size());
+        return false;
+    }
+
+    log.criticalWarning = static_cast<quint8>(data[0]);
+    log.temperature = kelvinToCelsius(readLe(data, 1, 2));
+    log.availableSpare = static_cast<quint8>(data[3]);
+    log.availableSpareThreshold = static_cast<quint8>(data[4]);
+    log.percentageUsed = static_cast<quint8>(data[5]);
+    log.dataUnitsRead = readLe128(data, 32);
+    log.dataUnitsWritten = readLe128(data, 48);
+    log.hostReadCommands = readLe128(data, 64);
+    log.hostWriteCommands = readLe128(data, 80);
+    log.controllerBusyTime = readLe128(data, 96);
+    log.powerCycles = readLe128(data, 112);
+    log.powerOnHours = readLe128(data, 128);
+    log.unsafeShutdowns = readLe128(data, 144);
+    log.mediaErrors = readLe128(data, 160);
+    log.errorLogEntries = readLe128(data, 176);
+    log.warningTempMinutes = static_cast<quint32>(readLe(data, 192, 4));
+    log.criticalTempMinutes = static_cast<quint32>(readLe(data, 196, 4));
+
+    log.temperatureSensors.clear();
+    for (int sensor = 0; sensor < 8; ++sensor) {
+        quint64 kelvin = readLe(data, 200 + sensor * 2, 2);
+        if (kelvin > 0) {
+            log.temperatureSensors[sensor + 1] = kelvinToCelsius(kelvin);
+        }
+    }
+
+    // 全零的日志页说明命令没有真正返回数据
+    if (log.temperature == 0 && log.powerOnHours == 0 && log.powerCycles == 0 && log.availableSpare == 0) {
+        errorMessage = "SMART/Health日志页内容为空";
+        return false;
+    }
+    return true;
+}
+
+QList<NvmeErrorLogEntry> NvmeHealthReader::decodeErrorLog(const QByteArray &data)
+{
+    QList<NvmeErrorLogEntry> entries;
+    for (int offset = 0; offset + kErrorLogEntrySize <= data.size(); offset += kErrorLogEntrySize) {
+        NvmeErrorLogEntry entry;
+        entry.errorCount = readLe(data, offset, 8);
+        if (entry.errorCount == 0) {
+            continue;
+        }
+        entry.submissionQueueId = static_cast<int>(readLe(data, offset + 8, 2));
+        entry.commandId = static_cast<int>(readLe(data, offset + 10, 2));
+        entry.statusField = static_cast<int>(readLe(data, offset + 12, 2) >> 1);
+        entry.lba = readLe(data, offset + 16, 8);
+        entry.namespaceId = static_cast<quint32>(readLe(data, offset + 24, 4));
+        entries.append(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const NvmeErrorLogEntry &a, const NvmeErrorLogEntry &b) {
+        return a.errorCount > b.errorCount;
+    });
+    return entries;
+}
@@ -0,0 +1,140 @@
+#ifndef NVMEPASSTHROUGH_H
+#define NVMEPASSTHROUGH_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QtGlobal>
+
+// 向NVMe控制器发送管理命令的底层接口
+// 真实设备使用IoctlNvmeTransport，测试时可以实现一个返回录制日志页的版本，不需要硬件
+class NvmeTransport
+{
+public:
+    virtual ~NvmeTransport() {}
+
+    // 发送带数据读取的管理命令，读取data.size()字节（调用方预先分配）
+    virtual bool adminCommand(quint8 opcode, quint32 namespaceId, quint32 cdw10, quint32 cdw11,
+                              QByteArray &data, QString &errorMessage) = 0;
+};
+
+// 通过Linux NVME_IOCTL_ADMIN_CMD发送管理命令
+// 设备可以是控制器字符设备(/dev/nvme0)或命名空间块设备(/dev/nvme0n1)，需要root权限。
+// 其他平台上open总是失败，由调用方退回smartctl。
+class IoctlNvmeTransport : public NvmeTransport
+{
+public:
+    IoctlNvmeTransport();
+    ~IoctlNvmeTransport() override;
+
+    bool open(const QString &devicePath, QString &errorMessage);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    bool adminCommand(quint8 opcode, quint32 namespaceId, quint32 cdw10, quint32 cdw11,
+                      QByteArray &data, QString &errorMessage) override;
+
+    // 当前平台是否支持NVMe管理命令直通
+    static bool isSupported();
+
+private:
+    int m_fd;
+    QString m_devicePath;
+};
+
+// 回放录制的Identify和日志页，不需要硬件即可测试NvmeHealthReader
+// 目录中identify-controller.bin为Identify Controller数据，log-XX.bin为日志页，XX为两位十六进制日志ID。
+// 录制数据比请求的长度短时其余部分补零，与控制器返回较少有效条目时一致。
+class RecordedNvmeTransport : public NvmeTransport
+{
+public:
+    explicit RecordedNvmeTransport(const QString &directory);
+
+    bool adminCommand(quint8 opcode, quint32 namespaceId, quint32 cdw10, quint32 cdw11,
+                      QByteArray &data, QString &errorMessage) override;
+
+private:
+    QString m_directory;
+};
+
+// Identify Controller中用到的字段
+struct NvmeControllerInfo {
+    QString model;
+    QString serialNumber;
+    QString firmware;
+    int errorLogPageEntries;    // 错误信息日志页的条目数(ELPE+1)
+    int warningTempThreshold;   // 温度警告阈值(°C)，0表示未报告
+    int criticalTempThreshold;  // 温度严重阈值(°C)，0表示未报告
+
+    NvmeControllerInfo() : errorLogPageEntries(0), warningTempThreshold(0), criticalTempThreshold(0) {}
+};
+
+// SMART/Health Information日志页(0x02)
+struct NvmeSmartLog {
+    int criticalWarning;            // 关键警告位图，0表示无警告
+    int temperature;                // 综合温度(°C)
+    int availableSpare;             // 可用备用空间(%)
+    int availableSpareThreshold;    // 可用备用空间阈值(%)
+    int percentageUsed;             // 已使用寿命(%)，可能超过100
+    quint64 dataUnitsRead;          // 单位为1000个512字节块
+    quint64 dataUnitsWritten;
+    quint64 hostReadCommands;
+    quint64 hostWriteCommands;
+    quint64 controllerBusyTime;     // 分钟
+    quint64 powerCycles;
+    quint64 powerOnHours;
+    quint64 unsafeShutdowns;
+    quint64 mediaErrors;
+    quint64 errorLogEntries;        // 控制器生命周期内产生的错误信息条目数
+    quint32 warningTempMinutes;     // 超过警告温度的累计时间
+    quint32 criticalTempMinutes;
+    QMap<int, int> temperatureSensors;  // 传感器编号(1-8) -> 温度(°C)，未实现的传感器不出现
+
+    NvmeSmartLog()
+        : criticalWarning(0), temperature(0), availableSpare(0), availableSpareThreshold(0), percentageUsed(0),
+          dataUnitsRead(0), dataUnitsWritten(0), hostReadCommands(0), hostWriteCommands(0), controllerBusyTime(0),
+          powerCycles(0), powerOnHours(0), unsafeShutdowns(0), mediaErrors(0), errorLogEntries(0),
+          warningTempMinutes(0), criticalTempMinutes(0) {}
+
+    // 每个数据单位的字节数
+    static const qint64 kDataUnitBytes = 512000;
+};
+
+// Error Information日志页(0x01)中的一条
+struct NvmeErrorLogEntry {
+    quint64 errorCount;         // 错误序号，0表示空条目
+    int submissionQueueId;
+    int commandId;
+    int statusField;            // 状态字段（已去掉相位标志位）
+    quint64 lba;
+    quint32 namespaceId;
+
+    NvmeErrorLogEntry() : errorCount(0), submissionQueueId(0), commandId(0), statusField(0), lba(0), namespaceId(0) {}
+};
+
+// 用NVMe管理命令直接读取和解码健康信息，不经过smartctl进程
+class NvmeHealthReader
+{
+public:
+    explicit NvmeHealthReader(NvmeTransport *transport);
+
+    bool identifyController(NvmeControllerInfo &info, QString &errorMessage);
+    bool readSmartLog(NvmeSmartLog &log, QString &errorMessage);
+    // 最多读取maxEntries条，只返回非空条目，按错误序号从新到旧排列
+    bool readErrorLog(int maxEntries, QList<NvmeErrorLogEntry> &entries, QString &errorMessage);
+
+    // 以下解码函数只依赖日志页内容，可以直接用录制的二进制数据测试
+    static bool decodeIdentifyController(const QByteArray &data, NvmeControllerInfo &info, QString &errorMessage);
+    static bool decodeSmartLog(const QByteArray &data, NvmeSmartLog &log, QString &errorMessage);
+    static QList<NvmeErrorLogEntry> decodeErrorLog(const QByteArray &data);
+
+    static const int kIdentifySize = 4096;
+    static const int kSmartLogSize = 512;
+    static const int kErrorLogEntrySize = 64;
+
+private:
+    NvmeTransport *m_transport;
+};
+
+#endif // NVMEPASSTHROUGH_H
@@ -1,11 +1,14 @@
 #include "satadata.h"
+#include "atapassthrough.h"
+#include "diskutils.h"
+#include "smartctljsonparser.h"
 #include <QDebug>
 #include <QProcess>
 #include <QRegularExpression>
 #include <QRandomGenerator>
 #include <QStringList>
 
-SATAData::SATAData(QObject *parent) : SmartData(parent)
+SATAData::SATAData(QObject *parent) : SmartData(parent), m_ataTransport(nullptr)
 {
     m_diskType = DiskType::SATA;
 }
@@ -14,6 +17,11 @@ SATAData::~SATAData()
 {
 }
 
+void SATAData::setAtaTransport(AtaTransport *transport)
+{
+    m_ataTransport = transport;
+}
+
 bool SATAData::detectDiskType(const QString &diskPath)
 {
     qDebug() << "---SATA类调试---覆盖实现的detectDiskType被调用，路径:" << diskPath;
@@ -25,34 +33,22 @@ bool SATAData::detectDiskType(const QString &diskPath)
 
 bool SATAData::loadSmartData(const QString &diskPath)
 {
-    QProcess smartctlProcess;
-    
     // Windows和Linux下不同的设备路径映射方式
-    QString deviceMapping;
-    if (diskPath.contains("PhysicalDrive")) {
-        // 将Windows物理设备路径映射为smartctl兼容格式
-        QRegularExpression driveNumRe("PhysicalDrive(\\d+)", QRegularExpression::CaseInsensitiveOption);
-        QRegularExpressionMatch match = driveNumRe.match(diskPath);
-        if (match.hasMatch()) {
-            int driveIndex = match.captured(1).toInt();
-            // 在Windows下，使用/dev/sd{a,b,c,...}格式
-            char driveLetter = 'a' + driveIndex;
-            deviceMapping = QString("/dev/sd%1").arg(driveLetter);
-            qDebug() << "---SMART命令调试---将Windows设备路径映射为:" << deviceMapping;
-        } else {
-            deviceMapping = "/dev/sda"; // 默认
-            qDebug() << "---SMART命令调试---无法解析驱动器索引，使用默认映射:" << deviceMapping;
-        }
-    } else {
-        deviceMapping = diskPath; // 使用原始路径
+    QString deviceMapping = DiskUtils::smartDevicePath(diskPath);
+    qDebug() << "---SMART命令调试---实际磁盘路径:" << diskPath << "映射为:" << deviceMapping;
+    
+    // 优先直接发送ATA命令，省去启动smartctl进程的开销
+    if (loadNativeSmartData(deviceMapping)) {
+        return true;
     }
     
-    // 构建smartctl参数
+    QProcess smartctlProcess;
+    
+    // 构建smartctl参数，-j输出JSON，省去逐行正则匹配
     QStringList args;
-    args << "-a" << "-d" << "ata" << "/dev/sda";
+    args << "-x" << "-j" << "-d" << "ata" << deviceMapping;
 
     qDebug() << "执行命令(SATA):" << "smartctl" << args.join(" ");
-    qDebug() << "---SMART命令调试---实际磁盘路径:" << diskPath << "映射为:" << deviceMapping;
     
     // 启动进程并等待完成
     smartctlProcess.start("smartctl", args);
@@ -66,8 +62,22 @@ bool SATAData::loadSmartData(const QString &diskPath)
         return false;
     }
     
-    // 解析smartctl输出
-    QString output = QString::fromLocal8Bit(smartctlProcess.readAllStandardOutput());
+    // 解析smartctl输出，JSON直接在原始字节上解析
+    QByteArray output = smartctlProcess.readAllStandardOutput();
+    
+    // 7.0之前的smartctl不认识-j，输出的是参数错误提示，改用原来的-a参数重新读取文本报告
+    if (!SmartctlJsonParser::looksLikeJson(output)) {
+        QStringList legacyArgs;
+        legacyArgs << "-a" << "-d" << "ata" << deviceMapping;
+        qDebug() << "---SMART命令调试---smartctl未输出JSON，改用旧版参数:" << legacyArgs.join(" ");
+        smartctlProcess.start("smartctl", legacyArgs);
+        if (!smartctlProcess.waitForFinished(5000)) {
+            qDebug() << "---SMART命令调试---命令执行超时(5秒)";
+            createSimulatedData();
+            return false;
+        }
+        output = smartctlProcess.readAllStandardOutput();
+    }
     
     // 检查退出状态，但我们不管退出码如何，只要有输出就尝试解析
     int exitCode = smartctlProcess.exitCode();
@@ -95,10 +105,11 @@ bool SATAData::loadSmartData(const QString &diskPath)
     }
     
     qDebug() << "SATA设备smartctl输出长度:" << output.length();
-    qDebug() << "---SMART命令调试---命令标准输出的前200个字符:" << output.left(200);
+    qDebug() << "---SMART命令调试---命令标准输出的前200个字符:" << QString::fromLocal8Bit(output.left(200));
     
-    // 解析SATA设备输出
-    bool success = parseSATAOutput(output);
+    // 解析SATA设备输出，旧版smartctl按-a的文本报告解析
+    bool success = SmartctlJsonParser::looksLikeJson(output) ? parseSATAJson(output)
+                                                             : parseSATAOutput(QString::fromLocal8Bit(output));
     
     // 如果解析失败，则使用模拟数据
     if (!success) {
@@ -110,6 +121,110 @@ bool SATAData::loadSmartData(const QString &diskPath)
     return true;
 }
 
+bool SATAData::loadNativeSmartData(const QString &devicePath)
+{
+    SgIoAtaTransport deviceTransport;
+    AtaTransport *transport = m_ataTransport;
+    QString errorMessage;
+    if (!transport) {
+        if (!SgIoAtaTransport::isSupported()) {
+            return false;
+        }
+        if (!deviceTransport.open(devicePath, errorMessage)) {
+            qDebug() << "---SMART直读调试---无法打开设备，改用smartctl:" << errorMessage;
+            return false;
+        }
+        transport = &deviceTransport;
+    }
+    
+    AtaSmartReader reader(transport);
+    AtaIdentifyInfo identifyInfo;
+    if (!reader.identify(identifyInfo, errorMessage)) {
+        qDebug() << "---SMART直读调试---IDENTIFY DEVICE失败，改用smartctl:" << errorMessage;
+        return false;
+    }
+    qDebug() << "---SMART直读调试---设备:" << identifyInfo.model << "序列号:" << identifyInfo.serialNumber
+             << "固件:" << identifyInfo.firmware << "SMART支持/启用:" << identifyInfo.smartSupported << identifyInfo.smartEnabled;
+    if (!identifyInfo.smartSupported || !identifyInfo.smartEnabled) {
+        qDebug() << "---SMART直读调试---设备未启用SMART，改用smartctl";
+        return false;
+    }
+    
+    QList<SmartAttribute> attributes;
+    if (!reader.readAttributes(attributes, errorMessage)) {
+        qDebug() << "---SMART直读调试---读取SMART属性失败，改用smartctl:" << errorMessage;
+        return false;
+    }
+    
+    bool passed = true;
+    if (reader.returnStatus(passed, errorMessage)) {
+        applyHealthStatus(passed);
+    } else {
+        qDebug() << "---SMART直读调试---读取整体健康状态失败:" << errorMessage;
+    }
+    
+    for (SmartAttribute &attr : attributes) {
+        evaluateAttribute(attr);
+    }
+    m_attributes = attributes;
+    qDebug() << "通过ATA直通读取到" << m_attributes.size() << "个SATA设备SMART属性";
+    return true;
+}
+
+bool SATAData::parseSATAJson(const QByteArray &output)
+{
+    SmartctlAtaReport report;
+    QString errorMessage;
+    if (!SmartctlJsonParser::parseAta(output, report, errorMessage)) {
+        qDebug() << "---SMART解析调试---JSON解析失败:" << errorMessage;
+        return false;
+    }
+    qDebug() << "---SMART解析调试---设备:" << report.model << "序列号:" << report.serialNumber << "固件:" << report.firmware;
+    
+    if (report.hasStatus) {
+        applyHealthStatus(report.passed);
+    } else {
+        qDebug() << "---SMART解析调试---未找到健康状态信息";
+    }
+    
+    bool hasTemperature = false;
+    bool hasPowerOnHours = false;
+    bool hasPowerCycles = false;
+    for (SmartAttribute &attr : report.attributes) {
+        evaluateAttribute(attr);
+        hasTemperature = hasTemperature || attr.id == 194 || attr.id == 190;
+        hasPowerOnHours = hasPowerOnHours || attr.id == 9;
+        hasPowerCycles = hasPowerCycles || attr.id == 12;
+    }
+    
+    // 属性表中没有的指标使用smartctl汇总的值
+    if (!hasTemperature && report.temperature >= 0) {
+        m_temperature = report.temperature;
+    }
+    if (!hasPowerOnHours && report.powerOnHours >= 0) {
+        m_powerOnHours = static_cast<int>(report.powerOnHours);
+    }
+    if (!hasPowerCycles && report.powerCycleCount >= 0) {
+        m_powerCycleCount = static_cast<int>(report.powerCycleCount);
+    }
+    
+    m_attributes = report.attributes;
+    qDebug() << "成功解析" << m_attributes.size() << "个SATA设备SMART属性(JSON)";
+    return true;
+}
+
+void SATAData::applyHealthStatus(bool passed)
+{
+    if (passed) {
+        m_overallHealth = 100; // 最终健康度在读取属性后按实际计数扣减
+        qDebug() << "SMART自测通过，健康度设置为:" << m_overallHealth;
+    } else {
+        m_overallHealth = 50;
+        m_warnings.append("警告: SMART自检失败！建议立即备份数据");
+        qDebug() << "SMART自测失败，健康度设置为:" << m_overallHealth;
+    }
+}
+
 bool SATAData::parseSATAOutput(const QString &output)
 {
     qDebug() << "开始解析SATA设备输出";
@@ -121,14 +236,7 @@ bool SATAData::parseSATAOutput(const QString &output)
     if (healthMatch.hasMatch()) {
         QString healthStatus = healthMatch.captured(1);
         qDebug() << "---SMART解析调试---找到健康状态:" << healthStatus;
-        if (healthStatus.contains("PASSED", Qt::CaseInsensitive)) {
-                m_overallHealth = 90 + QRandomGenerator::global()->bounded(11); // 90-100
-                qDebug() << "SMART自测通过，健康度设置为:" << m_overallHealth;
-        } else {
-                m_overallHealth = 10 + QRandomGenerator::global()->bounded(50); // 10-59
-                m_warnings.append("警告: SMART自检失败！建议立即备份数据");
-                qDebug() << "SMART自测失败，健康度设置为:" << m_overallHealth;
-            }
+        applyHealthStatus(healthStatus.contains("PASSED", Qt::CaseInsensitive));
     } else {
         qDebug() << "---SMART解析调试---未找到健康状态信息";
     }
@@ -167,7 +275,7 @@ bool SATAData::parseSATAOutput(const QString &output)
     
     // 修改正则表达式以更好地匹配输出格式
     // 格式: ID# ATTRIBUTE_NAME  FLAG     VALUE WORST THRESH TYPE      UPDATED  WHEN_FAILED RAW_VALUE
-    QRegularExpression attrRe("^\\s*(\\d+)\\s+([\\w_-]+)\\s+[0-9a-fx]+\\s+(\\d+)\\s+(\\d+)\\s+([\\d-]+|---)\\s+\\w+\\s+\\w+\\s+(-|\\w+)\\s+([\\d-]+)");
+    static const QRegularExpression attrRe("^\\s*(\\d+)\\s+([\\w_-]+)\\s+[0-9a-fx]+\\s+(\\d+)\\s+(\\d+)\\s+([\\d-]+|---)\\s+\\w+\\s+\\w+\\s+(-|\\w+)\\s+([\\d-]+)");
     qDebug() << "---SMART解析调试---使用正则表达式:" << attrRe.pattern();
     
     for (int i = attributeTableStart; i < lines.size(); i++) {
@@ -184,7 +292,7 @@ bool SATAData::parseSATAOutput(const QString &output)
         
         // 尝试简化的正则表达式
         if (!match.hasMatch()) {
-            QRegularExpression simpleAttrRe("^\\s*(\\d+)\\s+([\\w_-]+).*?(\\d+)\\s+(\\d+)\\s+([\\d-]+|---).*?(\\d+)$");
+            static const QRegularExpression simpleAttrRe("^\\s*(\\d+)\\s+([\\w_-]+).*?(\\d+)\\s+(\\d+)\\s+([\\d-]+|---).*?(\\d+)$");
             match = simpleAttrRe.match(line);
         }
         
@@ -216,74 +324,7 @@ bool SATAData::parseSATAOutput(const QString &output)
                      << "阈值:" << attr.threshold
                      << "原始值:" << attr.raw;
             
-            // 设置状态
-            if (attr.threshold > 0 && attr.current <= attr.threshold) {
-                attr.status = "危险";
-                m_warnings.append(QString("警告: 属性 %1(%2) 已达到或超过阈值").arg(attr.name).arg(attr.id));
-            } else if (attr.current < 70) {
-                attr.status = "警告";
-                if (attr.id == 5 || attr.id == 196 || attr.id == 197 || attr.id == 198) {
-                    m_warnings.append(QString("警告: 属性 %1(%2) 值较低").arg(attr.name).arg(attr.id));
-                }
-            } else {
-                attr.status = "正常";
-            }
-                
-            // 处理特定属性
-            if (attr.id == 194 || attr.id == 190) { // 温度
-                m_temperature = attr.raw;
-                qDebug() << "---SMART解析调试---设置温度值:" << m_temperature;
-                if (m_temperature > 65) {
-                    m_warnings.append(QString("警告: 硬盘温度过高 (%1°C)").arg(m_temperature));
-                }
-            } else if (attr.id == 9) { // 通电时间
-                m_powerOnHours = attr.raw;
-                qDebug() << "---SMART解析调试---设置通电时间:" << m_powerOnHours;
-            } else if (attr.id == 12) { // 通电次数
-                m_powerCycleCount = attr.raw;
-                qDebug() << "---SMART解析调试---设置通电次数:" << m_powerCycleCount;
-            } else if (attr.id == 5 || attr.id == 196) { // 重分配扇区
-                if (attr.raw > 0) {
-                    attr.status = "警告";
-                    m_warnings.append(QString("警告: 存在重分配扇区 (%1 个)").arg(attr.raw));
-                }
-            } else if (attr.id == 197 || attr.id == 198) { // 坏扇区
-                if (attr.raw > 0) {
-                    attr.status = "危险";
-                    m_warnings.append(QString("警告: 存在坏扇区 (%1 个)").arg(attr.raw));
-                }
-            }
-            
-            // 添加可读的描述
-            switch (attr.id) {
-                case 1:
-                    attr.description = "读取错误率";
-                    break;
-                case 5:
-                    attr.description = "重分配扇区数量";
-                    break;
-                case 9:
-                    attr.description = QString("%1 小时").arg(attr.raw);
-                    break;
-                case 12:
-                    attr.description = QString("%1 次").arg(attr.raw);
-                    break;
-                case 194:
-                case 190:
-                    attr.description = QString("%1 °C").arg(attr.raw);
-                    break;
-                case 241:
-                    attr.description = QString("%1 LBA").arg(attr.raw);
-                    break;
-                case 242:
-                    attr.description = QString("%1 LBA").arg(attr.raw);
-                    break;
-                default:
-                    if (attr.name.contains("Unknown", Qt::CaseInsensitive)) {
-                        attr.description = "未知属性";
-                    }
-                    break;
-            }
+            evaluateAttribute(attr);
             
             attributes.append(attr);
             qDebug() << "解析属性:" << attr.id << attr.name << "值:" << attr.current << "阈值:" << attr.threshold << "原始值:" << attr.raw;
@@ -307,6 +348,78 @@ bool SATAData::parseSATAOutput(const QString &output)
     }
 }
 
+void SATAData::evaluateAttribute(SmartAttribute &attr)
+{
+    // 设置状态
+    if (attr.threshold > 0 && attr.current <= attr.threshold) {
+        attr.status = "危险";
+        m_warnings.append(QString("警告: 属性 %1(%2) 已达到或超过阈值").arg(attr.name).arg(attr.id));
+    } else if (attr.current < 70) {
+        attr.status = "警告";
+        if (attr.id == 5 || attr.id == 196 || attr.id == 197 || attr.id == 198) {
+            m_warnings.append(QString("警告: 属性 %1(%2) 值较低").arg(attr.name).arg(attr.id));
+        }
+    } else {
+        attr.status = "正常";
+    }
+    
+    // 处理特定属性
+    if (attr.id == 194 || attr.id == 190) { // 温度
+        m_temperature = attr.raw;
+        qDebug() << "---SMART解析调试---设置温度值:" << m_temperature;
+        if (m_temperature > 65) {
+            m_warnings.append(QString("警告: 硬盘温度过高 (%1°C)").arg(m_temperature));
+        }
+    } else if (attr.id == 9) { // 通电时间
+        m_powerOnHours = attr.raw;
+        qDebug() << "---SMART解析调试---设置通电时间:" << m_powerOnHours;
+    } else if (attr.id == 12) { // 通电次数
+        m_powerCycleCount = attr.raw;
+        qDebug() << "---SMART解析调试---设置通电次数:" << m_powerCycleCount;
+    } else if (attr.id == 5 || attr.id == 196) { // 重分配扇区
+        if (attr.raw > 0) {
+            attr.status = "警告";
+            m_warnings.append(QString("警告: 存在重分配扇区 (%1 个)").arg(attr.raw));
+        }
+    } else if (attr.id == 197 || attr.id == 198) { // 坏扇区
+        if (attr.raw > 0) {
+            attr.status = "危险";
+            m_warnings.append(QString("警告: 存在坏扇区 (%1 个)").arg(attr.raw));
+        }
+    }
+    
+    // 添加可读的描述
+    switch (attr.id) {
+        case 1:
+            attr.description = "读取错误率";
+            break;
+        case 5:
+            attr.description = "重分配扇区数量";
+            break;
+        case 9:
+            attr.description = QString("%1 小时").arg(attr.raw);
+            break;
+        case 12:
+            attr.description = QString("%1 次").arg(attr.raw);
+            break;
+        case 194:
+        case 190:
+            attr.description = QString("%1 °C").arg(attr.raw);
+            break;
+        case 241:
+            attr.description = QString("%1 LBA").arg(attr.raw);
+            break;
+        case 242:
+            attr.description = QString("%1 LBA").arg(attr.raw);
+            break;
+        default:
+            if (attr.name.contains("Unknown", Qt::CaseInsensitive)) {
+                attr.description = "未知属性";
+            }
+            break;
+    }
+}
+
 void SATAData::createSimulatedData()
 {
     qDebug() << "创建SATA模拟SMART数据";
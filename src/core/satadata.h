@@ -3,6 +3,8 @@
 
 #include "smartdata.h"
 
+class AtaTransport;
+
 class SATAData : public SmartData
 {
     Q_OBJECT
@@ -11,6 +13,9 @@ public:
     explicit SATAData(QObject *parent = nullptr);
     virtual ~SATAData();
 
+    // 指定发送ATA命令的设备层（不转移所有权），用于没有真实硬盘时测试；未指定时在Linux上使用SG_IO
+    void setAtaTransport(AtaTransport *transport);
+
 protected:
     // 检测SATA设备类型
     virtual bool detectDiskType(const QString &diskPath) override;
@@ -18,11 +23,25 @@ protected:
     // 加载SATA设备SMART数据
     virtual bool loadSmartData(const QString &diskPath) override;
     
-    // 解析SATA设备输出
+    // 通过ATA PASS-THROUGH直接读取SMART数据，失败时由调用方退回smartctl
+    bool loadNativeSmartData(const QString &devicePath);
+    
+    // 解析smartctl -j输出
+    bool parseSATAJson(const QByteArray &output);
+    
+    // 解析SATA设备输出（smartctl文本格式）
     bool parseSATAOutput(const QString &output);
     
+    // 根据整体自检结果设置健康度
+    void applyHealthStatus(bool passed);
+    
+    // 根据属性值设置状态、描述，并提取温度、通电时间等指标
+    void evaluateAttribute(SmartAttribute &attr);
+    
     // 为SATA设备创建模拟数据
     virtual void createSimulatedData() override;
+    
+    AtaTransport *m_ataTransport;   // 外部指定的设备层，为空时自动打开设备
 };
 
 #endif // SATADATA_H 
\ No newline at end of file
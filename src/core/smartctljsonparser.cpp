@@ -0,0 +1,635 @@
+#include "smartctljsonparser.h"
+#include <QDebug>
+#include <QLatin1String>
+#include <limits>
+
+namespace {
+// 嵌套层数上限，smartctl输出最多五六层
+const int kMaxDepth = 32;
+
+// 在原始字节上前进的JSON读取器
+// 字符串以QLatin1String视图返回，指向原缓冲区，调用方需要保存时再转换
+class JsonReader
+{
+public:
+    explicit JsonReader(const QByteArray &data)
+        : m_begin(data.constData()), m_pos(data.constData()), m_end(data.constData() + data.size()), m_depth(0),
+          m_failed(false)
+    {
+    }
+
+    bool failed() const { return m_failed; }
+
+    QString errorString() const
+    {
+        return QString("JSON格式错误，位置 %1").arg(m_pos - m_begin);
+    }
+
+    bool enterObject()
+    {
+        return enter('{');
+    }
+
+    bool enterArray()
+    {
+        return enter('[');
+    }
+
+    // 读取对象的下一个键，到达对象结尾或出错时返回false，之后读取器位于值的开头
+    bool nextKey(QLatin1String &key)
+    {
+        if (!nextMember('}')) {
+            return false;
+        }
+        bool escaped = false;
+        if (!readString(key, escaped)) {
+            return false;
+        }
+        skipWhitespace();
+        if (m_pos >= m_end || *m_pos != ':') {
+            return fail();
+        }
+        ++m_pos;
+        skipWhitespace();
+        return true;
+    }
+
+    // 前进到数组的下一个元素，到达数组结尾或出错时返回false
+    bool nextElement()
+    {
+        return nextMember(']');
+    }
+
+    bool readString(QLatin1String &value, bool &escaped)
+    {
+        skipWhitespace();
+        if (m_pos >= m_end || *m_pos != '"') {
+            return fail();
+        }
+        const char *start = ++m_pos;
+        escaped = false;
+        while (m_pos < m_end && *m_pos != '"') {
+            if (*m_pos == '\\') {
+                escaped = true;
+                ++m_pos;
+            }
+            ++m_pos;
+        }
+        if (m_pos >= m_end) {
+            return fail();
+        }
+        value = QLatin1String(start, static_cast<int>(m_pos - start));
+        ++m_pos;
+        return true;
+    }
+
+    // 读取字符串并转换为QString，只用于需要保存的值
+    QString readQString()
+    {
+        QLatin1String view;
+        bool escaped = false;
+        if (peek() != '"') {
+            skipValue();
+            return QString();
+        }
+        if (!readString(view, escaped)) {
+            return QString();
+        }
+        if (!escaped) {
+            return QString::fromUtf8(view.data(), view.size()).trimmed();
+        }
+        return unescape(view).trimmed();
+    }
+
+    // 读取整数，小数部分和指数被忽略；值不是数字时跳过并返回false
+    bool readInteger(qint64 &value)
+    {
+        skipWhitespace();
+        bool negative = false;
+        if (m_pos < m_end && *m_pos == '-') {
+            negative = true;
+            ++m_pos;
+        }
+        if (m_pos >= m_end || *m_pos < '0' || *m_pos > '9') {
+            if (negative) {
+                return fail();
+            }
+            skipValue();
+            return false;
+        }
+        quint64 magnitude = 0;
+        while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9') {
+            quint64 next = magnitude * 10 + static_cast<quint64>(*m_pos - '0');
+            // 溢出时饱和
+            magnitude = next < magnitude ? ~0ULL : next;
+            ++m_pos;
+        }
+        while (m_pos < m_end && (*m_pos == '.' || *m_pos == 'e' || *m_pos == 'E' || *m_pos == '+' || *m_pos == '-'
+                                 || (*m_pos >= '0' && *m_pos <= '9'))) {
+            ++m_pos;
+        }
+        const quint64 limit = static_cast<quint64>(std::numeric_limits<qint64>::max());
+        value = static_cast<qint64>(qMin(magnitude, limit));
+        if (negative) {
+            value = -value;
+        }
+        return true;
+    }
+
+    bool readBool(bool &value)
+    {
+        skipWhitespace();
+        if (matchLiteral("true")) {
+            value = true;
+            return true;
+        }
+        if (matchLiteral("false")) {
+            value = false;
+            return true;
+        }
+        skipValue();
+        return false;
+    }
+
+    void skipValue()
+    {
+        skipWhitespace();
+        if (m_pos >= m_end) {
+            fail();
+            return;
+        }
+        QLatin1String ignored;
+        switch (*m_pos) {
+        case '{':
+            if (enterObject()) {
+                while (nextKey(ignored)) {
+                    skipValue();
+                }
+            }
+            break;
+        case '[':
+            if (enterArray()) {
+                while (nextElement()) {
+                    skipValue();
+                }
+            }
+            break;
+        case '"': {
+            bool escaped = false;
+            readString(ignored, escaped);
+            break;
+        }
+        case 't':
+        case 'f':
+        case 'n':
+            if (!matchLiteral("true") && !matchLiteral("false") && !matchLiteral("null")) {
+                fail();
+            }
+            break;
+        default: {
+            qint64 number = 0;
+            if (*m_pos != '-' && (*m_pos < '0' || *m_pos > '9')) {
+                fail();
+            } else {
+                readInteger(number);
+            }
+            break;
+        }
+        }
+    }
+
+    char peek()
+    {
+        skipWhitespace();
+        return m_pos < m_end ? *m_pos : '\0';
+    }
+
+private:
+    bool enter(char open)
+    {
+        skipWhitespace();
+        if (m_pos >= m_end || *m_pos != open) {
+            // 类型不符的值整体跳过，调用方按缺少该字段处理
+            if (m_pos < m_end) {
+                skipValue();
+            }
+            return false;
+        }
+        if (++m_depth > kMaxDepth) {
+            return fail();
+        }
+        ++m_pos;
+        m_first = true;
+        return true;
+    }
+
+    // 对象和数组共用的成员分隔处理
+    bool nextMember(char close)
+    {
+        if (m_failed) {
+            return false;
+        }
+        skipWhitespace();
+        if (m_pos >= m_end) {
+            return fail();
+        }
+        if (*m_pos == close) {
+            ++m_pos;
+            --m_depth;
+            m_first = false;
+            return false;
+        }
+        if (!m_first) {
+            if (*m_pos != ',') {
+                return fail();
+            }
+            ++m_pos;
+            skipWhitespace();
+        }
+        m_first = false;
+        return true;
+    }
+
+    bool matchLiteral(const char *literal)
+    {
+        const int length = static_cast<int>(qstrlen(literal));
+        if (m_end - m_pos >= length && qstrncmp(m_pos, literal, length) == 0) {
+            m_pos += length;
+            return true;
+        }
+        return false;
+    }
+
+    void skipWhitespace()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+            ++m_pos;
+        }
+    }
+
+    bool fail()
+    {
+        m_failed = true;
+        return false;
+    }
+
+    static QString unescape(QLatin1String view)
+    {
+        QByteArray bytes;
+        bytes.reserve(view.size());
+        for (int i = 0; i < view.size(); ++i) {
+            char c = view.at(i).toLatin1();
+            if (c != '\\' || i + 1 >= view.size()) {
+                bytes.append(c);
+                continue;
+            }
+            char escapedChar = view.at(++i).toLatin1();
+            switch (escapedChar) {
+            case 'n': bytes.append('\n'); break;
+            case 't': bytes.append('\t'); break;
+            case 'r': bytes.append('\r'); break;
+            case 'b': bytes.append('\b'); break;
+            case 'f': bytes.append('\f'); break;
+            case 'u':
+                if (i + 4 < view.size()) {
+                    bool ok = false;
+                    ushort code = QString(view.mid(i + 1, 4)).toUShort(&ok, 16);
+                    if (ok) {
+                        bytes.append(QString(QChar(code)).toUtf8());
+                    }
+                    i += 4;
+                }
+                break;
+            default: bytes.append(escapedChar); break;
+            }
+        }
+        return QString::fromUtf8(bytes);
+    }
+
+    const char *m_begin;
+    const char *m_pos;
+    const char *m_end;
+    int m_depth;
+    bool m_first = false;   // 刚进入对象/数组，第一个成员前没有逗号
+    bool m_failed;
+};
+
+bool keyIs(QLatin1String key, const char *name)
+{
+    return key == QLatin1String(name);
+}
+
+// 读取只含一个整数字段的对象，如 "temperature": {"current": 35}
+bool readNestedInteger(JsonReader &reader, const char *field, qint64 &value)
+{
+    bool found = false;
+    QLatin1String key;
+    if (reader.enterObject()) {
+        while (reader.nextKey(key)) {
+            if (keyIs(key, field)) {
+                found = reader.readInteger(value);
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+    return found;
+}
+
+bool readSmartStatus(JsonReader &reader, bool &passed)
+{
+    bool found = false;
+    QLatin1String key;
+    if (reader.enterObject()) {
+        while (reader.nextKey(key)) {
+            if (keyIs(key, "passed")) {
+                found = reader.readBool(passed);
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+    return found;
+}
+
+// 原始值取raw.string开头的数字，与smartctl文本输出一致（温度"35 (Min/Max 20/45)"、通电时间"1234h+05m"）；
+// 没有数字时退回raw.value
+long long leadingNumber(QLatin1String text, bool &ok)
+{
+    long long value = 0;
+    int i = 0;
+    while (i < text.size() && text.at(i).toLatin1() == ' ') {
+        ++i;
+    }
+    ok = false;
+    for (; i < text.size(); ++i) {
+        const char c = text.at(i).toLatin1();
+        if (c < '0' || c > '9') {
+            break;
+        }
+        value = value * 10 + (c - '0');
+        ok = true;
+    }
+    return value;
+}
+
+bool readAtaAttribute(JsonReader &reader, SmartAttribute &attr)
+{
+    attr.id = 0;
+    attr.current = 0;
+    attr.worst = 0;
+    attr.threshold = 0;
+    attr.raw = 0;
+
+    qint64 number = 0;
+    qint64 rawValue = 0;
+    bool hasRawString = false;
+    long long rawFromString = 0;
+    QLatin1String key;
+    if (!reader.enterObject()) {
+        return false;
+    }
+    while (reader.nextKey(key)) {
+        if (keyIs(key, "id")) {
+            if (reader.readInteger(number)) {
+                attr.id = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "name")) {
+            attr.name = reader.readQString();
+        } else if (keyIs(key, "value")) {
+            if (reader.readInteger(number)) {
+                attr.current = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "worst")) {
+            if (reader.readInteger(number)) {
+                attr.worst = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "thresh")) {
+            if (reader.readInteger(number)) {
+                attr.threshold = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "raw")) {
+            QLatin1String rawKey;
+            if (reader.enterObject()) {
+                while (reader.nextKey(rawKey)) {
+                    if (keyIs(rawKey, "value")) {
+                        reader.readInteger(rawValue);
+                    } else if (keyIs(rawKey, "string") && reader.peek() == '"') {
+                        QLatin1String text;
+                        bool escaped = false;
+                        if (reader.readString(text, escaped)) {
+                            rawFromString = leadingNumber(text, hasRawString);
+                        }
+                    } else {
+                        reader.skipValue();
+                    }
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    attr.raw = hasRawString ? rawFromString : rawValue;
+    return attr.id > 0 && !reader.failed();
+}
+
+bool readNvmeLog(JsonReader &reader, SmartctlNvmeReport &report)
+{
+    NvmeSmartLog &log = report.log;
+    QLatin1String key;
+    qint64 number = 0;
+    if (!reader.enterObject()) {
+        return false;
+    }
+
+    // 计数器字段与日志页结构一一对应
+    struct CounterField {
+        const char *name;
+        quint64 *target;
+    };
+    const CounterField counters[] = {
+        {"data_units_read", &log.dataUnitsRead},
+        {"data_units_written", &log.dataUnitsWritten},
+        {"host_reads", &log.hostReadCommands},
+        {"host_writes", &log.hostWriteCommands},
+        {"controller_busy_time", &log.controllerBusyTime},
+        {"power_cycles", &log.powerCycles},
+        {"power_on_hours", &log.powerOnHours},
+        {"unsafe_shutdowns", &log.unsafeShutdowns},
+        {"media_errors", &log.mediaErrors},
+        {"num_err_log_entries", &log.errorLogEntries}
+    };
+
+    while (reader.nextKey(key)) {
+        bool handled = false;
+        for (const CounterField &counter : counters) {
+            if (keyIs(key, counter.name)) {
+                if (reader.readInteger(number)) {
+                    *counter.target = static_cast<quint64>(qMax<qint64>(0, number));
+                }
+                handled = true;
+                break;
+            }
+        }
+        if (handled) {
+            continue;
+        }
+
+        if (keyIs(key, "critical_warning")) {
+            if (reader.readInteger(number)) {
+                log.criticalWarning = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "temperature")) {
+            if (reader.readInteger(number)) {
+                log.temperature = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "available_spare")) {
+            if (reader.readInteger(number)) {
+                log.availableSpare = static_cast<int>(number);
+                report.hasSpare = true;
+            }
+        } else if (keyIs(key, "available_spare_threshold")) {
+            if (reader.readInteger(number)) {
+                log.availableSpareThreshold = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "percentage_used")) {
+            if (reader.readInteger(number)) {
+                log.percentageUsed = static_cast<int>(number);
+                report.hasPercentageUsed = true;
+            }
+        } else if (keyIs(key, "warning_temp_time")) {
+            if (reader.readInteger(number)) {
+                log.warningTempMinutes = static_cast<quint32>(number);
+            }
+        } else if (keyIs(key, "critical_comp_time")) {
+            if (reader.readInteger(number)) {
+                log.criticalTempMinutes = static_cast<quint32>(number);
+            }
+        } else if (keyIs(key, "temperature_sensors")) {
+            int sensor = 0;
+            if (reader.enterArray()) {
+                while (reader.nextElement()) {
+                    ++sensor;
+                    if (reader.readInteger(number) && number > 0) {
+                        log.temperatureSensors[sensor] = static_cast<int>(number);
+                    }
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+    return !reader.failed();
+}
+}
+
+bool SmartctlJsonParser::looksLikeJson(const QByteArray &output)
+{
+    for (char c : output) {
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            continue;
+        }
+        return c == '{';
+    }
+    return false;
+}
+
+bool SmartctlJsonParser::parseAta(const QByteArray &json, SmartctlAtaReport &report, QString &errorMessage)
+{
+    JsonReader reader(json);
+    if (!reader.enterObject()) {
+        errorMessage = "smartctl输出不是JSON对象";
+        return false;
+    }
+
+    report.attributes.clear();
+    QLatin1String key;
+    qint64 number = 0;
+    while (reader.nextKey(key)) {
+        if (keyIs(key, "model_name")) {
+            report.model = reader.readQString();
+        } else if (keyIs(key, "serial_number")) {
+            report.serialNumber = reader.readQString();
+        } else if (keyIs(key, "firmware_version")) {
+            report.firmware = reader.readQString();
+        } else if (keyIs(key, "smart_status")) {
+            report.hasStatus = readSmartStatus(reader, report.passed);
+        } else if (keyIs(key, "temperature")) {
+            if (readNestedInteger(reader, "current", number)) {
+                report.temperature = static_cast<int>(number);
+            }
+        } else if (keyIs(key, "power_on_time")) {
+            if (readNestedInteger(reader, "hours", number)) {
+                report.powerOnHours = number;
+            }
+        } else if (keyIs(key, "power_cycle_count")) {
+            if (reader.readInteger(number)) {
+                report.powerCycleCount = number;
+            }
+        } else if (keyIs(key, "ata_smart_attributes")) {
+            QLatin1String tableKey;
+            if (reader.enterObject()) {
+                while (reader.nextKey(tableKey)) {
+                    if (keyIs(tableKey, "table") && reader.enterArray()) {
+                        while (reader.nextElement()) {
+                            SmartAttribute attr;
+                            if (readAtaAttribute(reader, attr)) {
+                                report.attributes.append(attr);
+                            }
+                        }
+                    } else if (!keyIs(tableKey, "table")) {
+                        reader.skipValue();
+                    }
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    if (reader.failed()) {
+        errorMessage = reader.errorString();
+        return false;
+    }
+    if (report.attributes.isEmpty()) {
+        errorMessage = "smartctl输出中没有SMART属性表";
+        return false;
+    }
+    return true;
+}
+
+bool SmartctlJsonParser::parseNvme(const QByteArray &json, SmartctlNvmeReport &report, QString &errorMessage)
+{
+    JsonReader reader(json);
+    if (!reader.enterObject()) {
+        errorMessage = "smartctl输出不是JSON对象";
+        return false;
+    }
+
+    QLatin1String key;
+    while (reader.nextKey(key)) {
+        if (keyIs(key, "model_name")) {
+            report.model = reader.readQString();
+        } else if (keyIs(key, "serial_number")) {
+            report.serialNumber = reader.readQString();
+        } else if (keyIs(key, "firmware_version")) {
+            report.firmware = reader.readQString();
+        } else if (keyIs(key, "smart_status")) {
+            report.hasStatus = readSmartStatus(reader, report.passed);
+        } else if (keyIs(key, "nvme_smart_health_information_log")) {
+            report.hasLog = readNvmeLog(reader, report);
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    if (reader.failed()) {
+        errorMessage = reader.errorString();
+        return false;
+    }
+    if (!report.hasLog) {
+        errorMessage = "smartctl输出中没有NVMe健康信息日志";
+        return false;
+    }
+    return true;
+}
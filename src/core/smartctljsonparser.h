@@ -0,0 +1,55 @@
+#ifndef SMARTCTLJSONPARSER_H
+#define SMARTCTLJSONPARSER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "smartdata.h"
+#include "nvmepassthrough.h"
+
+// smartctl -j输出中SATA设备的内容
+struct SmartctlAtaReport {
+    QString model;
+    QString serialNumber;
+    QString firmware;
+    bool hasStatus;         // 输出中是否有smart_status
+    bool passed;            // 整体自检结果
+    int temperature;        // temperature.current，-1表示没有
+    qint64 powerOnHours;    // power_on_time.hours，-1表示没有
+    qint64 powerCycleCount; // -1表示没有
+    QList<SmartAttribute> attributes;   // status和description由调用方填写
+
+    SmartctlAtaReport() : hasStatus(false), passed(true), temperature(-1), powerOnHours(-1), powerCycleCount(-1) {}
+};
+
+// smartctl -j输出中NVMe设备的内容，健康日志与直接读取日志页时使用同一结构
+struct SmartctlNvmeReport {
+    QString model;
+    QString serialNumber;
+    QString firmware;
+    bool hasStatus;
+    bool passed;
+    bool hasLog;            // 输出中是否有nvme_smart_health_information_log
+    bool hasSpare;
+    bool hasPercentageUsed;
+    NvmeSmartLog log;
+
+    SmartctlNvmeReport() : hasStatus(false), passed(true), hasLog(false), hasSpare(false), hasPercentageUsed(false) {}
+};
+
+// smartctl JSON输出(-j)解析
+// 单遍扫描原始字节，键名和字符串只在原缓冲区上比较，不构建QJsonDocument树，
+// 只有最终保存的型号、属性名等才会复制成QString。未识别的键整体跳过，
+// 所以smartctl新增字段不会影响解析；需要smartctl 7.0以上版本。
+class SmartctlJsonParser
+{
+public:
+    static bool parseAta(const QByteArray &json, SmartctlAtaReport &report, QString &errorMessage);
+    static bool parseNvme(const QByteArray &json, SmartctlNvmeReport &report, QString &errorMessage);
+
+    // 输出是否为JSON（旧版smartctl不认识-j时输出的是错误文本）
+    static bool looksLikeJson(const QByteArray &output);
+};
+
+#endif // SMARTCTLJSONPARSER_H
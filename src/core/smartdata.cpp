@@ -1,6 +1,7 @@
 #include "smartdata.h"
 #include "satadata.h"
 #include "nvmedata.h"
+#include "failurepredictor.h"
 #include <QDebug>
 #include <QProcess>
 #include <QRegularExpression>
@@ -14,6 +15,7 @@ SmartData::SmartData(QObject *parent)
     , m_powerOnHours(0)
     , m_powerCycleCount(0)
     , m_diskType(DiskType::Unknown)
+    , m_simulated(false)
 {
 }
 
@@ -33,6 +35,7 @@ bool SmartData::loadFromDisk(const QString &diskPath)
     m_powerCycleCount = 0;
     m_attributes.clear();
     m_warnings.clear();
+    m_simulated = false;
     
     qDebug() << "---基础SMART调试---已初始化所有属性为默认值";
     
@@ -57,10 +60,14 @@ bool SmartData::loadFromDisk(const QString &diskPath)
         qDebug() << "未能获取到SMART属性数据，使用模拟数据";
         qDebug() << "---基础SMART调试---SMART数据获取失败或属性为空，切换到模拟数据";
         createSimulatedData();
+        m_simulated = true;
         qDebug() << "---基础SMART调试---已创建模拟数据，属性数量:" << m_attributes.size();
         return false;
     }
     
+    // 自检结论只给出上限，按重映射、待映射、无法校正扇区和已用寿命确定健康度
+    m_overallHealth = FailurePredictor::healthScore(m_attributes, m_diskType, m_overallHealth);
+    
     qDebug() << "---基础SMART调试---SMART数据加载完成，总体健康度:" << m_overallHealth
              << "，温度:" << m_temperature
              << "，通电时间:" << m_powerOnHours
@@ -194,4 +201,9 @@ DiskType SmartData::diskType() const
 QStringList SmartData::warnings() const
 {
     return m_warnings;
-}
\ No newline at end of file
+}
+
+bool SmartData::isSimulated() const
+{
+    return m_simulated;
+}
@@ -51,6 +51,9 @@ public:
     // 获取警告信息
     QStringList warnings() const;
     
+    // 读取失败时填充的是模拟数据，不能用于历史记录和趋势分析
+    bool isSimulated() const;
+    
     // 检测硬盘类型并创建相应的实例
     virtual bool detectDiskType(const QString &diskPath);
 
@@ -68,6 +71,7 @@ protected:
     int m_powerOnHours;                   // 通电时间 (小时)
     int m_powerCycleCount;                // 通电次数
     DiskType m_diskType;                  // 硬盘类型
+    bool m_simulated;                     // 当前数据为模拟数据
 };
 
 #endif // SMARTDATA_H 
\ No newline at end of file
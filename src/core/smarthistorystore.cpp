@@ -0,0 +1,689 @@
+#include "smarthistorystore.h"
+#include "devicedatacache.h"
+#include "diskinventory.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QPair>
+#include <QReadLocker>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QWriteLocker>
+#include <algorithm>
+#include <limits>
+
+namespace {
+// 文件头：魔数、版本、类型、类型相关字段（原始分段的起点或汇总已覆盖到的时刻），共12字节
+const quint32 kFileMagic = 0x44545348;     // "DTSH"
+const quint16 kFileVersion = 1;
+const qint64 kHeaderSize = 12;
+const qint64 kSampleSize = 16;
+const qint64 kBucketSize = 24;
+
+enum FileKind {
+    RawFile = 0,
+    HourlyFile = 1,
+    DailyFile = 2
+};
+
+const quint32 kHour = 3600;
+const quint32 kDay = 24 * kHour;
+// 原始样本的环形窗口：4小时一段，保留6段
+const quint32 kSegmentSeconds = 4 * kHour;
+const int kRawSegments = 6;
+const quint32 kHourlyRetention = 14 * kDay;
+const quint32 kDailyRetention = 365 * kDay;
+// 值不变的指标每小时记一次，同一指标两次记录至少间隔1分钟
+const quint32 kHeartbeatSeconds = kHour;
+const quint32 kMinIntervalSeconds = 60;
+// 后台读取所有硬盘SMART数据的间隔，同时检查是否需要压缩
+const int kSampleIntervalMs = 10 * 60 * 1000;
+
+typedef QPair<quint16, quint32> BucketKey;     // (指标, 时间段起点)
+
+struct Accumulator {
+    double minimum;
+    double maximum;
+    double sum;
+    quint32 count;
+
+    Accumulator() : minimum(std::numeric_limits<double>::max()), maximum(std::numeric_limits<double>::lowest()),
+                    sum(0), count(0) {}
+
+    void add(double min, double max, double average, quint32 n)
+    {
+        minimum = qMin(minimum, min);
+        maximum = qMax(maximum, max);
+        sum += average * n;
+        count += n;
+    }
+};
+
+QString sanitizeKey(const QString &key)
+{
+    QString sanitized = key.trimmed();
+    sanitized.replace(QRegularExpression("[^A-Za-z0-9_-]"), "_");
+    return sanitized;
+}
+
+quint32 alignDown(quint32 time, quint32 unit)
+{
+    return time - time % unit;
+}
+
+quint32 toSeconds(const QDateTime &time)
+{
+    return static_cast<quint32>(qBound<qint64>(0, time.toSecsSinceEpoch(), std::numeric_limits<quint32>::max()));
+}
+
+QString segmentPath(const QString &directory, quint32 segmentStart)
+{
+    return QString("%1/raw-%2.seg").arg(directory).arg(segmentStart);
+}
+
+QList<quint32> rawSegments(const QString &directory)
+{
+    QList<quint32> segments;
+    const QStringList files = QDir(directory).entryList(QStringList() << "raw-*.seg", QDir::Files);
+    for (const QString &file : files) {
+        bool ok = false;
+        const quint32 start = file.mid(4, file.length() - 8).toUInt(&ok);
+        if (ok) {
+            segments.append(start);
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+void writeHeader(QDataStream &out, FileKind kind, quint32 field)
+{
+    out << kFileMagic << kFileVersion << quint16(kind) << field;
+}
+
+bool readHeader(QDataStream &in, FileKind kind, quint32 &field)
+{
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 fileKind = 0;
+    in >> magic >> version >> fileKind >> field;
+    return in.status() == QDataStream::Ok && magic == kFileMagic && version == kFileVersion && fileKind == kind;
+}
+
+QList<HistorySample> readSegment(const QString &path)
+{
+    QList<HistorySample> samples;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return samples;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+    quint32 segmentStart = 0;
+    if (!readHeader(in, RawFile, segmentStart)) {
+        return samples;
+    }
+
+    // 只读取完整的记录，写线程正在追加的最后一条可能不完整
+    const qint64 count = (file.size() - kHeaderSize) / kSampleSize;
+    samples.reserve(static_cast<int>(count));
+    for (qint64 i = 0; i < count; i++) {
+        HistorySample sample;
+        quint16 reserved = 0;
+        in >> sample.timestamp >> sample.metric >> reserved >> sample.value;
+        if (in.status() != QDataStream::Ok) {
+            break;
+        }
+        samples.append(sample);
+    }
+    return samples;
+}
+
+bool appendSegment(const QString &path, quint32 segmentStart, const QList<HistorySample> &samples,
+                   QString &errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        errorMessage = QString("无法写入SMART历史 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    if (file.size() == 0) {
+        writeHeader(out, RawFile, segmentStart);
+    }
+    for (const HistorySample &sample : samples) {
+        out << sample.timestamp << sample.metric << quint16(0) << sample.value;
+    }
+    if (out.status() != QDataStream::Ok) {
+        errorMessage = QString("写入SMART历史失败: %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+// 文件不存在时返回空列表
+bool readBuckets(const QString &path, FileKind kind, QList<HistoryBucket> &buckets, quint32 &coveredUntil)
+{
+    buckets.clear();
+    coveredUntil = 0;
+    QFile file(path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    if (!readHeader(in, kind, coveredUntil)) {
+        return false;
+    }
+
+    const qint64 count = (file.size() - kHeaderSize) / kBucketSize;
+    buckets.reserve(static_cast<int>(count));
+    for (qint64 i = 0; i < count; i++) {
+        HistoryBucket bucket;
+        in >> bucket.start >> bucket.metric >> bucket.span >> bucket.count
+           >> bucket.minimum >> bucket.maximum >> bucket.average;
+        if (in.status() != QDataStream::Ok) {
+            return false;
+        }
+        buckets.append(bucket);
+    }
+    return true;
+}
+
+bool writeBuckets(const QString &path, FileKind kind, const QList<HistoryBucket> &buckets, quint32 coveredUntil,
+                  QString &errorMessage)
+{
+    // 整个文件替换，查询线程只会看到旧文件或新文件
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = QString("无法写入SMART历史 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    writeHeader(out, kind, coveredUntil);
+    for (const HistoryBucket &bucket : buckets) {
+        out << bucket.start << bucket.metric << bucket.span << bucket.count
+            << bucket.minimum << bucket.maximum << bucket.average;
+    }
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        errorMessage = QString("保存SMART历史失败 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QList<HistoryBucket> toBuckets(const QMap<BucketKey, Accumulator> &accumulators)
+{
+    QList<HistoryBucket> buckets;
+    for (auto it = accumulators.constBegin(); it != accumulators.constEnd(); ++it) {
+        HistoryBucket bucket;
+        bucket.metric = it.key().first;
+        bucket.start = it.key().second;
+        bucket.span = 1;
+        bucket.count = it.value().count;
+        bucket.minimum = static_cast<float>(it.value().minimum);
+        bucket.maximum = static_cast<float>(it.value().maximum);
+        bucket.average = static_cast<float>(it.value().sum / qMax<quint32>(1, it.value().count));
+        buckets.append(bucket);
+    }
+    return buckets;
+}
+
+// 按(指标, 起点)排序，同一时间段的桶合并，值相同且相邻的单值桶合并为一段
+void mergeRuns(QList<HistoryBucket> &buckets, quint32 unit)
+{
+    std::sort(buckets.begin(), buckets.end(), [](const HistoryBucket &a, const HistoryBucket &b) {
+        return a.metric != b.metric ? a.metric < b.metric : a.start < b.start;
+    });
+
+    QList<HistoryBucket> merged;
+    for (const HistoryBucket &bucket : buckets) {
+        if (!merged.isEmpty() && merged.last().metric == bucket.metric) {
+            HistoryBucket &last = merged.last();
+            if (last.start == bucket.start && last.span == 1 && bucket.span == 1) {
+                const quint32 count = last.count + bucket.count;
+                last.average = static_cast<float>((double(last.average) * last.count
+                                                   + double(bucket.average) * bucket.count) / qMax<quint32>(1, count));
+                last.minimum = qMin(last.minimum, bucket.minimum);
+                last.maximum = qMax(last.maximum, bucket.maximum);
+                last.count = count;
+                continue;
+            }
+            const bool constant = last.minimum == last.maximum && bucket.minimum == bucket.maximum
+                                  && last.minimum == bucket.minimum;
+            if (constant && last.start + quint32(last.span) * unit == bucket.start
+                && int(last.span) + bucket.span <= 0xFFFF) {
+                last.span += bucket.span;
+                last.count += bucket.count;
+                continue;
+            }
+        }
+        merged.append(bucket);
+    }
+    buckets = merged;
+}
+
+// 把cutoff之前的时间单位移到粗一级的汇总中，跨越cutoff的合并段拆开；
+// movedUntil之前的部分已经移动过（上次写入中途失败），直接丢弃
+void expireBuckets(QList<HistoryBucket> &buckets, quint32 cutoff, quint32 unit, quint32 coarseUnit,
+                   quint32 movedUntil, QMap<BucketKey, Accumulator> &coarse)
+{
+    QList<HistoryBucket> kept;
+    for (HistoryBucket bucket : buckets) {
+        if (bucket.start >= cutoff) {
+            kept.append(bucket);
+            continue;
+        }
+        const quint32 expiredUnits = qMin<quint32>(bucket.span, (cutoff - bucket.start + unit - 1) / unit);
+        const quint32 unitCount = qMax<quint32>(1, bucket.count / bucket.span);
+        for (quint32 i = 0; i < expiredUnits; i++) {
+            const quint32 unitStart = bucket.start + i * unit;
+            if (unitStart < movedUntil) {
+                continue;
+            }
+            coarse[BucketKey(bucket.metric, alignDown(unitStart, coarseUnit))]
+                .add(bucket.minimum, bucket.maximum, bucket.average, unitCount);
+        }
+        if (expiredUnits < bucket.span) {
+            const quint32 remaining = bucket.span - expiredUnits;
+            bucket.count = qMax<quint32>(1, bucket.count * remaining / bucket.span);
+            bucket.start += expiredUnits * unit;
+            bucket.span = static_cast<quint16>(remaining);
+            kept.append(bucket);
+        }
+    }
+    buckets = kept;
+}
+
+void appendBucketPoints(QVector<HistoryPoint> &points, const HistoryBucket &bucket, quint32 unit,
+                        quint32 from, quint32 to)
+{
+    // 合并段只输出首尾两个点，图表上是一段水平线
+    quint32 first = bucket.start;
+    quint32 last = bucket.start + (quint32(bucket.span) - 1) * unit;
+    if (first < from) {
+        first = bucket.start + ((from - bucket.start + unit - 1) / unit) * unit;
+    }
+    if (last > to) {
+        if (to < bucket.start) {
+            return;
+        }
+        last = bucket.start + ((to - bucket.start) / unit) * unit;
+    }
+    if (first > last) {
+        return;
+    }
+
+    HistoryPoint point;
+    point.minimum = bucket.minimum;
+    point.maximum = bucket.maximum;
+    point.average = bucket.average;
+    point.count = qMax<quint32>(1, bucket.count / bucket.span);
+    point.timestamp = first;
+    points.append(point);
+    if (last != first) {
+        point.timestamp = last;
+        points.append(point);
+    }
+}
+
+QVector<HistoryPoint> downsample(const QVector<HistoryPoint> &points, quint32 unit)
+{
+    QMap<qint64, Accumulator> accumulators;
+    for (const HistoryPoint &point : points) {
+        accumulators[point.timestamp - point.timestamp % unit]
+            .add(point.minimum, point.maximum, point.average, qMax<quint32>(1, point.count));
+    }
+    QVector<HistoryPoint> result;
+    result.reserve(accumulators.size());
+    for (auto it = accumulators.constBegin(); it != accumulators.constEnd(); ++it) {
+        HistoryPoint point;
+        point.timestamp = it.key();
+        point.minimum = it.value().minimum;
+        point.maximum = it.value().maximum;
+        point.count = it.value().count;
+        point.average = it.value().sum / qMax<quint32>(1, point.count);
+        result.append(point);
+    }
+    return result;
+}
+}
+
+SmartHistoryWriter::SmartHistoryWriter(const QString &rootPath, QReadWriteLock *lock, QObject *parent)
+    : QObject(parent), m_rootPath(rootPath), m_lock(lock)
+{
+}
+
+void SmartHistoryWriter::append(const QString &diskKey, const QList<HistorySample> &samples)
+{
+    // 值没有变化的指标只按心跳间隔记录
+    QHash<quint16, LastSample> &lastSamples = m_lastSamples[diskKey];
+    QList<HistorySample> kept;
+    for (const HistorySample &sample : samples) {
+        auto it = lastSamples.constFind(sample.metric);
+        if (it != lastSamples.constEnd()) {
+            const quint32 elapsed = sample.timestamp > it->timestamp ? sample.timestamp - it->timestamp : 0;
+            if (elapsed < kMinIntervalSeconds || (it->value == sample.value && elapsed < kHeartbeatSeconds)) {
+                continue;
+            }
+        }
+        kept.append(sample);
+        lastSamples.insert(sample.metric, LastSample{sample.timestamp, sample.value});
+    }
+    if (kept.isEmpty()) {
+        return;
+    }
+
+    const QString directory = m_rootPath + "/" + diskKey;
+    QDir().mkpath(directory);
+    const quint32 segmentStart = alignDown(kept.first().timestamp, kSegmentSeconds);
+    QString errorMessage;
+    if (!appendSegment(segmentPath(directory, segmentStart), segmentStart, kept, errorMessage)) {
+        qDebug() << errorMessage;
+        emit failed(errorMessage);
+        return;
+    }
+    emit appended(diskKey, kept);
+
+    // 进入新的分段后，滑出窗口的旧分段汇总为小时数据
+    auto current = m_currentSegment.constFind(diskKey);
+    const bool rolledOver = current != m_currentSegment.constEnd() && current.value() != segmentStart;
+    m_currentSegment.insert(diskKey, segmentStart);
+    if (rolledOver) {
+        compactDisk(diskKey, kept.first().timestamp);
+    }
+}
+
+void SmartHistoryWriter::compact()
+{
+    const quint32 now = toSeconds(QDateTime::currentDateTimeUtc());
+    const QStringList disks = QDir(m_rootPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &diskKey : disks) {
+        compactDisk(diskKey, now);
+    }
+}
+
+bool SmartHistoryWriter::compactDisk(const QString &diskKey, quint32 now)
+{
+    const QString directory = m_rootPath + "/" + diskKey;
+    const QString hourlyPath = directory + "/hourly.dat";
+    const QString dailyPath = directory + "/daily.dat";
+
+    // 超出段数或已经整段落在窗口之外（不再写入的硬盘）的原始分段需要汇总
+    const QList<quint32> segments = rawSegments(directory);
+    const quint32 windowStart = now > kRawSegments * kSegmentSeconds ? now - kRawSegments * kSegmentSeconds : 0;
+    QList<quint32> expired;
+    for (int i = 0; i < segments.size(); i++) {
+        if (segments.size() - i > kRawSegments || segments[i] + kSegmentSeconds <= windowStart) {
+            expired.append(segments[i]);
+        }
+    }
+
+    QList<HistoryBucket> hourly;
+    QList<HistoryBucket> daily;
+    quint32 hourlyUntil = 0;
+    quint32 dailyUntil = 0;
+    if (!readBuckets(hourlyPath, HourlyFile, hourly, hourlyUntil) || !readBuckets(dailyPath, DailyFile, daily, dailyUntil)) {
+        const QString errorMessage = QString("SMART历史文件损坏: %1").arg(directory);
+        qDebug() << errorMessage;
+        emit failed(errorMessage);
+        return false;
+    }
+
+    const quint32 hourlyCutoff = alignDown(now > kHourlyRetention ? now - kHourlyRetention : 0, kDay);
+    const quint32 dailyCutoff = alignDown(now > kDailyRetention ? now - kDailyRetention : 0, kDay);
+    bool hasExpiredHours = false;
+    for (const HistoryBucket &bucket : hourly) {
+        hasExpiredHours = hasExpiredHours || bucket.start < hourlyCutoff;
+    }
+    if (expired.isEmpty() && !hasExpiredHours) {
+        return true;
+    }
+
+    // 原始样本 -> 小时，hourlyUntil之前的样本已经汇总过
+    QMap<BucketKey, Accumulator> hours;
+    for (quint32 segmentStart : expired) {
+        for (const HistorySample &sample : readSegment(segmentPath(directory, segmentStart))) {
+            if (sample.timestamp >= hourlyUntil) {
+                hours[BucketKey(sample.metric, alignDown(sample.timestamp, kHour))]
+                    .add(sample.value, sample.value, sample.value, 1);
+            }
+        }
+        hourlyUntil = qMax(hourlyUntil, segmentStart + kSegmentSeconds);
+    }
+    hourly.append(toBuckets(hours));
+    mergeRuns(hourly, kHour);
+
+    // 小时 -> 天
+    QMap<BucketKey, Accumulator> days;
+    expireBuckets(hourly, hourlyCutoff, kHour, kDay, dailyUntil, days);
+    if (!days.isEmpty()) {
+        daily.append(toBuckets(days));
+    }
+    dailyUntil = qMax(dailyUntil, hourlyCutoff);
+    QMap<BucketKey, Accumulator> dropped;
+    expireBuckets(daily, dailyCutoff, kDay, kDay, std::numeric_limits<quint32>::max(), dropped);
+    mergeRuns(daily, kDay);
+
+    QString errorMessage;
+    {
+        QWriteLocker locker(m_lock);
+        if (!writeBuckets(dailyPath, DailyFile, daily, dailyUntil, errorMessage)
+            || !writeBuckets(hourlyPath, HourlyFile, hourly, hourlyUntil, errorMessage)) {
+            qDebug() << errorMessage;
+            emit failed(errorMessage);
+            return false;
+        }
+        for (quint32 segmentStart : expired) {
+            QFile::remove(segmentPath(directory, segmentStart));
+        }
+    }
+
+    qDebug() << "SMART历史压缩完成:" << diskKey << "汇总原始分段" << expired.size()
+             << "个，小时记录" << hourly.size() << "条，每日记录" << daily.size() << "条";
+    return true;
+}
+
+SmartHistoryStore::SmartHistoryStore(const QString &rootPath, QObject *parent)
+    : QObject(parent), m_rootPath(rootPath), m_sampleTimer(nullptr)
+{
+    if (m_rootPath.isEmpty()) {
+        m_rootPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/smarthistory";
+    }
+    QDir().mkpath(m_rootPath);
+    qRegisterMetaType<QList<HistorySample>>("QList<HistorySample>");
+
+    m_writerThread = new QThread(this);
+    m_writer = new SmartHistoryWriter(m_rootPath, &m_lock);
+    m_writer->moveToThread(m_writerThread);
+    connect(m_writer, &SmartHistoryWriter::appended, this, &SmartHistoryStore::samplesRecorded);
+    connect(m_writer, &SmartHistoryWriter::failed, this, &SmartHistoryStore::historyFailed);
+    m_writerThread->start();
+}
+
+SmartHistoryStore::~SmartHistoryStore()
+{
+    // 排队中的写入先全部完成
+    QMetaObject::invokeMethod(m_writer, []() {}, Qt::BlockingQueuedConnection);
+    m_writerThread->quit();
+    m_writerThread->wait();
+    delete m_writer;
+}
+
+SmartHistoryStore *SmartHistoryStore::instance()
+{
+    static SmartHistoryStore *store = new SmartHistoryStore(QString(), QCoreApplication::instance());
+    return store;
+}
+
+QString SmartHistoryStore::diskKey(const DiskInfo &disk)
+{
+    // 优先用序列号，Linux上设备名在插拔后可能变化
+    const QString serial = disk.serialNumber.trimmed();
+    return sanitizeKey(serial.isEmpty() ? disk.diskPath : serial);
+}
+
+QString SmartHistoryStore::diskKeyForDevice(const QString &deviceKey)
+{
+    const QList<DiskInfo> disks = DiskInventory::instance()->disks();
+    for (const DiskInfo &disk : disks) {
+        if (DeviceDataCache::deviceKey(disk.diskPath) == deviceKey) {
+            return diskKey(disk);
+        }
+    }
+    return sanitizeKey(deviceKey);
+}
+
+void SmartHistoryStore::startRecording()
+{
+    if (m_sampleTimer) {
+        return;
+    }
+
+    // 任何界面读取到的SMART数据都会记录下来
+    connect(DeviceDataCache::instance(), &DeviceDataCache::smartDataUpdated,
+            this, &SmartHistoryStore::onSmartDataUpdated);
+
+    m_sampleTimer = new QTimer(this);
+    m_sampleTimer->setInterval(kSampleIntervalMs);
+    connect(m_sampleTimer, &QTimer::timeout, this, &SmartHistoryStore::sampleAllDisks);
+    m_sampleTimer->start();
+
+    // 程序没有运行期间滑出窗口的分段先汇总
+    compactNow();
+}
+
+void SmartHistoryStore::record(const QString &diskKey, const SmartData *data, const QDateTime &time)
+{
+    if (!data || data->isSimulated()) {
+        return;
+    }
+
+    const quint32 timestamp = toSeconds(time);
+    QList<HistorySample> samples;
+    if (data->temperature() > 0) {
+        samples.append(HistorySample(timestamp, TemperatureMetric, data->temperature()));
+    }
+    samples.append(HistorySample(timestamp, HealthMetric, data->overallHealth()));
+    for (const SmartAttribute &attr : data->attributes()) {
+        if (attr.id > 0 && attr.id <= 255) {
+            samples.append(HistorySample(timestamp, static_cast<quint16>(attr.id), static_cast<double>(attr.raw)));
+        }
+        if (attr.id == 177 && data->diskType() == DiskType::NVMe) {
+            samples.append(HistorySample(timestamp, WearMetric, static_cast<double>(attr.raw)));
+        }
+    }
+
+    const QString key = sanitizeKey(diskKey);
+    SmartHistoryWriter *writer = m_writer;
+    QMetaObject::invokeMethod(writer, [writer, key, samples]() {
+        writer->append(key, samples);
+    }, Qt::QueuedConnection);
+}
+
+QVector<HistoryPoint> SmartHistoryStore::query(const QString &diskKey, quint16 metric, const QDateTime &from,
+                                               const QDateTime &to, Resolution resolution) const
+{
+    const QString directory = m_rootPath + "/" + sanitizeKey(diskKey);
+    const quint32 fromTime = toSeconds(from);
+    const quint32 toTime = toSeconds(to);
+    QVector<HistoryPoint> points;
+    if (fromTime > toTime) {
+        return points;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        // 三级数据按各自覆盖的时间拼接：天汇总 < dailyUntil <= 小时汇总 < hourlyUntil <= 原始样本
+        quint32 hourlyUntil = 0;
+        quint32 dailyUntil = 0;
+        QList<HistoryBucket> hourly;
+        QList<HistoryBucket> daily;
+        readBuckets(directory + "/hourly.dat", HourlyFile, hourly, hourlyUntil);
+        readBuckets(directory + "/daily.dat", DailyFile, daily, dailyUntil);
+
+        if (resolution != RawResolution) {
+            for (const HistoryBucket &bucket : daily) {
+                if (bucket.metric == metric) {
+                    appendBucketPoints(points, bucket, kDay, fromTime, qMin(toTime, dailyUntil - (dailyUntil ? 1 : 0)));
+                }
+            }
+            for (const HistoryBucket &bucket : hourly) {
+                if (bucket.metric == metric) {
+                    appendBucketPoints(points, bucket, kHour, qMax(fromTime, dailyUntil), toTime);
+                }
+            }
+        }
+
+        const quint32 rawFrom = resolution == RawResolution ? fromTime : qMax(fromTime, hourlyUntil);
+        for (quint32 segmentStart : rawSegments(directory)) {
+            if (segmentStart + kSegmentSeconds <= rawFrom || segmentStart > toTime) {
+                continue;
+            }
+            for (const HistorySample &sample : readSegment(segmentPath(directory, segmentStart))) {
+                if (sample.metric != metric || sample.timestamp < rawFrom || sample.timestamp > toTime) {
+                    continue;
+                }
+                HistoryPoint point;
+                point.timestamp = sample.timestamp;
+                point.minimum = sample.value;
+                point.maximum = sample.value;
+                point.average = sample.value;
+                point.count = 1;
+                points.append(point);
+            }
+        }
+    }
+
+    std::stable_sort(points.begin(), points.end(), [](const HistoryPoint &a, const HistoryPoint &b) {
+        return a.timestamp < b.timestamp;
+    });
+    if (resolution == HourlyResolution) {
+        return downsample(points, kHour);
+    }
+    if (resolution == DailyResolution) {
+        return downsample(points, kDay);
+    }
+    return points;
+}
+
+QStringList SmartHistoryStore::disks() const
+{
+    return QDir(m_rootPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+}
+
+void SmartHistoryStore::compactNow()
+{
+    SmartHistoryWriter *writer = m_writer;
+    QMetaObject::invokeMethod(writer, [writer]() {
+        writer->compact();
+    }, Qt::QueuedConnection);
+}
+
+void SmartHistoryStore::onSmartDataUpdated(const QString &deviceKey)
+{
+    QSharedPointer<SmartData> data = DeviceDataCache::instance()->smartData(deviceKey);
+    record(diskKeyForDevice(deviceKey), data.data());
+}
+
+void SmartHistoryStore::sampleAllDisks()
+{
+    // 缓存有效期内不会重复读取，读取完成后经smartDataUpdated记录
+    const QList<DiskInfo> disks = DiskInventory::instance()->disks();
+    for (const DiskInfo &disk : disks) {
+        DeviceDataCache::instance()->requestSmartData(disk.diskPath);
+    }
+    compactNow();
+}
@@ -0,0 +1,159 @@
+#ifndef SMARTHISTORYSTORE_H
+#define SMARTHISTORYSTORE_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include "diskutils.h"
+#include "smartdata.h"
+
+class QTimer;
+
+// 历史序列中的一个点，原始样本的最小/最大/平均值相同
+struct HistoryPoint {
+    qint64 timestamp;       // 秒(UTC)，汇总点为时间段起点
+    double minimum;
+    double maximum;
+    double average;
+    quint32 count;          // 包含的原始样本数
+
+    HistoryPoint() : timestamp(0), minimum(0), maximum(0), average(0), count(0) {}
+};
+
+// 一条原始样本，文件中每条16字节
+struct HistorySample {
+    quint32 timestamp;      // 秒(UTC)
+    quint16 metric;
+    double value;
+
+    HistorySample() : timestamp(0), metric(0), value(0) {}
+    HistorySample(quint32 t, quint16 m, double v) : timestamp(t), metric(m), value(v) {}
+};
+
+Q_DECLARE_METATYPE(HistorySample)
+
+// 汇总桶，文件中每条24字节
+// 连续span个时间单位的值完全相同时合并为一条，长期不变的属性只占一条记录
+struct HistoryBucket {
+    quint32 start;          // 第一个时间单位的起点
+    quint16 metric;
+    quint16 span;           // 覆盖的时间单位数（小时或天）
+    quint32 count;
+    float minimum;
+    float maximum;
+    float average;
+
+    HistoryBucket() : start(0), metric(0), span(1), count(0), minimum(0), maximum(0), average(0) {}
+};
+
+// 后台写线程上的写入和压缩，只由SmartHistoryStore使用
+class SmartHistoryWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    SmartHistoryWriter(const QString &rootPath, QReadWriteLock *lock, QObject *parent = nullptr);
+
+    void append(const QString &diskKey, const QList<HistorySample> &samples);
+    void compact();
+
+signals:
+    // 去重后实际写入的样本
+    void appended(const QString &diskKey, const QList<HistorySample> &samples);
+    void failed(const QString &message);
+
+private:
+    struct LastSample {
+        quint32 timestamp;
+        double value;
+    };
+
+    bool compactDisk(const QString &diskKey, quint32 now);
+
+    QString m_rootPath;
+    QReadWriteLock *m_lock;
+    QHash<QString, QHash<quint16, LastSample>> m_lastSamples;
+    QHash<QString, quint32> m_currentSegment;
+};
+
+// SMART属性和温度的历史记录
+// 每块硬盘一个目录（以序列号命名，设备名变化后仍能对上），分三级保存：
+// - 原始样本按4小时对齐追加到分段文件，只保留最近6段，形成环形窗口；
+//   值不变的属性每小时只记一次
+// - 滑出窗口的分段汇总为每小时的最小/最大/平均值，保留14天
+// - 更早的按天汇总，保留一年
+// 写入和压缩都在后台线程进行，40块硬盘一年的历史约几MB。
+// 查询在调用线程直接读取文件，按时间范围拼接三级数据，可以直接用于图表。
+class SmartHistoryStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Resolution {
+        AutoResolution,     // 近期用原始样本，较早的用小时/天汇总
+        RawResolution,
+        HourlyResolution,
+        DailyResolution
+    };
+
+    // 指标编号：1-255为SMART属性ID（NVMe使用与ATA对应的ID），记录原始值
+    static const quint16 TemperatureMetric = 0x1000;
+    static const quint16 HealthMetric = 0x1001;
+    // NVMe已用寿命百分比，ATA的177号属性各厂商含义不同，不能与之混用
+    static const quint16 WearMetric = 0x1002;
+
+    // rootPath为空时使用应用数据目录下的smarthistory
+    explicit SmartHistoryStore(const QString &rootPath = QString(), QObject *parent = nullptr);
+    ~SmartHistoryStore();
+
+    // 应用共用的历史库，第一次应在主线程调用
+    static SmartHistoryStore *instance();
+
+    QString rootPath() const { return m_rootPath; }
+
+    // 历史记录中硬盘的标识
+    static QString diskKey(const DiskInfo &disk);
+    // DeviceDataCache的设备键对应的历史标识，不在硬盘清单中时使用设备路径
+    static QString diskKeyForDevice(const QString &deviceKey);
+
+    // 记录DeviceDataCache读取到的所有SMART数据，并定时读取清单中的每块硬盘
+    void startRecording();
+
+    // 记录一次SMART读取结果，模拟数据不记录
+    void record(const QString &diskKey, const SmartData *data, const QDateTime &time = QDateTime::currentDateTimeUtc());
+
+    // 按时间范围查询，结果按时间升序
+    QVector<HistoryPoint> query(const QString &diskKey, quint16 metric, const QDateTime &from, const QDateTime &to,
+                                Resolution resolution = AutoResolution) const;
+
+    // 有历史记录的硬盘
+    QStringList disks() const;
+
+    // 立即在后台压缩一次
+    void compactNow();
+
+signals:
+    // 新样本已写入历史，在主线程发出；值不变的属性已按心跳间隔去重
+    void samplesRecorded(const QString &diskKey, const QList<HistorySample> &samples);
+    void historyFailed(const QString &message);
+
+private slots:
+    void onSmartDataUpdated(const QString &deviceKey);
+    void sampleAllDisks();
+
+private:
+    QString m_rootPath;
+    mutable QReadWriteLock m_lock;
+    QThread *m_writerThread;
+    SmartHistoryWriter *m_writer;
+    QTimer *m_sampleTimer;
+};
+
+#endif // SMARTHISTORYSTORE_H
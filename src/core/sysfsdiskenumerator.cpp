@@ -0,0 +1,259 @@
+#include "sysfsdiskenumerator.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace {
+// sysfs中的size按512字节扇区计数，与设备的逻辑块大小无关
+const qint64 kSysfsSectorSize = 512;
+// SCSI外围设备类型：5为光驱
+const int kScsiTypeCdrom = 5;
+// 原生NVMe多路径的命名空间挂在虚拟的子系统设备下，但它们是真实的硬盘
+const QString kNvmeSubsystemPath("/devices/virtual/nvme-subsystem/");
+
+bool naturalLess(const SysfsDiskInfo &a, const SysfsDiskInfo &b)
+{
+    // sdz排在sdaa之前，nvme2n1排在nvme10n1之前
+    if (a.name.length() != b.name.length()) {
+        return a.name.length() < b.name.length();
+    }
+    return a.name < b.name;
+}
+}
+
+SysfsDiskEnumerator::SysfsDiskEnumerator(const QString &sysfsRoot) : m_root(sysfsRoot)
+{
+}
+
+bool SysfsDiskEnumerator::isVirtualDevicePath(const QString &canonicalPath)
+{
+    // 回环、ram、zram、dm、md等都挂在/sys/devices/virtual下
+    return canonicalPath.contains("/devices/virtual/") && !canonicalPath.contains(kNvmeSubsystemPath);
+}
+
+bool SysfsDiskEnumerator::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return QFileInfo::exists("/sys/block");
+#else
+    return false;
+#endif
+}
+
+QList<SysfsDiskInfo> SysfsDiskEnumerator::enumerate() const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<SysfsDiskInfo> disks;
+    const QStringList names = QDir(m_root + "/block").entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System);
+    for (const QString &name : names) {
+        SysfsDiskInfo info;
+        if (readDisk(name, info)) {
+            disks.append(info);
+        }
+    }
+    std::sort(disks.begin(), disks.end(), naturalLess);
+
+    qDebug() << "sysfs枚举到" << disks.size() << "个硬盘，耗时" << timer.nsecsElapsed() / 1000 << "微秒";
+    return disks;
+}
+
+bool SysfsDiskEnumerator::readDisk(const QString &name, SysfsDiskInfo &info) const
+{
+    info = SysfsDiskInfo();
+    info.name = name.startsWith("/dev/") ? name.mid(5) : name;
+    const QString block = "block/" + info.name;
+
+    QFileInfo blockInfo(m_root + "/" + block);
+    if (!blockInfo.exists()) {
+        return false;
+    }
+    const QString devicePath = blockInfo.canonicalFilePath();
+    if (isVirtualDevicePath(devicePath)) {
+        return false;
+    }
+    // 多路径下每条路径还有一个隐藏的nvmeXcYnZ节点，不能单独打开，只保留子系统下的nvmeXnY
+    if (readAttribute(block + "/hidden") == "1") {
+        return false;
+    }
+    if (info.name.startsWith("sr") || info.name.startsWith("fd")
+        || readAttribute(block + "/device/type").toInt() == kScsiTypeCdrom) {
+        return false;
+    }
+
+    info.sizeBytes = readAttribute(block + "/size").toLongLong() * kSysfsSectorSize;
+    if (info.sizeBytes <= 0) {
+        // 没有插卡的读卡器等
+        return false;
+    }
+
+    info.devicePath = "/dev/" + info.name;
+    info.logicalBlockSize = qMax(512, readAttribute(block + "/queue/logical_block_size").toInt());
+    info.physicalBlockSize = qMax(info.logicalBlockSize, readAttribute(block + "/queue/physical_block_size").toInt());
+    info.rotational = readAttribute(block + "/queue/rotational") == "1";
+    info.removable = readAttribute(block + "/removable") == "1";
+
+    static const QRegularExpression nvmeNameRe("^(nvme\\d+)n\\d+$");
+    QRegularExpressionMatch nvmeMatch = nvmeNameRe.match(info.name);
+    if (nvmeMatch.hasMatch()) {
+        info.transport = "nvme";
+        info.diskType = DiskType::NVMe;
+        // 开启原生多路径时nvmeXnY的X是子系统编号而不是控制器编号，控制器要从子系统目录中找
+        info.controller = devicePath.contains(kNvmeSubsystemPath) ? nvmeSubsystemController(devicePath)
+                                                                 : nvmeMatch.captured(1);
+        // 命名空间的device指向控制器（开启原生多路径时指向子系统），两者都有这些属性
+        const QString controller = "class/nvme/" + info.controller;
+        info.model = readAttribute(block + "/device/model");
+        if (info.model.isEmpty()) {
+            info.model = readAttribute(controller + "/model");
+        }
+        info.serialNumber = readAttribute(block + "/device/serial");
+        if (info.serialNumber.isEmpty()) {
+            info.serialNumber = readAttribute(controller + "/serial");
+        }
+        info.firmwareVersion = readAttribute(block + "/device/firmware_rev");
+        if (info.firmwareVersion.isEmpty()) {
+            info.firmwareVersion = readAttribute(controller + "/firmware_rev");
+        }
+        info.wwid = readAttribute(block + "/wwid");
+    } else {
+        static const QRegularExpression ataPortRe("/ata\\d+/");
+        if (devicePath.contains("/usb")) {
+            info.transport = "usb";
+            // USB硬盘盒大多支持SAT，按SATA读取SMART
+            info.diskType = DiskType::SATA;
+        } else if (devicePath.contains(ataPortRe)) {
+            info.transport = "sata";
+            info.diskType = DiskType::SATA;
+        } else if (devicePath.contains("/virtio")) {
+            info.transport = "virtio";
+        } else if (info.name.startsWith("mmcblk")) {
+            info.transport = "mmc";
+        } else {
+            info.transport = "scsi";
+        }
+
+        info.model = readAttribute(block + "/device/model");
+        if (info.model.isEmpty()) {
+            info.model = readAttribute(block + "/device/name");     // mmc
+        }
+        info.vendor = readAttribute(block + "/device/vendor");
+        info.firmwareVersion = readAttribute(block + "/device/rev");
+        info.serialNumber = readVpdSerial(block + "/device/vpd_pg80");
+        if (info.serialNumber.isEmpty()) {
+            info.serialNumber = readAttribute(block + "/device/serial");    // mmc
+        }
+        if (info.serialNumber.isEmpty()) {
+            info.serialNumber = readAttribute(block + "/serial");           // virtio
+        }
+        info.wwid = readAttribute(block + "/device/wwid");
+    }
+
+    // 分区是设备目录下带partition文件的子目录
+    const QStringList entries = QDir(m_root + "/" + block).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        if (entry.startsWith(info.name) && QFileInfo::exists(m_root + "/" + block + "/" + entry + "/partition")) {
+            info.partitions.append(entry);
+        }
+    }
+
+    info.linkSpeed = detectLinkSpeed(info, devicePath);
+    return true;
+}
+
+QString SysfsDiskEnumerator::detectLinkSpeed(const SysfsDiskInfo &disk, const QString &devicePath) const
+{
+    if (disk.transport == "nvme" && !disk.controller.isEmpty()) {
+        const QString pci = "class/nvme/" + disk.controller + "/device/";
+        QString speed = readAttribute(pci + "current_link_speed");     // 如"8.0 GT/s PCIe"
+        QString width = readAttribute(pci + "current_link_width");
+        if (!speed.isEmpty()) {
+            return width.isEmpty() ? speed : QString("%1 x%2").arg(speed, width);
+        }
+    } else if (disk.transport == "sata") {
+        static const QRegularExpression ataPortRe("/ata(\\d+)/");
+        QRegularExpressionMatch match = ataPortRe.match(devicePath);
+        if (match.hasMatch()) {
+            return readAttribute(QString("class/ata_link/link%1/sata_spd").arg(match.captured(1)));
+        }
+    }
+    return QString();
+}
+
+QString SysfsDiskEnumerator::nvmeSubsystemController(const QString &devicePath) const
+{
+    // /sys/devices/virtual/nvme-subsystem/nvme-subsys0/nvme0n1的上级目录里，
+    // nvme0、nvme1等链接指向该子系统的各个控制器，优先取状态为live的
+    static const QRegularExpression controllerRe("^nvme\\d+$");
+    const QString subsystem = devicePath.section('/', 0, -2);
+    QStringList controllers = QDir(subsystem).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System)
+                              .filter(controllerRe);
+    std::sort(controllers.begin(), controllers.end(), [](const QString &a, const QString &b) {
+        return a.length() != b.length() ? a.length() < b.length() : a < b;
+    });
+    for (const QString &controller : controllers) {
+        QFile state(subsystem + "/" + controller + "/state");
+        if (state.open(QIODevice::ReadOnly) && state.readAll().trimmed() == "live") {
+            return controller;
+        }
+    }
+    return controllers.isEmpty() ? QString() : controllers.first();
+}
+
+QString SysfsDiskEnumerator::readAttribute(const QString &relativePath) const
+{
+    QFile file(m_root + "/" + relativePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromUtf8(file.read(4096)).trimmed();
+}
+
+QString SysfsDiskEnumerator::readVpdSerial(const QString &relativePath) const
+{
+    // Unit Serial Number页：4字节页头，第2-3字节为长度，之后是ASCII序列号
+    QFile file(m_root + "/" + relativePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QByteArray page = file.read(256);
+    if (page.size() < 4 || static_cast<quint8>(page[1]) != 0x80) {
+        return QString();
+    }
+    const int length = (static_cast<quint8>(page[2]) << 8) | static_cast<quint8>(page[3]);
+    return QString::fromLatin1(page.mid(4, length)).trimmed();
+}
+
+DiskInfo SysfsDiskEnumerator::toDiskInfo(const SysfsDiskInfo &disk, int index)
+{
+    DiskInfo info;
+    info.index = index;
+    info.diskPath = disk.devicePath;
+    // libata把厂商字段固定为"ATA"，没有意义
+    const bool hasVendor = !disk.vendor.isEmpty() && disk.vendor != "ATA";
+    info.model = hasVendor && !disk.model.startsWith(disk.vendor) ? disk.vendor + " " + disk.model : disk.model;
+    if (info.model.isEmpty()) {
+        info.model = disk.name;
+    }
+    info.diskName = info.model;
+    info.manufacturer = hasVendor ? disk.vendor : QString();
+    info.serialNumber = disk.serialNumber;
+    info.firmwareVersion = disk.firmwareVersion;
+
+    if (disk.transport == "usb") {
+        info.type = "USB";
+    } else {
+        info.type = disk.rotational ? "HDD" : "SSD";
+    }
+    QString bus = disk.transport == "nvme" ? "NVMe" : disk.transport.toUpper();
+    info.interfaceSpeed = disk.linkSpeed.isEmpty() ? bus : QString("%1 %2").arg(bus, disk.linkSpeed);
+
+    info.diskSize = disk.sizeBytes;
+    info.sectorSize = disk.logicalBlockSize;
+    return info;
+}
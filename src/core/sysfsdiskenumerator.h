@@ -0,0 +1,70 @@
+#ifndef SYSFSDISKENUMERATOR_H
+#define SYSFSDISKENUMERATOR_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "smartdata.h"
+#include "diskutils.h"
+
+// /sys/block中一块硬盘的信息
+struct SysfsDiskInfo {
+    QString name;               // 内核设备名，如sda、nvme0n1
+    QString devicePath;         // /dev/sda
+    DiskType diskType;          // 由总线判断，不再按磁盘序号猜测
+    QString transport;          // nvme/sata/usb/virtio/mmc/scsi
+    QString model;
+    QString vendor;             // SCSI厂商字段，SATA硬盘经libata时固定为"ATA"
+    QString serialNumber;
+    QString firmwareVersion;
+    QString wwid;               // 全局唯一标识，设备改名后仍可用来识别同一块硬盘
+    QString controller;         // NVMe控制器名，如nvme0
+    QString linkSpeed;          // 接口速率，如"6.0 Gbps"、"8.0 GT/s PCIe x4"
+    qint64 sizeBytes;
+    int logicalBlockSize;
+    int physicalBlockSize;
+    bool rotational;            // 机械硬盘
+    bool removable;
+    QStringList partitions;     // 分区设备名，如sda1、nvme0n1p2
+
+    SysfsDiskInfo() : diskType(DiskType::Unknown), sizeBytes(0), logicalBlockSize(512), physicalBlockSize(512),
+                      rotational(false), removable(false) {}
+};
+
+// 通过sysfs枚举Linux上的物理硬盘
+// 只读取/sys/block和/sys/class/nvme下的小文件，不启动任何子进程，枚举全部硬盘只需几毫秒。
+// 回环、ramdisk、dm等虚拟设备(/sys/devices/virtual)和光驱不在结果中；
+// 原生NVMe多路径的命名空间虽然挂在/sys/devices/virtual/nvme-subsystem下，仍按物理硬盘处理，
+// 每条路径对应的隐藏节点nvmeXcYnZ不在结果中。
+// sysfs根目录可以指定，用录制的目录树测试时不需要真实硬件。
+class SysfsDiskEnumerator
+{
+public:
+    explicit SysfsDiskEnumerator(const QString &sysfsRoot = QString("/sys"));
+
+    // 所有物理硬盘，按设备名排序（sda..sdz, sdaa..; nvme0n1, nvme1n1..）
+    QList<SysfsDiskInfo> enumerate() const;
+
+    // 读取一块硬盘，name可以是sda或/dev/sda
+    bool readDisk(const QString &name, SysfsDiskInfo &info) const;
+
+    // 规范化后的sysfs设备路径是否属于虚拟设备，热插拔和卷解析也用它过滤
+    static bool isVirtualDevicePath(const QString &canonicalPath);
+
+    // 当前系统是否有可用的sysfs
+    static bool isSupported();
+
+    // 转换为界面使用的磁盘信息
+    static DiskInfo toDiskInfo(const SysfsDiskInfo &disk, int index);
+
+private:
+    QString readAttribute(const QString &relativePath) const;
+    QString readVpdSerial(const QString &relativePath) const;
+    QString nvmeSubsystemController(const QString &devicePath) const;
+    QString detectLinkSpeed(const SysfsDiskInfo &disk, const QString &devicePath) const;
+
+    QString m_root;
+};
+
+#endif // SYSFSDISKENUMERATOR_H
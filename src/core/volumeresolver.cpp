@@ -0,0 +1,411 @@
+#include "volumeresolver.h"
+#include "sysfsdiskenumerator.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSocketNotifier>
+#include <QStorageInfo>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <winioctl.h>
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+const char *const kSysClassBlock = "/sys/class/block/";
+// dm套dm、md上建LVM等的嵌套层数上限，防止异常的sysfs链接造成死循环
+const int kMaxStackDepth = 16;
+
+QString canonicalName(const QString &path)
+{
+    return QFileInfo(path).canonicalFilePath().section('/', -1);
+}
+
+bool isPartition(const QString &name)
+{
+    return QFileInfo::exists(kSysClassBlock + name + "/partition");
+}
+
+QString partitionParent(const QString &name)
+{
+    // /sys/class/block/sda1 -> /sys/devices/.../block/sda/sda1
+    return QFileInfo(kSysClassBlock + name).canonicalFilePath().section('/', -2, -2);
+}
+
+bool isVirtualDevice(const QString &name)
+{
+    return SysfsDiskEnumerator::isVirtualDevicePath(QFileInfo(kSysClassBlock + name).canonicalFilePath());
+}
+
+QStringList blockLinks(const QString &name, const char *directory)
+{
+    return QDir(kSysClassBlock + name + "/" + directory)
+           .entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot);
+}
+
+QStringList partitionsOf(const QString &disk)
+{
+    QStringList partitions;
+    const QStringList entries = QDir(kSysClassBlock + disk).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        if (entry.startsWith(disk) && isPartition(entry)) {
+            partitions.append(entry);
+        }
+    }
+    return partitions;
+}
+
+// 向上收集使用该设备的dm、md设备
+void collectHolders(const QString &name, QStringList &stack, int depth)
+{
+    if (depth > kMaxStackDepth) {
+        return;
+    }
+    const QStringList holders = blockLinks(name, "holders");
+    for (const QString &holder : holders) {
+        if (!stack.contains(holder)) {
+            stack.append(holder);
+            collectHolders(holder, stack, depth + 1);
+        }
+    }
+}
+
+// 向下沿slaves找到底层物理硬盘，holders索引中没有的设备才会用到
+QStringList disksBySlaves(const QString &name, int depth)
+{
+    if (depth > kMaxStackDepth) {
+        return QStringList();
+    }
+    if (isPartition(name)) {
+        return disksBySlaves(partitionParent(name), depth + 1);
+    }
+
+    const QStringList slaves = blockLinks(name, "slaves");
+    if (slaves.isEmpty()) {
+        // 回环、zram等没有底层硬盘
+        return isVirtualDevice(name) ? QStringList() : QStringList("/dev/" + name);
+    }
+    QStringList disks;
+    for (const QString &slave : slaves) {
+        for (const QString &disk : disksBySlaves(slave, depth + 1)) {
+            if (!disks.contains(disk)) {
+                disks.append(disk);
+            }
+        }
+    }
+    return disks;
+}
+
+QString unescapeMountField(const QByteArray &field)
+{
+    // mountinfo中的空格、制表符、换行和反斜杠写成\040这样的八进制转义
+    QByteArray result;
+    result.reserve(field.size());
+    for (int i = 0; i < field.size(); i++) {
+        if (field[i] == '\\' && i + 3 < field.size()) {
+            bool ok = false;
+            const int value = field.mid(i + 1, 3).toInt(&ok, 8);
+            if (ok) {
+                result.append(static_cast<char>(value));
+                i += 3;
+                continue;
+            }
+        }
+        result.append(field[i]);
+    }
+    return QString::fromLocal8Bit(result);
+}
+
+QString mountBlockDevice(const QByteArray &majorMinor, const QString &source)
+{
+    QString name;
+    if (!majorMinor.startsWith("0:")) {
+        name = canonicalName("/sys/dev/block/" + QString::fromLatin1(majorMinor));
+    }
+    // btrfs等报告匿名设备号0:N，改用挂载源；/dev/mapper下的名字是指向dm-N的链接
+    if (name.isEmpty() && source.startsWith("/dev/")) {
+        const QString device = QFileInfo(source).canonicalFilePath();
+        if (device.startsWith("/dev/")) {
+            name = device.mid(5);
+        }
+    }
+    return name;
+}
+#endif
+
+#ifdef Q_OS_WIN
+// 跨盘的动态卷、存储空间最多记录的区段数
+const int kMaxDiskExtents = 32;
+
+QStringList volumeDiskExtents(const QString &device)
+{
+    // 卷设备名形如\\?\Volume{GUID}\，去掉末尾的反斜杠才能打开卷本身；查询区段不需要读写权限
+    QString volumeName = device;
+    if (volumeName.endsWith('\\')) {
+        volumeName.chop(1);
+    }
+    HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t *>(volumeName.utf16()), 0,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return QStringList();
+    }
+
+    QStringList disks;
+    QByteArray buffer(sizeof(VOLUME_DISK_EXTENTS) + kMaxDiskExtents * sizeof(DISK_EXTENT), 0);
+    DWORD returned = 0;
+    if (DeviceIoControl(handle, IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS, nullptr, 0,
+                        buffer.data(), static_cast<DWORD>(buffer.size()), &returned, nullptr)) {
+        const VOLUME_DISK_EXTENTS *extents = reinterpret_cast<const VOLUME_DISK_EXTENTS *>(buffer.constData());
+        for (DWORD i = 0; i < extents->NumberOfDiskExtents && i <= static_cast<DWORD>(kMaxDiskExtents); i++) {
+            const QString disk = QString("\\\\.\\PhysicalDrive%1").arg(extents->Extents[i].DiskNumber);
+            if (!disks.contains(disk)) {
+                disks.append(disk);
+            }
+        }
+    }
+    CloseHandle(handle);
+    return disks;
+}
+#endif
+}
+
+VolumeResolver::VolumeResolver(QObject *parent) : QObject(parent),
+    m_mountInfoFd(-1),
+    m_mountNotifier(nullptr)
+{
+#ifdef Q_OS_LINUX
+    // 挂载表变化时内核对打开的mountinfo报告POLLPRI，不需要定时重新读取
+    m_mountInfoFd = ::open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+    if (m_mountInfoFd >= 0) {
+        m_mountNotifier = new QSocketNotifier(m_mountInfoFd, QSocketNotifier::Exception, this);
+        // activated在Qt 5.15中有两个带私有参数的重载，只能用字符串形式连接
+        connect(m_mountNotifier, SIGNAL(activated(int)), this, SLOT(onMountTableChanged()));
+    }
+#endif
+}
+
+VolumeResolver::~VolumeResolver()
+{
+#ifdef Q_OS_LINUX
+    if (m_mountInfoFd >= 0) {
+        ::close(m_mountInfoFd);
+    }
+#endif
+}
+
+VolumeResolver *VolumeResolver::instance()
+{
+    static VolumeResolver *resolver = new VolumeResolver(QCoreApplication::instance());
+    return resolver;
+}
+
+QStringList VolumeResolver::disksForVolume(const QString &path) const
+{
+    return volumeForPath(path).disks;
+}
+
+QString VolumeResolver::diskForVolume(const QString &path) const
+{
+    const QStringList disks = disksForVolume(path);
+    return disks.isEmpty() ? QString() : disks.first();
+}
+
+MountedVolume VolumeResolver::volumeForPath(const QString &path) const
+{
+    QSharedPointer<const Graph> snapshot = graph();
+    const int index = findVolume(*snapshot, path);
+    return index >= 0 ? snapshot->volumes[index] : MountedVolume();
+}
+
+MountedVolume VolumeResolver::volumeForRoot(const QString &rootPath) const
+{
+    QSharedPointer<const Graph> snapshot = graph();
+    const int index = snapshot->volumeByRoot.value(normalizeRoot(rootPath), -1);
+    return index >= 0 ? snapshot->volumes[index] : MountedVolume();
+}
+
+QList<MountedVolume> VolumeResolver::volumesOnDisk(const QString &diskPath) const
+{
+    QSharedPointer<const Graph> snapshot = graph();
+    QList<MountedVolume> volumes;
+    const QList<int> indexes = snapshot->volumesByDisk.value(diskPath);
+    for (int index : indexes) {
+        volumes.append(snapshot->volumes[index]);
+    }
+    return volumes;
+}
+
+QStringList VolumeResolver::stackedDevices(const QString &diskPath) const
+{
+    return graph()->stackedByDisk.value(diskPath);
+}
+
+void VolumeResolver::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_graph.reset();
+}
+
+void VolumeResolver::onMountTableChanged()
+{
+    qDebug() << "挂载表已变化，卷索引失效";
+    invalidate();
+    emit mountsChanged();
+}
+
+QSharedPointer<const VolumeResolver::Graph> VolumeResolver::graph() const
+{
+    // 在锁内建立，多个线程同时查询时只建立一次
+    QMutexLocker locker(&m_mutex);
+    if (!m_graph) {
+        m_graph = buildGraph();
+    }
+    return m_graph;
+}
+
+QSharedPointer<const VolumeResolver::Graph> VolumeResolver::buildGraph()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QSharedPointer<Graph> graph(new Graph);
+    QList<MountedVolume> mounts;
+    QHash<QString, int> mountByRoot;
+
+#ifdef Q_OS_LINUX
+    // holders方向：每块物理硬盘之上的分区、dm、md设备，反过来得到设备所在的硬盘
+    QHash<QString, QStringList> disksByDevice;
+    const QStringList disks = QDir("/sys/block").entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot);
+    for (const QString &disk : disks) {
+        if (isVirtualDevice(disk)) {
+            continue;
+        }
+        const QString diskPath = "/dev/" + disk;
+        QStringList stack;
+        for (const QString &partition : partitionsOf(disk)) {
+            stack.append(partition);
+            collectHolders(partition, stack, 1);
+        }
+        collectHolders(disk, stack, 1);
+        graph->stackedByDisk.insert(diskPath, stack);
+
+        disksByDevice[disk].append(diskPath);
+        for (const QString &device : stack) {
+            QStringList &owners = disksByDevice[device];
+            if (!owners.contains(diskPath)) {
+                owners.append(diskPath);
+            }
+        }
+    }
+
+    // 挂载表，格式见proc(5)：ID 父ID 主:次 根 挂载点 选项 [可选字段...] - 类型 来源 超级块选项
+    QFile file("/proc/self/mountinfo");
+    if (file.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        for (const QByteArray &line : lines) {
+            const QList<QByteArray> fields = line.split(' ');
+            const int separator = fields.indexOf(QByteArray("-"), 6);
+            if (fields.size() < 10 || separator < 0 || separator + 2 >= fields.size()) {
+                continue;
+            }
+
+            MountedVolume volume;
+            volume.rootPath = unescapeMountField(fields[4]);
+            volume.fileSystem = QString::fromLatin1(fields[separator + 1]);
+            volume.source = unescapeMountField(fields[separator + 2]);
+            volume.blockDevice = mountBlockDevice(fields[2], volume.source);
+            if (volume.blockDevice.isEmpty()) {
+                continue;       // proc、tmpfs、网络文件系统等
+            }
+            volume.disks = disksByDevice.value(volume.blockDevice);
+            if (volume.disks.isEmpty()) {
+                volume.disks = disksBySlaves(volume.blockDevice, 0);
+            }
+            if (volume.disks.isEmpty()) {
+                continue;       // 回环、zram等
+            }
+
+            // 后挂载的覆盖同一挂载点上之前的挂载
+            auto it = mountByRoot.constFind(volume.rootPath);
+            if (it != mountByRoot.constEnd()) {
+                mounts[it.value()] = volume;
+            } else {
+                mountByRoot.insert(volume.rootPath, mounts.size());
+                mounts.append(volume);
+            }
+        }
+    }
+#elif defined(Q_OS_WIN)
+    foreach (const QStorageInfo &storage, QStorageInfo::mountedVolumes()) {
+        if (!storage.isValid()) {
+            continue;
+        }
+        MountedVolume volume;
+        volume.rootPath = normalizeRoot(storage.rootPath());
+        volume.fileSystem = QString(storage.fileSystemType());
+        volume.source = QString::fromLocal8Bit(storage.device());
+        volume.blockDevice = volume.source;
+        volume.disks = volumeDiskExtents(volume.source);
+        if (volume.disks.isEmpty() || mountByRoot.contains(volume.rootPath)) {
+            continue;
+        }
+        mountByRoot.insert(volume.rootPath, mounts.size());
+        mounts.append(volume);
+    }
+#endif
+
+    graph->volumes = mounts;
+    for (int i = 0; i < mounts.size(); i++) {
+        graph->volumeByRoot.insert(normalizeRoot(mounts[i].rootPath), i);
+        for (const QString &disk : mounts[i].disks) {
+            graph->volumesByDisk[disk].append(i);
+        }
+    }
+
+    qDebug() << "卷索引建立完成，卷数量:" << mounts.size() << "，耗时" << timer.nsecsElapsed() / 1000 << "微秒";
+    return graph;
+}
+
+QString VolumeResolver::normalizeRoot(const QString &path)
+{
+    QString root = QDir::cleanPath(QDir::fromNativeSeparators(path));
+    // 盘符统一为"C:/"
+    if (root.size() >= 2 && root[1] == ':') {
+        root[0] = root[0].toUpper();
+        if (root.size() == 2) {
+            root += '/';
+        }
+    }
+    return root;
+}
+
+int VolumeResolver::findVolume(const Graph &graph, const QString &path)
+{
+    // 从路径本身开始逐级向上查找挂载点，每级一次哈希查找
+    QString current = normalizeRoot(path);
+    while (!current.isEmpty()) {
+        auto it = graph.volumeByRoot.constFind(current);
+        if (it != graph.volumeByRoot.constEnd()) {
+            return it.value();
+        }
+        const int slash = current.lastIndexOf('/');
+        if (slash < 0 || current == "/" || (current.size() == 3 && current.endsWith(":/"))) {
+            break;
+        }
+        current = slash == 0 ? QString("/") : current.left(slash);
+        if (current.size() == 2 && current[1] == ':') {
+            current += '/';
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,86 @@
+#ifndef VOLUMERESOLVER_H
+#define VOLUMERESOLVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+class QSocketNotifier;
+
+// 一个已挂载的卷
+struct MountedVolume {
+    QString rootPath;           // 挂载点，如"/home"、"C:/"
+    QString source;             // 挂载源，如/dev/mapper/vg-home
+    QString blockDevice;        // 内核块设备名，如dm-2、sda1、md0
+    QString fileSystem;
+    QStringList disks;          // 所在的物理硬盘，如/dev/sda；md、跨盘LVM时有多块
+};
+
+// 卷与物理硬盘之间的精确对应关系
+// Linux上解析/proc/self/mountinfo得到每个挂载点的块设备，再沿/sys/class/block的分区、
+// holders和slaves关系穿过dm-crypt、LVM、md RAID找到底层硬盘；Windows上对每个卷
+// 查询IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS。
+// 结果建成以挂载点、块设备和硬盘为键的索引，查询不再枚举硬盘。索引在第一次查询时建立，
+// 挂载表变化(mountinfo可poll)或收到块设备uevent后失效，下次查询时重建。
+// 查询方法可以在任意线程调用，instance()第一次应在主线程调用。
+class VolumeResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    static VolumeResolver *instance();
+
+    // 路径所在卷的物理硬盘，路径可以是挂载点或其中的任意文件，也可以是"C:"这样的盘符
+    QStringList disksForVolume(const QString &path) const;
+    QString diskForVolume(const QString &path) const;
+
+    // 路径所在的卷，不在任何已知卷上时rootPath为空
+    MountedVolume volumeForPath(const QString &path) const;
+    // 以rootPath为挂载点的卷，不向上级目录查找，索引中没有时rootPath为空
+    MountedVolume volumeForRoot(const QString &rootPath) const;
+
+    // 硬盘上挂载的所有卷，包括经过LVM/加密/RAID间接挂载的卷
+    QList<MountedVolume> volumesOnDisk(const QString &diskPath) const;
+
+    // 建立在硬盘之上的块设备：分区以及经holders找到的dm、md设备
+    QStringList stackedDevices(const QString &diskPath) const;
+
+    // 丢弃索引，下次查询时重建
+    void invalidate();
+
+signals:
+    // 挂载表发生变化，索引已失效
+    void mountsChanged();
+
+private slots:
+    void onMountTableChanged();
+
+private:
+    explicit VolumeResolver(QObject *parent = nullptr);
+    ~VolumeResolver();
+
+    // 一次建立的索引，建立后只读，查询线程持有快照
+    struct Graph {
+        QList<MountedVolume> volumes;
+        QHash<QString, int> volumeByRoot;               // 挂载点 -> volumes下标
+        QHash<QString, QList<int>> volumesByDisk;       // 硬盘 -> volumes下标
+        QHash<QString, QStringList> stackedByDisk;      // 硬盘 -> 其上的块设备
+    };
+
+    QSharedPointer<const Graph> graph() const;
+    static QSharedPointer<const Graph> buildGraph();
+    static QString normalizeRoot(const QString &path);
+    static int findVolume(const Graph &graph, const QString &path);
+
+    mutable QMutex m_mutex;
+    mutable QSharedPointer<const Graph> m_graph;
+
+    int m_mountInfoFd;                  // 用于等待挂载表变化，-1表示不支持
+    QSocketNotifier *m_mountNotifier;
+};
+
+#endif // VOLUMERESOLVER_H
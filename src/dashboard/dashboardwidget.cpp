@@ -39,10 +39,16 @@ DashboardWidget::DashboardWidget(QWidget *parent) :
     m_temperatureValueLabel(nullptr),
     m_startStopLabel(nullptr),
     m_startStopValueLabel(nullptr),
+    m_predictionLabel(nullptr),
+    m_predictionValueLabel(nullptr),
     m_warningLabel(nullptr),
     m_refreshTimer(nullptr),
     m_currentDiskIndex(-1),
-    m_smartData(nullptr)
+    m_currentTemperature(-1),
+    m_usagePercent(0.0),
+    m_generation(0),
+    m_pendingGeneration(0),
+    m_snapshotPending(false)
 {
     qDebug() << "DashboardWidget构造函数开始初始化...";
     
@@ -50,9 +56,8 @@ DashboardWidget::DashboardWidget(QWidget *parent) :
     
     // 使用单次定时器延迟加载磁盘列表，先让UI显示出来
     QTimer::singleShot(500, this, [this]() {
-        qDebug() << "开始刷新磁盘列表...";
-        refreshDiskList();
-        qDebug() << "磁盘列表刷新完成，磁盘数量:" << m_diskList.size();
+        qDebug() << "开始加载磁盘列表...";
+        applyDiskList(DiskInventory::instance()->disks());
     });
     
     // 设置定时刷新
@@ -60,6 +65,19 @@ DashboardWidget::DashboardWidget(QWidget *parent) :
     connect(m_refreshTimer, &QTimer::timeout, this, &DashboardWidget::onTimerTimeout);
     m_refreshTimer->start(5000); // 5秒刷新一次
     
+    // 其他界面读取了同一块硬盘的SMART数据时直接使用
+    connect(DeviceDataCache::instance(), &DeviceDataCache::smartDataUpdated,
+            this, &DashboardWidget::onSmartDataUpdated);
+    
+    // 硬盘插拔时增量更新下拉框，不重新枚举
+    DiskInventory *inventory = DiskInventory::instance();
+    connect(inventory, &DiskInventory::diskAdded, this, &DashboardWidget::onDiskAdded);
+    connect(inventory, &DiskInventory::diskRemoved, this, &DashboardWidget::onDiskRemoved);
+    connect(inventory, &DiskInventory::diskChanged, this, &DashboardWidget::onDiskChanged);
+    
+    connect(FailurePredictor::instance(), &FailurePredictor::predictionUpdated,
+            this, &DashboardWidget::onPredictionUpdated);
+    
     qDebug() << "DashboardWidget构造函数初始化完成";
 }
 
@@ -68,11 +86,6 @@ DashboardWidget::~DashboardWidget()
     if (m_refreshTimer) {
         m_refreshTimer->stop();
     }
-    
-    if (m_smartData) {
-        delete m_smartData;
-        m_smartData = nullptr;
-    }
 }
 
 void DashboardWidget::setupUI()
@@ -120,6 +133,8 @@ void DashboardWidget::setupUI()
     m_powerOnHoursValueLabel = new QLabel("N/A", this);
     m_startStopLabel = new QLabel("启动次数:", this);
     m_startStopValueLabel = new QLabel("N/A", this);
+    m_predictionLabel = new QLabel("故障预测:", this);
+    m_predictionValueLabel = new QLabel("N/A", this);
     m_warningLabel = new QLabel("", this);
     m_warningLabel->setStyleSheet("color: #FFA500;"); // 橙色警告
     
@@ -139,7 +154,9 @@ void DashboardWidget::setupUI()
     infoGridLayout->addWidget(m_startStopValueLabel, 3, 1);
     infoGridLayout->addWidget(m_healthLabel, 3, 2);
     infoGridLayout->addWidget(m_healthProgressBar, 3, 3);
-    infoGridLayout->addWidget(m_warningLabel, 4, 0, 1, 4);
+    infoGridLayout->addWidget(m_predictionLabel, 4, 0);
+    infoGridLayout->addWidget(m_predictionValueLabel, 4, 1, 1, 3);
+    infoGridLayout->addWidget(m_warningLabel, 5, 0, 1, 4);
     
     infoGridLayout->setColumnStretch(1, 1);
     infoGridLayout->setColumnStretch(3, 1);
@@ -167,7 +184,7 @@ void DashboardWidget::setupUI()
     connect(m_refreshButton, &QPushButton::clicked, this, &DashboardWidget::onRefreshClicked);
 }
 
-void DashboardWidget::refreshDiskList()
+void DashboardWidget::applyDiskList(const QList<DiskInfo> &disks)
 {
     // 保存当前选择
     QString currentDiskPath;
@@ -175,39 +192,134 @@ void DashboardWidget::refreshDiskList()
         currentDiskPath = m_diskList[m_currentDiskIndex].diskPath;
     }
     
-    // 清除旧数据
-    m_diskComboBox->clear();
-    m_diskList.clear();
+    m_diskList = disks;
     
-    // 获取硬盘列表
-    m_diskList = DiskUtils::getAllDisks();
-    
-    // 填充下拉框
+    // 填充下拉框，期间不触发选择变化
     int index = 0;
     int newSelectedIndex = -1;
-    
-    for (const DiskInfo &disk : m_diskList) {
-        QString displayText = QString("%1 (%2) - %3")
-                            .arg(disk.model)
-                            .arg(disk.diskPath)
-                            .arg(DiskUtils::formatSize(disk.diskSize));
-        m_diskComboBox->addItem(displayText);
-        
-        // 检查是否为之前选择的磁盘
-        if (disk.diskPath == currentDiskPath) {
-            newSelectedIndex = index;
+    {
+        QSignalBlocker blocker(m_diskComboBox);
+        m_diskComboBox->clear();
+        for (const DiskInfo &disk : m_diskList) {
+            m_diskComboBox->addItem(diskDisplayText(disk));
+            
+            // 检查是否为之前选择的磁盘
+            if (disk.diskPath == currentDiskPath) {
+                newSelectedIndex = index;
+            }
+            
+            index++;
         }
         
-        index++;
+        // 如果找到之前的选择，则还原，否则选择第一个
+        if (newSelectedIndex < 0 && !m_diskList.isEmpty()) {
+            newSelectedIndex = 0;
+        }
+        m_diskComboBox->setCurrentIndex(newSelectedIndex);
     }
     
-    // 如果找到之前的选择，则还原
-    if (newSelectedIndex >= 0) {
-        m_diskComboBox->setCurrentIndex(newSelectedIndex);
-    } else if (!m_diskList.isEmpty()) {
-        // 否则选择第一个
-        m_diskComboBox->setCurrentIndex(0);
+    if (newSelectedIndex >= 0 && m_diskList[newSelectedIndex].diskPath == currentDiskPath) {
+        // 还是同一块硬盘，只刷新数据
+        m_currentDiskIndex = newSelectedIndex;
+        ++m_generation;
+        updateDashboard();
+    } else {
+        m_currentDiskIndex = -1;
+        onDiskSelectionChanged(newSelectedIndex);
+    }
+}
+
+void DashboardWidget::onDiskAdded(const DiskInfo &disk)
+{
+    m_diskList.append(disk);
+    {
+        QSignalBlocker blocker(m_diskComboBox);
+        m_diskComboBox->addItem(diskDisplayText(disk));
+    }
+    
+    // 之前没有可显示的硬盘时选中新接入的硬盘
+    if (m_currentDiskIndex < 0) {
+        const int index = m_diskList.size() - 1;
+        {
+            QSignalBlocker blocker(m_diskComboBox);
+            m_diskComboBox->setCurrentIndex(index);
+        }
+        onDiskSelectionChanged(index);
+    }
+}
+
+void DashboardWidget::onDiskRemoved(const DiskInfo &disk)
+{
+    const int index = diskListIndex(disk.diskPath);
+    if (index < 0) {
+        return;
+    }
+    
+    m_diskList.removeAt(index);
+    {
+        QSignalBlocker blocker(m_diskComboBox);
+        m_diskComboBox->removeItem(index);
+    }
+    
+    if (index < m_currentDiskIndex) {
+        m_currentDiskIndex--;
+    } else if (index == m_currentDiskIndex) {
+        // 正在显示的硬盘被拔出，尚未返回的读取结果作废，改为显示第一块硬盘
+        m_currentDiskIndex = -1;
+        ++m_generation;
+        m_smartData.reset();
+        m_currentTemperature = -1;
+        if (!m_diskList.isEmpty()) {
+            {
+                QSignalBlocker blocker(m_diskComboBox);
+                m_diskComboBox->setCurrentIndex(0);
+            }
+            onDiskSelectionChanged(0);
+        }
+    }
+}
+
+void DashboardWidget::onDiskChanged(const DiskInfo &disk)
+{
+    const int index = diskListIndex(disk.diskPath);
+    if (index < 0) {
+        return;
+    }
+    
+    m_diskList[index] = disk;
+    m_diskComboBox->setItemText(index, diskDisplayText(disk));
+    
+    // 分区或挂载变化会影响使用率，重新读取当前硬盘
+    if (index == m_currentDiskIndex) {
+        ++m_generation;
+        updateDashboard();
+    }
+}
+
+void DashboardWidget::onPredictionUpdated(const QString &diskKey)
+{
+    if (m_currentDiskIndex >= 0 && m_currentDiskIndex < m_diskList.size()
+        && SmartHistoryStore::diskKey(m_diskList[m_currentDiskIndex]) == diskKey) {
+        updateInfoLabels();
+    }
+}
+
+int DashboardWidget::diskListIndex(const QString &diskPath) const
+{
+    for (int i = 0; i < m_diskList.size(); i++) {
+        if (m_diskList[i].diskPath == diskPath) {
+            return i;
+        }
     }
+    return -1;
+}
+
+QString DashboardWidget::diskDisplayText(const DiskInfo &disk)
+{
+    return QString("%1 (%2) - %3")
+           .arg(disk.model)
+           .arg(disk.diskPath)
+           .arg(DiskUtils::formatSize(disk.diskSize));
 }
 
 void DashboardWidget::onDiskSelectionChanged(int index)
@@ -218,6 +330,20 @@ void DashboardWidget::onDiskSelectionChanged(int index)
         // 清除温度历史记录，确保切换硬盘后不显示上一个硬盘的温度历史
         m_temperatureHistory.clear();
         
+        // 用最近一小时记录的温度填充曲线，不必从空白开始
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        const QVector<HistoryPoint> history = SmartHistoryStore::instance()->query(
+            SmartHistoryStore::diskKey(m_diskList[index]), SmartHistoryStore::TemperatureMetric,
+            now.addSecs(-3600), now, SmartHistoryStore::RawResolution);
+        for (int i = qMax(0, history.size() - 20); i < history.size(); ++i) {
+            m_temperatureHistory.append(history[i].average);
+        }
+        
+        // 上一块硬盘尚未返回的结果作废
+        ++m_generation;
+        m_smartData.reset();
+        m_currentTemperature = -1;
+        
         // 更新仪表盘
         updateDashboard();
     }
@@ -225,7 +351,13 @@ void DashboardWidget::onDiskSelectionChanged(int index)
 
 void DashboardWidget::onRefreshClicked()
 {
-    refreshDiskList();
+    // 手动刷新时不使用缓存
+    if (m_currentDiskIndex >= 0 && m_currentDiskIndex < m_diskList.size()) {
+        DeviceDataCache::instance()->invalidate(m_diskList[m_currentDiskIndex].diskPath);
+    }
+    // 硬盘列表有变化时通过DiskInventory的信号更新
+    DiskInventory::instance()->refresh();
+    ++m_generation;
     updateDashboard();
 }
 
@@ -235,11 +367,64 @@ void DashboardWidget::updateDashboard()
         return;
     }
     
-    // 获取当前选择的硬盘
-    const DiskInfo &disk = m_diskList[m_currentDiskIndex];
+    // 当前代数的请求还没返回时不重复发起，读取慢时定时器不会堆积请求
+    if (m_snapshotPending && m_pendingGeneration == m_generation) {
+        return;
+    }
+    
+    const QString diskPath = m_diskList[m_currentDiskIndex].diskPath;
+    const quint64 generation = m_generation;
+    m_snapshotPending = true;
+    m_pendingGeneration = generation;
+    
+    QFutureWatcher<DashboardSnapshot> *watcher = new QFutureWatcher<DashboardSnapshot>(this);
+    connect(watcher, &QFutureWatcher<DashboardSnapshot>::finished, this, [this, watcher]() {
+        applySnapshot(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&DashboardWidget::fetchSnapshot, diskPath, generation));
+}
+
+DashboardSnapshot DashboardWidget::fetchSnapshot(const QString &diskPath, quint64 generation)
+{
+    // 在工作线程中执行，不访问界面对象
+    DashboardSnapshot snapshot;
+    snapshot.generation = generation;
+    snapshot.diskPath = diskPath;
+    
+    // 从共享缓存获取，有效期内不会重复读取硬盘，其他界面正在读取时等待同一次读取
+    DeviceDataCache *cache = DeviceDataCache::instance();
+    snapshot.smartData = cache->requestSmartData(diskPath).result();
+    // 温度的有效期比SMART数据短，过期时才重新读取
+    snapshot.temperature = cache->requestTemperature(diskPath).result();
+    snapshot.usagePercent = DiskUtils::getDiskUsage(diskPath).usedPercent;
+    return snapshot;
+}
+
+void DashboardWidget::applySnapshot(const DashboardSnapshot &snapshot)
+{
+    if (snapshot.generation == m_pendingGeneration) {
+        m_snapshotPending = false;
+    }
+    
+    // 切换硬盘或手动刷新后，之前发起的请求结果丢弃
+    if (snapshot.generation != m_generation) {
+        qDebug() << "丢弃过期的仪表盘数据:" << snapshot.diskPath;
+        return;
+    }
     
-    // 加载SMART数据
-    loadSmartData(disk.diskPath);
+    m_smartData = snapshot.smartData;
+    m_currentTemperature = snapshot.temperature;
+    m_usagePercent = snapshot.usagePercent;
+    
+    if (m_smartData) {
+        qDebug() << "硬盘类型:" << (m_smartData->diskType() == DiskType::NVMe ? "NVMe" : 
+                   (m_smartData->diskType() == DiskType::SATA ? "SATA" : "未知"))
+                 << "SMART健康度:" << m_smartData->overallHealth()
+                 << "温度:" << m_currentTemperature
+                 << "通电时间:" << m_smartData->powerOnHours() << "小时"
+                 << "SMART属性数量:" << m_smartData->attributes().size();
+    }
     
     // 更新各个图表
     updateDiskUsageChart();
@@ -254,6 +439,26 @@ void DashboardWidget::onTimerTimeout()
     updateDashboard();
 }
 
+void DashboardWidget::onSmartDataUpdated(const QString &deviceKey)
+{
+    if (m_currentDiskIndex < 0 || m_currentDiskIndex >= m_diskList.size()) {
+        return;
+    }
+    const QString diskPath = m_diskList[m_currentDiskIndex].diskPath;
+    if (DeviceDataCache::deviceKey(diskPath) != deviceKey) {
+        return;
+    }
+    
+    QSharedPointer<SmartData> data = DeviceDataCache::instance()->smartData(diskPath);
+    if (!data || data == m_smartData) {
+        return;
+    }
+    m_smartData = data;
+    // 温度历史只在定时器中追加，这里只刷新健康状态和标签
+    updateHealthChart();
+    updateInfoLabels();
+}
+
 void DashboardWidget::createDiskUsageChart()
 {
     m_diskUsageChart = new QChart();
@@ -319,10 +524,8 @@ void DashboardWidget::updateDiskUsageChart()
         return;
     }
     
-    const DiskInfo &disk = m_diskList[m_currentDiskIndex];
-    
-    // 计算使用率
-    double usagePercent = DiskUtils::getDiskUsage(disk.diskPath).usedPercent;
+    // 使用率由快照提供
+    double usagePercent = m_usagePercent;
     
     m_diskUsageSeries->clear();
     
@@ -348,10 +551,9 @@ void DashboardWidget::updateTemperatureChart()
     // 从SMART数据中获取温度
     int temperature = m_smartData->temperature();
     
-    // 如果SMART数据中没有温度信息，尝试使用其他方法获取
-    if (temperature <= 0) {
-        const DiskInfo &disk = m_diskList[m_currentDiskIndex];
-        temperature = DiskUtils::getDiskTemperature(disk.diskPath);
+    // 优先使用快照中的最新温度
+    if (m_currentTemperature > 0) {
+        temperature = m_currentTemperature;
     }
     
     // 确保温度在合理范围内
@@ -476,10 +678,18 @@ void DashboardWidget::updateInfoLabels()
     m_interfaceValueLabel->setText(disk.interfaceSpeed);
     m_typeValueLabel->setText(disk.type);
     
+    // 故障预测来自SMART历史，不依赖本次读取
+    const FailurePrediction prediction = FailurePredictor::instance()->prediction(SmartHistoryStore::diskKey(disk));
+    m_predictionValueLabel->setText(FailurePredictor::describe(prediction));
+    m_predictionValueLabel->setStyleSheet(FailurePredictor::needsAttention(prediction) ? "color: #FFA500;" : "");
+    
     // 更新SMART信息标签
     if (m_smartData) {
-        // 温度
-        int temperature = m_smartData->temperature();
+        // 温度，优先使用快照中的最新值
+        int temperature = m_currentTemperature;
+        if (temperature <= 0) {
+            temperature = m_smartData->temperature();
+        }
         if (temperature > 0) {
             QString tempStatus;
             if (temperature < 35) {
@@ -551,43 +761,9 @@ void DashboardWidget::updateInfoLabels()
     }
 }
 
-// 加载SMART数据的方法
-void DashboardWidget::loadSmartData(const QString &diskPath)
-{
-    // 清理旧的SMART数据对象
-    if (m_smartData) {
-        delete m_smartData;
-        m_smartData = nullptr;
-    }
-    
-    // 使用工厂类创建适合的SMART数据处理器
-    m_smartData = SmartFactory::createSmartData(diskPath, this);
-    
-    // 加载SMART数据
-    QFuture<bool> future = QtConcurrent::run([this, diskPath]() {
-        return m_smartData->loadFromDisk(diskPath);
-    });
-    
-    // 等待加载完成
-    bool success = future.result();
-    
-    if (!success) {
-        qDebug() << "加载SMART数据失败，使用模拟数据";
-    } else {
-        qDebug() << "硬盘类型:" << (m_smartData->diskType() == DiskType::NVMe ? "NVMe" : 
-                   (m_smartData->diskType() == DiskType::SATA ? "SATA" : "未知"))
-                 << "SMART健康度:" << m_smartData->overallHealth()
-                 << "温度:" << m_smartData->temperature()
-                 << "通电时间:" << m_smartData->powerOnHours() << "小时"
-                 << "SMART属性数量:" << m_smartData->attributes().size();
-    }
-}
-
 void DashboardWidget::refreshData()
 {
-    // 刷新硬盘列表
-    refreshDiskList();
-    
-    // 更新当前选中磁盘的信息
+    // 硬盘列表由DiskInventory维护，这里只更新当前选中磁盘的信息
+    ++m_generation;
     updateDashboard();
 } 
\ No newline at end of file
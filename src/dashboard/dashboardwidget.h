@@ -20,9 +20,24 @@
 #include "../core/diskutils.h"
 #include "../core/smartdata.h"
 #include "../core/smartfactory.h"
+#include "../core/devicedatacache.h"
+#include "../core/diskinventory.h"
+#include "../core/smarthistorystore.h"
+#include "../core/failurepredictor.h"
 
 QT_CHARTS_USE_NAMESPACE
 
+// 一次仪表盘刷新读取到的数据，在工作线程中生成，交给界面后不再修改
+struct DashboardSnapshot {
+    quint64 generation;                     // 发起请求时的刷新代数，用于丢弃过期结果
+    QString diskPath;
+    QSharedPointer<SmartData> smartData;    // 来自DeviceDataCache，加载完成后只读
+    int temperature;                        // 最新温度，-1表示没有
+    double usagePercent;                    // 磁盘使用率(%)
+    
+    DashboardSnapshot() : generation(0), temperature(-1), usagePercent(0.0) {}
+};
+
 class DashboardWidget : public QWidget
 {
     Q_OBJECT
@@ -38,10 +53,14 @@ private slots:
     void onRefreshClicked();
     void updateDashboard();
     void onTimerTimeout();
+    void onSmartDataUpdated(const QString &deviceKey);
+    void onDiskAdded(const DiskInfo &disk);
+    void onDiskRemoved(const DiskInfo &disk);
+    void onDiskChanged(const DiskInfo &disk);
+    void onPredictionUpdated(const QString &diskKey);
     
 private:
     void setupUI();
-    void refreshDiskList();
     void createDiskUsageChart();
     void createTemperatureChart();
     void createHealthChart();
@@ -49,7 +68,11 @@ private:
     void updateTemperatureChart();
     void updateHealthChart();
     void updateInfoLabels();
-    void loadSmartData(const QString &diskPath);
+    void applyDiskList(const QList<DiskInfo> &disks);
+    void applySnapshot(const DashboardSnapshot &snapshot);
+    int diskListIndex(const QString &diskPath) const;
+    static QString diskDisplayText(const DiskInfo &disk);
+    static DashboardSnapshot fetchSnapshot(const QString &diskPath, quint64 generation);
     
 private:
     QVBoxLayout *m_mainLayout;
@@ -93,13 +116,22 @@ private:
     QLabel *m_temperatureValueLabel;
     QLabel *m_startStopLabel;
     QLabel *m_startStopValueLabel;
+    QLabel *m_predictionLabel;
+    QLabel *m_predictionValueLabel;
     QLabel *m_warningLabel;
     
     QTimer *m_refreshTimer;
     
     QList<DiskInfo> m_diskList;
     int m_currentDiskIndex;
-    SmartData *m_smartData;
+    QSharedPointer<SmartData> m_smartData;   // 来自DeviceDataCache，与其他界面共享
+    int m_currentTemperature;               // 最近一次快照的温度，-1表示没有
+    double m_usagePercent;
+    
+    // 异步刷新状态：界面线程只发起请求和应用结果，不等待I/O
+    quint64 m_generation;                   // 切换硬盘或手动刷新时递增
+    quint64 m_pendingGeneration;            // 正在读取的快照所属代数
+    bool m_snapshotPending;
 };
 
 #endif // DASHBOARDWIDGET_H 
\ No newline at end of file
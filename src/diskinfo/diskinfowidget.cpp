@@ -16,6 +16,8 @@
 #include <QTextStream>
 
 #include "../core/diskutils.h"
+#include "../core/diskinventory.h"
+#include "../core/volumeresolver.h"
 
 DiskInfoWidget::DiskInfoWidget(QWidget *parent) :
     QWidget(parent),
@@ -23,6 +25,12 @@ DiskInfoWidget::DiskInfoWidget(QWidget *parent) :
 {
     setupUI();
     refreshDiskList();
+    
+    // 硬盘插拔时增量更新，不重新枚举
+    DiskInventory *inventory = DiskInventory::instance();
+    connect(inventory, &DiskInventory::diskAdded, this, &DiskInfoWidget::onDiskAdded);
+    connect(inventory, &DiskInventory::diskRemoved, this, &DiskInfoWidget::onDiskRemoved);
+    connect(inventory, &DiskInventory::diskChanged, this, &DiskInfoWidget::onDiskChanged);
 }
 
 DiskInfoWidget::~DiskInfoWidget()
@@ -120,19 +128,15 @@ void DiskInfoWidget::refreshDiskList()
     m_diskComboBox->clear();
     m_disks.clear();
     
-    // 获取硬盘列表
-    m_disks = DiskUtils::getAllDisks();
+    // 获取硬盘列表，由DiskInventory统一枚举
+    m_disks = DiskInventory::instance()->disks();
     
     // 填充下拉框
     int index = 0;
     int newSelectedIndex = -1;
     
     for (const DiskInfo &disk : m_disks) {
-        QString displayText = QString("%1 (%2) - %3")
-                            .arg(disk.model)
-                            .arg(disk.diskPath)
-                            .arg(DiskUtils::formatSize(disk.diskSize));
-        m_diskComboBox->addItem(displayText);
+        m_diskComboBox->addItem(diskDisplayText(disk));
         
         // 检查是否为之前选择的磁盘
         if (disk.diskPath == currentDiskPath) {
@@ -153,12 +157,81 @@ void DiskInfoWidget::refreshDiskList()
 
 void DiskInfoWidget::onDiskSelectionChanged(int index)
 {
+    m_currentDiskIndex = index;
     displayDiskInfo(index);
 }
 
 void DiskInfoWidget::onRefreshClicked()
 {
-    refreshDiskList();
+    // 硬盘列表有变化时通过DiskInventory的信号更新，这里刷新当前硬盘的卷信息
+    DiskInventory::instance()->refresh();
+    displayDiskInfo(m_currentDiskIndex);
+}
+
+void DiskInfoWidget::onDiskAdded(const DiskInfo &disk)
+{
+    // 下拉框原来为空时会自动选中新项并触发onDiskSelectionChanged
+    m_disks.append(disk);
+    m_diskComboBox->addItem(diskDisplayText(disk));
+}
+
+void DiskInfoWidget::onDiskRemoved(const DiskInfo &disk)
+{
+    const int index = diskListIndex(disk.diskPath);
+    if (index < 0) {
+        return;
+    }
+    // 先更新列表，下拉框移除当前项时会选中相邻项并触发onDiskSelectionChanged
+    m_disks.removeAt(index);
+    m_diskComboBox->removeItem(index);
+    if (m_disks.isEmpty()) {
+        m_currentDiskIndex = -1;
+    }
+}
+
+void DiskInfoWidget::onDiskChanged(const DiskInfo &disk)
+{
+    const int index = diskListIndex(disk.diskPath);
+    if (index < 0) {
+        return;
+    }
+    m_disks[index] = disk;
+    m_diskComboBox->setItemText(index, diskDisplayText(disk));
+    if (index == m_currentDiskIndex) {
+        displayDiskInfo(index);
+    }
+}
+
+bool DiskInfoWidget::volumeBelongsToDisk(const VolumeInfo &volume, const DiskInfo &disk)
+{
+    // 优先使用卷索引的精确关系，经LVM、加密卷、RAID挂载的卷也能找到
+    // 按挂载点精确查找，tmpfs等不在索引中的挂载不能沿上级目录归到根分区所在的硬盘
+    const MountedVolume mounted = VolumeResolver::instance()->volumeForRoot(volume.rootPath);
+    if (!mounted.rootPath.isEmpty()) {
+        return mounted.disks.contains(disk.diskPath);
+    }
+    
+    // 模拟数据等不在卷索引中的卷，按磁盘记录的盘符判断
+    return disk.volumes.contains(volume.driveLetter) || disk.volumes.contains(volume.rootPath)
+           || (!volume.driveLetter.isEmpty() && volume.driveLetter == disk.mainVolume);
+}
+
+int DiskInfoWidget::diskListIndex(const QString &diskPath) const
+{
+    for (int i = 0; i < m_disks.size(); i++) {
+        if (m_disks[i].diskPath == diskPath) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString DiskInfoWidget::diskDisplayText(const DiskInfo &disk)
+{
+    return QString("%1 (%2) - %3")
+           .arg(disk.model)
+           .arg(disk.diskPath)
+           .arg(DiskUtils::formatSize(disk.diskSize));
 }
 
 void DiskInfoWidget::onSaveInfoClicked()
@@ -208,7 +281,7 @@ void DiskInfoWidget::onSaveInfoClicked()
     QList<VolumeInfo> volumes = DiskUtils::getVolumes();
     for (const VolumeInfo &volume : volumes) {
         // 只保存与当前磁盘相关的卷信息
-        if (!disk.diskPath.isEmpty() && !volume.rootPath.startsWith(disk.diskPath)) {
+        if (!volumeBelongsToDisk(volume, disk)) {
             continue;
         }
         
@@ -261,16 +334,7 @@ void DiskInfoWidget::displayVolumeInfo(const DiskInfo& disk)
     int row = 0;
     for (const VolumeInfo &volume : volumes) {
         // 只显示与当前硬盘相关的分区
-        // 检查卷的盘符是否在当前磁盘的volumes列表中
-        if (!disk.volumes.contains(volume.driveLetter) && 
-            // 或者检查卷的盘符是否是当前磁盘的主卷
-            volume.driveLetter != disk.mainVolume &&
-            // 如果磁盘路径以\\.\开头(原始物理磁盘格式)，则不进行路径开头匹配
-            // 否则尝试匹配路径前缀(用于模拟数据或其他情况)
-            (!disk.diskPath.startsWith("\\\\.\\") && 
-             !disk.diskPath.isEmpty() && 
-             !volume.rootPath.startsWith(disk.diskPath))) {
-            // 跳过不属于当前磁盘的卷
+        if (!volumeBelongsToDisk(volume, disk)) {
             continue;
         }
         
@@ -26,6 +26,9 @@ private slots:
     void onDiskSelectionChanged(int index);
     void onRefreshClicked();
     void onSaveInfoClicked();
+    void onDiskAdded(const DiskInfo &disk);
+    void onDiskRemoved(const DiskInfo &disk);
+    void onDiskChanged(const DiskInfo &disk);
 
 private:
     void setupUI();
@@ -33,6 +36,9 @@ private:
     void displayDiskInfo(int index);
     void displayVolumeInfo(const DiskInfo &disk);
     QString getVolumeType(const QString &fileSystem);
+    int diskListIndex(const QString &diskPath) const;
+    static bool volumeBelongsToDisk(const VolumeInfo &volume, const DiskInfo &disk);
+    static QString diskDisplayText(const DiskInfo &disk);
     
 private:
     QVBoxLayout *m_mainLayout;
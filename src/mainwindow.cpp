@@ -14,6 +14,7 @@
 #include <QCloseEvent>
 #include <QSettings>
 #include <QFileDialog>
+#include <QStandardPaths>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QTimer>
@@ -26,6 +27,10 @@
 #include "speedtest/speedtestwidget.h"
 #include "smart/smartwidget.h"
 #include "spaceanalyzer/spaceanalyzerwidget.h"
+#include "surfacescan/surfacescanwidget.h"
+#include "core/diskinventory.h"
+#include "core/smarthistorystore.h"
+#include "core/failurepredictor.h"
 // 注释掉尚未实现的模块的引用
 // #include "health/healthmonitorwidget.h"
 
@@ -47,6 +52,12 @@ MainWindow::MainWindow(QWidget *parent)
     // 加载样式表
     loadStyleSheet(m_isDarkTheme ? ":/resources/styles/dark.qss" : ":/resources/styles/light.qss");
     
+    // 各页面创建时从硬盘清单读取磁盘列表，只枚举这一次
+    DiskInventory::instance()->start();
+    // 后台记录所有硬盘的SMART历史
+    SmartHistoryStore::instance()->startRecording();
+    FailurePredictor::instance()->start();
+    
     qDebug() << "开始设置UI组件...";
     // 设置UI组件
     setupUI();
@@ -57,14 +68,14 @@ MainWindow::MainWindow(QWidget *parent)
     // 创建系统托盘图标
     createTrayIcon();
     
-    // 使用单次定时器延迟启动自动刷新，避免窗口显示延迟
-    QTimer::singleShot(1000, this, [this]() {
-        // 启动自动刷新定时器
-        m_refreshTimer = new QTimer(this);
-        connect(m_refreshTimer, &QTimer::timeout, this, &MainWindow::refreshAllData);
-        m_refreshTimer->start(60000); // 每分钟刷新一次
-        qDebug() << "刷新定时器已启动";
-    });
+    // 硬盘插拔由DiskInventory的热插拔通知更新，收不到通知时才定时全量刷新
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(60000); // 每分钟刷新一次
+    connect(m_refreshTimer, &QTimer::timeout, this, &MainWindow::refreshAllData);
+    if (!DiskInventory::instance()->isMonitoring()) {
+        m_refreshTimer->start();
+        qDebug() << "不支持热插拔通知，刷新定时器已启动";
+    }
     
     // 检查更新
     QTimer::singleShot(2000, this, &MainWindow::checkForUpdates);
@@ -90,6 +101,7 @@ void MainWindow::setupUI()
     m_speedTestWidget = new SpeedTestWidget(this);
     m_smartWidget = new SmartWidget(this);
     m_spaceAnalyzerWidget = new SpaceAnalyzerWidget(this);
+    m_surfaceScanWidget = new SurfaceScanWidget(this);
     
     // 添加选项卡
     m_tabWidget->addTab(m_dashboardWidget, QIcon(":/resources/icons/dashboard.png"), "仪表盘");
@@ -97,6 +109,7 @@ void MainWindow::setupUI()
     m_tabWidget->addTab(m_speedTestWidget, QIcon(":/resources/icons/speed.png"), "速度测试");
     m_tabWidget->addTab(m_smartWidget, QIcon(":/resources/icons/smart.png"), "SMART信息");
     m_tabWidget->addTab(m_spaceAnalyzerWidget, QIcon(":/resources/icons/space.png"), "空间分析");
+    m_tabWidget->addTab(m_surfaceScanWidget, QIcon(":/resources/icons/disk.png"), "表面扫描");
     
     // 创建状态栏
     m_statusBar = statusBar();
@@ -161,6 +174,9 @@ void MainWindow::createMenus()
     refreshAction->setShortcut(QKeySequence("F5"));
     connect(refreshAction, &QAction::triggered, this, &MainWindow::refreshAllData);
     
+    QAction *exportPredictionAction = fileMenu->addAction("导出故障预测...");
+    connect(exportPredictionAction, &QAction::triggered, this, &MainWindow::exportFailurePrediction);
+    
     fileMenu->addSeparator();
     
     QAction *exitAction = fileMenu->addAction("退出");
@@ -236,6 +252,9 @@ void MainWindow::onTabChanged(int index)
     case 4:
         m_statusBar->showMessage("空间分析 - 分析磁盘空间使用情况");
         break;
+    case 5:
+        m_statusBar->showMessage("表面扫描 - 检测磁盘慢区域和坏道");
+        break;
     default:
         m_statusBar->showMessage("准备就绪");
         break;
@@ -347,6 +366,9 @@ void MainWindow::showSettingsDialog()
 
 void MainWindow::refreshAllData()
 {
+    // 重新枚举硬盘，有变化时各页面通过DiskInventory的信号更新
+    DiskInventory::instance()->refresh();
+    
     // 刷新所有模块的数据
     // 注释掉不存在的刷新方法
     // m_dashboardWidget->refreshData();
@@ -370,6 +392,10 @@ void MainWindow::refreshAllData()
         // 空间分析
         // 不需要自动刷新
         break;
+    case 5:
+        // 表面扫描
+        // 不需要自动刷新
+        break;
     default:
         break;
     }
@@ -378,6 +404,27 @@ void MainWindow::refreshAllData()
     m_statusBar->showMessage("数据已刷新: " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"), 3000);
 }
 
+void MainWindow::exportFailurePrediction()
+{
+    QString filePath = QFileDialog::getSaveFileName(
+        this,
+        "导出故障预测",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/硬盘故障预测.json",
+        "JSON文件 (*.json);;所有文件 (*.*)"
+    );
+    
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    QString errorMessage;
+    if (!FailurePredictor::instance()->exportJson(filePath, errorMessage)) {
+        QMessageBox::critical(this, "错误", errorMessage);
+        return;
+    }
+    m_statusBar->showMessage("故障预测已导出: " + filePath, 3000);
+}
+
 void MainWindow::onTrayIconActivated(QSystemTrayIcon::ActivationReason reason)
 {
     switch (reason) {
@@ -15,6 +15,7 @@
 #include "speedtest/speedtestwidget.h"
 #include "smart/smartwidget.h"
 #include "spaceanalyzer/spaceanalyzerwidget.h"
+#include "surfacescan/surfacescanwidget.h"
 
 class MainWindow : public QMainWindow
 {
@@ -32,6 +33,7 @@ private slots:
     void showAboutDialog();
     void showSettingsDialog();
     void refreshAllData();
+    void exportFailurePrediction();
     void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason);
     void switchTheme(bool isDark);
     
@@ -50,6 +52,7 @@ private:
     SpeedTestWidget *m_speedTestWidget;
     SmartWidget *m_smartWidget;
     SpaceAnalyzerWidget *m_spaceAnalyzerWidget;
+    SurfaceScanWidget *m_surfaceScanWidget;
     
     QStatusBar *m_statusBar;
     QMenuBar *m_menuBar;
@@ -32,7 +32,6 @@ QT_CHARTS_USE_NAMESPACE
 SmartWidget::SmartWidget(QWidget *parent) :
     QWidget(parent),
     m_currentDiskIndex(-1),
-    m_smartData(nullptr),
     m_language(SmartAttributeLanguage::Chinese) // 默认使用中文
 {
     setupUI();
@@ -42,6 +41,10 @@ SmartWidget::SmartWidget(QWidget *parent) :
     m_refreshTimer = new QTimer(this);
     connect(m_refreshTimer, &QTimer::timeout, this, &SmartWidget::onTimerTimeout);
     m_refreshTimer->start(300000);  // 每5分钟刷新一次，避免频繁刷新导致卡顿
+    
+    // 其他界面读取了同一块硬盘的SMART数据时直接使用
+    connect(DeviceDataCache::instance(), &DeviceDataCache::smartDataUpdated,
+            this, &SmartWidget::onSmartDataUpdated);
 }
 
 SmartWidget::~SmartWidget()
@@ -49,11 +52,6 @@ SmartWidget::~SmartWidget()
     if (m_refreshTimer) {
         m_refreshTimer->stop();
     }
-    
-    if (m_smartData) {
-        delete m_smartData;
-        m_smartData = nullptr;
-    }
 }
 
 void SmartWidget::setupUI()
@@ -302,6 +300,11 @@ void SmartWidget::onRefreshClicked()
     // 显示正在刷新状态
     m_refreshButton->setText("刷新中...");
     
+    // 手动刷新时不使用缓存
+    if (m_currentDiskIndex >= 0 && m_currentDiskIndex < m_diskList.size()) {
+        DeviceDataCache::instance()->invalidate(m_diskList[m_currentDiskIndex].diskPath);
+    }
+    
     // 创建一个短暂延迟，让UI能够更新
     QTimer::singleShot(100, this, [this]() {
         // 刷新磁盘列表
@@ -482,10 +485,12 @@ void SmartWidget::loadSmartData(int diskIndex)
     m_refreshButton->setEnabled(false);
     
     // 创建一个QFutureWatcher来监控异步任务
-    QFutureWatcher<void> *watcher = new QFutureWatcher<void>(this);
+    typedef QSharedPointer<SmartData> SmartDataPtr;
+    QFutureWatcher<SmartDataPtr> *watcher = new QFutureWatcher<SmartDataPtr>(this);
+    QString deviceKey = DeviceDataCache::deviceKey(disk.diskPath);
     
     // 连接完成信号
-    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, disk]() {
+    connect(watcher, &QFutureWatcher<SmartDataPtr>::finished, this, [this, watcher, deviceKey]() {
         // 重新启用刷新按钮
         m_refreshButton->setEnabled(true);
         m_refreshButton->setText("刷新"); // 恢复按钮文本
@@ -495,46 +500,56 @@ void SmartWidget::loadSmartData(int diskIndex)
         m_healthGroup->setTitle(QString("硬盘健康状态"));
         m_summaryGroup->setTitle(QString("重要指标"));
         
-        // 更新界面
-        updateAttributesTable();
-        updateHealthChart();
-        updateSummaryInfo();
+        // 加载期间切换了硬盘时丢弃结果，新硬盘的请求会再次更新界面
+        bool stillCurrent = m_currentDiskIndex >= 0 && m_currentDiskIndex < m_diskList.size()
+                            && DeviceDataCache::deviceKey(m_diskList[m_currentDiskIndex].diskPath) == deviceKey;
+        if (stillCurrent) {
+            m_smartData = watcher->result();
+            if (m_smartData) {
+                qDebug() << "硬盘类型:" << (m_smartData->diskType() == DiskType::NVMe ? "NVMe" : 
+                           (m_smartData->diskType() == DiskType::SATA ? "SATA" : "未知"))
+                         << "SMART健康度:" << m_smartData->overallHealth()
+                         << "温度:" << m_smartData->temperature()
+                         << "通电时间:" << m_smartData->powerOnHours() << "小时"
+                         << "SMART属性数量:" << m_smartData->attributes().size();
+            }
+            
+            // 更新界面
+            updateAttributesTable();
+            updateHealthChart();
+            updateSummaryInfo();
+        }
         
         // 删除watcher
         watcher->deleteLater();
     });
     
-    // 预先在主线程中创建适合磁盘类型的SmartData对象
-    if (m_smartData) {
-        delete m_smartData;
-        m_smartData = nullptr;
+    // 从共享缓存获取，有效期内不会重复读取硬盘，其他界面正在读取同一块硬盘时共用那次读取
+    watcher->setFuture(DeviceDataCache::instance()->requestSmartData(disk.diskPath));
+}
+
+void SmartWidget::onSmartDataUpdated(const QString &deviceKey)
+{
+    // 正在加载时由加载完成的回调更新
+    if (!m_refreshButton->isEnabled()) {
+        return;
+    }
+    if (m_currentDiskIndex < 0 || m_currentDiskIndex >= m_diskList.size()) {
+        return;
+    }
+    const QString diskPath = m_diskList[m_currentDiskIndex].diskPath;
+    if (DeviceDataCache::deviceKey(diskPath) != deviceKey) {
+        return;
     }
     
-    // 使用工厂类创建适合的SMART数据处理器
-    m_smartData = SmartFactory::createSmartData(disk.diskPath, this);
-    
-    // 复制要传给线程的数据，避免传递QObject
-    QString diskPathCopy = disk.diskPath;
-    
-    // 使用QtConcurrent在单独线程中执行SMART数据加载
-    QFuture<void> future = QtConcurrent::run([this, diskPathCopy]() {
-        // 加载SMART数据
-        bool success = m_smartData->loadFromDisk(diskPathCopy);
-        
-        if (success) {
-            qDebug() << "硬盘类型:" << (m_smartData->diskType() == DiskType::NVMe ? "NVMe" : 
-                       (m_smartData->diskType() == DiskType::SATA ? "SATA" : "未知"))
-                     << "SMART健康度:" << m_smartData->overallHealth()
-                     << "温度:" << m_smartData->temperature()
-                     << "通电时间:" << m_smartData->powerOnHours() << "小时"
-                     << "SMART属性数量:" << m_smartData->attributes().size();
-        } else {
-            qDebug() << "加载SMART数据失败，使用模拟数据";
-        }
-    });
-    
-    // 设置watcher以监控future
-    watcher->setFuture(future);
+    QSharedPointer<SmartData> data = DeviceDataCache::instance()->smartData(diskPath);
+    if (!data || data == m_smartData) {
+        return;
+    }
+    m_smartData = data;
+    updateAttributesTable();
+    updateHealthChart();
+    updateSummaryInfo();
 }
 
 void SmartWidget::updateAttributesTable()
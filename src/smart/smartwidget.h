@@ -17,6 +17,7 @@
 #include <QtCharts/QChart>
 #include "../core/diskutils.h"
 #include "../core/smartdata.h"
+#include "../core/devicedatacache.h"
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -48,6 +49,7 @@ private slots:
     void onSaveSmartInfoClicked();
     void onTimerTimeout();
     void onLanguageToggleClicked();
+    void onSmartDataUpdated(const QString &deviceKey);
 
 private:
     void setupUI();
@@ -92,7 +94,7 @@ private:
     
     QList<DiskInfo> m_diskList;
     int m_currentDiskIndex;
-    SmartData *m_smartData;
+    QSharedPointer<SmartData> m_smartData;   // 来自DeviceDataCache，与其他界面共享
     QTimer *m_refreshTimer;
     SmartAttributeLanguage m_language;  // 新增语言设置
 };
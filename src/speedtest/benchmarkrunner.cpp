@@ -0,0 +1,218 @@
+#include "benchmarkrunner.h"
+#include "workloadengine.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QRegularExpression>
+#include <QDebug>
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkConfig &config, QObject *parent)
+    : QObject(parent), m_config(config), m_canceled(0), m_currentEngine(nullptr) {
+    m_config.warmupRuns = qMax(0, config.warmupRuns);
+    m_config.repetitions = qMax(1, config.repetitions);
+    qRegisterMetaType<BenchmarkResult>("BenchmarkResult");
+}
+
+void BenchmarkRunner::cancel() {
+    m_canceled.storeRelaxed(1);
+    QMutexLocker locker(&m_engineMutex);
+    if (m_currentEngine) {
+        m_currentEngine->cancel();
+    }
+}
+
+void BenchmarkRunner::startTest() {
+    BenchmarkResult result;
+    result.config = m_config;
+
+    const qint64 fileSize = static_cast<qint64>(m_config.fileSizeMB) * 1024 * 1024;
+    const int totalPasses = m_config.warmupRuns + m_config.repetitions;
+
+    qDebug() << "开始统计测试: 预热" << m_config.warmupRuns << "次, 重复" << m_config.repetitions << "次, 文件"
+             << m_config.testFilePath;
+
+    // 测试文件只创建一次，所有轮次复用，避免每轮都重新铺设
+    emit progressUpdated(0, "正在创建测试文件...");
+    QString error;
+    if (!WorkloadEngine::layoutFile(m_config.testFilePath, fileSize, error, &m_canceled)) {
+        QFile::remove(m_config.testFilePath);
+        result.errorMessage = m_canceled.loadRelaxed() ? QString("测试已取消") : error;
+        emit testCompleted(result);
+        return;
+    }
+
+    QList<double> readSpeeds;
+    QList<double> writeSpeeds;
+
+    for (int pass = 0; pass < totalPasses && !m_canceled.loadRelaxed(); ++pass) {
+        bool warmup = pass < m_config.warmupRuns;
+        QString status = warmup ? QString("预热 %1/%2").arg(pass + 1).arg(m_config.warmupRuns)
+                                : QString("第 %1/%2 轮").arg(pass - m_config.warmupRuns + 1).arg(m_config.repetitions);
+        emit progressUpdated(pass * 100 / totalPasses, QString("正在进行%1...").arg(status));
+
+        double readSpeed = 0;
+        double writeSpeed = 0;
+        LatencyHistogram syncLatency;
+        if (!runPass(readSpeed, writeSpeed, syncLatency, error)) {
+            if (!m_canceled.loadRelaxed()) {
+                result.errorMessage = QString("%1失败: %2").arg(status).arg(error);
+            }
+            break;
+        }
+
+        qDebug() << status << "读取:" << readSpeed << "MB/s 写入:" << writeSpeed << "MB/s";
+        emit passCompleted(pass, warmup, readSpeed, writeSpeed);
+
+        if (!warmup) {
+            readSpeeds.append(readSpeed);
+            writeSpeeds.append(writeSpeed);
+            result.syncLatency.merge(syncLatency);
+        }
+    }
+
+    QFile::remove(m_config.testFilePath);
+
+    if (m_canceled.loadRelaxed()) {
+        result.errorMessage = "测试已取消";
+        emit testCompleted(result);
+        return;
+    }
+    if (!result.errorMessage.isEmpty()) {
+        emit testCompleted(result);
+        return;
+    }
+
+    result.read = BenchmarkStatistics::compute(readSpeeds);
+    result.write = BenchmarkStatistics::compute(writeSpeeds);
+    result.success = true;
+
+    // 与该磁盘的基准比较；没有基准时把本次结果作为基准
+    if (!m_config.diskSerial.isEmpty()) {
+        SampleStatistics baseline;
+        QDateTime timestamp;
+        if (loadBaseline(m_config, "read", baseline, timestamp)) {
+            result.readComparison = BenchmarkStatistics::compare(result.read, baseline.mean, baseline.stddev, baseline.count);
+            result.readComparison.baselineTime = timestamp;
+        }
+        if (loadBaseline(m_config, "write", baseline, timestamp)) {
+            result.writeComparison = BenchmarkStatistics::compare(result.write, baseline.mean, baseline.stddev, baseline.count);
+            result.writeComparison.baselineTime = timestamp;
+        }
+        if (!result.readComparison.available && !result.writeComparison.available) {
+            saveBaseline(result);
+            result.baselineCreated = true;
+        }
+    }
+
+    qDebug() << "统计测试完成: 读取" << result.read.mean << "±" << result.read.ciHalfWidth()
+             << "写入" << result.write.mean << "±" << result.write.ciHalfWidth()
+             << "性能下降:" << result.hasSlowdown();
+
+    emit progressUpdated(100, "统计测试完成");
+    emit testCompleted(result);
+}
+
+bool BenchmarkRunner::runPass(double &readSpeed, double &writeSpeed, LatencyHistogram &syncLatency,
+                              QString &errorMessage) {
+    // 每轮先顺序写再顺序读，与标准读写测试的顺序一致
+    FioJob writeJob;
+    writeJob.name = "write";
+    writeJob.rw = "write";
+    writeJob.readPercent = 0;
+    writeJob.filename = m_config.testFilePath;
+    writeJob.size = static_cast<qint64>(m_config.fileSizeMB) * 1024 * 1024;
+    writeJob.blockSize = static_cast<qint64>(m_config.blockSizeKB) * 1024;
+    writeJob.direct = true;
+    writeJob.setDurability(m_config.durability, m_config.syncIntervalBytes);
+
+    FioJob readJob = writeJob;
+    readJob.name = "read";
+    readJob.rw = "read";
+    readJob.readPercent = 100;
+    readJob.setDurability(FioJob::NoSync);
+
+    WorkloadEngine engine(QList<FioJob>() << writeJob << readJob, QFileInfo(m_config.testFilePath).absolutePath());
+    {
+        QMutexLocker locker(&m_engineMutex);
+        m_currentEngine = &engine;
+    }
+    if (m_canceled.loadRelaxed()) {
+        engine.cancel();
+    }
+
+    WorkloadRunResult run = engine.run();
+
+    {
+        QMutexLocker locker(&m_engineMutex);
+        m_currentEngine = nullptr;
+    }
+
+    if (!run.success) {
+        errorMessage = run.errorMessage;
+        return false;
+    }
+
+    for (const WorkloadJobResult &job : run.jobs) {
+        if (job.jobName == "write") {
+            writeSpeed = job.writeMBps();
+            syncLatency = job.syncLatency;
+        } else {
+            readSpeed = job.readMBps();
+        }
+    }
+    return true;
+}
+
+QString BenchmarkRunner::baselineKey(const BenchmarkConfig &config) {
+    QString serial = config.diskSerial.trimmed();
+    serial.replace(QRegularExpression("[^A-Za-z0-9_-]"), "_");
+    QString key = QString("Baselines/%1/bs%2K_size%3M").arg(serial).arg(config.blockSizeKB).arg(config.fileSizeMB);
+    // 不同持久化方式的写入速度不可比；默认的结束时fsync沿用原来的键
+    if (config.durability == FioJob::PeriodicSync) {
+        key += QString("_fdatasync%1M").arg(config.syncIntervalBytes / (1024 * 1024));
+    } else if (config.durability != FioJob::FinalSync) {
+        key += "_" + FioJob::durabilityName(config.durability);
+    }
+    return key;
+}
+
+bool BenchmarkRunner::loadBaseline(const BenchmarkConfig &config, const QString &metric, SampleStatistics &baseline,
+                                   QDateTime &timestamp) {
+    if (config.diskSerial.trimmed().isEmpty()) {
+        return false;
+    }
+
+    QSettings settings("DiskToolbox", "DiskToolbox");
+    settings.beginGroup(baselineKey(config));
+    if (!settings.contains(metric + "_mean")) {
+        return false;
+    }
+
+    baseline = SampleStatistics();
+    baseline.mean = settings.value(metric + "_mean").toDouble();
+    baseline.stddev = settings.value(metric + "_stddev").toDouble();
+    baseline.count = settings.value(metric + "_count").toInt();
+    timestamp = settings.value("timestamp").toDateTime();
+    settings.endGroup();
+    return baseline.count > 0;
+}
+
+void BenchmarkRunner::saveBaseline(const BenchmarkResult &result) {
+    if (!result.success || result.config.diskSerial.trimmed().isEmpty()) {
+        return;
+    }
+
+    QSettings settings("DiskToolbox", "DiskToolbox");
+    settings.beginGroup(baselineKey(result.config));
+    settings.setValue("read_mean", result.read.mean);
+    settings.setValue("read_stddev", result.read.stddev);
+    settings.setValue("read_count", result.read.count);
+    settings.setValue("write_mean", result.write.mean);
+    settings.setValue("write_stddev", result.write.stddev);
+    settings.setValue("write_count", result.write.count);
+    settings.setValue("timestamp", QDateTime::currentDateTime());
+    settings.endGroup();
+
+    qDebug() << "已保存速度测试基准:" << baselineKey(result.config);
+}
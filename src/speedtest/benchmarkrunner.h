@@ -0,0 +1,88 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QMetaType>
+
+#include "benchmarkstats.h"
+#include "fiojob.h"
+#include "latencyhistogram.h"
+
+class WorkloadEngine;
+
+// 重复测试参数
+struct BenchmarkConfig {
+    QString testFilePath;
+    QString diskSerial;     // 用于查找同一块磁盘的基准结果
+    int blockSizeKB;
+    int fileSizeMB;
+    int warmupRuns;         // 预热次数，结果丢弃
+    int repetitions;        // 正式统计次数
+    FioJob::Durability durability;  // 写入阶段的持久化方式
+    qint64 syncIntervalBytes;       // PeriodicSync时每写入多少数据同步一次
+
+    BenchmarkConfig()
+        : blockSizeKB(64), fileSizeMB(500), warmupRuns(1), repetitions(5), durability(FioJob::FinalSync),
+          syncIntervalBytes(64LL * 1024 * 1024) {}
+};
+
+// 重复测试结果
+struct BenchmarkResult {
+    bool success;
+    QString errorMessage;
+    BenchmarkConfig config;
+    SampleStatistics read;      // MB/s
+    SampleStatistics write;
+    LatencyHistogram syncLatency;   // 正式轮次写入阶段所有fsync/fdatasync的耗时
+    BaselineComparison readComparison;
+    BaselineComparison writeComparison;
+    bool baselineCreated;       // 该磁盘此前没有基准，本次结果已保存为基准
+
+    BenchmarkResult() : success(false), baselineCreated(false) {}
+
+    bool hasSlowdown() const { return readComparison.significantSlowdown || writeComparison.significantSlowdown; }
+};
+
+Q_DECLARE_METATYPE(BenchmarkResult)
+
+// 统计型速度测试
+// 先做若干次预热（结果丢弃），再重复N次顺序写+顺序读，剔除离群值后给出均值、标准差和95%置信区间，
+// 并与同一序列号磁盘、相同参数下保存的基准做Welch t检验，判断是否出现显著的性能下降。
+// 每次读写都通过WorkloadEngine以直接I/O执行，测试文件只在开始时创建一次。
+class BenchmarkRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BenchmarkRunner(const BenchmarkConfig &config, QObject *parent = nullptr);
+
+    void cancel();
+
+    // 基准保存在QSettings中，按磁盘序列号和测试参数区分
+    static bool loadBaseline(const BenchmarkConfig &config, const QString &metric, SampleStatistics &baseline,
+                             QDateTime &timestamp);
+    static void saveBaseline(const BenchmarkResult &result);
+
+public slots:
+    void startTest();
+
+signals:
+    void progressUpdated(int percent, const QString &status);
+    void passCompleted(int pass, bool warmup, double readSpeed, double writeSpeed);
+    void testCompleted(const BenchmarkResult &result);
+
+private:
+    bool runPass(double &readSpeed, double &writeSpeed, LatencyHistogram &syncLatency, QString &errorMessage);
+    static QString baselineKey(const BenchmarkConfig &config);
+
+    BenchmarkConfig m_config;
+    QAtomicInt m_canceled;
+    QMutex m_engineMutex;
+    WorkloadEngine *m_currentEngine;
+};
+
+#endif // BENCHMARKRUNNER_H
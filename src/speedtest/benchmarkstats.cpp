@@ -0,0 +1,219 @@
+#include "benchmarkstats.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 修正z分数超过该值视为离群（Iglewicz & Hoaglin推荐值）
+const double kOutlierThreshold = 3.5;
+// 剔除离群值所需的最少样本数
+const int kMinSamplesForRejection = 5;
+
+// t分布0.975分位数，自由度1-30
+const double kTTable[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+}
+
+double BenchmarkStatistics::median(QList<double> values) {
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    int middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+SampleStatistics BenchmarkStatistics::compute(const QList<double> &values, bool rejectOutliers) {
+    SampleStatistics stats;
+    stats.values = values;
+
+    if (rejectOutliers && values.size() >= kMinSamplesForRejection) {
+        double center = median(values);
+        QList<double> deviations;
+        for (double value : values) {
+            deviations.append(qAbs(value - center));
+        }
+        double mad = median(deviations);
+
+        // MAD为0说明大多数样本完全相同，此时不做剔除
+        if (mad > 0) {
+            stats.values.clear();
+            for (double value : values) {
+                double modifiedZ = 0.6745 * (value - center) / mad;
+                if (qAbs(modifiedZ) > kOutlierThreshold) {
+                    stats.outliers.append(value);
+                } else {
+                    stats.values.append(value);
+                }
+            }
+        }
+    }
+
+    stats.count = stats.values.size();
+    if (stats.count == 0) {
+        return stats;
+    }
+
+    double sum = 0;
+    for (double value : stats.values) {
+        sum += value;
+    }
+    stats.mean = sum / stats.count;
+    stats.median = median(stats.values);
+
+    if (stats.count > 1) {
+        double squares = 0;
+        for (double value : stats.values) {
+            squares += (value - stats.mean) * (value - stats.mean);
+        }
+        stats.stddev = qSqrt(squares / (stats.count - 1));
+        double halfWidth = tQuantile95(stats.count - 1) * stats.stddev / qSqrt(stats.count);
+        stats.ciLow = stats.mean - halfWidth;
+        stats.ciHigh = stats.mean + halfWidth;
+    } else {
+        stats.ciLow = stats.mean;
+        stats.ciHigh = stats.mean;
+    }
+
+    return stats;
+}
+
+double BenchmarkStatistics::tQuantile95(double degreesOfFreedom) {
+    if (degreesOfFreedom < 1) {
+        return kTTable[0];
+    }
+    int df = static_cast<int>(degreesOfFreedom);
+    if (df <= 30) {
+        return kTTable[df - 1];
+    }
+    if (df <= 40) {
+        return 2.021;
+    }
+    if (df <= 60) {
+        return 2.000;
+    }
+    if (df <= 120) {
+        return 1.980;
+    }
+    return 1.960;
+}
+
+double BenchmarkStatistics::betaContinuedFraction(double a, double b, double x) {
+    // Lentz算法求不完全Beta函数的连分式
+    const int maxIterations = 200;
+    const double epsilon = 3e-14;
+    const double tiny = 1e-300;
+
+    double qab = a + b;
+    double qap = a + 1.0;
+    double qam = a - 1.0;
+    double c = 1.0;
+    double d = 1.0 - qab * x / qap;
+    if (qAbs(d) < tiny) {
+        d = tiny;
+    }
+    d = 1.0 / d;
+    double h = d;
+
+    for (int m = 1; m <= maxIterations; ++m) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+        if (qAbs(d) < tiny) {
+            d = tiny;
+        }
+        c = 1.0 + aa / c;
+        if (qAbs(c) < tiny) {
+            c = tiny;
+        }
+        d = 1.0 / d;
+        h *= d * c;
+
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+        if (qAbs(d) < tiny) {
+            d = tiny;
+        }
+        c = 1.0 + aa / c;
+        if (qAbs(c) < tiny) {
+            c = tiny;
+        }
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (qAbs(delta - 1.0) < epsilon) {
+            break;
+        }
+    }
+    return h;
+}
+
+double BenchmarkStatistics::incompleteBeta(double a, double b, double x) {
+    if (x <= 0) {
+        return 0;
+    }
+    if (x >= 1) {
+        return 1;
+    }
+
+    double front = qExp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * qLn(x) + b * qLn(1.0 - x));
+    // 按收敛快的一侧计算
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return front * betaContinuedFraction(a, b, x) / a;
+    }
+    return 1.0 - front * betaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+double BenchmarkStatistics::studentTCdf(double t, double degreesOfFreedom) {
+    if (degreesOfFreedom <= 0) {
+        return 0.5;
+    }
+    double x = degreesOfFreedom / (degreesOfFreedom + t * t);
+    double tail = 0.5 * incompleteBeta(degreesOfFreedom / 2.0, 0.5, x);
+    return t > 0 ? 1.0 - tail : tail;
+}
+
+BaselineComparison BenchmarkStatistics::compare(const SampleStatistics &current, double baselineMean,
+                                                double baselineStddev, int baselineCount) {
+    BaselineComparison comparison;
+    if (baselineCount <= 0 || baselineMean <= 0 || current.count == 0) {
+        return comparison;
+    }
+
+    comparison.available = true;
+    comparison.baselineMean = baselineMean;
+    comparison.baselineStddev = baselineStddev;
+    comparison.baselineCount = baselineCount;
+    comparison.changePercent = (current.mean - baselineMean) / baselineMean * 100.0;
+
+    // 任一侧只有一个样本时无法估计方差，不做显著性判断
+    if (current.count < 2 || baselineCount < 2) {
+        comparison.pValue = 1.0;
+        return comparison;
+    }
+
+    double currentVariance = current.stddev * current.stddev / current.count;
+    double baselineVariance = baselineStddev * baselineStddev / baselineCount;
+    double standardError = qSqrt(currentVariance + baselineVariance);
+
+    if (standardError <= 0) {
+        // 两组样本都没有波动，只要均值变低就视为确定
+        comparison.pValue = current.mean < baselineMean ? 0.0 : 1.0;
+    } else {
+        comparison.tStatistic = (current.mean - baselineMean) / standardError;
+        // Welch-Satterthwaite自由度
+        double numerator = (currentVariance + baselineVariance) * (currentVariance + baselineVariance);
+        double denominator = currentVariance * currentVariance / (current.count - 1)
+                           + baselineVariance * baselineVariance / (baselineCount - 1);
+        comparison.degreesOfFreedom = denominator > 0 ? numerator / denominator : current.count + baselineCount - 2;
+        comparison.pValue = studentTCdf(comparison.tStatistic, comparison.degreesOfFreedom);
+    }
+
+    comparison.significantSlowdown = comparison.pValue < kSignificanceLevel
+                                     && comparison.changePercent <= -kMinPracticalChangePercent;
+    return comparison;
+}
@@ -0,0 +1,75 @@
+#ifndef BENCHMARKSTATS_H
+#define BENCHMARKSTATS_H
+
+#include <QList>
+#include <QDateTime>
+#include <QMetaType>
+
+// 多次重复测试的样本统计
+struct SampleStatistics {
+    int count;              // 参与统计的样本数（剔除离群值后）
+    double mean;
+    double stddev;          // 样本标准差(n-1)
+    double median;
+    double ciLow;           // 均值的95%置信区间
+    double ciHigh;
+    QList<double> values;   // 参与统计的样本
+    QList<double> outliers; // 被剔除的离群值
+
+    SampleStatistics() : count(0), mean(0), stddev(0), median(0), ciLow(0), ciHigh(0) {}
+
+    double ciHalfWidth() const { return (ciHigh - ciLow) / 2.0; }
+    // 变异系数(%)
+    double cv() const { return mean > 0 ? stddev / mean * 100.0 : 0; }
+};
+
+// 与基准结果的比较
+struct BaselineComparison {
+    bool available;             // 是否有可比较的基准
+    double baselineMean;
+    double baselineStddev;
+    int baselineCount;
+    QDateTime baselineTime;
+    double changePercent;       // 相对基准的变化，负数表示变慢
+    double tStatistic;          // Welch t检验统计量
+    double degreesOfFreedom;
+    double pValue;              // 单侧p值（当前结果低于基准的显著性）
+    bool significantSlowdown;   // 统计显著且超过最小实际差异
+
+    BaselineComparison()
+        : available(false), baselineMean(0), baselineStddev(0), baselineCount(0), changePercent(0),
+          tStatistic(0), degreesOfFreedom(0), pValue(1), significantSlowdown(false) {}
+};
+
+Q_DECLARE_METATYPE(SampleStatistics)
+Q_DECLARE_METATYPE(BaselineComparison)
+
+// 基准测试统计工具
+class BenchmarkStatistics
+{
+public:
+    // 计算均值、标准差和95%置信区间（t分布）
+    // rejectOutliers为true且样本数>=5时，用基于中位数绝对偏差的修正z分数剔除离群值
+    static SampleStatistics compute(const QList<double> &values, bool rejectOutliers = true);
+
+    // Welch t检验：判断当前结果是否显著低于基准
+    static BaselineComparison compare(const SampleStatistics &current, double baselineMean,
+                                      double baselineStddev, int baselineCount);
+
+    // 双侧95%置信度对应的t分位数
+    static double tQuantile95(double degreesOfFreedom);
+
+    // 学生t分布的累积分布函数
+    static double studentTCdf(double t, double degreesOfFreedom);
+
+    // 显著性水平和最小实际差异（变化小于该百分比即使显著也不报警）
+    static constexpr double kSignificanceLevel = 0.05;
+    static constexpr double kMinPracticalChangePercent = 3.0;
+
+private:
+    static double median(QList<double> values);
+    static double incompleteBeta(double a, double b, double x);
+    static double betaContinuedFraction(double a, double b, double x);
+};
+
+#endif // BENCHMARKSTATS_H
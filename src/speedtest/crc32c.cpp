@@ -0,0 +1,134 @@
+#include "crc32c.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32C_HAVE_SSE42
+#define CRC32C_SSE42_TARGET __attribute__((target("sse4.2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CRC32C_HAVE_SSE42
+#define CRC32C_SSE42_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+// 反射形式的Castagnoli多项式
+const quint32 kPolynomial = 0x82F63B78u;
+
+struct Crc32cTables {
+    quint32 table[8][256];
+
+    Crc32cTables() {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+            }
+            table[0][i] = crc;
+        }
+        for (quint32 i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables &tables() {
+    static const Crc32cTables instance;
+    return instance;
+}
+
+// slicing-by-8：每次查8张表处理8字节
+quint32 computeTable(quint32 crc, const unsigned char *data, qint64 size) {
+    const Crc32cTables &t = tables();
+
+    while (size >= 8) {
+        quint32 low;
+        quint32 high;
+        memcpy(&low, data, 4);
+        memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = t.table[7][low & 0xFF] ^ t.table[6][(low >> 8) & 0xFF] ^
+              t.table[5][(low >> 16) & 0xFF] ^ t.table[4][low >> 24] ^
+              t.table[3][high & 0xFF] ^ t.table[2][(high >> 8) & 0xFF] ^
+              t.table[1][(high >> 16) & 0xFF] ^ t.table[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t.table[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRC32C_HAVE_SSE42
+CRC32C_SSE42_TARGET
+quint32 computeSse42(quint32 crc, const unsigned char *data, qint64 size) {
+#if defined(__x86_64__) || defined(_M_X64)
+    quint64 crc64 = crc;
+    while (size >= 8) {
+        quint64 value;
+        memcpy(&value, data, 8);
+        crc64 = _mm_crc32_u64(crc64, value);
+        data += 8;
+        size -= 8;
+    }
+    crc = static_cast<quint32>(crc64);
+#endif
+    while (size >= 4) {
+        quint32 value;
+        memcpy(&value, data, 4);
+        crc = _mm_crc32_u32(crc, value);
+        data += 4;
+        size -= 4;
+    }
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+bool detectSse42() {
+#if defined(CRC32C_HAVE_SSE42) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#elif defined(CRC32C_HAVE_SSE42)
+    int info[4] = {0};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return false;
+#endif
+}
+}
+
+quint32 Crc32c::compute(const void *data, qint64 size, quint32 crc) {
+    static const bool useHardware = hardwareSupported();
+
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef CRC32C_HAVE_SSE42
+    if (useHardware) {
+        crc = computeSse42(crc, bytes, size);
+    } else {
+        crc = computeTable(crc, bytes, size);
+    }
+#else
+    Q_UNUSED(useHardware);
+    crc = computeTable(crc, bytes, size);
+#endif
+    return ~crc;
+}
+
+bool Crc32c::hardwareSupported() {
+    static const bool supported = detectSse42();
+    return supported;
+}
+
+const char *Crc32c::implementationName() {
+    return hardwareSupported() ? "CRC32C SSE4.2" : "CRC32C slicing-by-8";
+}
@@ -0,0 +1,19 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <QtGlobal>
+
+// CRC32C（Castagnoli多项式，与iSCSI/ext4/Btrfs相同）
+// x86 CPU支持SSE4.2时用crc32指令每次处理8字节，否则用slicing-by-8查表实现，
+// 两种实现结果一致。
+class Crc32c
+{
+public:
+    // 计算data的CRC32C；传入上一段的结果可以分段连续计算
+    static quint32 compute(const void *data, qint64 size, quint32 crc = 0);
+
+    static bool hardwareSupported();
+    static const char *implementationName();
+};
+
+#endif // CRC32C_H
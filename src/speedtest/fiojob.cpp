@@ -0,0 +1,494 @@
+#include "fiojob.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QDebug>
+
+namespace {
+// 作业数和队列深度上限，避免误写参数创建过多线程
+const int kMaxNumJobs = 64;
+const int kMaxIoDepth = 256;
+
+bool parseBool(const QString &value, bool hasValue, bool &result) {
+    if (!hasValue) {
+        result = true;
+        return true;
+    }
+    bool ok = false;
+    int number = value.toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+    result = number != 0;
+    return true;
+}
+
+bool parseInt(const QString &value, int minValue, int maxValue, int &result) {
+    bool ok = false;
+    int number = value.toInt(&ok);
+    if (!ok || number < minValue || number > maxValue) {
+        return false;
+    }
+    result = number;
+    return true;
+}
+}
+
+bool FioJobParser::parseSize(const QString &text, qint64 &bytes) {
+    QString value = text.trimmed().toLower();
+    if (value.isEmpty()) {
+        return false;
+    }
+
+    // 允许的后缀：k kb kib m mb mib ...，统一按1024进位（与fio默认kb_base=1024一致）
+    if (value.endsWith("ib")) {
+        value.chop(2);
+    } else if (value.endsWith('b') && value.size() > 1 && value.at(value.size() - 2).isLetter()) {
+        value.chop(1);
+    }
+
+    qint64 multiplier = 1;
+    if (!value.isEmpty() && value.at(value.size() - 1).isLetter()) {
+        switch (value.at(value.size() - 1).toLatin1()) {
+        case 'k': multiplier = 1024LL; break;
+        case 'm': multiplier = 1024LL * 1024; break;
+        case 'g': multiplier = 1024LL * 1024 * 1024; break;
+        case 't': multiplier = 1024LL * 1024 * 1024 * 1024; break;
+        case 'p': multiplier = 1024LL * 1024 * 1024 * 1024 * 1024; break;
+        case 'b': multiplier = 1; break;
+        default: return false;
+        }
+        value.chop(1);
+    }
+
+    bool ok = false;
+    double number = value.toDouble(&ok);
+    if (!ok || number < 0) {
+        return false;
+    }
+    bytes = static_cast<qint64>(number * multiplier);
+    return true;
+}
+
+bool FioJobParser::parseTime(const QString &text, qint64 &ms) {
+    QString value = text.trimmed().toLower();
+    if (value.isEmpty()) {
+        return false;
+    }
+
+    double multiplier = 1000.0;
+    const struct { const char *suffix; double ms; } units[] = {
+        { "usec", 0.001 }, { "us", 0.001 }, { "msec", 1.0 }, { "ms", 1.0 },
+        { "sec", 1000.0 }, { "s", 1000.0 }, { "min", 60000.0 }, { "m", 60000.0 },
+        { "h", 3600000.0 }, { "d", 86400000.0 }
+    };
+    for (const auto &unit : units) {
+        if (value.endsWith(unit.suffix)) {
+            multiplier = unit.ms;
+            value.chop(static_cast<int>(qstrlen(unit.suffix)));
+            break;
+        }
+    }
+
+    bool ok = false;
+    double number = value.toDouble(&ok);
+    if (!ok || number < 0) {
+        return false;
+    }
+    ms = static_cast<qint64>(number * multiplier);
+    return true;
+}
+
+bool FioJobParser::parseFile(const QString &path, QList<FioJob> &jobs, QString &errorMessage,
+                             QStringList *warnings) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorMessage = QString("无法打开作业文件: %1").arg(path);
+        return false;
+    }
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    return parse(in.readAll(), jobs, errorMessage, warnings);
+}
+
+bool FioJobParser::parse(const QString &text, QList<FioJob> &jobs, QString &errorMessage,
+                         QStringList *warnings) {
+    jobs.clear();
+
+    FioJob globalJob;
+    FioJob currentJob;
+    bool inGlobal = false;
+    bool inJob = false;
+    int jobLine = 0;
+
+    // 结束当前作业段：校验后加入列表
+    auto finishJob = [&]() -> bool {
+        if (!inJob) {
+            return true;
+        }
+        QString error;
+        if (!validate(currentJob, error)) {
+            errorMessage = QString("第%1行 [%2]: %3").arg(jobLine).arg(currentJob.name).arg(error);
+            return false;
+        }
+        jobs.append(currentJob);
+        inJob = false;
+        return true;
+    };
+
+    const QStringList lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        const int lineNumber = i + 1;
+        QString line = lines[i].trimmed();
+
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
+            continue;
+        }
+
+        if (line.startsWith('[')) {
+            if (!line.endsWith(']') || line.size() < 3) {
+                errorMessage = QString("第%1行: 段名格式错误: %2").arg(lineNumber).arg(line);
+                return false;
+            }
+            if (!finishJob()) {
+                return false;
+            }
+
+            QString section = line.mid(1, line.size() - 2).trimmed();
+            if (section.compare("global", Qt::CaseInsensitive) == 0) {
+                inGlobal = true;
+            } else {
+                // 新作业继承此前[global]段中的设置
+                inGlobal = false;
+                inJob = true;
+                jobLine = lineNumber;
+                currentJob = globalJob;
+                currentJob.name = section;
+            }
+            continue;
+        }
+
+        if (!inGlobal && !inJob) {
+            errorMessage = QString("第%1行: 参数必须写在[global]或作业段内: %2").arg(lineNumber).arg(line);
+            return false;
+        }
+
+        // 行尾注释
+        int commentPos = line.indexOf(QRegularExpression("\\s[#;]"));
+        if (commentPos > 0) {
+            line = line.left(commentPos).trimmed();
+        }
+
+        QString key = line;
+        QString value;
+        bool hasValue = false;
+        int equalPos = line.indexOf('=');
+        if (equalPos >= 0) {
+            key = line.left(equalPos).trimmed();
+            value = line.mid(equalPos + 1).trimmed();
+            hasValue = true;
+        }
+        key = key.toLower();
+
+        QString error;
+        if (!applyOption(inGlobal ? globalJob : currentJob, key, value, hasValue, error, warnings)) {
+            errorMessage = QString("第%1行: %2").arg(lineNumber).arg(error);
+            return false;
+        }
+    }
+
+    if (!finishJob()) {
+        return false;
+    }
+
+    if (jobs.isEmpty()) {
+        errorMessage = "作业文件中没有任何作业段";
+        return false;
+    }
+
+    qDebug() << "解析fio作业文件完成，作业数:" << jobs.size();
+    return true;
+}
+
+bool FioJobParser::applyOption(FioJob &job, const QString &key, const QString &value, bool hasValue,
+                               QString &errorMessage, QStringList *warnings) {
+    auto invalidValue = [&]() {
+        errorMessage = QString("参数%1的值无效: %2").arg(key).arg(value);
+        return false;
+    };
+
+    if (key == "rw" || key == "readwrite") {
+        // rw=randread:8 之类的附加参数不支持，只取冒号前部分
+        QString mode = value.section(':', 0, 0).toLower();
+        if (mode == "read") {
+            job.random = false; job.readPercent = 100;
+        } else if (mode == "write") {
+            job.random = false; job.readPercent = 0;
+        } else if (mode == "rw" || mode == "readwrite") {
+            job.random = false; job.readPercent = job.rwMixRead;
+        } else if (mode == "randread") {
+            job.random = true; job.readPercent = 100;
+        } else if (mode == "randwrite") {
+            job.random = true; job.readPercent = 0;
+        } else if (mode == "randrw") {
+            job.random = true; job.readPercent = job.rwMixRead;
+        } else {
+            errorMessage = QString("不支持的rw模式: %1（支持read/write/rw/randread/randwrite/randrw）").arg(value);
+            return false;
+        }
+        job.rw = mode;
+    } else if (key == "rwmixread" || key == "rwmixwrite") {
+        int percent = 0;
+        if (!parseInt(value, 0, 100, percent)) {
+            return invalidValue();
+        }
+        // 混合比例与rw参数的先后顺序无关
+        job.rwMixRead = key == "rwmixread" ? percent : 100 - percent;
+        if (job.rw == "rw" || job.rw == "readwrite" || job.rw == "randrw") {
+            job.readPercent = job.rwMixRead;
+        }
+    } else if (key == "bs" || key == "blocksize") {
+        // bs=读,写 的写法只取读块大小
+        if (value.contains(',') && warnings) {
+            warnings->append(QString("%1: 读写使用不同块大小暂不支持，统一使用 %2").arg(job.name).arg(value.section(',', 0, 0)));
+        }
+        if (!parseSize(value.section(',', 0, 0), job.blockSize) || job.blockSize <= 0) {
+            return invalidValue();
+        }
+    } else if (key == "size") {
+        if (value.endsWith('%')) {
+            if (!parseInt(value.left(value.size() - 1), 1, 100, job.sizePercent)) {
+                return invalidValue();
+            }
+            job.size = 0;
+        } else if (!parseSize(value, job.size)) {
+            return invalidValue();
+        } else {
+            job.sizePercent = 0;
+        }
+    } else if (key == "offset") {
+        if (!parseSize(value, job.offset)) {
+            return invalidValue();
+        }
+    } else if (key == "io_size" || key == "io_limit") {
+        if (!parseSize(value, job.ioLimit)) {
+            return invalidValue();
+        }
+    } else if (key == "iodepth") {
+        if (!parseInt(value, 1, kMaxIoDepth, job.ioDepth)) {
+            return invalidValue();
+        }
+    } else if (key == "numjobs") {
+        if (!parseInt(value, 1, kMaxNumJobs, job.numJobs)) {
+            return invalidValue();
+        }
+    } else if (key == "runtime" || key == "timeout") {
+        if (!parseTime(value, job.runtimeMs)) {
+            return invalidValue();
+        }
+    } else if (key == "ramp_time") {
+        if (!parseTime(value, job.rampTimeMs)) {
+            return invalidValue();
+        }
+    } else if (key == "time_based") {
+        if (!parseBool(value, hasValue, job.timeBased)) {
+            return invalidValue();
+        }
+    } else if (key == "direct") {
+        if (!parseBool(value, hasValue, job.direct)) {
+            return invalidValue();
+        }
+    } else if (key == "buffered") {
+        bool buffered = false;
+        if (!parseBool(value, hasValue, buffered)) {
+            return invalidValue();
+        }
+        job.direct = !buffered;
+    } else if (key == "filename") {
+        job.filename = value;
+    } else if (key == "directory") {
+        job.directory = value;
+    } else if (key == "name") {
+        job.name = value;
+    } else if (key == "ioengine") {
+        QString engine = value.toLower();
+        if (engine == "sync" || engine == "psync" || engine == "pvsync" || engine == "vsync") {
+            job.engine = FioJob::Sync;
+        } else if (engine == "libaio") {
+            job.engine = FioJob::NativeAio;
+        } else if (engine == "io_uring" || engine == "posixaio" || engine == "windowsaio") {
+            // 按异步引擎处理：Linux上使用原生AIO，其他平台用多线程模拟队列深度
+            job.engine = FioJob::NativeAio;
+            if (warnings) {
+                warnings->append(QString("%1: ioengine=%2 按libaio方式运行").arg(job.name).arg(engine));
+            }
+        } else {
+            errorMessage = QString("不支持的ioengine: %1").arg(value);
+            return false;
+        }
+    } else if (key == "random_distribution") {
+        QString type = value.section(':', 0, 0).toLower();
+        QString param = value.section(':', 1, 1);
+        if (type == "random") {
+            job.distribution = FioJob::Uniform;
+            job.distributionParam = 0;
+        } else if (type == "zipf" || type == "pareto") {
+            bool ok = false;
+            double number = param.toDouble(&ok);
+            if (!ok || number <= 0 || (type == "pareto" && number >= 1.0)) {
+                errorMessage = QString("random_distribution参数无效: %1（zipf:theta需大于0，pareto:h需在0到1之间）").arg(value);
+                return false;
+            }
+            job.distribution = type == "zipf" ? FioJob::Zipf : FioJob::Pareto;
+            job.distributionParam = number;
+        } else {
+            errorMessage = QString("不支持的random_distribution: %1（支持random/zipf/pareto）").arg(value);
+            return false;
+        }
+    } else if (key == "randseed") {
+        bool ok = false;
+        quint64 seed = value.toULongLong(&ok);
+        if (!ok) {
+            return invalidValue();
+        }
+        job.randSeed = seed;
+    } else if (key == "fsync") {
+        if (!parseInt(value, 0, 1 << 30, job.fsyncInterval)) {
+            return invalidValue();
+        }
+    } else if (key == "fdatasync") {
+        if (!parseInt(value, 0, 1 << 30, job.fdatasyncInterval)) {
+            return invalidValue();
+        }
+    } else if (key == "sync") {
+        // fio的sync=1或sync=sync/dsync都按O_DSYNC处理
+        QString mode = value.toLower();
+        if (!hasValue || mode == "1" || mode == "sync" || mode == "dsync") {
+            job.syncWrites = true;
+        } else if (mode == "0" || mode == "none") {
+            job.syncWrites = false;
+        } else {
+            return invalidValue();
+        }
+    } else if (key == "end_fsync") {
+        if (!parseBool(value, hasValue, job.endFsync)) {
+            return invalidValue();
+        }
+    } else if (key == "buffer_compress_percentage") {
+        if (!parseInt(value, 0, 100, job.bufferCompressPercent)) {
+            return invalidValue();
+        }
+    } else if (key == "dedupe_percentage") {
+        if (!parseInt(value, 0, 100, job.dedupePercent)) {
+            return invalidValue();
+        }
+    } else if (key == "zero_buffers") {
+        bool zero = false;
+        if (!parseBool(value, hasValue, zero)) {
+            return invalidValue();
+        }
+        job.bufferCompressPercent = zero ? 100 : 0;
+    } else if (key == "scramble_buffers") {
+        if (!parseBool(value, hasValue, job.scrambleBuffers)) {
+            return invalidValue();
+        }
+    } else if (key == "refill_buffers") {
+        if (!parseBool(value, hasValue, job.refillBuffers)) {
+            return invalidValue();
+        }
+    } else if (key == "group_reporting" || key == "thread" || key == "stonewall" || key == "wait_for_previous"
+               || key == "norandommap" || key == "randrepeat" || key == "description") {
+        // 对本实现没有影响的参数：作业本来就按顺序运行、使用线程、不维护随机映射
+    } else {
+        if (warnings) {
+            warnings->append(QString("%1: 忽略不支持的参数 %2").arg(job.name.isEmpty() ? QString("global") : job.name).arg(key));
+        }
+    }
+    return true;
+}
+
+bool FioJobParser::validate(const FioJob &job, QString &errorMessage) {
+    if (job.rw.isEmpty()) {
+        errorMessage = "缺少rw参数";
+        return false;
+    }
+    if (job.blockSize % 512 != 0) {
+        errorMessage = QString("bs必须是512字节的整数倍: %1").arg(job.blockSize);
+        return false;
+    }
+    if (job.direct && job.blockSize % 4096 != 0) {
+        errorMessage = QString("direct=1时bs必须是4K的整数倍: %1").arg(job.blockSize);
+        return false;
+    }
+    if (job.timeBased && job.runtimeMs <= 0) {
+        errorMessage = "time_based需要同时设置runtime";
+        return false;
+    }
+    if (job.size > 0 && job.size < job.blockSize) {
+        errorMessage = "size不能小于bs";
+        return false;
+    }
+    if (job.filename.isEmpty() && job.size <= 0) {
+        errorMessage = "未指定filename时必须设置size（不支持百分比）";
+        return false;
+    }
+    return true;
+}
+
+void FioJob::setDurability(Durability durability, qint64 syncIntervalBytes) {
+    fsyncInterval = 0;
+    fdatasyncInterval = 0;
+    syncWrites = false;
+    endFsync = false;
+
+    switch (durability) {
+    case PeriodicSync:
+        fdatasyncInterval = static_cast<int>(qBound<qint64>(1, syncIntervalBytes / qMax<qint64>(1, blockSize), 1 << 30));
+        endFsync = true;
+        break;
+    case DsyncWrites:
+        syncWrites = true;
+        break;
+    case FinalSync:
+        endFsync = true;
+        break;
+    default:
+        break;
+    }
+}
+
+QString FioJob::durabilityName(Durability durability) {
+    switch (durability) {
+    case NoSync: return "none";
+    case PeriodicSync: return "fdatasync";
+    case DsyncWrites: return "dsync";
+    case FinalSync: return "fsync";
+    default: return QString();
+    }
+}
+
+QString FioJobParser::sampleJobText() {
+    return QString(
+        "; 示例：4K随机读写混合，预热5秒后统计30秒\n"
+        "[global]\n"
+        "ioengine=libaio\n"
+        "direct=1\n"
+        "size=1g\n"
+        "runtime=30\n"
+        "ramp_time=5\n"
+        "time_based\n"
+        "\n"
+        "[randrw-4k]\n"
+        "rw=randrw\n"
+        "rwmixread=70\n"
+        "bs=4k\n"
+        "iodepth=32\n"
+        "numjobs=2\n"
+        "random_distribution=zipf:1.2\n"
+        "\n"
+        "[seqread-1m]\n"
+        "rw=read\n"
+        "bs=1m\n"
+        "iodepth=8\n");
+}
@@ -0,0 +1,106 @@
+#ifndef FIOJOB_H
+#define FIOJOB_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMetaType>
+
+// fio作业定义（只支持常用参数子集）
+struct FioJob {
+    // 偏移量分布
+    enum Distribution {
+        Uniform,    // random（均匀分布）
+        Zipf,       // zipf:theta
+        Pareto      // pareto:h
+    };
+
+    // I/O引擎
+    enum Engine {
+        Sync,       // sync/psync：每个I/O深度一个线程同步读写
+        NativeAio   // libaio：Linux内核原生异步I/O，其他平台退化为Sync
+    };
+
+    // 写入数据的持久化方式，速度测试界面用来设置下面几个同步参数的常用组合
+    enum Durability {
+        NoSync,         // 不同步，写入速度包含系统写缓存
+        PeriodicSync,   // 每写入一定数据量执行一次fdatasync，结束时再同步一次
+        DsyncWrites,    // 以O_DSYNC打开，每次写入落盘后才返回
+        FinalSync       // 只在结束时fsync一次，耗时计入结果
+    };
+
+    QString name;
+    QString filename;       // 目标文件或块设备，为空时在测试目录下自动创建
+    QString directory;      // 自动创建文件的目录
+    QString rw;             // 原始rw参数，用于显示
+    bool random;            // 随机/顺序
+    int readPercent;        // 读操作比例，100为纯读，0为纯写
+    int rwMixRead;          // 混合读写时的读比例(rwmixread)
+    qint64 blockSize;
+    qint64 size;            // 每个作业的I/O范围（字节），0表示使用整个文件/设备
+    int sizePercent;        // size=N%时记录百分比
+    qint64 offset;          // I/O范围起始偏移
+    qint64 ioLimit;         // io_size：非time_based时的总传输量，0表示等于size
+    int ioDepth;
+    int numJobs;
+    qint64 runtimeMs;       // 0表示不限时
+    qint64 rampTimeMs;      // 预热时间，期间的I/O不计入统计
+    bool timeBased;         // 达到size后继续循环直到runtime结束
+    bool direct;
+    Engine engine;
+    Distribution distribution;
+    double distributionParam;
+    quint64 randSeed;
+    int fsyncInterval;      // 每N次写入执行一次fsync，0为不执行
+    int fdatasyncInterval;  // 每N次写入执行一次fdatasync，0为不执行
+    bool syncWrites;        // sync=1/dsync：以O_DSYNC打开文件
+    bool endFsync;          // 作业结束时fsync
+    int bufferCompressPercent;  // 写入数据可压缩比例(buffer_compress_percentage)
+    int dedupePercent;      // 可去重的4K块比例(dedupe_percentage)
+    bool scrambleBuffers;   // 每次写入前给缓冲区打唯一标记，防止去重
+    bool refillBuffers;     // 每次写入前重新生成整个缓冲区
+
+    FioJob()
+        : random(false), readPercent(100), rwMixRead(50), blockSize(4096), size(0), sizePercent(0), offset(0),
+          ioLimit(0), ioDepth(1), numJobs(1), runtimeMs(0), rampTimeMs(0), timeBased(false),
+          direct(false), engine(Sync), distribution(Uniform), distributionParam(0),
+          randSeed(0x89abcdefULL), fsyncInterval(0), fdatasyncInterval(0), syncWrites(false), endFsync(false), bufferCompressPercent(0), dedupePercent(0),
+          scrambleBuffers(true), refillBuffers(false) {}
+
+    bool hasReads() const { return readPercent > 0; }
+    bool hasWrites() const { return readPercent < 100; }
+
+    // 按持久化方式设置同步参数，syncIntervalBytes只用于PeriodicSync，会换算成写入次数
+    void setDurability(Durability durability, qint64 syncIntervalBytes = 0);
+    // 用于记录和基准区分的名称：none/fdatasync/dsync/fsync
+    static QString durabilityName(Durability durability);
+};
+
+Q_DECLARE_METATYPE(FioJob)
+
+// fio作业文件解析
+// 支持[global]段和多个作业段、注释（#和;）、带单位的大小(k/m/g/t)和时间(us/ms/s/m/h)。
+// 不认识的参数只产生警告，语法或取值错误返回false并在errorMessage中给出行号。
+class FioJobParser
+{
+public:
+    static bool parse(const QString &text, QList<FioJob> &jobs, QString &errorMessage,
+                      QStringList *warnings = nullptr);
+    static bool parseFile(const QString &path, QList<FioJob> &jobs, QString &errorMessage,
+                          QStringList *warnings = nullptr);
+
+    // 解析"4k"、"1m"、"2GiB"等大小，单位按1024进位
+    static bool parseSize(const QString &text, qint64 &bytes);
+    // 解析"30"、"500ms"、"2m"等时间，无单位时按秒
+    static bool parseTime(const QString &text, qint64 &ms);
+
+    // 内置示例作业，给界面做初始内容
+    static QString sampleJobText();
+
+private:
+    static bool applyOption(FioJob &job, const QString &key, const QString &value, bool hasValue,
+                            QString &errorMessage, QStringList *warnings);
+    static bool validate(const FioJob &job, QString &errorMessage);
+};
+
+#endif // FIOJOB_H
@@ -0,0 +1,126 @@
+#include "integritypanel.h"
+
+#include <QVBoxLayout>
+#include <QMessageBox>
+#include <QDir>
+#include <QDebug>
+
+IntegrityPanel::IntegrityPanel(QWidget *parent) : SpeedTestPanel("数据校验结果", parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    QLabel *hintLabel = new QLabel("写满指定空间后逐块读回比对，用于识别扩容卡、假U盘；"
+                                   "写入总量选100%可用空间时检测整张卡", this);
+    hintLabel->setWordWrap(true);
+    m_resultLabel = new QLabel("尚未进行数据校验", this);
+    m_resultLabel->setWordWrap(true);
+
+    layout->addWidget(hintLabel);
+    layout->addWidget(m_resultLabel);
+}
+
+bool IntegrityPanel::start(const SpeedTestParameters &parameters) {
+    const QString &testDir = parameters.testDirectory;
+    DiskUsage usage = DiskUtils::getDiskUsage(testDir);
+    qint64 freeSpace = usage.freeSpace;
+
+    // 写满时给文件系统元数据留一点余量
+    const qint64 reserveBytes = 64LL * 1024 * 1024;
+    qint64 targetBytes = 0;
+    if (parameters.targetIsPercent) {
+        targetBytes = qMin(freeSpace / 100 * parameters.targetAmount, freeSpace - reserveBytes);
+    } else {
+        targetBytes = static_cast<qint64>(parameters.targetAmount) * 1024 * 1024 * 1024;
+    }
+
+    if (targetBytes <= 0 || targetBytes > freeSpace - reserveBytes) {
+        QMessageBox::warning(this, "错误", QString("磁盘空间不足，无法进行测试\n可用空间: %1，计划写入: %2")
+                             .arg(DiskUtils::formatSize(freeSpace))
+                             .arg(DiskUtils::formatSize(targetBytes)));
+        return false;
+    }
+
+    qDebug() << "开始数据校验测试，目录:" << testDir << "写入量:" << targetBytes;
+
+    m_parameters = parameters;
+    emit statusChanged(QString("正在进行数据校验，计划写入 %1...").arg(DiskUtils::formatSize(targetBytes)));
+    m_resultLabel->setText("测试进行中...");
+
+    IntegrityTester *tester = new IntegrityTester(testDir, targetBytes);
+    connect(tester, &IntegrityTester::progressUpdated, this, [this](int percent, const QString &phase, double currentSpeed) {
+        emit progressChanged(percent);
+        emit statusChanged(QString("数据校验 - %1中: %2 MB/s").arg(phase).arg(currentSpeed, 0, 'f', 2));
+    });
+    connect(tester, &IntegrityTester::testCompleted, this, &IntegrityPanel::onTestCompleted);
+    runWorker(tester, &IntegrityTester::startTest, &IntegrityTester::testCompleted);
+    return true;
+}
+
+void IntegrityPanel::setOptionsEnabled(bool enabled) {
+    // 写入总量由宿主界面的公共设置决定，本面板没有自己的选项
+    Q_UNUSED(enabled);
+}
+
+void IntegrityPanel::onTestCompleted(const IntegrityResult &result) {
+    if (result.bytesWritten == 0) {
+        QString message = result.errorMessage.isEmpty() ? QString("测试失败") : result.errorMessage;
+        emit statusChanged(message);
+        m_resultLabel->setText(message);
+        return;
+    }
+
+    QString summary = QString("写入 %1（%2 MB/s），读回校验 %3（%4 MB/s）")
+                          .arg(DiskUtils::formatSize(result.bytesWritten))
+                          .arg(result.writeSpeed, 0, 'f', 2)
+                          .arg(DiskUtils::formatSize(result.bytesVerified))
+                          .arg(result.readSpeed, 0, 'f', 2);
+
+    if (result.firstBadOffset >= 0) {
+        summary += QString("\n发现错误！首个错误位置: %1（%2）\n数据损坏 %3 块，地址错位 %4 块，读取失败 %5")
+                       .arg(DiskUtils::formatSize(result.firstBadOffset))
+                       .arg(QDir::toNativeSeparators(result.firstBadFile))
+                       .arg(result.corruptedBlocks)
+                       .arg(result.misplacedBlocks)
+                       .arg(DiskUtils::formatSize(result.unreadableBytes));
+        summary += QString("\n估算真实可用容量: %1").arg(DiskUtils::formatSize(result.usableBytes));
+        if (result.misplacedBlocks > 0) {
+            summary += "\n读到了其他位置写入的数据，该设备很可能虚标了容量";
+        }
+    } else if (result.dataIntact()) {
+        summary += "\n全部数据校验通过，未发现错误";
+    }
+
+    if (!result.writeError.isEmpty()) {
+        summary += QString("\n写入提前结束: %1").arg(result.writeError);
+    }
+    if (!result.success) {
+        summary += QString("\n测试未完成: %1").arg(result.errorMessage);
+    }
+
+    m_resultLabel->setText(summary);
+    emit speedsMeasured(result.readSpeed, result.writeSpeed);
+
+    if (!result.success) {
+        emit statusChanged(result.errorMessage);
+        return;
+    }
+
+    emit progressChanged(100);
+    emit statusChanged(result.firstBadOffset >= 0 ? QString("数据校验完成，发现错误") : QString("数据校验完成"));
+
+    SpeedTestRecord record = newRecord("verify");
+    record.blockSize = IntegrityTester::kBlockSize;
+    record.fileSize = result.bytesWritten;
+    record.readMBps = result.readSpeed;
+    record.writeMBps = result.writeSpeed;
+    record.parameters["plannedBytes"] = result.plannedBytes;
+    record.parameters["bytesVerified"] = result.bytesVerified;
+    record.parameters["usableBytes"] = result.usableBytes;
+    record.parameters["firstBadOffset"] = result.firstBadOffset;
+    record.parameters["corruptedBlocks"] = result.corruptedBlocks;
+    record.parameters["misplacedBlocks"] = result.misplacedBlocks;
+    record.parameters["unreadableBytes"] = result.unreadableBytes;
+    if (!result.writeError.isEmpty()) {
+        record.parameters["writeError"] = result.writeError;
+    }
+    emit recordReady(record);
+}
@@ -0,0 +1,27 @@
+#ifndef INTEGRITYPANEL_H
+#define INTEGRITYPANEL_H
+
+#include <QLabel>
+
+#include "speedtestpanel.h"
+#include "integritytester.h"
+
+// 数据校验（写满后读回比对）模式面板
+class IntegrityPanel : public SpeedTestPanel
+{
+    Q_OBJECT
+
+public:
+    explicit IntegrityPanel(QWidget *parent = nullptr);
+
+    bool start(const SpeedTestParameters &parameters) override;
+    void setOptionsEnabled(bool enabled) override;
+
+private slots:
+    void onTestCompleted(const IntegrityResult &result);
+
+private:
+    QLabel *m_resultLabel;
+};
+
+#endif // INTEGRITYPANEL_H
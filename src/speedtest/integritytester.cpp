@@ -0,0 +1,350 @@
+#include "integritytester.h"
+#include "iocore.h"
+#include "crc32c.h"
+#include "patterngenerator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <cstring>
+
+namespace {
+// 单个测试文件的大小，兼容FAT32的4GB单文件上限
+const qint64 kFileSize = 1024LL * 1024 * 1024;
+// 单次读写长度，kFileSize必须是它的整数倍
+const qint64 kChunkSize = 4 * 1024 * 1024;
+// 块头魔数 "DTVERIFY"
+const quint64 kHeaderMagic = 0x5946495245565444ULL;
+// 块头中crc字段的位置，校验和覆盖它前后的全部内容
+const int kCrcOffset = 32;
+const int kCrcSize = 4;
+// 进度刷新间隔（毫秒）
+const qint64 kProgressIntervalMs = 500;
+// 日志中最多逐条列出的错误块数
+const int kMaxLoggedBadBlocks = 16;
+}
+
+IntegrityTester::IntegrityTester(const QString &testDirectory, qint64 targetBytes, QObject *parent)
+    : QObject(parent), m_testDirectory(testDirectory), m_canceled(0) {
+    // 按校验块对齐，同时满足直接I/O的对齐要求
+    m_targetBytes = targetBytes - (targetBytes % kBlockSize);
+    m_seed = QRandomGenerator::global()->generate64();
+    qRegisterMetaType<IntegrityResult>("IntegrityResult");
+}
+
+void IntegrityTester::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+void IntegrityTester::startTest() {
+    IntegrityResult result;
+    result.plannedBytes = m_targetBytes;
+
+    if (m_targetBytes <= 0) {
+        result.errorMessage = "写入目标大小无效";
+        emit testCompleted(result);
+        return;
+    }
+
+    qDebug() << "数据校验测试开始:" << m_testDirectory << "计划写入" << m_targetBytes << "字节,"
+             << Crc32c::implementationName() << "," << PatternGenerator::implementationName();
+
+    writePhase(result);
+    if (!m_canceled.loadRelaxed()) {
+        verifyPhase(result);
+    }
+
+    // 无论结果如何都删除测试文件
+    for (const QString &path : m_files) {
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qDebug() << "删除数据校验测试文件失败:" << path;
+        }
+    }
+
+    result.usableBytes = result.firstBadOffset >= 0 ? result.firstBadOffset : result.bytesVerified;
+
+    if (m_canceled.loadRelaxed()) {
+        result.errorMessage = "测试已取消";
+    } else if (result.errorMessage.isEmpty()) {
+        result.success = true;
+    }
+
+    qDebug() << "数据校验测试结束: 写入" << result.bytesWritten << "校验" << result.bytesVerified
+             << "损坏块" << result.corruptedBlocks << "错位块" << result.misplacedBlocks
+             << "读取失败" << result.unreadableBytes << "首个错误位置" << result.firstBadOffset;
+
+    emit testCompleted(result);
+}
+
+void IntegrityTester::writePhase(IntegrityResult &result) {
+    // 双缓冲：一个缓冲区在后台写入时生成下一个
+    AlignedBuffer buffers[2];
+    buffers[0].resize(kChunkSize);
+    buffers[1].resize(kChunkSize);
+    if (!buffers[0].data() || !buffers[1].data()) {
+        result.errorMessage = "分配写入缓冲区失败";
+        return;
+    }
+
+    PatternGenerator pattern(m_seed);
+    auto generate = [this, &pattern](char *buffer, qint64 length, qint64 offset) {
+        pattern.fill(buffer, length);
+        stampBlocks(buffer, length, offset);
+    };
+
+    IoFile file;
+    int fileIndex = -1;
+    IoFile *filePtr = &file;
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 lastProgressMs = 0;
+    qint64 lastProgressBytes = 0;
+
+    qint64 offset = 0;
+    int current = 0;
+    generate(buffers[current].data(), qMin(kChunkSize, m_targetBytes), 0);
+
+    while (offset < m_targetBytes && !m_canceled.loadRelaxed()) {
+        // 块按文件顺序排列，跨过文件边界时换下一个文件
+        const int index = static_cast<int>(offset / kFileSize);
+        if (index != fileIndex) {
+            file.sync();
+            file.close();
+            const QString path = filePathAt(index);
+            m_files.append(path);
+            if (!file.open(path, IoFile::WriteOnly | IoFile::Create | IoFile::Truncate | IoFile::Direct)) {
+                result.writeError = file.errorString();
+                break;
+            }
+            if (!file.isDirect()) {
+                qDebug() << "数据校验测试未能使用直接I/O，读回前将尝试丢弃系统缓存";
+            }
+            fileIndex = index;
+        }
+
+        const char *data = buffers[current].data();
+        const qint64 length = qMin(kChunkSize, m_targetBytes - offset);
+        const qint64 fileOffset = offset - index * kFileSize;
+
+        QFuture<qint64> pending = QtConcurrent::run([filePtr, data, length, fileOffset]() {
+            return filePtr->writeAt(data, length, fileOffset);
+        });
+
+        // 写入进行时生成下一块数据
+        const qint64 nextOffset = offset + length;
+        if (nextOffset < m_targetBytes) {
+            generate(buffers[1 - current].data(), qMin(kChunkSize, m_targetBytes - nextOffset), nextOffset);
+        }
+
+        qint64 written = pending.result();
+        if (written != length) {
+            // 写满或设备报错时提前结束写入，已写入的部分照常校验
+            result.writeError = written < 0 ? file.errorString() : QString("写入不完整，可能磁盘已满");
+            break;
+        }
+
+        offset = nextOffset;
+        current = 1 - current;
+
+        qint64 nowMs = timer.elapsed();
+        if (nowMs - lastProgressMs >= kProgressIntervalMs) {
+            double speed = ((offset - lastProgressBytes) / (1024.0 * 1024.0)) / ((nowMs - lastProgressMs) / 1000.0);
+            emit progressUpdated(percentDone(offset, false, m_targetBytes), "写入", speed);
+            lastProgressMs = nowMs;
+            lastProgressBytes = offset;
+        }
+    }
+
+    // 刷盘时间计入写入耗时
+    file.sync();
+    file.close();
+    qint64 totalMs = timer.elapsed();
+
+    result.bytesWritten = offset;
+    if (totalMs > 0) {
+        result.writeSpeed = (offset / (1024.0 * 1024.0)) / (totalMs / 1000.0);
+    }
+    if (!result.writeError.isEmpty()) {
+        qDebug() << "数据校验写入提前结束:" << result.writeError << "已写入" << offset << "字节";
+    }
+}
+
+void IntegrityTester::verifyPhase(IntegrityResult &result) {
+    const qint64 total = result.bytesWritten;
+    if (total <= 0) {
+        if (result.errorMessage.isEmpty()) {
+            result.errorMessage = result.writeError.isEmpty() ? QString("没有写入任何数据") : result.writeError;
+        }
+        return;
+    }
+
+    AlignedBuffer buffers[2];
+    buffers[0].resize(kChunkSize);
+    buffers[1].resize(kChunkSize);
+    if (!buffers[0].data() || !buffers[1].data()) {
+        result.errorMessage = "分配读取缓冲区失败";
+        return;
+    }
+
+    // 校验一个已读入的缓冲区，读取失败的整段按不可读计入
+    auto verifyChunk = [this, &result](const char *buffer, qint64 length, qint64 offset, bool readOk) {
+        if (!readOk) {
+            result.unreadableBytes += length;
+            if (result.firstBadOffset < 0) {
+                result.firstBadOffset = offset;
+                result.firstBadFile = filePathAt(static_cast<int>(offset / kFileSize));
+            }
+            return;
+        }
+        for (qint64 pos = 0; pos < length; pos += kBlockSize) {
+            BlockStatus status = checkBlock(buffer + pos, offset + pos);
+            if (status != BlockOk) {
+                recordBadBlock(result, offset + pos, status);
+            }
+        }
+        result.bytesVerified += length;
+    };
+
+    IoFile file;
+    int fileIndex = -1;
+    bool fileOk = false;
+    IoFile *filePtr = &file;
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 lastProgressMs = 0;
+    qint64 lastProgressBytes = 0;
+
+    // 上一轮读入、等待校验的缓冲区
+    int pendingIndex = -1;
+    qint64 pendingOffset = 0;
+    qint64 pendingLength = 0;
+    bool pendingOk = false;
+
+    qint64 offset = 0;
+    int current = 0;
+    while (offset < total && !m_canceled.loadRelaxed()) {
+        const int index = static_cast<int>(offset / kFileSize);
+        if (index != fileIndex) {
+            file.close();
+            fileOk = file.open(filePathAt(index), IoFile::ReadOnly | IoFile::Direct);
+            if (!fileOk) {
+                qDebug() << "打开数据校验测试文件失败:" << file.errorString();
+            } else if (!file.isDirect() && !file.dropCache()) {
+                qDebug() << "无法绕过系统缓存，读回的数据可能来自内存而非磁盘";
+            }
+            fileIndex = index;
+        }
+
+        char *data = buffers[current].data();
+        const qint64 length = qMin(kChunkSize, total - offset);
+        const qint64 fileOffset = offset - index * kFileSize;
+
+        QFuture<qint64> pending;
+        if (fileOk) {
+            pending = QtConcurrent::run([filePtr, data, length, fileOffset]() {
+                return filePtr->readAt(data, length, fileOffset);
+            });
+        }
+
+        // 读取进行时校验上一个缓冲区
+        if (pendingIndex >= 0) {
+            verifyChunk(buffers[pendingIndex].data(), pendingLength, pendingOffset, pendingOk);
+        }
+
+        pendingOk = fileOk && pending.result() == length;
+        pendingIndex = current;
+        pendingOffset = offset;
+        pendingLength = length;
+
+        offset += length;
+        current = 1 - current;
+
+        qint64 nowMs = timer.elapsed();
+        if (nowMs - lastProgressMs >= kProgressIntervalMs) {
+            double speed = ((offset - lastProgressBytes) / (1024.0 * 1024.0)) / ((nowMs - lastProgressMs) / 1000.0);
+            emit progressUpdated(percentDone(offset, true, total), "校验", speed);
+            lastProgressMs = nowMs;
+            lastProgressBytes = offset;
+        }
+    }
+
+    if (pendingIndex >= 0) {
+        verifyChunk(buffers[pendingIndex].data(), pendingLength, pendingOffset, pendingOk);
+    }
+    file.close();
+
+    qint64 totalMs = timer.elapsed();
+    if (totalMs > 0) {
+        result.readSpeed = (offset / (1024.0 * 1024.0)) / (totalMs / 1000.0);
+    }
+}
+
+void IntegrityTester::stampBlocks(char *buffer, qint64 length, qint64 offset) const {
+    for (qint64 pos = 0; pos < length; pos += kBlockSize) {
+        char *block = buffer + pos;
+
+        BlockHeader header;
+        header.magic = kHeaderMagic;
+        header.offset = static_cast<quint64>(offset + pos);
+        header.sequence = header.offset / kBlockSize;
+        header.seed = m_seed;
+        header.crc = 0;
+        header.blockSize = kBlockSize;
+        memcpy(block, &header, sizeof(header));
+
+        quint32 crc = Crc32c::compute(block, kCrcOffset);
+        crc = Crc32c::compute(block + kCrcOffset + kCrcSize, kBlockSize - kCrcOffset - kCrcSize, crc);
+        memcpy(block + kCrcOffset, &crc, sizeof(crc));
+    }
+}
+
+IntegrityTester::BlockStatus IntegrityTester::checkBlock(const char *block, qint64 offset) const {
+    BlockHeader header;
+    memcpy(&header, block, sizeof(header));
+
+    quint32 crc = Crc32c::compute(block, kCrcOffset);
+    crc = Crc32c::compute(block + kCrcOffset + kCrcSize, kBlockSize - kCrcOffset - kCrcSize, crc);
+    if (header.magic != kHeaderMagic || crc != header.crc || header.blockSize != static_cast<quint32>(kBlockSize)) {
+        return BlockCorrupted;
+    }
+
+    // 内容完好却不是这里应有的块：读到了别处写入的数据或上一次测试的残留
+    if (header.offset != static_cast<quint64>(offset) || header.sequence != header.offset / kBlockSize
+        || header.seed != m_seed) {
+        return BlockMisplaced;
+    }
+    return BlockOk;
+}
+
+void IntegrityTester::recordBadBlock(IntegrityResult &result, qint64 offset, BlockStatus status) const {
+    if (status == BlockCorrupted) {
+        ++result.corruptedBlocks;
+    } else {
+        ++result.misplacedBlocks;
+    }
+
+    if (result.firstBadOffset < 0 || offset < result.firstBadOffset) {
+        result.firstBadOffset = offset;
+        result.firstBadFile = filePathAt(static_cast<int>(offset / kFileSize));
+    }
+
+    if (result.badBlocks() <= kMaxLoggedBadBlocks) {
+        qDebug() << "数据校验失败: 位置" << offset << (status == BlockCorrupted ? "数据损坏" : "地址错位");
+    }
+}
+
+QString IntegrityTester::filePathAt(int index) const {
+    return QDir(m_testDirectory).filePath(QString("disktoolbox_verify_%1.dat").arg(index, 4, 10, QChar('0')));
+}
+
+int IntegrityTester::percentDone(qint64 bytesDone, bool verifying, qint64 total) const {
+    // 写入和校验各占一半进度
+    int percent = total > 0 ? static_cast<int>(bytesDone * 50 / total) : 0;
+    return verifying ? 50 + percent : percent;
+}
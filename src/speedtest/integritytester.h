@@ -0,0 +1,101 @@
+#ifndef INTEGRITYTESTER_H
+#define INTEGRITYTESTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMetaType>
+#include <QAtomicInt>
+
+// 数据校验测试结果
+struct IntegrityResult {
+    bool success;               // 流程完整跑完（不代表数据无误）
+    qint64 plannedBytes;        // 计划写入量
+    qint64 bytesWritten;        // 实际写入量
+    qint64 bytesVerified;       // 已读回校验的数据量
+    double writeSpeed;          // 写入阶段平均速度(MB/s)
+    double readSpeed;           // 读回校验阶段平均速度(MB/s)
+    qint64 corruptedBlocks;     // 校验和不符（数据损坏）的块数
+    qint64 misplacedBlocks;     // 校验和正确但偏移/种子不符的块数（地址回绕，扩容卡的典型表现）
+    qint64 unreadableBytes;     // 读取出错的数据量
+    qint64 firstBadOffset;      // 第一个错误块在写入数据中的位置，-1表示没有错误
+    QString firstBadFile;       // 第一个错误块所在的测试文件
+    qint64 usableBytes;         // 从头开始连续校验通过的数据量，即估算的真实可用容量
+    QString writeError;         // 写入阶段提前结束的原因（写满、I/O错误等）
+    QString errorMessage;
+
+    IntegrityResult()
+        : success(false), plannedBytes(0), bytesWritten(0), bytesVerified(0), writeSpeed(0), readSpeed(0),
+          corruptedBlocks(0), misplacedBlocks(0), unreadableBytes(0), firstBadOffset(-1), usableBytes(0) {}
+
+    qint64 badBlocks() const { return corruptedBlocks + misplacedBlocks; }
+    bool dataIntact() const { return firstBadOffset < 0 && bytesVerified == bytesWritten && bytesWritten > 0; }
+};
+
+Q_DECLARE_METATYPE(IntegrityResult)
+
+// 数据完整性校验（写入-读回-比对），用于识别扩容卡、假U盘等虚标容量的存储介质
+// 在目标目录下按1GB一个文件写满指定数据量，每个4K块开头嵌入块头
+// （魔数、写入偏移、序号、本次测试种子和CRC32C），其余部分为随机数据。
+// 读回时逐块检查块头和校验和：校验和不符说明数据损坏，校验和正确但偏移或种子不符
+// 说明读到的是别处或上一次写入的数据，即设备地址回绕。
+// 写入阶段在后台写一个缓冲区的同时生成下一个，读回阶段在后台读下一个缓冲区的同时
+// 校验当前缓冲区，数据生成、I/O和校验互相重叠。
+class IntegrityTester : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 校验粒度，每块一个块头
+    static const int kBlockSize = 4096;
+
+    // targetBytes为计划写入量，写满磁盘提前结束时只校验已写入的部分
+    IntegrityTester(const QString &testDirectory, qint64 targetBytes, QObject *parent = nullptr);
+
+    void cancel();
+
+public slots:
+    void startTest();
+
+signals:
+    // phase为"写入"或"校验"，percent为整个测试的进度
+    void progressUpdated(int percent, const QString &phase, double currentSpeed);
+    void testCompleted(const IntegrityResult &result);
+
+private:
+    // 每个块的块头，位于块的最开头
+    struct BlockHeader {
+        quint64 magic;
+        quint64 offset;     // 在全部写入数据中的位置
+        quint64 sequence;   // 写入序号
+        quint64 seed;       // 本次测试的随机种子，区分上一次测试残留的数据
+        quint32 crc;        // 除crc字段外整个块的CRC32C
+        quint32 blockSize;
+    };
+
+    // 块内容检查结果
+    enum BlockStatus {
+        BlockOk,
+        BlockCorrupted,
+        BlockMisplaced
+    };
+
+    void writePhase(IntegrityResult &result);
+    void verifyPhase(IntegrityResult &result);
+
+    // 在buffer中为从offset开始的各块写入块头和校验和（数据部分已填好）
+    void stampBlocks(char *buffer, qint64 length, qint64 offset) const;
+    BlockStatus checkBlock(const char *block, qint64 offset) const;
+    void recordBadBlock(IntegrityResult &result, qint64 offset, BlockStatus status) const;
+
+    QString filePathAt(int index) const;
+    int percentDone(qint64 bytesDone, bool verifying, qint64 total) const;
+
+    QString m_testDirectory;
+    qint64 m_targetBytes;
+    quint64 m_seed;
+    QStringList m_files;        // 已创建的测试文件，按写入顺序
+    QAtomicInt m_canceled;
+};
+
+#endif // INTEGRITYTESTER_H
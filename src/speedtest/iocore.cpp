@@ -0,0 +1,409 @@
+#include "iocore.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#define NOMINMAX
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <linux/fs.h>
+#include <sys/syscall.h>
+
+// glibc没有导出ioprio相关定义，按内核头文件取值
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_CLASS_IDLE 3
+#define IOPRIO_WHO_PROCESS 1
+#endif
+
+// ==================== AlignedBuffer ====================
+
+AlignedBuffer::AlignedBuffer(qint64 size, int alignment)
+    : m_data(nullptr), m_size(0), m_alignment(alignment) {
+    resize(size);
+}
+
+AlignedBuffer::~AlignedBuffer() {
+    if (m_data) {
+        qFreeAligned(m_data);
+    }
+}
+
+void AlignedBuffer::resize(qint64 size) {
+    if (m_data) {
+        qFreeAligned(m_data);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    if (size <= 0) {
+        return;
+    }
+
+    // 长度也向上对齐，保证直接I/O时整块读写不会越界
+    qint64 alignedSize = ((size + m_alignment - 1) / m_alignment) * m_alignment;
+    m_data = static_cast<char*>(qMallocAligned(static_cast<size_t>(alignedSize), static_cast<size_t>(m_alignment)));
+    if (m_data) {
+        m_size = size;
+    } else {
+        qDebug() << "分配对齐缓冲区失败，大小:" << alignedSize;
+    }
+}
+
+// ==================== IoFile ====================
+
+IoFile::IoFile()
+#ifdef Q_OS_WIN
+    : m_handle(INVALID_HANDLE_VALUE)
+#else
+    : m_fd(-1)
+#endif
+    , m_direct(false)
+    , m_blockDevice(false) {
+}
+
+IoFile::~IoFile() {
+    close();
+}
+
+bool IoFile::open(const QString &path, int flags) {
+    close();
+
+    m_path = path;
+    m_errorString.clear();
+    m_direct = false;
+    m_blockDevice = false;
+
+    bool wantDirect = (flags & Direct) != 0;
+
+#ifdef Q_OS_WIN
+    DWORD access = 0;
+    if (flags & ReadOnly) access |= GENERIC_READ;
+    if (flags & WriteOnly) access |= GENERIC_WRITE;
+
+    DWORD disposition = OPEN_EXISTING;
+    if ((flags & Create) && (flags & Truncate)) {
+        disposition = CREATE_ALWAYS;
+    } else if (flags & Create) {
+        disposition = OPEN_ALWAYS;
+    } else if (flags & Truncate) {
+        disposition = TRUNCATE_EXISTING;
+    }
+
+    m_blockDevice = path.startsWith("\\\\.\\");
+    QString nativePath = m_blockDevice ? path : QDir::toNativeSeparators(path);
+
+    DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+    if (wantDirect) {
+        attributes |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH;
+    }
+    if (flags & Dsync) {
+        attributes |= FILE_FLAG_WRITE_THROUGH;
+    }
+
+    HANDLE handle = CreateFileW(reinterpret_cast<LPCWSTR>(nativePath.utf16()), access,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                disposition, attributes, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        setSystemError("打开");
+        return false;
+    }
+
+    m_handle = handle;
+    m_direct = wantDirect;
+#else
+    int openFlags = O_CLOEXEC;
+    if ((flags & ReadWrite) == ReadWrite) {
+        openFlags |= O_RDWR;
+    } else if (flags & WriteOnly) {
+        openFlags |= O_WRONLY;
+    } else {
+        openFlags |= O_RDONLY;
+    }
+    if (flags & Create) openFlags |= O_CREAT;
+    if (flags & Truncate) openFlags |= O_TRUNC;
+    if (flags & Dsync) openFlags |= O_DSYNC;
+
+    QByteArray nativePath = QFile::encodeName(path);
+    int fd = -1;
+
+#ifdef O_DIRECT
+    if (wantDirect) {
+        fd = ::open(nativePath.constData(), openFlags | O_DIRECT, 0644);
+        if (fd >= 0) {
+            m_direct = true;
+        } else if (errno == EINVAL) {
+            // tmpfs等文件系统不支持O_DIRECT，回退为普通I/O
+            qDebug() << "文件系统不支持O_DIRECT，回退为缓冲I/O:" << path;
+        } else {
+            setSystemError("打开");
+            return false;
+        }
+    }
+#endif
+
+    if (fd < 0) {
+        fd = ::open(nativePath.constData(), openFlags, 0644);
+        if (fd < 0) {
+            setSystemError("打开");
+            return false;
+        }
+    }
+
+#if defined(Q_OS_MACOS) || defined(Q_OS_DARWIN)
+    if (wantDirect && fcntl(fd, F_NOCACHE, 1) == 0) {
+        m_direct = true;
+    }
+#endif
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        m_blockDevice = S_ISBLK(st.st_mode);
+    }
+
+    m_fd = fd;
+#endif
+
+    return true;
+}
+
+void IoFile::close() {
+#ifdef Q_OS_WIN
+    if (m_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(static_cast<HANDLE>(m_handle));
+        m_handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
+
+bool IoFile::isOpen() const {
+#ifdef Q_OS_WIN
+    return m_handle != INVALID_HANDLE_VALUE;
+#else
+    return m_fd >= 0;
+#endif
+}
+
+qintptr IoFile::nativeHandle() const {
+#ifdef Q_OS_WIN
+    return reinterpret_cast<qintptr>(m_handle);
+#else
+    return m_fd;
+#endif
+}
+
+qint64 IoFile::readAt(void *buffer, qint64 length, qint64 offset) {
+    if (!isOpen()) {
+        m_errorString = "文件未打开";
+        return -1;
+    }
+
+#ifdef Q_OS_WIN
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD bytesRead = 0;
+    if (!ReadFile(static_cast<HANDLE>(m_handle), buffer, static_cast<DWORD>(length), &bytesRead, &overlapped)) {
+        if (GetLastError() == ERROR_HANDLE_EOF) {
+            return 0;
+        }
+        setSystemError("读取");
+        return -1;
+    }
+    return bytesRead;
+#else
+    qint64 total = 0;
+    char *dst = static_cast<char*>(buffer);
+    while (total < length) {
+        ssize_t n = ::pread(m_fd, dst + total, static_cast<size_t>(length - total), offset + total);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            setSystemError("读取");
+            return -1;
+        }
+        if (n == 0) {
+            break; // 到达文件末尾
+        }
+        total += n;
+    }
+    return total;
+#endif
+}
+
+qint64 IoFile::writeAt(const void *buffer, qint64 length, qint64 offset) {
+    if (!isOpen()) {
+        m_errorString = "文件未打开";
+        return -1;
+    }
+
+#ifdef Q_OS_WIN
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD bytesWritten = 0;
+    if (!WriteFile(static_cast<HANDLE>(m_handle), buffer, static_cast<DWORD>(length), &bytesWritten, &overlapped)) {
+        setSystemError("写入");
+        return -1;
+    }
+    return bytesWritten;
+#else
+    qint64 total = 0;
+    const char *src = static_cast<const char*>(buffer);
+    while (total < length) {
+        ssize_t n = ::pwrite(m_fd, src + total, static_cast<size_t>(length - total), offset + total);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            setSystemError("写入");
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    return total;
+#endif
+}
+
+bool IoFile::sync() {
+    if (!isOpen()) {
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    if (!FlushFileBuffers(static_cast<HANDLE>(m_handle))) {
+        setSystemError("刷新");
+        return false;
+    }
+#else
+    if (::fsync(m_fd) != 0) {
+        setSystemError("刷新");
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool IoFile::dataSync() {
+    if (!isOpen()) {
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    if (::fdatasync(m_fd) != 0) {
+        setSystemError("刷新");
+        return false;
+    }
+    return true;
+#else
+    return sync();
+#endif
+}
+
+bool IoFile::dropCache() {
+    if (!isOpen()) {
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    // 已缓存的页需要先落盘才能被丢弃
+    ::fdatasync(m_fd);
+    return ::posix_fadvise(m_fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+#else
+    // Windows和macOS没有针对单个文件清理缓存的接口
+    return false;
+#endif
+}
+
+qint64 IoFile::size() const {
+    if (!isOpen()) {
+        return -1;
+    }
+
+#ifdef Q_OS_WIN
+    HANDLE handle = static_cast<HANDLE>(m_handle);
+    if (m_blockDevice) {
+        GET_LENGTH_INFORMATION lengthInfo;
+        DWORD returned = 0;
+        if (DeviceIoControl(handle, IOCTL_DISK_GET_LENGTH_INFO, nullptr, 0,
+                            &lengthInfo, sizeof(lengthInfo), &returned, nullptr)) {
+            return lengthInfo.Length.QuadPart;
+        }
+        return -1;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(handle, &fileSize)) {
+        return fileSize.QuadPart;
+    }
+    return -1;
+#else
+#ifdef Q_OS_LINUX
+    if (m_blockDevice) {
+        quint64 deviceSize = 0;
+        if (ioctl(m_fd, BLKGETSIZE64, &deviceSize) == 0) {
+            return static_cast<qint64>(deviceSize);
+        }
+        return -1;
+    }
+#endif
+    struct stat st;
+    if (fstat(m_fd, &st) == 0) {
+        return st.st_size;
+    }
+    return -1;
+#endif
+}
+
+bool IoFile::setThreadBackgroundIo(bool enable) {
+#ifdef Q_OS_WIN
+    // 后台模式同时降低CPU和I/O优先级
+    return SetThreadPriority(GetCurrentThread(), enable ? THREAD_MODE_BACKGROUND_BEGIN : THREAD_MODE_BACKGROUND_END) != 0;
+#elif defined(Q_OS_LINUX)
+    // who=0时只作用于调用线程；优先级值0表示恢复为按nice值推导的默认类
+    int priority = enable ? (IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) : 0;
+    if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, priority) != 0) {
+        qDebug() << "设置I/O优先级失败:" << strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(enable);
+    return false;
+#endif
+}
+
+void IoFile::setSystemError(const QString &operation) {
+#ifdef Q_OS_WIN
+    DWORD code = GetLastError();
+    m_errorString = QString("%1失败: %2 (错误码 %3)").arg(operation).arg(m_path).arg(code);
+#else
+    int code = errno;
+    m_errorString = QString("%1失败: %2 (%3)").arg(operation).arg(m_path).arg(QString::fromLocal8Bit(strerror(code)));
+#endif
+    qDebug() << m_errorString;
+}
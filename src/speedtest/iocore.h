@@ -0,0 +1,112 @@
+#ifndef IOCORE_H
+#define IOCORE_H
+
+#include <QString>
+#include <QtGlobal>
+
+// 速度测试使用的底层I/O封装
+// 提供按偏移量读写、绕过页缓存(O_DIRECT / FILE_FLAG_NO_BUFFERING)等能力，
+// 所有测试模式都通过这里访问文件或块设备。
+
+// 按扇区对齐的内存缓冲区（直接I/O要求缓冲区地址和长度都对齐）
+class AlignedBuffer
+{
+public:
+    explicit AlignedBuffer(qint64 size = 0, int alignment = 4096);
+    ~AlignedBuffer();
+
+    // 重新分配缓冲区，原有内容不保留
+    void resize(qint64 size);
+
+    char *data() { return m_data; }
+    const char *data() const { return m_data; }
+    qint64 size() const { return m_size; }
+    int alignment() const { return m_alignment; }
+
+private:
+    Q_DISABLE_COPY(AlignedBuffer)
+
+    char *m_data;
+    qint64 m_size;
+    int m_alignment;
+};
+
+class IoFile
+{
+public:
+    // 打开选项
+    enum OpenFlag {
+        ReadOnly  = 0x01,
+        WriteOnly = 0x02,
+        ReadWrite = ReadOnly | WriteOnly,
+        Create    = 0x04,   // 文件不存在时创建
+        Truncate  = 0x08,   // 打开时清空文件
+        Direct    = 0x10,   // 绕过系统页缓存
+        Dsync     = 0x20    // 每次写入等数据落盘后才返回(O_DSYNC / FILE_FLAG_WRITE_THROUGH)
+    };
+
+    IoFile();
+    ~IoFile();
+
+    // 打开文件或块设备，flags为OpenFlag组合
+    bool open(const QString &path, int flags);
+    void close();
+
+    bool isOpen() const;
+
+    // 底层文件描述符/句柄，供异步I/O等需要直接调用系统接口的场景使用
+    qintptr nativeHandle() const;
+
+    // 实际是否以直接I/O方式打开（部分文件系统不支持时会自动回退）
+    bool isDirect() const { return m_direct; }
+
+    // 按偏移量读写，返回实际传输字节数，出错返回-1
+    qint64 readAt(void *buffer, qint64 length, qint64 offset);
+    qint64 writeAt(const void *buffer, qint64 length, qint64 offset);
+
+    // 将已写入数据刷到设备
+    bool sync();
+
+    // 只刷数据和读回数据所需的元数据(fdatasync)，不支持的平台等同于sync()
+    bool dataSync();
+
+    // 丢弃该文件在系统页缓存中的数据（仅Linux），用于缓冲I/O测试前排除缓存影响
+    bool dropCache();
+
+    // 文件大小；块设备返回设备容量
+    qint64 size() const;
+
+    // 是否为块设备/物理磁盘
+    bool isBlockDevice() const { return m_blockDevice; }
+
+    QString path() const { return m_path; }
+    QString errorString() const { return m_errorString; }
+
+    // 直接I/O所需的对齐粒度
+    static int alignment() { return 4096; }
+
+    // 向下/向上对齐到alignment()
+    static qint64 alignDown(qint64 value) { return value - (value % alignment()); }
+    static qint64 alignUp(qint64 value) { return alignDown(value + alignment() - 1); }
+
+    // 将当前线程的I/O优先级降为后台（Linux: IDLE调度类，Windows: 后台模式），
+    // 传入false恢复默认优先级。线程池线程用完后必须恢复。
+    static bool setThreadBackgroundIo(bool enable);
+
+private:
+    Q_DISABLE_COPY(IoFile)
+
+    void setSystemError(const QString &operation);
+
+#ifdef Q_OS_WIN
+    void *m_handle;
+#else
+    int m_fd;
+#endif
+    QString m_path;
+    QString m_errorString;
+    bool m_direct;
+    bool m_blockDevice;
+};
+
+#endif // IOCORE_H
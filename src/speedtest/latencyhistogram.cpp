@@ -0,0 +1,123 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms>
+#include <limits>
+
+namespace {
+// 每个2的幂区间的子桶数 = 2^kSubBucketBits
+const int kSubBucketBits = 5;
+const int kSubBuckets = 1 << kSubBucketBits;
+// 可记录的最大延迟为2^kMaxExponent纳秒，超出的计入最后一个桶
+const int kMaxExponent = 42;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets(bucketCount(), 0), m_count(0), m_sum(0),
+      m_min(std::numeric_limits<qint64>::max()), m_max(0) {
+}
+
+int LatencyHistogram::bucketCount() {
+    return (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+}
+
+int LatencyHistogram::bucketIndex(qint64 ns) {
+    if (ns < 0) {
+        ns = 0;
+    }
+    quint64 value = static_cast<quint64>(ns);
+
+    // 小于2*kSubBuckets的值每纳秒一个桶
+    if (value < static_cast<quint64>(kSubBuckets * 2)) {
+        return static_cast<int>(value);
+    }
+
+    int msb = 63 - qCountLeadingZeroBits(value);
+    int shift = msb - kSubBucketBits;
+    int index = (shift + 1) * kSubBuckets + static_cast<int>((value >> shift) - kSubBuckets);
+    return qMin(index, bucketCount() - 1);
+}
+
+qint64 LatencyHistogram::bucketLowerBound(int index) {
+    if (index < kSubBuckets * 2) {
+        return index;
+    }
+    int shift = index / kSubBuckets - 1;
+    qint64 mantissa = index % kSubBuckets + kSubBuckets;
+    return mantissa << shift;
+}
+
+void LatencyHistogram::record(qint64 ns) {
+    if (ns < 0) {
+        ns = 0;
+    }
+    ++m_buckets[bucketIndex(ns)];
+    ++m_count;
+    m_sum += ns;
+    m_min = qMin(m_min, ns);
+    m_max = qMax(m_max, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    if (other.m_count == 0) {
+        return;
+    }
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = qMin(m_min, other.m_min);
+    m_max = qMax(m_max, other.m_max);
+}
+
+void LatencyHistogram::clear() {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = std::numeric_limits<qint64>::max();
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentileNs(double percentile) const {
+    if (m_count == 0) {
+        return 0;
+    }
+
+    percentile = qBound(0.0, percentile, 100.0);
+    quint64 target = static_cast<quint64>(percentile / 100.0 * m_count + 0.5);
+    target = qBound<quint64>(1, target, m_count);
+
+    quint64 seen = 0;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets[i];
+        if (seen >= target) {
+            qint64 low = bucketLowerBound(i);
+            qint64 high = i + 1 < m_buckets.size() ? bucketLowerBound(i + 1) : low * 2;
+            // 桶中点可能超出实际记录范围，按最小/最大值截断
+            return qBound(minNs(), (low + high) / 2, m_max);
+        }
+    }
+    return m_max;
+}
+
+bool LatencyHistogram::setBuckets(const QVector<quint64> &buckets) {
+    if (buckets.size() != bucketCount()) {
+        return false;
+    }
+
+    clear();
+    m_buckets = buckets;
+
+    // 从桶恢复时只能得到近似的总和和极值
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        if (m_buckets[i] == 0) {
+            continue;
+        }
+        qint64 low = bucketLowerBound(i);
+        m_count += m_buckets[i];
+        m_sum += static_cast<double>(low) * m_buckets[i];
+        m_min = qMin(m_min, low);
+        m_max = qMax(m_max, low);
+    }
+    return true;
+}
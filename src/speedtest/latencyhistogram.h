@@ -0,0 +1,46 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+#include <QMetaType>
+#include <QtGlobal>
+
+// I/O延迟直方图（纳秒）
+// 对数-线性分桶：每个2的幂区间再等分为32个子桶，相对误差约3%，
+// 覆盖1ns到约73分钟，桶数固定，可以直接合并或整体保存。
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 ns);
+    void merge(const LatencyHistogram &other);
+    void clear();
+
+    quint64 count() const { return m_count; }
+    qint64 minNs() const { return m_count ? m_min : 0; }
+    qint64 maxNs() const { return m_max; }
+    double meanNs() const { return m_count ? m_sum / static_cast<double>(m_count) : 0; }
+
+    // 百分位延迟，percentile取0-100，返回所在桶的中点
+    qint64 percentileNs(double percentile) const;
+
+    // 原始桶计数，用于保存和恢复
+    const QVector<quint64> &buckets() const { return m_buckets; }
+    bool setBuckets(const QVector<quint64> &buckets);
+
+    static int bucketCount();
+    static int bucketIndex(qint64 ns);
+    static qint64 bucketLowerBound(int index);
+
+private:
+    QVector<quint64> m_buckets;
+    quint64 m_count;
+    double m_sum;
+    qint64 m_min;
+    qint64 m_max;
+};
+
+Q_DECLARE_METATYPE(LatencyHistogram)
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,356 @@
+#include "metadatabenchmark.h"
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <vector>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+// 进度刷新间隔（毫秒），元数据阶段通常很短，比其他测试刷新得更频繁
+const int kProgressIntervalMs = 200;
+// 与fio作业引擎相同的线程数上限
+const int kMaxThreads = 256;
+
+#ifdef Q_OS_WIN
+typedef std::wstring NativePath;
+
+QString lastErrorText() {
+    return QString("错误码 %1").arg(GetLastError());
+}
+
+bool createFile(const NativePath &path, const char *data, qint64 size) {
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool ok = true;
+    if (size > 0) {
+        DWORD written = 0;
+        ok = WriteFile(handle, data, static_cast<DWORD>(size), &written, nullptr) && written == static_cast<DWORD>(size);
+    }
+    return CloseHandle(handle) && ok;
+}
+
+bool statFile(const NativePath &path) {
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    return GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &info) != 0;
+}
+
+bool renameFile(const NativePath &from, const NativePath &to) {
+    return MoveFileExW(from.c_str(), to.c_str(), 0) != 0;
+}
+
+bool unlinkFile(const NativePath &path) {
+    return DeleteFileW(path.c_str()) != 0;
+}
+
+NativePath toNativePath(const QString &path) {
+    return QDir::toNativeSeparators(path).toStdWString();
+}
+#else
+typedef QByteArray NativePath;
+
+QString lastErrorText() {
+    return QString::fromLocal8Bit(strerror(errno));
+}
+
+bool createFile(const NativePath &path, const char *data, qint64 size) {
+    int fd = ::open(path.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = size <= 0 || ::write(fd, data, static_cast<size_t>(size)) == size;
+    return ::close(fd) == 0 && ok;
+}
+
+bool statFile(const NativePath &path) {
+    struct stat info;
+    return ::stat(path.constData(), &info) == 0;
+}
+
+bool renameFile(const NativePath &from, const NativePath &to) {
+    return ::rename(from.constData(), to.constData()) == 0;
+}
+
+bool unlinkFile(const NativePath &path) {
+    return ::unlink(path.constData()) == 0;
+}
+
+NativePath toNativePath(const QString &path) {
+    return QFile::encodeName(path);
+}
+#endif
+}
+
+// 一个阶段内所有工作线程共享的状态
+struct MetadataBenchmark::PhaseContext {
+    Operation operation;
+    QElapsedTimer timer;
+    QAtomicInt stop;
+    QAtomicInteger<qint64> completed;
+    QMutex errorMutex;
+    QString errorMessage;
+    QByteArray data;                            // 创建文件时写入的内容
+    std::vector<LatencyHistogram> latency;      // 每个线程一份，结束后合并
+    std::vector<qint64> endNs;
+};
+
+MetadataBenchmark::MetadataBenchmark(const QString &testDirectory, const MetadataBenchmarkOptions &options, QObject *parent)
+    : QObject(parent), m_testDirectory(testDirectory), m_options(options), m_canceled(0) {
+    m_options.threads = qBound(1, m_options.threads, kMaxThreads);
+    m_options.filesPerThread = qMax(1, m_options.filesPerThread);
+    m_options.directories = qMax(1, m_options.directories);
+    m_options.fileSize = qMax<qint64>(0, m_options.fileSize);
+    qRegisterMetaType<MetadataOpResult>("MetadataOpResult");
+    qRegisterMetaType<MetadataBenchmarkResult>("MetadataBenchmarkResult");
+}
+
+void MetadataBenchmark::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+QString MetadataBenchmark::operationName(Operation operation) {
+    switch (operation) {
+    case Create: return "create";
+    case Stat: return "stat";
+    case Rename: return "rename";
+    case Unlink: return "unlink";
+    default: return QString();
+    }
+}
+
+QString MetadataBenchmark::operationDisplayName(Operation operation) {
+    switch (operation) {
+    case Create: return "创建";
+    case Stat: return "查询属性";
+    case Rename: return "重命名";
+    case Unlink: return "删除";
+    default: return QString();
+    }
+}
+
+void MetadataBenchmark::startTest() {
+    MetadataBenchmarkResult result;
+    result.options = m_options;
+
+    qDebug() << "元数据测试开始:" << m_testDirectory << "线程" << m_options.threads << "每线程文件"
+             << m_options.filesPerThread << "子目录" << m_options.directories << "文件大小" << m_options.fileSize;
+
+    QString errorMessage;
+    if (prepareTree(errorMessage)) {
+        for (int op = 0; op < OperationCount && !m_canceled.loadRelaxed(); ++op) {
+            MetadataOpResult opResult = runPhase(static_cast<Operation>(op), errorMessage);
+            if (!errorMessage.isEmpty()) {
+                break;
+            }
+            if (m_canceled.loadRelaxed()) {
+                break;
+            }
+            result.operations.append(opResult);
+            emit operationCompleted(opResult);
+
+            qDebug() << "元数据测试阶段完成:" << opResult.name << opResult.ops << "次,"
+                     << opResult.opsPerSec() << "次/秒, p99" << opResult.latency.percentileNs(99) << "ns";
+        }
+    }
+
+    // 中途出错或取消时残留的文件和目录一并删除
+    if (!m_rootPath.isEmpty() && QDir(m_rootPath).exists() && !QDir(m_rootPath).removeRecursively()) {
+        qDebug() << "删除元数据测试目录失败:" << m_rootPath;
+    }
+
+    if (m_canceled.loadRelaxed()) {
+        result.canceled = true;
+        result.errorMessage = "测试已取消";
+    } else if (!errorMessage.isEmpty()) {
+        result.errorMessage = errorMessage;
+    } else {
+        result.success = true;
+    }
+
+    emit testCompleted(result);
+}
+
+bool MetadataBenchmark::prepareTree(QString &errorMessage) {
+    QDir base(m_testDirectory);
+    m_rootPath = base.filePath(QString("disktoolbox_meta_%1").arg(QCoreApplication::applicationPid()));
+
+    // 上一次异常退出可能留下同名目录
+    QDir root(m_rootPath);
+    if (root.exists()) {
+        root.removeRecursively();
+    }
+    if (!base.mkpath(m_rootPath)) {
+        errorMessage = QString("无法创建测试目录: %1").arg(m_rootPath);
+        m_rootPath.clear();
+        return false;
+    }
+
+    QStringList directories;
+    for (int i = 0; i < m_options.directories; ++i) {
+        QString dir = root.filePath(QString("d%1").arg(i, 4, 10, QChar('0')));
+        if (!root.mkdir(dir)) {
+            errorMessage = QString("无法创建测试目录: %1").arg(dir);
+            return false;
+        }
+        directories.append(dir);
+    }
+
+    // 路径在计时前一次性转换好，测量结果只包含系统调用本身
+    const qint64 total = m_options.totalFiles();
+    m_paths.clear();
+    m_renamedPaths.clear();
+    m_paths.reserve(static_cast<int>(total));
+    m_renamedPaths.reserve(static_cast<int>(total));
+    for (int t = 0; t < m_options.threads; ++t) {
+        for (int i = 0; i < m_options.filesPerThread; ++i) {
+            const qint64 index = static_cast<qint64>(t) * m_options.filesPerThread + i;
+            const QDir dir(directories[static_cast<int>(index % m_options.directories)]);
+            const QString name = QString("t%1_f%2").arg(t, 3, 10, QChar('0')).arg(i, 7, 10, QChar('0'));
+            m_paths.append(toNativePath(dir.filePath(name)));
+            m_renamedPaths.append(toNativePath(dir.filePath(name + ".renamed")));
+        }
+    }
+    return true;
+}
+
+MetadataOpResult MetadataBenchmark::runPhase(Operation operation, QString &errorMessage) {
+    MetadataOpResult result;
+    result.name = operationName(operation);
+
+    PhaseContext context;
+    context.operation = operation;
+    context.stop.storeRelaxed(0);
+    context.completed.storeRelaxed(0);
+    context.latency.resize(static_cast<size_t>(m_options.threads));
+    context.endNs.assign(static_cast<size_t>(m_options.threads), 0);
+    if (operation == Create && m_options.fileSize > 0) {
+        context.data = QByteArray(static_cast<int>(m_options.fileSize), 'm');
+    }
+
+    const qint64 total = m_options.totalFiles();
+
+    // 独立线程池，保证所有工作线程同时运行
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_options.threads);
+
+    context.timer.start();
+    QList<QFuture<void>> workers;
+    for (int t = 0; t < m_options.threads; ++t) {
+        workers.append(QtConcurrent::run(&pool, [this, &context, t]() {
+            runWorker(&context, t);
+        }));
+    }
+
+    qint64 lastCompleted = 0;
+    qint64 lastNs = 0;
+    bool running = true;
+    while (running) {
+        QThread::msleep(kProgressIntervalMs);
+
+        if (m_canceled.loadRelaxed()) {
+            context.stop.storeRelaxed(1);
+        }
+
+        running = false;
+        for (const QFuture<void> &worker : workers) {
+            if (!worker.isFinished()) {
+                running = true;
+                break;
+            }
+        }
+
+        qint64 nowNs = context.timer.nsecsElapsed();
+        qint64 completed = context.completed.loadRelaxed();
+        double intervalSec = (nowNs - lastNs) / 1e9;
+        double rate = intervalSec > 0 ? (completed - lastCompleted) / intervalSec : 0;
+        int percent = static_cast<int>((operation + static_cast<double>(completed) / total) * 100 / OperationCount);
+        emit progressUpdated(percent, operationDisplayName(operation), rate);
+
+        lastCompleted = completed;
+        lastNs = nowNs;
+    }
+
+    qint64 endNs = 0;
+    for (size_t t = 0; t < context.latency.size(); ++t) {
+        result.latency.merge(context.latency[t]);
+        endNs = qMax(endNs, context.endNs[t]);
+    }
+    result.ops = context.completed.loadRelaxed();
+    result.elapsedSec = endNs / 1e9;
+
+    errorMessage = context.errorMessage;
+    return result;
+}
+
+void MetadataBenchmark::runWorker(PhaseContext *context, int thread) {
+    const int first = thread * m_options.filesPerThread;
+    const int last = first + m_options.filesPerThread;
+    const char *data = context->data.constData();
+    const qint64 size = context->data.size();
+    LatencyHistogram &latency = context->latency[static_cast<size_t>(thread)];
+
+    for (int index = first; index < last; ++index) {
+        if (context->stop.loadRelaxed()) {
+            break;
+        }
+
+        const qint64 startNs = context->timer.nsecsElapsed();
+        bool ok = false;
+        switch (context->operation) {
+        case Create:
+            ok = createFile(m_paths[index], data, size);
+            break;
+        case Stat:
+            ok = statFile(m_paths[index]);
+            break;
+        case Rename:
+            ok = renameFile(m_paths[index], m_renamedPaths[index]);
+            break;
+        case Unlink:
+            ok = unlinkFile(m_renamedPaths[index]);
+            break;
+        default:
+            break;
+        }
+        const qint64 endNs = context->timer.nsecsElapsed();
+
+        if (!ok) {
+            // 只保留第一个错误，其他线程随后停止
+            const QString reason = lastErrorText();
+            QString error = QString("%1失败: %2").arg(operationDisplayName(context->operation)).arg(reason);
+            QMutexLocker locker(&context->errorMutex);
+            if (context->errorMessage.isEmpty()) {
+                context->errorMessage = error;
+                qDebug() << "元数据测试出错:" << error;
+            }
+            context->stop.storeRelaxed(1);
+            break;
+        }
+
+        latency.record(endNs - startNs);
+        context->completed.fetchAndAddRelaxed(1);
+    }
+
+    context->endNs[static_cast<size_t>(thread)] = context->timer.nsecsElapsed();
+}
@@ -0,0 +1,111 @@
+#ifndef METADATABENCHMARK_H
+#define METADATABENCHMARK_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMetaType>
+#include <QAtomicInt>
+#include <QVector>
+
+#include <string>
+
+#include "latencyhistogram.h"
+
+// 元数据测试参数
+struct MetadataBenchmarkOptions {
+    int threads;            // 并发线程数
+    int filesPerThread;     // 每个线程操作的文件数
+    int directories;        // 文件分散到的子目录数（目录扇出）
+    qint64 fileSize;        // 创建时写入的数据量，0为空文件
+
+    MetadataBenchmarkOptions() : threads(4), filesPerThread(2000), directories(16), fileSize(0) {}
+
+    qint64 totalFiles() const { return static_cast<qint64>(threads) * filesPerThread; }
+};
+
+// 单种元数据操作的统计
+struct MetadataOpResult {
+    QString name;           // create/stat/rename/unlink
+    qint64 ops;             // 成功完成的操作数
+    double elapsedSec;      // 该阶段从所有线程开始到全部结束的时间
+    LatencyHistogram latency;
+
+    MetadataOpResult() : ops(0), elapsedSec(0) {}
+
+    double opsPerSec() const { return elapsedSec > 0 ? ops / elapsedSec : 0; }
+};
+
+Q_DECLARE_METATYPE(MetadataOpResult)
+
+// 元数据测试结果
+struct MetadataBenchmarkResult {
+    bool success;
+    bool canceled;
+    QString errorMessage;
+    MetadataBenchmarkOptions options;
+    QList<MetadataOpResult> operations;     // 按create/stat/rename/unlink顺序
+
+    MetadataBenchmarkResult() : success(false), canceled(false) {}
+};
+
+Q_DECLARE_METATYPE(MetadataBenchmarkResult)
+
+// 文件系统元数据（小文件）测试
+// 与mdtest类似，所有线程依次完成四个阶段：创建文件、查询属性、重命名、删除，
+// 阶段之间等待全部线程结束，每个阶段单独统计每秒操作数和延迟分布。
+// 文件按序号轮流分散到若干子目录中，目录扇出越小，同一目录内的竞争越激烈。
+// 直接调用系统接口（open/stat/rename/unlink或对应的Win32 API），不经过Qt的文件类，
+// 避免额外的路径转换和属性缓存影响结果。
+class MetadataBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 每个阶段的操作
+    enum Operation {
+        Create,
+        Stat,
+        Rename,
+        Unlink,
+        OperationCount
+    };
+
+    MetadataBenchmark(const QString &testDirectory, const MetadataBenchmarkOptions &options, QObject *parent = nullptr);
+
+    void cancel();
+
+    static QString operationName(Operation operation);
+    static QString operationDisplayName(Operation operation);
+
+public slots:
+    void startTest();
+
+signals:
+    void progressUpdated(int percent, const QString &operation, double opsPerSec);
+    void operationCompleted(const MetadataOpResult &result);
+    void testCompleted(const MetadataBenchmarkResult &result);
+
+private:
+    struct PhaseContext;
+
+    bool prepareTree(QString &errorMessage);
+    MetadataOpResult runPhase(Operation operation, QString &errorMessage);
+    void runWorker(PhaseContext *context, int thread);
+
+#ifdef Q_OS_WIN
+    typedef std::wstring NativePath;
+#else
+    typedef QByteArray NativePath;
+#endif
+
+    QString m_testDirectory;
+    QString m_rootPath;         // 本次测试创建的根目录，结束后整体删除
+    MetadataBenchmarkOptions m_options;
+    // 预先转换好的文件路径，第t个线程的第i个文件位于t*filesPerThread+i
+    QVector<NativePath> m_paths;
+    QVector<NativePath> m_renamedPaths;
+    QAtomicInt m_canceled;
+};
+
+#endif // METADATABENCHMARK_H
@@ -0,0 +1,139 @@
+#include "metadatapanel.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDebug>
+
+MetadataPanel::MetadataPanel(QWidget *parent) : SpeedTestPanel("元数据测试 (小文件)", parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_threadsSpinBox = new QSpinBox(this);
+    m_threadsSpinBox->setRange(1, 64);
+    m_threadsSpinBox->setValue(4);
+    m_threadsSpinBox->setPrefix("线程 ");
+    m_filesSpinBox = new QSpinBox(this);
+    m_filesSpinBox->setRange(100, 100000);
+    m_filesSpinBox->setSingleStep(1000);
+    m_filesSpinBox->setValue(2000);
+    m_filesSpinBox->setPrefix("每线程文件 ");
+    m_dirsSpinBox = new QSpinBox(this);
+    m_dirsSpinBox->setRange(1, 1024);
+    m_dirsSpinBox->setValue(16);
+    m_dirsSpinBox->setPrefix("子目录 ");
+    m_dirsSpinBox->setToolTip("文件轮流分散到这些子目录中，子目录越少同一目录内的竞争越激烈");
+    m_fileSizeComboBox = new QComboBox(this);
+    m_fileSizeComboBox->addItem("空文件", 0);
+    m_fileSizeComboBox->addItem("1 KB", 1024);
+    m_fileSizeComboBox->addItem("4 KB", 4096);
+    m_fileSizeComboBox->addItem("64 KB", 65536);
+
+    QHBoxLayout *settingsLayout = new QHBoxLayout();
+    settingsLayout->addWidget(m_threadsSpinBox);
+    settingsLayout->addWidget(m_filesSpinBox);
+    settingsLayout->addWidget(m_dirsSpinBox);
+    settingsLayout->addWidget(m_fileSizeComboBox);
+
+    m_table = new QTableWidget(0, 6, this);
+    m_table->setHorizontalHeaderLabels({"操作", "次数", "每秒操作数", "平均延迟", "延迟 p50/p99", "延迟 p99.9"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setEditTriggers(QTableWidget::NoEditTriggers);
+
+    layout->addLayout(settingsLayout);
+    layout->addWidget(m_table);
+}
+
+bool MetadataPanel::start(const SpeedTestParameters &parameters) {
+    MetadataBenchmarkOptions options;
+    options.threads = m_threadsSpinBox->value();
+    options.filesPerThread = m_filesSpinBox->value();
+    options.directories = m_dirsSpinBox->value();
+    options.fileSize = m_fileSizeComboBox->currentData().toLongLong();
+
+    qDebug() << "开始元数据测试，目录:" << parameters.testDirectory << "文件总数:" << options.totalFiles();
+
+    m_parameters = parameters;
+    emit statusChanged(QString("正在准备元数据测试，共 %1 个文件...").arg(options.totalFiles()));
+    m_table->setRowCount(0);
+
+    MetadataBenchmark *benchmark = new MetadataBenchmark(parameters.testDirectory, options);
+    connect(benchmark, &MetadataBenchmark::progressUpdated, this, [this](int percent, const QString &operation, double opsPerSec) {
+        emit progressChanged(percent);
+        emit statusChanged(QString("元数据测试 - %1: %2 次/秒").arg(operation).arg(opsPerSec, 0, 'f', 0));
+    });
+    connect(benchmark, &MetadataBenchmark::operationCompleted, this, &MetadataPanel::onOperationCompleted);
+    connect(benchmark, &MetadataBenchmark::testCompleted, this, &MetadataPanel::onTestCompleted);
+    runWorker(benchmark, &MetadataBenchmark::startTest, &MetadataBenchmark::testCompleted);
+    return true;
+}
+
+void MetadataPanel::setOptionsEnabled(bool enabled) {
+    m_threadsSpinBox->setEnabled(enabled);
+    m_filesSpinBox->setEnabled(enabled);
+    m_dirsSpinBox->setEnabled(enabled);
+    m_fileSizeComboBox->setEnabled(enabled);
+}
+
+void MetadataPanel::onOperationCompleted(const MetadataOpResult &result) {
+    static const QMap<QString, QString> operationNames = {
+        {"create", "创建"}, {"stat", "查询属性"}, {"rename", "重命名"}, {"unlink", "删除"}
+    };
+
+    int row = m_table->rowCount();
+    m_table->insertRow(row);
+    m_table->setItem(row, 0, new QTableWidgetItem(operationNames.value(result.name, result.name)));
+    m_table->setItem(row, 1, new QTableWidgetItem(QString::number(result.ops)));
+    m_table->setItem(row, 2, new QTableWidgetItem(QString::number(result.opsPerSec(), 'f', 0)));
+    m_table->setItem(row, 3, new QTableWidgetItem(QString("%1 us").arg(result.latency.meanNs() / 1000.0, 0, 'f', 1)));
+    m_table->setItem(row, 4, new QTableWidgetItem(QString("%1 / %2 us")
+                                                  .arg(result.latency.percentileNs(50) / 1000.0, 0, 'f', 1)
+                                                  .arg(result.latency.percentileNs(99) / 1000.0, 0, 'f', 1)));
+    m_table->setItem(row, 5, new QTableWidgetItem(QString("%1 us").arg(result.latency.percentileNs(99.9) / 1000.0, 0, 'f', 1)));
+}
+
+void MetadataPanel::onTestCompleted(const MetadataBenchmarkResult &result) {
+    if (!result.success) {
+        emit statusChanged(result.errorMessage);
+        if (!result.canceled) {
+            QMessageBox::warning(this, "元数据测试失败", result.errorMessage);
+        }
+        return;
+    }
+
+    emit progressChanged(100);
+    emit statusChanged("元数据测试完成");
+
+    // 读/写速度不适用；查询属性和创建分别记为读、写方向的IOPS，完整数据放在参数中
+    SpeedTestRecord record = newRecord("metadata");
+    const MetadataBenchmarkOptions &options = result.options;
+    record.blockSize = options.fileSize;
+    record.fileSize = options.totalFiles() * options.fileSize;
+    record.label = QString("%1线程×%2文件").arg(options.threads).arg(options.filesPerThread);
+    record.parameters["threads"] = options.threads;
+    record.parameters["filesPerThread"] = options.filesPerThread;
+    record.parameters["directories"] = options.directories;
+    record.parameters["fileSize"] = options.fileSize;
+
+    for (const MetadataOpResult &op : result.operations) {
+        QJsonObject stats;
+        stats["ops"] = op.ops;
+        stats["opsPerSec"] = op.opsPerSec();
+        stats["meanUs"] = op.latency.meanNs() / 1000.0;
+        stats["p50Us"] = op.latency.percentileNs(50) / 1000.0;
+        stats["p99Us"] = op.latency.percentileNs(99) / 1000.0;
+        stats["p999Us"] = op.latency.percentileNs(99.9) / 1000.0;
+        record.parameters[op.name] = stats;
+
+        if (op.name == "stat") {
+            record.readIops = op.opsPerSec();
+            record.readP99Us = op.latency.percentileNs(99) / 1000.0;
+            record.readLatency = op.latency;
+        } else if (op.name == "create") {
+            record.writeIops = op.opsPerSec();
+            record.writeP99Us = op.latency.percentileNs(99) / 1000.0;
+            record.writeLatency = op.latency;
+        }
+    }
+    emit recordReady(record);
+}
@@ -0,0 +1,34 @@
+#ifndef METADATAPANEL_H
+#define METADATAPANEL_H
+
+#include <QSpinBox>
+#include <QComboBox>
+#include <QTableWidget>
+
+#include "speedtestpanel.h"
+#include "metadatabenchmark.h"
+
+// 元数据（小文件创建/查询/重命名/删除）测试模式面板
+class MetadataPanel : public SpeedTestPanel
+{
+    Q_OBJECT
+
+public:
+    explicit MetadataPanel(QWidget *parent = nullptr);
+
+    bool start(const SpeedTestParameters &parameters) override;
+    void setOptionsEnabled(bool enabled) override;
+
+private slots:
+    void onOperationCompleted(const MetadataOpResult &result);
+    void onTestCompleted(const MetadataBenchmarkResult &result);
+
+private:
+    QSpinBox *m_threadsSpinBox;
+    QSpinBox *m_filesSpinBox;
+    QSpinBox *m_dirsSpinBox;
+    QComboBox *m_fileSizeComboBox;
+    QTableWidget *m_table;
+};
+
+#endif // METADATAPANEL_H
@@ -0,0 +1,452 @@
+#include "mmapbenchmark.h"
+#include "iocore.h"
+#include "patterngenerator.h"
+#include "workloadengine.h"
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <vector>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <errno.h>
+#endif
+
+namespace {
+// 进度刷新间隔（毫秒）
+const int kProgressIntervalMs = 200;
+// 与fio作业引擎相同的线程数上限
+const int kMaxThreads = 256;
+
+// 本进程累计的缺页次数
+struct FaultCounters {
+    qint64 total;
+    qint64 major;       // 平台不区分时为-1
+};
+
+FaultCounters processFaults() {
+    FaultCounters counters = { 0, -1 };
+#ifdef Q_OS_WIN
+    // Windows只提供软、硬缺页的合计
+    PROCESS_MEMORY_COUNTERS memory;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory))) {
+        counters.total = memory.PageFaultCount;
+    }
+#else
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+        counters.total = usage.ru_minflt + usage.ru_majflt;
+        counters.major = usage.ru_majflt;
+    }
+#endif
+    return counters;
+}
+
+// 一种访问模式
+struct AccessPattern {
+    bool random;
+    bool write;
+};
+
+// 每个线程独立的随机数发生器(xorshift64*)
+class ThreadRandom {
+public:
+    explicit ThreadRandom(quint64 seed) : m_state(seed * 0x9E3779B97F4A7C15ULL | 1) {}
+
+    quint64 next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
+private:
+    quint64 m_state;
+};
+
+// 整个测试文件的共享映射
+class FileMapping {
+public:
+    FileMapping() : m_data(nullptr), m_size(0)
+#ifdef Q_OS_WIN
+        , m_mapping(nullptr)
+#endif
+    {}
+
+    ~FileMapping() { unmap(); }
+
+    bool map(IoFile &file, qint64 size, bool writable, const MmapBenchmarkOptions &options, QString &errorMessage) {
+#ifdef Q_OS_WIN
+        Q_UNUSED(options);
+        HANDLE handle = reinterpret_cast<HANDLE>(file.nativeHandle());
+        m_mapping = CreateFileMappingW(handle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                       static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+        if (!m_mapping) {
+            errorMessage = QString("创建文件映射失败，错误码 %1").arg(GetLastError());
+            return false;
+        }
+        m_data = static_cast<char*>(MapViewOfFile(m_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0,
+                                                  static_cast<SIZE_T>(size)));
+        if (!m_data) {
+            errorMessage = QString("映射文件失败，错误码 %1").arg(GetLastError());
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+            return false;
+        }
+#else
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (options.populate) {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        void *data = ::mmap(nullptr, static_cast<size_t>(size), writable ? PROT_READ | PROT_WRITE : PROT_READ, flags,
+                            static_cast<int>(file.nativeHandle()), 0);
+        if (data == MAP_FAILED) {
+            errorMessage = QString("映射文件失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+            return false;
+        }
+        m_data = static_cast<char*>(data);
+
+        int advice = MADV_NORMAL;
+        switch (options.advice) {
+        case MmapBenchmarkOptions::AdviceSequential: advice = MADV_SEQUENTIAL; break;
+        case MmapBenchmarkOptions::AdviceRandom: advice = MADV_RANDOM; break;
+        case MmapBenchmarkOptions::AdviceWillNeed: advice = MADV_WILLNEED; break;
+        default: break;
+        }
+        if (advice != MADV_NORMAL && ::madvise(data, static_cast<size_t>(size), advice) != 0) {
+            // 提示失败不影响测试本身
+            qDebug() << "madvise失败:" << strerror(errno);
+        }
+#endif
+        m_size = size;
+        return true;
+    }
+
+    // 把映射中的脏页同步写回磁盘
+    bool flush() {
+        if (!m_data) {
+            return false;
+        }
+#ifdef Q_OS_WIN
+        return FlushViewOfFile(m_data, 0) != 0;
+#else
+        return ::msync(m_data, static_cast<size_t>(m_size), MS_SYNC) == 0;
+#endif
+    }
+
+    void unmap() {
+        if (!m_data) {
+            return;
+        }
+#ifdef Q_OS_WIN
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+#else
+        ::munmap(m_data, static_cast<size_t>(m_size));
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    char *data() const { return m_data; }
+
+private:
+    Q_DISABLE_COPY(FileMapping)
+
+    char *m_data;
+    qint64 m_size;
+#ifdef Q_OS_WIN
+    HANDLE m_mapping;
+#endif
+};
+}
+
+// 一个变体内所有工作线程共享的状态
+struct MmapBenchmark::VariantContext {
+    bool mapped;
+    bool random;
+    bool write;
+    qint64 accessCount;                         // 文件按访问粒度划分的块数
+    char *mapData;
+    AlignedBuffer pattern;                      // 写入时的数据源
+    QElapsedTimer timer;
+    QAtomicInt stop;
+    QAtomicInteger<qint64> completedBytes;
+    QMutex errorMutex;
+    QString errorMessage;
+    std::vector<LatencyHistogram> latency;      // 每个线程一份，结束后合并
+    std::vector<quint64> checksums;             // 读取映射内存的结果，防止编译器优化掉访问
+};
+
+MmapBenchmark::MmapBenchmark(const QString &testDirectory, const MmapBenchmarkOptions &options, QObject *parent)
+    : QObject(parent), m_testDirectory(testDirectory), m_options(options), m_canceled(0) {
+    m_options.threads = qBound(1, m_options.threads, kMaxThreads);
+    // 访问粒度至少一页，文件大小取访问粒度的整数倍
+    m_options.accessSize = qMax<qint64>(IoFile::alignment(), IoFile::alignDown(m_options.accessSize));
+    m_options.fileSize = qMax(m_options.accessSize, m_options.fileSize - m_options.fileSize % m_options.accessSize);
+    qRegisterMetaType<MmapVariantResult>("MmapVariantResult");
+    qRegisterMetaType<MmapBenchmarkResult>("MmapBenchmarkResult");
+}
+
+void MmapBenchmark::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+QString MmapBenchmark::variantDisplayName(const MmapVariantResult &variant) {
+    return QString("%1 %2%3")
+        .arg(variant.mapped ? "mmap" : "read/write")
+        .arg(variant.random ? "随机" : "顺序")
+        .arg(variant.write ? "写" : "读");
+}
+
+void MmapBenchmark::startTest() {
+    MmapBenchmarkResult result;
+    result.options = m_options;
+
+    qDebug() << "内存映射测试开始:" << m_testDirectory << "线程" << m_options.threads << "文件大小" << m_options.fileSize
+             << "访问粒度" << m_options.accessSize << "populate" << m_options.populate << "madvise" << m_options.advice;
+
+    m_filePath = QDir(m_testDirectory).filePath("disktoolbox_mmap.dat");
+    bool existed = QFile::exists(m_filePath);
+
+    emit progressUpdated(0, "正在准备测试文件...", 0);
+    QString errorMessage;
+    if (WorkloadEngine::layoutFile(m_filePath, m_options.fileSize, errorMessage, &m_canceled)) {
+        // 每种访问模式先跑系统调用再跑映射，结果成对排列
+        QList<AccessPattern> patterns = { { false, false }, { true, false } };
+        if (m_options.includeWrites) {
+            patterns.append({ false, true });
+            patterns.append({ true, true });
+        }
+
+        const int count = patterns.size() * 2;
+        int index = 0;
+        for (const AccessPattern &pattern : patterns) {
+            for (bool mapped : { false, true }) {
+                if (m_canceled.loadRelaxed() || !errorMessage.isEmpty()) {
+                    break;
+                }
+                MmapVariantResult variant = runVariant(mapped, pattern.random, pattern.write, index++, count, errorMessage);
+                if (!errorMessage.isEmpty() || m_canceled.loadRelaxed()) {
+                    break;
+                }
+                result.variants.append(variant);
+                emit variantCompleted(variant);
+
+                qDebug() << "内存映射测试变体完成:" << variant.name << variant.mbps() << "MB/s, 缺页" << variant.pageFaults
+                         << "其中主缺页" << variant.majorFaults;
+            }
+        }
+    }
+
+    if (!existed && QFile::exists(m_filePath) && !QFile::remove(m_filePath)) {
+        qDebug() << "删除内存映射测试文件失败:" << m_filePath;
+    }
+
+    if (m_canceled.loadRelaxed()) {
+        result.canceled = true;
+        result.errorMessage = "测试已取消";
+    } else if (!errorMessage.isEmpty()) {
+        result.errorMessage = errorMessage;
+    } else {
+        result.success = true;
+    }
+
+    emit testCompleted(result);
+}
+
+MmapVariantResult MmapBenchmark::runVariant(bool mapped, bool random, bool write, int index, int count,
+                                           QString &errorMessage) {
+    MmapVariantResult result;
+    result.mapped = mapped;
+    result.random = random;
+    result.write = write;
+    result.name = QString("%1-%2%3").arg(mapped ? "mmap" : "psync").arg(random ? "rand" : "").arg(write ? "write" : "read");
+
+    IoFile file;
+    if (!file.open(m_filePath, IoFile::ReadWrite)) {
+        errorMessage = file.errorString();
+        return result;
+    }
+    // 上一个变体留下的页缓存会让读取直接命中内存
+    file.dropCache();
+
+    VariantContext context;
+    context.mapped = mapped;
+    context.random = random;
+    context.write = write;
+    context.accessCount = m_options.fileSize / m_options.accessSize;
+    context.mapData = nullptr;
+    context.stop.storeRelaxed(0);
+    context.completedBytes.storeRelaxed(0);
+    context.latency.resize(static_cast<size_t>(m_options.threads));
+    context.checksums.assign(static_cast<size_t>(m_options.threads), 0);
+    if (write) {
+        context.pattern.resize(m_options.accessSize);
+        PatternGenerator::fillRandom(context.pattern.data(), m_options.accessSize, static_cast<quint64>(index) + 1);
+    }
+
+    const FaultCounters faultsBefore = processFaults();
+    context.timer.start();
+
+    // 建立映射（包括MAP_POPULATE预先缺页）的时间计入结果
+    FileMapping mapping;
+    if (mapped) {
+        if (!mapping.map(file, m_options.fileSize, write, m_options, errorMessage)) {
+            return result;
+        }
+        context.mapData = mapping.data();
+    }
+
+    // 独立线程池，保证所有工作线程同时运行
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_options.threads);
+
+    QList<QFuture<void>> workers;
+    for (int t = 0; t < m_options.threads; ++t) {
+        workers.append(QtConcurrent::run(&pool, [this, &context, t]() {
+            runWorker(&context, t);
+        }));
+    }
+
+    const QString displayName = variantDisplayName(result);
+    qint64 lastBytes = 0;
+    qint64 lastNs = 0;
+    bool running = true;
+    while (running) {
+        QThread::msleep(kProgressIntervalMs);
+
+        if (m_canceled.loadRelaxed()) {
+            context.stop.storeRelaxed(1);
+        }
+
+        running = false;
+        for (const QFuture<void> &worker : workers) {
+            if (!worker.isFinished()) {
+                running = true;
+                break;
+            }
+        }
+
+        qint64 nowNs = context.timer.nsecsElapsed();
+        qint64 bytes = context.completedBytes.loadRelaxed();
+        double intervalSec = (nowNs - lastNs) / 1e9;
+        double mbps = intervalSec > 0 ? (bytes - lastBytes) / intervalSec / 1024 / 1024 : 0;
+        int percent = static_cast<int>((index + static_cast<double>(bytes) / m_options.fileSize) * 100 / count);
+        emit progressUpdated(percent, displayName, mbps);
+
+        lastBytes = bytes;
+        lastNs = nowNs;
+    }
+
+    // 写入的数据落盘后才算完成
+    if (write && context.errorMessage.isEmpty() && !context.stop.loadRelaxed()) {
+        if ((mapped && !mapping.flush()) || !file.sync()) {
+            context.errorMessage = QString("写回数据失败: %1").arg(m_filePath);
+        }
+    }
+    mapping.unmap();
+
+    const qint64 elapsedNs = context.timer.nsecsElapsed();
+    const FaultCounters faultsAfter = processFaults();
+
+    for (const LatencyHistogram &latency : context.latency) {
+        result.latency.merge(latency);
+    }
+    result.bytes = context.completedBytes.loadRelaxed();
+    result.elapsedSec = elapsedNs / 1e9;
+    result.pageFaults = faultsAfter.total - faultsBefore.total;
+    result.majorFaults = faultsAfter.major >= 0 ? faultsAfter.major - faultsBefore.major : -1;
+
+    errorMessage = context.errorMessage;
+    return result;
+}
+
+void MmapBenchmark::runWorker(VariantContext *context, int thread) {
+    const qint64 accessSize = m_options.accessSize;
+    const qint64 threads = m_options.threads;
+    // 顺序访问时每个线程负责连续的一段，随机访问时每个线程在整个文件中访问相同次数
+    const qint64 first = context->accessCount * thread / threads;
+    const qint64 last = context->accessCount * (thread + 1) / threads;
+    LatencyHistogram &latency = context->latency[static_cast<size_t>(thread)];
+    ThreadRandom random(static_cast<quint64>(thread) + 1);
+
+    // 系统调用方式每个线程使用自己的文件句柄和缓冲区，和映射一样经过页缓存
+    IoFile file;
+    AlignedBuffer buffer;
+    if (!context->mapped) {
+        if (!file.open(m_filePath, IoFile::ReadWrite)) {
+            QMutexLocker locker(&context->errorMutex);
+            if (context->errorMessage.isEmpty()) {
+                context->errorMessage = file.errorString();
+            }
+            context->stop.storeRelaxed(1);
+            return;
+        }
+        buffer.resize(accessSize);
+    }
+
+    quint64 checksum = 0;
+    for (qint64 i = first; i < last; ++i) {
+        if (context->stop.loadRelaxed()) {
+            break;
+        }
+
+        const qint64 block = context->random ? static_cast<qint64>(random.next() % context->accessCount) : i;
+        const qint64 offset = block * accessSize;
+
+        const qint64 startNs = context->timer.nsecsElapsed();
+        bool ok = true;
+        if (context->mapped) {
+            char *data = context->mapData + offset;
+            if (context->write) {
+                memcpy(data, context->pattern.data(), static_cast<size_t>(accessSize));
+            } else {
+                // 读取整块而不只是每页一个字节，和pread拷贝的数据量相同
+                const quint64 *words = reinterpret_cast<const quint64*>(data);
+                for (qint64 w = 0; w < accessSize / 8; ++w) {
+                    checksum += words[w];
+                }
+            }
+        } else if (context->write) {
+            ok = file.writeAt(context->pattern.data(), accessSize, offset) == accessSize;
+        } else {
+            ok = file.readAt(buffer.data(), accessSize, offset) == accessSize;
+        }
+        const qint64 endNs = context->timer.nsecsElapsed();
+
+        if (!ok) {
+            // 只保留第一个错误，其他线程随后停止
+            QString error = QString("%1失败，偏移 %2: %3").arg(context->write ? "写入" : "读取").arg(offset).arg(file.errorString());
+            QMutexLocker locker(&context->errorMutex);
+            if (context->errorMessage.isEmpty()) {
+                context->errorMessage = error;
+                qDebug() << "内存映射测试出错:" << error;
+            }
+            context->stop.storeRelaxed(1);
+            break;
+        }
+
+        latency.record(endNs - startNs);
+        context->completedBytes.fetchAndAddRelaxed(accessSize);
+    }
+
+    context->checksums[static_cast<size_t>(thread)] = checksum;
+}
@@ -0,0 +1,106 @@
+#ifndef MMAPBENCHMARK_H
+#define MMAPBENCHMARK_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMetaType>
+#include <QAtomicInt>
+
+#include "latencyhistogram.h"
+
+// 内存映射测试参数
+struct MmapBenchmarkOptions {
+    // 映射后给内核的访问模式提示(madvise)
+    enum Advice {
+        AdviceNone,         // 不提示，使用内核默认预读
+        AdviceSequential,   // MADV_SEQUENTIAL：加大预读，访问过的页尽早回收
+        AdviceRandom,       // MADV_RANDOM：关闭预读
+        AdviceWillNeed      // MADV_WILLNEED：立即异步预读整个映射
+    };
+
+    int threads;            // 并发访问线程数
+    qint64 fileSize;        // 测试文件大小
+    qint64 accessSize;      // 每次访问的字节数，映射方式下按此粒度读/写映射内存
+    bool populate;          // 映射时预先建立页表(MAP_POPULATE)，耗时计入结果
+    Advice advice;
+    bool includeWrites;     // 是否测试写入（写入变体结束时把脏页刷回磁盘并计入耗时）
+
+    MmapBenchmarkOptions()
+        : threads(4), fileSize(1024LL * 1024 * 1024), accessSize(4096), populate(false), advice(AdviceNone),
+          includeWrites(true) {}
+};
+
+// 单个测试变体的结果
+struct MmapVariantResult {
+    QString name;           // 如 "mmap-randread"
+    bool mapped;            // true为内存映射，false为pread/pwrite系统调用
+    bool random;
+    bool write;
+    qint64 bytes;           // 实际访问的字节数
+    double elapsedSec;      // 包含映射/解除映射和写入后的刷盘时间
+    qint64 pageFaults;      // 测试期间本进程发生的缺页次数
+    qint64 majorFaults;     // 其中需要读磁盘的缺页，平台不区分时为-1
+    LatencyHistogram latency;   // 每次访问的耗时
+
+    MmapVariantResult() : mapped(false), random(false), write(false), bytes(0), elapsedSec(0), pageFaults(0),
+                          majorFaults(-1) {}
+
+    double mbps() const { return elapsedSec > 0 ? bytes / elapsedSec / 1024 / 1024 : 0; }
+    double faultsPerSec() const { return elapsedSec > 0 ? pageFaults / elapsedSec : 0; }
+};
+
+Q_DECLARE_METATYPE(MmapVariantResult)
+
+// 内存映射测试结果
+struct MmapBenchmarkResult {
+    bool success;
+    bool canceled;
+    QString errorMessage;
+    MmapBenchmarkOptions options;
+    QList<MmapVariantResult> variants;      // 每种访问模式先系统调用后映射，成对排列
+
+    MmapBenchmarkResult() : success(false), canceled(false) {}
+};
+
+Q_DECLARE_METATYPE(MmapBenchmarkResult)
+
+// 内存映射(mmap)读写测试
+// 通过映射文件访问数据时I/O由缺页触发，预读、页表建立和脏页回写的开销都和read()/write()不同。
+// 对顺序读、随机读（以及可选的顺序写、随机写）各运行两遍：先用pread/pwrite，再映射整个文件后由
+// 多个线程直接访问映射内存，两者使用相同的访问粒度和线程数，便于对照。
+// 每个变体开始前先落盘并清空该文件的页缓存（仅Linux支持），统计吞吐量和期间的缺页次数。
+// Windows下使用MapViewOfFile，预先建立页表和madvise提示不可用，会被忽略。
+class MmapBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    MmapBenchmark(const QString &testDirectory, const MmapBenchmarkOptions &options, QObject *parent = nullptr);
+
+    void cancel();
+
+    // 变体的显示名称，如"mmap 随机读"
+    static QString variantDisplayName(const MmapVariantResult &variant);
+
+public slots:
+    void startTest();
+
+signals:
+    void progressUpdated(int percent, const QString &variant, double mbps);
+    void variantCompleted(const MmapVariantResult &result);
+    void testCompleted(const MmapBenchmarkResult &result);
+
+private:
+    struct VariantContext;
+
+    MmapVariantResult runVariant(bool mapped, bool random, bool write, int index, int count, QString &errorMessage);
+    void runWorker(VariantContext *context, int thread);
+
+    QString m_testDirectory;
+    QString m_filePath;
+    MmapBenchmarkOptions m_options;
+    QAtomicInt m_canceled;
+};
+
+#endif // MMAPBENCHMARK_H
@@ -0,0 +1,134 @@
+#include "mmappanel.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDebug>
+
+MmapPanel::MmapPanel(QWidget *parent) : SpeedTestPanel("内存映射 (mmap) 与 read/write 对比", parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_threadsSpinBox = new QSpinBox(this);
+    m_threadsSpinBox->setRange(1, 64);
+    m_threadsSpinBox->setValue(4);
+    m_threadsSpinBox->setPrefix("线程 ");
+    m_adviceComboBox = new QComboBox(this);
+    m_adviceComboBox->addItem("madvise: 无", MmapBenchmarkOptions::AdviceNone);
+    m_adviceComboBox->addItem("madvise: SEQUENTIAL", MmapBenchmarkOptions::AdviceSequential);
+    m_adviceComboBox->addItem("madvise: RANDOM", MmapBenchmarkOptions::AdviceRandom);
+    m_adviceComboBox->addItem("madvise: WILLNEED", MmapBenchmarkOptions::AdviceWillNeed);
+    m_populateCheckBox = new QCheckBox("MAP_POPULATE 预先建立页表", this);
+    m_populateCheckBox->setToolTip("映射时一次性读入整个文件并建立页表，耗时计入结果");
+    m_writeCheckBox = new QCheckBox("包含写入测试", this);
+    m_writeCheckBox->setChecked(true);
+
+    QHBoxLayout *settingsLayout = new QHBoxLayout();
+    settingsLayout->addWidget(m_threadsSpinBox);
+    settingsLayout->addWidget(m_adviceComboBox);
+    settingsLayout->addWidget(m_populateCheckBox);
+    settingsLayout->addWidget(m_writeCheckBox);
+    settingsLayout->addStretch();
+
+    m_table = new QTableWidget(0, 6, this);
+    m_table->setHorizontalHeaderLabels({"方式", "速度", "缺页次数", "主缺页", "缺页/秒", "延迟 p50/p99"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setEditTriggers(QTableWidget::NoEditTriggers);
+
+    layout->addLayout(settingsLayout);
+    layout->addWidget(m_table);
+}
+
+bool MmapPanel::start(const SpeedTestParameters &parameters) {
+    MmapBenchmarkOptions options;
+    options.threads = m_threadsSpinBox->value();
+    options.fileSize = parameters.fileSize;
+    options.accessSize = parameters.blockSize;
+    options.populate = m_populateCheckBox->isChecked();
+    options.advice = static_cast<MmapBenchmarkOptions::Advice>(m_adviceComboBox->currentData().toInt());
+    options.includeWrites = m_writeCheckBox->isChecked();
+
+    qDebug() << "开始内存映射测试，目录:" << parameters.testDirectory << "文件大小:" << options.fileSize
+             << "访问粒度:" << options.accessSize;
+
+    m_parameters = parameters;
+    emit statusChanged("正在准备内存映射测试...");
+    m_table->setRowCount(0);
+
+    MmapBenchmark *benchmark = new MmapBenchmark(parameters.testDirectory, options);
+    connect(benchmark, &MmapBenchmark::progressUpdated, this, [this](int percent, const QString &variant, double mbps) {
+        emit progressChanged(percent);
+        emit statusChanged(QString("内存映射测试 - %1: %2 MB/s").arg(variant).arg(mbps, 0, 'f', 1));
+    });
+    connect(benchmark, &MmapBenchmark::variantCompleted, this, &MmapPanel::onVariantCompleted);
+    connect(benchmark, &MmapBenchmark::testCompleted, this, &MmapPanel::onTestCompleted);
+    runWorker(benchmark, &MmapBenchmark::startTest, &MmapBenchmark::testCompleted);
+    return true;
+}
+
+void MmapPanel::setOptionsEnabled(bool enabled) {
+    m_threadsSpinBox->setEnabled(enabled);
+    m_adviceComboBox->setEnabled(enabled);
+    m_populateCheckBox->setEnabled(enabled);
+    m_writeCheckBox->setEnabled(enabled);
+}
+
+void MmapPanel::onVariantCompleted(const MmapVariantResult &result) {
+    int row = m_table->rowCount();
+    m_table->insertRow(row);
+    m_table->setItem(row, 0, new QTableWidgetItem(MmapBenchmark::variantDisplayName(result)));
+    m_table->setItem(row, 1, new QTableWidgetItem(QString("%1 MB/s").arg(result.mbps(), 0, 'f', 1)));
+    m_table->setItem(row, 2, new QTableWidgetItem(QString::number(result.pageFaults)));
+    m_table->setItem(row, 3, new QTableWidgetItem(result.majorFaults >= 0 ? QString::number(result.majorFaults) : QString("-")));
+    m_table->setItem(row, 4, new QTableWidgetItem(QString::number(result.faultsPerSec(), 'f', 0)));
+    m_table->setItem(row, 5, new QTableWidgetItem(QString("%1 / %2 us")
+                                                  .arg(result.latency.percentileNs(50) / 1000.0, 0, 'f', 1)
+                                                  .arg(result.latency.percentileNs(99) / 1000.0, 0, 'f', 1)));
+}
+
+void MmapPanel::onTestCompleted(const MmapBenchmarkResult &result) {
+    if (!result.success) {
+        emit statusChanged(result.errorMessage);
+        if (!result.canceled) {
+            QMessageBox::warning(this, "内存映射测试失败", result.errorMessage);
+        }
+        return;
+    }
+
+    emit progressChanged(100);
+    emit statusChanged("内存映射测试完成");
+
+    // 读/写速度取映射方式的顺序读写，所有变体的完整数据放在参数中
+    SpeedTestRecord record = newRecord("mmap");
+    const MmapBenchmarkOptions &options = result.options;
+    record.blockSize = options.accessSize;
+    record.fileSize = options.fileSize;
+    record.label = QString("%1线程 %2%3").arg(options.threads)
+                       .arg(m_adviceComboBox->currentText())
+                       .arg(options.populate ? " +POPULATE" : "");
+    record.parameters["threads"] = options.threads;
+    record.parameters["populate"] = options.populate;
+    record.parameters["advice"] = static_cast<int>(options.advice);
+
+    for (const MmapVariantResult &variant : result.variants) {
+        QJsonObject stats;
+        stats["mbps"] = variant.mbps();
+        stats["pageFaults"] = variant.pageFaults;
+        stats["majorFaults"] = variant.majorFaults;
+        stats["faultsPerSec"] = variant.faultsPerSec();
+        stats["p50Us"] = variant.latency.percentileNs(50) / 1000.0;
+        stats["p99Us"] = variant.latency.percentileNs(99) / 1000.0;
+        record.parameters[variant.name] = stats;
+
+        if (variant.mapped && !variant.random) {
+            if (variant.write) {
+                record.writeMBps = variant.mbps();
+                record.writeLatency = variant.latency;
+            } else {
+                record.readMBps = variant.mbps();
+                record.readLatency = variant.latency;
+            }
+        }
+    }
+    emit recordReady(record);
+}
@@ -0,0 +1,35 @@
+#ifndef MMAPPANEL_H
+#define MMAPPANEL_H
+
+#include <QSpinBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QTableWidget>
+
+#include "speedtestpanel.h"
+#include "mmapbenchmark.h"
+
+// 内存映射(mmap)与read/write对比测试模式面板
+class MmapPanel : public SpeedTestPanel
+{
+    Q_OBJECT
+
+public:
+    explicit MmapPanel(QWidget *parent = nullptr);
+
+    bool start(const SpeedTestParameters &parameters) override;
+    void setOptionsEnabled(bool enabled) override;
+
+private slots:
+    void onVariantCompleted(const MmapVariantResult &result);
+    void onTestCompleted(const MmapBenchmarkResult &result);
+
+private:
+    QSpinBox *m_threadsSpinBox;
+    QComboBox *m_adviceComboBox;
+    QCheckBox *m_populateCheckBox;
+    QCheckBox *m_writeCheckBox;
+    QTableWidget *m_table;
+};
+
+#endif // MMAPPANEL_H
@@ -0,0 +1,298 @@
+#include "multidiskpanel.h"
+
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDir>
+#include <QDebug>
+#include <QtCharts/QValueAxis>
+
+MultiDiskPanel::MultiDiskPanel(QWidget *parent) : SpeedTestPanel("多盘并发测试", parent), m_maxSpeed(0) {
+    QGridLayout *layout = new QGridLayout(this);
+
+    m_diskList = new QListWidget(this);
+    m_diskList->setMaximumHeight(120);
+
+    m_patternComboBox = new QComboBox(this);
+    m_patternComboBox->addItem("顺序读取", "read");
+    m_patternComboBox->addItem("顺序写入", "write");
+    m_patternComboBox->addItem("随机读取 (QD32)", "randread");
+    m_patternComboBox->addItem("随机写入 (QD32)", "randwrite");
+    m_runtimeSpinBox = new QSpinBox(this);
+    m_runtimeSpinBox->setRange(5, 600);
+    m_runtimeSpinBox->setValue(30);
+    m_runtimeSpinBox->setPrefix("运行 ");
+    m_runtimeSpinBox->setSuffix(" 秒");
+    m_staggerSpinBox = new QSpinBox(this);
+    m_staggerSpinBox->setRange(0, 120);
+    m_staggerSpinBox->setValue(0);
+    m_staggerSpinBox->setPrefix("错峰加入 ");
+    m_staggerSpinBox->setSuffix(" 秒");
+    m_staggerSpinBox->setToolTip("为0时所有磁盘同时开始；大于0时每隔该时间加入一块磁盘，便于观察合计带宽在第几块盘时饱和");
+    m_rawCheckBox = new QCheckBox("直接读取块设备 (只读)", this);
+
+    QHBoxLayout *optionsLayout = new QHBoxLayout();
+    optionsLayout->addWidget(m_patternComboBox);
+    optionsLayout->addWidget(m_runtimeSpinBox);
+    optionsLayout->addWidget(m_staggerSpinBox);
+    optionsLayout->addWidget(m_rawCheckBox);
+
+    m_chartView = new QtCharts::QChartView(this);
+    m_chartView->setRenderHint(QPainter::Antialiasing);
+    m_chartView->setMinimumHeight(220);
+
+    m_table = new QTableWidget(0, 6, this);
+    m_table->setHorizontalHeaderLabels({"磁盘", "加入时间", "读取速度", "写入速度", "IOPS", "延迟 p50/p99"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setEditTriggers(QTableWidget::NoEditTriggers);
+
+    layout->addWidget(new QLabel("参与测试的磁盘:", this), 0, 0);
+    layout->addWidget(m_diskList, 1, 0);
+    layout->addLayout(optionsLayout, 2, 0);
+    layout->addWidget(m_chartView, 3, 0);
+    layout->addWidget(m_table, 4, 0);
+}
+
+void MultiDiskPanel::setDisks(const QList<DiskInfo> &disks) {
+    m_disks = disks;
+
+    m_diskList->clear();
+    for (const DiskInfo &disk : m_disks) {
+        QListWidgetItem *item = new QListWidgetItem(QString("%1 (%2), %3").arg(disk.diskName).arg(disk.model)
+                                                    .arg(DiskUtils::formatSize(disk.diskSize)));
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Unchecked);
+        m_diskList->addItem(item);
+    }
+}
+
+bool MultiDiskPanel::start(const SpeedTestParameters &parameters) {
+    const bool raw = m_rawCheckBox->isChecked();
+    const QString rw = m_patternComboBox->currentData().toString();
+
+    FioJob job;
+    job.name = "multidisk";
+    job.rw = rw;
+    job.random = rw.startsWith("rand");
+    job.readPercent = rw.endsWith("read") ? 100 : 0;
+    job.blockSize = job.random ? 4096 : parameters.blockSize;
+    job.ioDepth = job.random ? 32 : 8;
+    job.engine = FioJob::NativeAio;
+    job.direct = true;
+    job.timeBased = true;
+    job.runtimeMs = m_runtimeSpinBox->value() * 1000LL;
+    job.rampTimeMs = 2000;
+    // 块设备使用整个设备，文件按“文件大小”设置创建
+    job.size = raw ? 0 : parameters.fileSize;
+
+    if (raw && job.hasWrites()) {
+        QMessageBox::warning(this, "错误", "直接访问块设备时只能进行读取测试");
+        return false;
+    }
+
+    QList<MultiDiskTarget> targets;
+    QStringList skipped;
+    for (int i = 0; i < m_diskList->count() && i < m_disks.size(); ++i) {
+        if (m_diskList->item(i)->checkState() != Qt::Checked) {
+            continue;
+        }
+        const DiskInfo &disk = m_disks[i];
+        MultiDiskTarget target;
+        target.diskName = disk.diskName;
+        target.model = disk.model;
+        target.serialNumber = disk.serialNumber.trimmed();
+        target.firmware = disk.firmwareVersion;
+        target.rawDevice = raw;
+        target.path = raw ? disk.diskPath : QDir::fromNativeSeparators(disk.volumePath);
+        // 文件模式必须写在对应磁盘上，没有可用分区的磁盘只能跳过
+        if (target.path.isEmpty() || (!raw && !QDir(target.path).exists())) {
+            skipped.append(disk.diskName);
+            continue;
+        }
+        targets.append(target);
+    }
+
+    if (targets.size() < 2) {
+        QMessageBox::warning(this, "警告", skipped.isEmpty() ? QString("请至少勾选两块磁盘")
+                             : QString("可测试的磁盘不足两块，以下磁盘没有可用的%1: %2")
+                                   .arg(raw ? "设备路径" : "分区").arg(skipped.join(", ")));
+        return false;
+    }
+
+    const qint64 staggerMs = m_staggerSpinBox->value() * 1000LL;
+    qDebug() << "开始多盘并发测试，磁盘数:" << targets.size() << "模式:" << rw << "错峰:" << staggerMs << "ms";
+
+    m_parameters = parameters;
+    emit statusChanged(skipped.isEmpty() ? QString("正在准备多盘并发测试...")
+                                         : QString("正在准备多盘并发测试...（已跳过 %1）").arg(skipped.join(", ")));
+    m_table->setRowCount(0);
+    createChart(targets);
+
+    MultiDiskRunner *runner = new MultiDiskRunner(targets, job, staggerMs);
+    connect(runner, &MultiDiskRunner::progressUpdated, this, [this](int percent, const QString &status) {
+        emit progressChanged(percent);
+        emit statusChanged(status);
+    });
+    connect(runner, &MultiDiskRunner::sampleRecorded, this, &MultiDiskPanel::onSampleRecorded);
+    connect(runner, &MultiDiskRunner::runCompleted, this, &MultiDiskPanel::onRunCompleted);
+    runWorker(runner, &MultiDiskRunner::startRun, &MultiDiskRunner::runCompleted);
+    return true;
+}
+
+void MultiDiskPanel::setOptionsEnabled(bool enabled) {
+    m_diskList->setEnabled(enabled);
+    m_patternComboBox->setEnabled(enabled);
+    m_runtimeSpinBox->setEnabled(enabled);
+    m_staggerSpinBox->setEnabled(enabled);
+    m_rawCheckBox->setEnabled(enabled);
+}
+
+void MultiDiskPanel::createChart(const QList<MultiDiskTarget> &targets) {
+    QtCharts::QChart *chart = new QtCharts::QChart();
+    chart->setTitle("各盘及合计速度");
+
+    m_series.clear();
+    m_maxSpeed = 0;
+    for (const MultiDiskTarget &target : targets) {
+        QtCharts::QLineSeries *series = new QtCharts::QLineSeries(chart);
+        series->setName(target.diskName);
+        chart->addSeries(series);
+        m_series.append(series);
+    }
+
+    QtCharts::QLineSeries *totalSeries = new QtCharts::QLineSeries(chart);
+    totalSeries->setName("合计");
+    totalSeries->setPen(QPen(QColor("#F44336"), 3));
+    chart->addSeries(totalSeries);
+    m_series.append(totalSeries);
+
+    QtCharts::QValueAxis *axisX = new QtCharts::QValueAxis();
+    axisX->setRange(0, 10);
+    axisX->setTitleText("时间(秒)");
+    axisX->setLabelFormat("%d");
+    chart->addAxis(axisX, Qt::AlignBottom);
+
+    QtCharts::QValueAxis *axisY = new QtCharts::QValueAxis();
+    axisY->setRange(0, 1000);
+    axisY->setTitleText("速度(MB/s)");
+    chart->addAxis(axisY, Qt::AlignLeft);
+
+    for (QtCharts::QLineSeries *series : m_series) {
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+
+    // 替换图表时旧图表随之释放
+    QtCharts::QChart *oldChart = m_chartView->chart();
+    m_chartView->setChart(chart);
+    delete oldChart;
+}
+
+void MultiDiskPanel::onSampleRecorded(const MultiDiskSample &sample) {
+    if (m_series.size() != sample.diskMBps.size() + 1) {
+        return;
+    }
+
+    for (int i = 0; i < sample.diskMBps.size(); ++i) {
+        m_series[i]->append(sample.elapsedSec, sample.diskMBps[i]);
+    }
+    m_series.last()->append(sample.elapsedSec, sample.totalMBps);
+    m_maxSpeed = qMax(m_maxSpeed, sample.totalMBps);
+
+    QtCharts::QChart *chart = m_chartView->chart();
+    QList<QtCharts::QAbstractAxis*> xAxes = chart->axes(Qt::Horizontal);
+    QList<QtCharts::QAbstractAxis*> yAxes = chart->axes(Qt::Vertical);
+    if (!xAxes.isEmpty()) {
+        xAxes.first()->setRange(0, qMax(10.0, sample.elapsedSec));
+    }
+    if (!yAxes.isEmpty()) {
+        yAxes.first()->setRange(0, qMax(100.0, m_maxSpeed * 1.1));
+    }
+}
+
+void MultiDiskPanel::onRunCompleted(const MultiDiskResult &result) {
+    auto latencyText = [](const LatencyHistogram &histogram) {
+        if (histogram.count() == 0) {
+            return QString("-");
+        }
+        return QString("%1 / %2 ms")
+            .arg(histogram.percentileNs(50) / 1e6, 0, 'f', 3)
+            .arg(histogram.percentileNs(99) / 1e6, 0, 'f', 3);
+    };
+
+    for (const MultiDiskDiskResult &disk : result.disks) {
+        const WorkloadJobResult &job = disk.job;
+        LatencyHistogram latency = job.readLatency;
+        latency.merge(job.writeLatency);
+
+        int row = m_table->rowCount();
+        m_table->insertRow(row);
+        m_table->setItem(row, 0, new QTableWidgetItem(QString("%1 (%2)").arg(disk.target.diskName).arg(disk.target.model)));
+        m_table->setItem(row, 1, new QTableWidgetItem(QString("%1 秒").arg(disk.startSec, 0, 'f', 0)));
+        if (!job.success) {
+            m_table->setItem(row, 2, new QTableWidgetItem(job.errorMessage.isEmpty() ? QString("未运行") : job.errorMessage));
+            m_table->setSpan(row, 2, 1, 4);
+            continue;
+        }
+        m_table->setItem(row, 2, new QTableWidgetItem(job.readIos > 0 ? QString("%1 MB/s").arg(job.readMBps(), 0, 'f', 1) : QString("-")));
+        m_table->setItem(row, 3, new QTableWidgetItem(job.writeIos > 0 ? QString("%1 MB/s").arg(job.writeMBps(), 0, 'f', 1) : QString("-")));
+        m_table->setItem(row, 4, new QTableWidgetItem(QString::number(disk.totalIops(), 'f', 0)));
+        m_table->setItem(row, 5, new QTableWidgetItem(latencyText(latency)));
+    }
+
+    if (!result.success) {
+        emit statusChanged(result.errorMessage);
+        if (!result.canceled) {
+            QMessageBox::warning(this, "多盘并发测试失败", result.errorMessage);
+        }
+        return;
+    }
+
+    int row = m_table->rowCount();
+    m_table->insertRow(row);
+    m_table->setItem(row, 0, new QTableWidgetItem("合计"));
+    m_table->setItem(row, 1, new QTableWidgetItem(QString("峰值 %1 MB/s").arg(result.peakTotalMBps, 0, 'f', 1)));
+    m_table->setItem(row, 2, new QTableWidgetItem(QString("%1 MB/s").arg(result.aggregateMBps, 0, 'f', 1)));
+    m_table->setSpan(row, 2, 1, 2);
+    m_table->setItem(row, 4, new QTableWidgetItem(QString::number(result.aggregateIops, 'f', 0)));
+
+    emit progressChanged(100);
+    emit statusChanged(QString("多盘并发测试完成: %1 块磁盘合计 %2 MB/s")
+                       .arg(result.disks.size()).arg(result.aggregateMBps, 0, 'f', 1));
+
+    // 每块盘各保存一条记录，便于在单盘历史中对比并发与单独测试的差异
+    for (const MultiDiskDiskResult &disk : result.disks) {
+        const WorkloadJobResult &job = disk.job;
+        SpeedTestRecord record = newRecord("multidisk");
+        record.diskSerial = disk.target.serialNumber;
+        record.diskModel = disk.target.model;
+        record.firmware = disk.target.firmware;
+        record.diskName = disk.target.diskName;
+        record.label = QString("%1盘并发").arg(result.disks.size());
+        record.blockSize = job.blockSize;
+        record.fileSize = job.readBytes + job.writeBytes;
+        if (job.readIos > 0) {
+            record.readMBps = job.readMBps();
+            record.readIops = job.readIops();
+            record.readP99Us = job.readLatency.percentileNs(99) / 1000.0;
+        }
+        if (job.writeIos > 0) {
+            record.writeMBps = job.writeMBps();
+            record.writeIops = job.writeIops();
+            record.writeP99Us = job.writeLatency.percentileNs(99) / 1000.0;
+        }
+        record.parameters["rw"] = job.rw;
+        record.parameters["ioDepth"] = job.ioDepth;
+        record.parameters["concurrentDisks"] = result.disks.size();
+        record.parameters["startSec"] = disk.startSec;
+        record.parameters["aggregateMBps"] = result.aggregateMBps;
+        record.parameters["peakTotalMBps"] = result.peakTotalMBps;
+        record.parameters["rawDevice"] = disk.target.rawDevice;
+        record.readLatency = job.readLatency;
+        record.writeLatency = job.writeLatency;
+        record.series = job.samples;
+        emit recordReady(record);
+    }
+}
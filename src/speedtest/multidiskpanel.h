@@ -0,0 +1,49 @@
+#ifndef MULTIDISKPANEL_H
+#define MULTIDISKPANEL_H
+
+#include <QListWidget>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QTableWidget>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+
+#include "speedtestpanel.h"
+#include "multidiskrunner.h"
+
+// 多盘并发（控制器瓶颈）测试模式面板
+class MultiDiskPanel : public SpeedTestPanel
+{
+    Q_OBJECT
+
+public:
+    explicit MultiDiskPanel(QWidget *parent = nullptr);
+
+    // 磁盘列表刷新时重建可勾选的磁盘
+    void setDisks(const QList<DiskInfo> &disks);
+
+    bool start(const SpeedTestParameters &parameters) override;
+    void setOptionsEnabled(bool enabled) override;
+
+private slots:
+    void onSampleRecorded(const MultiDiskSample &sample);
+    void onRunCompleted(const MultiDiskResult &result);
+
+private:
+    void createChart(const QList<MultiDiskTarget> &targets);
+
+    QListWidget *m_diskList;
+    QComboBox *m_patternComboBox;
+    QSpinBox *m_runtimeSpinBox;
+    QSpinBox *m_staggerSpinBox;
+    QCheckBox *m_rawCheckBox;
+    QtCharts::QChartView *m_chartView;
+    QList<QtCharts::QLineSeries*> m_series;  // 各盘一条，最后一条为合计
+    double m_maxSpeed;
+    QTableWidget *m_table;
+
+    QList<DiskInfo> m_disks;
+};
+
+#endif // MULTIDISKPANEL_H
@@ -0,0 +1,233 @@
+#include "multidiskrunner.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QtConcurrent>
+
+namespace {
+// 采样间隔（毫秒），与WorkloadEngine的进度间隔一致
+const int kSampleIntervalMs = 500;
+// 错峰等待时检查取消的间隔
+const int kWaitSliceMs = 100;
+}
+
+MultiDiskRunner::MultiDiskRunner(const QList<MultiDiskTarget> &targets, const FioJob &job, qint64 staggerMs, QObject *parent)
+    : QObject(parent), m_targets(targets), m_job(job), m_staggerMs(qMax<qint64>(0, staggerMs)), m_canceled(0) {
+    qRegisterMetaType<MultiDiskSample>("MultiDiskSample");
+    qRegisterMetaType<MultiDiskResult>("MultiDiskResult");
+}
+
+void MultiDiskRunner::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+FioJob MultiDiskRunner::jobForTarget(int index) const {
+    const MultiDiskTarget &target = m_targets[index];
+    FioJob job = m_job;
+    job.name = QString("%1@%2").arg(m_job.name).arg(target.diskName);
+    job.filename = target.rawDevice ? target.path
+                                    : QDir(target.path).filePath(QString("disktoolbox_multidisk_%1.dat").arg(index));
+    // 错峰加入时先加入的盘运行更久，保证所有盘同时结束
+    if (m_staggerMs > 0 && job.runtimeMs > 0) {
+        job.runtimeMs += (m_targets.size() - 1 - index) * m_staggerMs;
+    }
+    return job;
+}
+
+bool MultiDiskRunner::prepareFiles(QList<FioJob> &jobs, QString &errorMessage) {
+    jobs.clear();
+    for (int i = 0; i < m_targets.size(); ++i) {
+        jobs.append(jobForTarget(i));
+    }
+
+    // 测试文件并行铺设，避免先铺好的盘提前开始跑
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_targets.size());
+    QList<QFuture<QString>> layouts;
+    for (int i = 0; i < m_targets.size(); ++i) {
+        if (m_targets[i].rawDevice) {
+            if (jobs[i].hasWrites()) {
+                errorMessage = QString("为防止破坏数据，不允许对块设备执行写入: %1").arg(m_targets[i].path);
+                return false;
+            }
+            continue;
+        }
+
+        const QString path = jobs[i].filename;
+        const qint64 size = jobs[i].offset + jobs[i].size;
+        if (!QFileInfo::exists(path)) {
+            m_createdFiles.append(path);
+        }
+        layouts.append(QtConcurrent::run(&pool, [this, path, size]() {
+            QString error;
+            if (!WorkloadEngine::layoutFile(path, size, error, &m_canceled)) {
+                return error.isEmpty() ? QString("铺设测试文件失败: %1").arg(path) : error;
+            }
+            return QString();
+        }));
+    }
+
+    bool ok = true;
+    for (QFuture<QString> &layout : layouts) {
+        QString error = layout.result();
+        if (!error.isEmpty() && ok) {
+            errorMessage = error;
+            ok = false;
+        }
+    }
+    return ok && !m_canceled.loadRelaxed();
+}
+
+void MultiDiskRunner::startRun() {
+    MultiDiskResult result;
+    const int diskCount = m_targets.size();
+
+    if (diskCount == 0) {
+        result.errorMessage = "没有选择磁盘";
+        emit runCompleted(result);
+        return;
+    }
+
+    qDebug() << "多盘并发测试开始: 磁盘数" << diskCount << "rw=" << m_job.rw << "bs=" << m_job.blockSize
+             << "iodepth=" << m_job.ioDepth << "错峰间隔" << m_staggerMs << "ms";
+
+    emit progressUpdated(0, "正在准备测试文件...");
+    QList<FioJob> jobs;
+    QString errorMessage;
+    if (!prepareFiles(jobs, errorMessage)) {
+        for (const QString &path : m_createdFiles) {
+            QFile::remove(path);
+        }
+        result.canceled = m_canceled.loadRelaxed() != 0;
+        result.errorMessage = result.canceled ? QString("测试已取消") : errorMessage;
+        emit runCompleted(result);
+        return;
+    }
+
+    // 每块盘一个引擎，进度信号在工作线程中直接记录各盘当前速度
+    QMutex speedMutex;
+    QVector<double> currentMBps(diskCount, 0.0);
+    QList<WorkloadEngine*> engines;
+    for (int i = 0; i < diskCount; ++i) {
+        WorkloadEngine *engine = new WorkloadEngine(QList<FioJob>() << jobs[i], QString());
+        connect(engine, &WorkloadEngine::progressUpdated, engine,
+                [&speedMutex, &currentMBps, i](int, const QString &, double readMBps, double writeMBps) {
+            QMutexLocker locker(&speedMutex);
+            currentMBps[i] = readMBps + writeMBps;
+        }, Qt::DirectConnection);
+        engines.append(engine);
+    }
+
+    // 独立线程池，保证所有盘同时运行
+    QThreadPool pool;
+    pool.setMaxThreadCount(diskCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QFuture<WorkloadRunResult>> runs;
+    for (int i = 0; i < diskCount; ++i) {
+        WorkloadEngine *engine = engines[i];
+        const qint64 delayMs = i * m_staggerMs;
+        runs.append(QtConcurrent::run(&pool, [this, engine, delayMs, &timer]() {
+            while (timer.elapsed() < delayMs && !m_canceled.loadRelaxed()) {
+                QThread::msleep(kWaitSliceMs);
+            }
+            if (m_canceled.loadRelaxed()) {
+                return WorkloadRunResult();
+            }
+            return engine->run();
+        }));
+    }
+
+    // 预计总时长，用于进度显示；按大小运行的作业无法预估时只显示耗时
+    qint64 expectedMs = 0;
+    if (m_job.runtimeMs > 0) {
+        expectedMs = m_job.rampTimeMs + m_job.runtimeMs + (diskCount - 1) * m_staggerMs;
+    }
+
+    bool running = true;
+    while (running) {
+        QThread::msleep(kSampleIntervalMs);
+
+        if (m_canceled.loadRelaxed()) {
+            for (WorkloadEngine *engine : engines) {
+                engine->cancel();
+            }
+        }
+
+        const qint64 nowMs = timer.elapsed();
+        MultiDiskSample sample;
+        sample.elapsedSec = nowMs / 1000.0;
+        sample.diskMBps.resize(diskCount);
+
+        int active = 0;
+        running = false;
+        {
+            QMutexLocker locker(&speedMutex);
+            for (int i = 0; i < diskCount; ++i) {
+                bool started = nowMs >= i * m_staggerMs;
+                bool finished = runs[i].isFinished();
+                if (finished) {
+                    currentMBps[i] = 0;
+                } else {
+                    running = true;
+                }
+                sample.diskMBps[i] = started ? currentMBps[i] : 0;
+                sample.totalMBps += sample.diskMBps[i];
+                if (started && !finished) {
+                    ++active;
+                }
+            }
+        }
+
+        result.samples.append(sample);
+        result.peakTotalMBps = qMax(result.peakTotalMBps, sample.totalMBps);
+        emit sampleRecorded(sample);
+
+        int percent = expectedMs > 0 ? static_cast<int>(qMin<qint64>(99, nowMs * 100 / expectedMs)) : 0;
+        emit progressUpdated(percent, QString("%1 块磁盘运行中，合计 %2 MB/s").arg(active).arg(sample.totalMBps, 0, 'f', 1));
+    }
+
+    QStringList failures;
+    for (int i = 0; i < diskCount; ++i) {
+        WorkloadRunResult run = runs[i].result();
+
+        MultiDiskDiskResult disk;
+        disk.target = m_targets[i];
+        disk.startSec = i * m_staggerMs / 1000.0;
+        if (!run.jobs.isEmpty()) {
+            disk.job = run.jobs.first();
+        }
+        if (!run.success && !run.canceled && !m_canceled.loadRelaxed()) {
+            failures.append(QString("%1: %2").arg(m_targets[i].diskName).arg(run.errorMessage));
+        }
+        result.aggregateMBps += disk.totalMBps();
+        result.aggregateIops += disk.totalIops();
+        result.disks.append(disk);
+    }
+    qDeleteAll(engines);
+
+    for (const QString &path : m_createdFiles) {
+        QFile::remove(path);
+    }
+    m_createdFiles.clear();
+
+    result.canceled = m_canceled.loadRelaxed() != 0;
+    if (result.canceled) {
+        result.errorMessage = "测试已取消";
+    } else if (!failures.isEmpty()) {
+        result.errorMessage = failures.join("\n");
+    } else {
+        result.success = true;
+    }
+
+    qDebug() << "多盘并发测试结束: 合计" << result.aggregateMBps << "MB/s, 峰值" << result.peakTotalMBps << "MB/s";
+    emit runCompleted(result);
+}
@@ -0,0 +1,99 @@
+#ifndef MULTIDISKRUNNER_H
+#define MULTIDISKRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QMetaType>
+#include <QAtomicInt>
+
+#include "fiojob.h"
+#include "workloadengine.h"
+
+// 参与并发测试的一块磁盘
+struct MultiDiskTarget {
+    QString diskName;
+    QString model;
+    QString serialNumber;
+    QString firmware;
+    QString path;           // 块设备路径，或在该盘上创建测试文件的目录
+    bool rawDevice;         // path为块设备，只允许读
+
+    MultiDiskTarget() : rawDevice(false) {}
+};
+
+// 并发运行中的一个采样点
+struct MultiDiskSample {
+    double elapsedSec;          // 从所有磁盘同时开始计
+    QVector<double> diskMBps;   // 各盘本区间的读写速度之和，未加入或已结束的盘为0
+    double totalMBps;           // 全部磁盘的合计
+
+    MultiDiskSample() : elapsedSec(0), totalMBps(0) {}
+};
+
+// 单盘在并发运行中的结果
+struct MultiDiskDiskResult {
+    MultiDiskTarget target;
+    double startSec;            // 错峰加入时的加入时刻
+    WorkloadJobResult job;
+
+    MultiDiskDiskResult() : startSec(0) {}
+
+    double totalMBps() const { return job.readMBps() + job.writeMBps(); }
+    double totalIops() const { return job.readIops() + job.writeIops(); }
+};
+
+// 多盘并发测试结果
+struct MultiDiskResult {
+    bool success;
+    bool canceled;
+    QString errorMessage;
+    QList<MultiDiskDiskResult> disks;
+    QList<MultiDiskSample> samples;
+    double aggregateMBps;       // 各盘平均速度之和
+    double aggregateIops;
+    double peakTotalMBps;       // 采样中合计速度的峰值
+
+    MultiDiskResult() : success(false), canceled(false), aggregateMBps(0), aggregateIops(0), peakTotalMBps(0) {}
+};
+
+Q_DECLARE_METATYPE(MultiDiskSample)
+Q_DECLARE_METATYPE(MultiDiskResult)
+
+// 多盘并发测试
+// 在多块磁盘上同时运行同一个fio作业，用来找出HBA、扩展卡或PCIe交换芯片的总带宽瓶颈。
+// 先并行铺好所有测试文件，再让每块盘各用一个WorkloadEngine在独立线程上同时开始，
+// 统一按固定间隔采样各盘和合计速度。
+// staggerMs大于0时各盘按顺序每隔staggerMs加入一块，所有盘同时结束，
+// 合计曲线随盘数阶梯上升，单盘速度开始下降的位置就是总线或控制器饱和点。
+class MultiDiskRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    MultiDiskRunner(const QList<MultiDiskTarget> &targets, const FioJob &job, qint64 staggerMs = 0,
+                    QObject *parent = nullptr);
+
+    void cancel();
+
+public slots:
+    void startRun();
+
+signals:
+    void progressUpdated(int percent, const QString &status);
+    void sampleRecorded(const MultiDiskSample &sample);
+    void runCompleted(const MultiDiskResult &result);
+
+private:
+    bool prepareFiles(QList<FioJob> &jobs, QString &errorMessage);
+    FioJob jobForTarget(int index) const;
+
+    QList<MultiDiskTarget> m_targets;
+    FioJob m_job;
+    qint64 m_staggerMs;
+    QStringList m_createdFiles;
+    QAtomicInt m_canceled;
+};
+
+#endif // MULTIDISKRUNNER_H
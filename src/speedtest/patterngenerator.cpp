@@ -0,0 +1,219 @@
+#include "patterngenerator.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PATTERN_HAVE_AVX2
+#define PATTERN_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define PATTERN_HAVE_AVX2
+#define PATTERN_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+// 重复块的种类数，去重命中的块在这些内容之间循环
+const int kDedupePoolChunks = 16;
+
+quint64 splitMix64(quint64 value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+inline quint64 rotl(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// 逐路计算，每次输出4个64位数（32字节），顺序与AVX2实现相同
+void generateScalar(quint64 (&s)[4][4], quint64 *out, qint64 blocks) {
+    for (qint64 i = 0; i < blocks; ++i) {
+        for (int lane = 0; lane < 4; ++lane) {
+            const quint64 result = rotl(s[1][lane] * 5, 7) * 9;
+            const quint64 t = s[1][lane] << 17;
+            s[2][lane] ^= s[0][lane];
+            s[3][lane] ^= s[1][lane];
+            s[1][lane] ^= s[2][lane];
+            s[0][lane] ^= s[3][lane];
+            s[2][lane] ^= t;
+            s[3][lane] = rotl(s[3][lane], 45);
+            out[i * 4 + lane] = result;
+        }
+    }
+}
+
+#ifdef PATTERN_HAVE_AVX2
+PATTERN_AVX2_TARGET
+inline __m256i rotlAvx2(__m256i value, int bits) {
+    return _mm256_or_si256(_mm256_slli_epi64(value, bits), _mm256_srli_epi64(value, 64 - bits));
+}
+
+// AVX2没有64位乘法，×5和×9用移位加法代替
+PATTERN_AVX2_TARGET
+void generateAvx2(quint64 (&s)[4][4], quint64 *out, qint64 blocks) {
+    __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[0]));
+    __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[1]));
+    __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[2]));
+    __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[3]));
+
+    for (qint64 i = 0; i < blocks; ++i) {
+        __m256i times5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+        __m256i rotated = rotlAvx2(times5, 7);
+        __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), result);
+
+        __m256i t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = rotlAvx2(s3, 45);
+    }
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[0]), s0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[1]), s1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[2]), s2);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s[3]), s3);
+}
+#endif
+
+bool detectAvx2() {
+#if defined(PATTERN_HAVE_AVX2) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(PATTERN_HAVE_AVX2)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // 需要操作系统保存YMM寄存器（OSXSAVE且XCR0的SSE/AVX位均已开启）
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+}
+
+PatternGenerator::PatternGenerator(quint64 seed, int compressPercent, int dedupePercent)
+    : m_seed(splitMix64(seed)), m_chunkCounter(0),
+      m_compressPercent(qBound(0, compressPercent, 100)), m_dedupePercent(qBound(0, dedupePercent, 100)) {
+    seedState(m_state, seed);
+
+    if (m_dedupePercent > 0) {
+        // 重复块也按压缩比例生成，保证整体可压缩比例不受去重比例影响
+        m_dedupePool.resize(kDedupePoolChunks * kChunkSize);
+        State poolState;
+        seedState(poolState, m_seed ^ 0xD1B54A32D192ED03ULL);
+        const qint64 randomBytes = (kChunkSize * (100 - m_compressPercent) / 100) & ~qint64(7);
+        for (int i = 0; i < kDedupePoolChunks; ++i) {
+            char *chunk = m_dedupePool.data() + i * kChunkSize;
+            generate(poolState, chunk, randomBytes);
+            memset(chunk + randomBytes, 0, kChunkSize - randomBytes);
+        }
+    }
+}
+
+void PatternGenerator::seedState(State &state, quint64 seed) {
+    quint64 value = seed;
+    for (int word = 0; word < 4; ++word) {
+        for (int lane = 0; lane < 4; ++lane) {
+            value = splitMix64(value);
+            state.words[word][lane] = value;
+        }
+    }
+}
+
+void PatternGenerator::generate(State &state, char *data, qint64 size) {
+    static const bool useAvx2 = avx2Supported();
+
+    const qint64 blocks = size / 32;
+    quint64 *out = reinterpret_cast<quint64*>(data);
+#ifdef PATTERN_HAVE_AVX2
+    if (useAvx2) {
+        generateAvx2(state.words, out, blocks);
+    } else {
+        generateScalar(state.words, out, blocks);
+    }
+#else
+    Q_UNUSED(useAvx2);
+    generateScalar(state.words, out, blocks);
+#endif
+
+    // 不足32字节的尾部单独生成一组再截取
+    const qint64 tail = size - blocks * 32;
+    if (tail > 0) {
+        quint64 last[4];
+        generateScalar(state.words, last, 1);
+        memcpy(data + blocks * 32, last, static_cast<size_t>(tail));
+    }
+}
+
+void PatternGenerator::fillChunk(char *chunk, qint64 size) {
+    const quint64 counter = m_chunkCounter++;
+    if (m_dedupePercent > 0) {
+        quint64 hash = splitMix64(m_seed ^ counter);
+        if (static_cast<int>(hash % 100) < m_dedupePercent) {
+            const int slot = static_cast<int>((hash >> 32) % kDedupePoolChunks);
+            memcpy(chunk, m_dedupePool.constData() + slot * kChunkSize, static_cast<size_t>(size));
+            return;
+        }
+    }
+
+    const qint64 randomBytes = qMin(size, (kChunkSize * (100 - m_compressPercent) / 100) & ~qint64(7));
+    generate(m_state, chunk, randomBytes);
+    memset(chunk + randomBytes, 0, static_cast<size_t>(size - randomBytes));
+}
+
+void PatternGenerator::fill(char *data, qint64 size) {
+    if (m_compressPercent == 0 && m_dedupePercent == 0) {
+        generate(m_state, data, size);
+        return;
+    }
+
+    for (qint64 offset = 0; offset < size; offset += kChunkSize) {
+        fillChunk(data + offset, qMin<qint64>(kChunkSize, size - offset));
+    }
+}
+
+void PatternGenerator::refresh(char *data, qint64 size, quint64 sequence) {
+    const quint64 base = splitMix64(m_seed ^ sequence);
+    for (qint64 offset = 0, index = 0; offset < size; offset += kChunkSize, ++index) {
+        const qint64 length = qMin<qint64>(kChunkSize, size - offset);
+        const quint64 hash = splitMix64(base + static_cast<quint64>(index));
+
+        if (m_dedupePercent > 0 && static_cast<int>(hash % 100) < m_dedupePercent) {
+            const int slot = static_cast<int>((hash >> 32) % kDedupePoolChunks);
+            memcpy(data + offset, m_dedupePool.constData() + slot * kChunkSize, static_cast<size_t>(length));
+            continue;
+        }
+
+        // 块开头写入唯一标记，随机部分仍不可压缩
+        const quint64 stamp = splitMix64(hash);
+        memcpy(data + offset, &stamp, static_cast<size_t>(qMin<qint64>(length, sizeof(stamp))));
+    }
+}
+
+void PatternGenerator::fillRandom(char *data, qint64 size, quint64 seed) {
+    State state;
+    seedState(state, seed);
+    generate(state, data, size);
+}
+
+bool PatternGenerator::avx2Supported() {
+    static const bool supported = detectAvx2();
+    return supported;
+}
+
+const char *PatternGenerator::implementationName() {
+    return avx2Supported() ? "xoshiro256** AVX2" : "xoshiro256** scalar";
+}
@@ -0,0 +1,55 @@
+#ifndef PATTERNGENERATOR_H
+#define PATTERNGENERATOR_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+// 写入缓冲区数据生成器
+// 随机部分用4路并行的xoshiro256**生成，CPU支持AVX2时按向量一次生成4个64位数，
+// 不支持时逐路计算，两种实现输出完全一致。
+// 以4K为单位控制可压缩比例（每块后部填零）和去重比例（部分块重复固定内容），
+// 与fio的buffer_compress_percentage/dedupe_percentage含义一致。
+class PatternGenerator
+{
+public:
+    // 压缩和去重的判定粒度
+    static const int kChunkSize = 4096;
+
+    explicit PatternGenerator(quint64 seed, int compressPercent = 0, int dedupePercent = 0);
+
+    int compressPercent() const { return m_compressPercent; }
+    int dedupePercent() const { return m_dedupePercent; }
+
+    // 生成全新的数据，应在计时开始前或与I/O并行调用
+    void fill(char *data, qint64 size);
+
+    // 每次写入前调用：按去重比例把部分4K块换成重复块，其余块写入8字节唯一标记。
+    // 只改动少量字节，即使放在计时循环内也可以忽略，同时让每次写入的内容都不相同，
+    // 主控或文件系统的去重无法命中（相当于fio的scramble_buffers）。
+    void refresh(char *data, qint64 size, quint64 sequence);
+
+    // 不可压缩的随机数据，size应为8的整数倍
+    static void fillRandom(char *data, qint64 size, quint64 seed);
+
+    static bool avx2Supported();
+    static const char *implementationName();
+
+private:
+    // 4路xoshiro256**状态，words[k][lane]
+    struct State {
+        alignas(32) quint64 words[4][4];
+    };
+
+    static void seedState(State &state, quint64 seed);
+    static void generate(State &state, char *data, qint64 size);
+    void fillChunk(char *chunk, qint64 size);
+
+    State m_state;
+    quint64 m_seed;
+    quint64 m_chunkCounter;
+    int m_compressPercent;
+    int m_dedupePercent;
+    QByteArray m_dedupePool;        // 重复块的固定内容
+};
+
+#endif // PATTERNGENERATOR_H
@@ -0,0 +1,162 @@
+#include "qospanel.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDebug>
+
+QosPanel::QosPanel(QWidget *parent) : SpeedTestPanel("负载下延迟 (QoS)", parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    QLabel *hintLabel = new QLabel("先在空闲状态下以固定速率发出4K随机读得到基线延迟，再在后台吞吐负载运行时重复探测；"
+                                   "后台负载使用上方的块大小和文件大小", this);
+    hintLabel->setWordWrap(true);
+
+    m_patternComboBox = new QComboBox(this);
+    m_patternComboBox->addItem("后台: 顺序写入", "write");
+    m_patternComboBox->addItem("后台: 顺序读取", "read");
+    m_patternComboBox->addItem("后台: 随机写入", "randwrite");
+    m_patternComboBox->addItem("后台: 随机混合读写", "randrw");
+    m_depthSpinBox = new QSpinBox(this);
+    m_depthSpinBox->setRange(1, 256);
+    m_depthSpinBox->setValue(32);
+    m_depthSpinBox->setPrefix("后台QD ");
+    m_probeRateSpinBox = new QSpinBox(this);
+    m_probeRateSpinBox->setRange(1, 1000);
+    m_probeRateSpinBox->setValue(50);
+    m_probeRateSpinBox->setPrefix("探测 ");
+    m_probeRateSpinBox->setSuffix(" 次/秒");
+    m_durationSpinBox = new QSpinBox(this);
+    m_durationSpinBox->setRange(5, 300);
+    m_durationSpinBox->setValue(20);
+    m_durationSpinBox->setPrefix("每阶段 ");
+    m_durationSpinBox->setSuffix(" 秒");
+
+    QHBoxLayout *settingsLayout = new QHBoxLayout();
+    settingsLayout->addWidget(m_patternComboBox);
+    settingsLayout->addWidget(m_depthSpinBox);
+    settingsLayout->addWidget(m_probeRateSpinBox);
+    settingsLayout->addWidget(m_durationSpinBox);
+    settingsLayout->addStretch();
+
+    // 行为百分位，列为空闲/负载下延迟和两者之比
+    m_table = new QTableWidget(0, 4, this);
+    m_table->setHorizontalHeaderLabels({"百分位", "空闲延迟", "负载下延迟", "膨胀系数"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setEditTriggers(QTableWidget::NoEditTriggers);
+
+    m_resultLabel = new QLabel("尚未进行负载下延迟测试", this);
+    m_resultLabel->setWordWrap(true);
+
+    layout->addWidget(hintLabel);
+    layout->addLayout(settingsLayout);
+    layout->addWidget(m_table);
+    layout->addWidget(m_resultLabel);
+}
+
+bool QosPanel::start(const SpeedTestParameters &parameters) {
+    const QString rw = m_patternComboBox->currentData().toString();
+
+    QosTestOptions options;
+    options.background.rw = rw;
+    options.background.random = rw.startsWith("rand");
+    options.background.readPercent = rw == "randrw" ? 50 : (rw.endsWith("read") ? 100 : 0);
+    options.background.rwMixRead = 50;
+    options.background.blockSize = parameters.blockSize;
+    options.background.ioDepth = m_depthSpinBox->value();
+    options.background.engine = FioJob::NativeAio;
+    options.background.direct = true;
+    options.probeIops = m_probeRateSpinBox->value();
+    options.probeSeconds = m_durationSpinBox->value();
+    options.fileSize = parameters.fileSize;
+
+    qDebug() << "开始负载下延迟测试，目录:" << parameters.testDirectory << "后台负载:" << rw
+             << "探测速率:" << options.probeIops;
+
+    m_parameters = parameters;
+    emit statusChanged("正在准备负载下延迟测试...");
+    m_table->setRowCount(0);
+    m_resultLabel->setText("测试进行中...");
+
+    QosTester *tester = new QosTester(parameters.testDirectory, options);
+    connect(tester, &QosTester::progressUpdated, this, [this](int percent, const QString &phase, double probeLatencyUs) {
+        emit progressChanged(percent);
+        if (probeLatencyUs > 0) {
+            emit statusChanged(QString("负载下延迟测试 - %1: 探测p99 %2 us").arg(phase).arg(probeLatencyUs, 0, 'f', 1));
+        } else {
+            emit statusChanged(QString("负载下延迟测试 - %1").arg(phase));
+        }
+    });
+    connect(tester, &QosTester::testCompleted, this, &QosPanel::onTestCompleted);
+    runWorker(tester, &QosTester::startTest, &QosTester::testCompleted);
+    return true;
+}
+
+void QosPanel::setOptionsEnabled(bool enabled) {
+    m_patternComboBox->setEnabled(enabled);
+    m_depthSpinBox->setEnabled(enabled);
+    m_probeRateSpinBox->setEnabled(enabled);
+    m_durationSpinBox->setEnabled(enabled);
+}
+
+void QosPanel::onTestCompleted(const QosResult &result) {
+    if (!result.success) {
+        emit statusChanged(result.errorMessage);
+        m_resultLabel->setText(result.errorMessage);
+        if (!result.canceled) {
+            QMessageBox::warning(this, "负载下延迟测试失败", result.errorMessage);
+        }
+        return;
+    }
+
+    emit progressChanged(100);
+    emit statusChanged("负载下延迟测试完成");
+
+    const QList<QPair<QString, double>> percentiles = {
+        {"p50", 50}, {"p90", 90}, {"p99", 99}, {"p99.9", 99.9}, {"最大值", 100}
+    };
+    m_table->setRowCount(percentiles.size());
+    for (int row = 0; row < percentiles.size(); ++row) {
+        const double percentile = percentiles[row].second;
+        m_table->setItem(row, 0, new QTableWidgetItem(percentiles[row].first));
+        m_table->setItem(row, 1, new QTableWidgetItem(QString("%1 us").arg(result.idleLatency.percentileNs(percentile) / 1000.0, 0, 'f', 1)));
+        m_table->setItem(row, 2, new QTableWidgetItem(QString("%1 us").arg(result.loadedLatency.percentileNs(percentile) / 1000.0, 0, 'f', 1)));
+        m_table->setItem(row, 3, new QTableWidgetItem(QString("%1x").arg(result.inflation(percentile), 0, 'f', 2)));
+    }
+
+    const double backgroundMBps = result.backgroundReadMBps + result.backgroundWriteMBps;
+    QString summary = QString("p99延迟膨胀 %1 倍（空闲 %2 us → 负载下 %3 us），后台负载 %4 MB/s / %5 IOPS")
+                          .arg(result.inflation(99), 0, 'f', 2)
+                          .arg(result.idleLatency.percentileNs(99) / 1000.0, 0, 'f', 1)
+                          .arg(result.loadedLatency.percentileNs(99) / 1000.0, 0, 'f', 1)
+                          .arg(backgroundMBps, 0, 'f', 1)
+                          .arg(result.backgroundIops, 0, 'f', 0);
+    if (result.lateProbes > 0) {
+        summary += QString("\n有 %1 次探测因前一次未完成而推迟发出，推迟时间已计入延迟").arg(result.lateProbes);
+    }
+    m_resultLabel->setText(summary);
+
+    // 读延迟取负载下的探测延迟，空闲基线和膨胀系数放在参数中，便于按磁盘跟踪
+    SpeedTestRecord record = newRecord("qos");
+    const QosTestOptions &options = result.options;
+    record.blockSize = options.background.blockSize;
+    record.fileSize = options.fileSize;
+    record.label = QString("后台%1 QD%2, 探测%3次/秒").arg(options.background.rw).arg(options.background.ioDepth).arg(options.probeIops);
+    record.readLatency = result.loadedLatency;
+    record.readP99Us = result.loadedLatency.percentileNs(99) / 1000.0;
+    record.parameters["backgroundRw"] = options.background.rw;
+    record.parameters["backgroundIoDepth"] = options.background.ioDepth;
+    record.parameters["backgroundMBps"] = backgroundMBps;
+    record.parameters["backgroundIops"] = result.backgroundIops;
+    record.parameters["probeIops"] = options.probeIops;
+    record.parameters["probeSeconds"] = options.probeSeconds;
+    record.parameters["lateProbes"] = result.lateProbes;
+    record.parameters["idleP50Us"] = result.idleLatency.percentileNs(50) / 1000.0;
+    record.parameters["idleP99Us"] = result.idleLatency.percentileNs(99) / 1000.0;
+    record.parameters["idleP999Us"] = result.idleLatency.percentileNs(99.9) / 1000.0;
+    record.parameters["inflationP50"] = result.inflation(50);
+    record.parameters["inflationP99"] = result.inflation(99);
+    record.parameters["inflationP999"] = result.inflation(99.9);
+    emit recordReady(record);
+}
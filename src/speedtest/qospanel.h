@@ -0,0 +1,35 @@
+#ifndef QOSPANEL_H
+#define QOSPANEL_H
+
+#include <QComboBox>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QLabel>
+
+#include "speedtestpanel.h"
+#include "qostester.h"
+
+// 负载下延迟(QoS)测试模式面板
+class QosPanel : public SpeedTestPanel
+{
+    Q_OBJECT
+
+public:
+    explicit QosPanel(QWidget *parent = nullptr);
+
+    bool start(const SpeedTestParameters &parameters) override;
+    void setOptionsEnabled(bool enabled) override;
+
+private slots:
+    void onTestCompleted(const QosResult &result);
+
+private:
+    QComboBox *m_patternComboBox;
+    QSpinBox *m_depthSpinBox;
+    QSpinBox *m_probeRateSpinBox;
+    QSpinBox *m_durationSpinBox;
+    QTableWidget *m_table;
+    QLabel *m_resultLabel;
+};
+
+#endif // QOSPANEL_H
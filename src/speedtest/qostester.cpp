@@ -0,0 +1,192 @@
+#include "qostester.h"
+#include "iocore.h"
+#include "workloadengine.h"
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <QtConcurrent>
+
+namespace {
+// 探测的读取大小
+const qint64 kProbeSize = 4096;
+// 后台负载开始后等待其稳定的时间，期间不探测也不统计
+const qint64 kSettleMs = 3000;
+// 进度刷新间隔（毫秒）
+const int kProgressIntervalMs = 500;
+// 探测速率上限，再高就不再是"低速率"前台请求了
+const int kMaxProbeIops = 1000;
+}
+
+QosTester::QosTester(const QString &testDirectory, const QosTestOptions &options, QObject *parent)
+    : QObject(parent), m_testDirectory(testDirectory), m_options(options), m_canceled(0), m_engine(nullptr) {
+    m_options.probeIops = qBound(1, m_options.probeIops, kMaxProbeIops);
+    m_options.probeSeconds = qMax(1, m_options.probeSeconds);
+    m_options.fileSize = qMax<qint64>(m_options.background.blockSize, IoFile::alignDown(m_options.fileSize));
+    qRegisterMetaType<QosResult>("QosResult");
+}
+
+void QosTester::cancel() {
+    m_canceled.storeRelaxed(1);
+    QMutexLocker locker(&m_engineMutex);
+    if (m_engine) {
+        m_engine->cancel();
+    }
+}
+
+void QosTester::startTest() {
+    QosResult result;
+    result.options = m_options;
+
+    m_filePath = QDir(m_testDirectory).filePath("disktoolbox_qos.dat");
+    bool existed = QFile::exists(m_filePath);
+
+    qDebug() << "负载下延迟测试开始:" << m_filePath << "后台" << m_options.background.rw << "bs"
+             << m_options.background.blockSize << "iodepth" << m_options.background.ioDepth << "探测"
+             << m_options.probeIops << "次/秒 ×" << m_options.probeSeconds << "秒";
+
+    emit progressUpdated(0, "正在准备测试文件...", 0);
+    QString errorMessage;
+    bool ok = WorkloadEngine::layoutFile(m_filePath, m_options.fileSize, errorMessage, &m_canceled);
+
+    // 空闲基线
+    if (ok) {
+        ok = runProbe(result.idleLatency, result.lateProbes, 0, 40, "空闲基线", errorMessage);
+    }
+
+    // 后台负载运行期间探测；负载的预热时间与等待稳定的时间一致，统计区间与探测区间重合
+    if (ok && !m_canceled.loadRelaxed()) {
+        FioJob job = m_options.background;
+        job.name = "background";
+        job.filename = m_filePath;
+        job.size = m_options.fileSize;
+        job.timeBased = true;
+        job.rampTimeMs = kSettleMs;
+        job.runtimeMs = m_options.probeSeconds * 1000LL;
+
+        WorkloadEngine engine(QList<FioJob>() << job, m_testDirectory);
+        {
+            QMutexLocker locker(&m_engineMutex);
+            m_engine = &engine;
+        }
+        if (m_canceled.loadRelaxed()) {
+            engine.cancel();
+        }
+
+        QFuture<WorkloadRunResult> background = QtConcurrent::run([&engine]() {
+            return engine.run();
+        });
+
+        emit progressUpdated(45, "等待后台负载稳定...", 0);
+        QElapsedTimer settle;
+        settle.start();
+        while (settle.elapsed() < kSettleMs && !background.isFinished() && !m_canceled.loadRelaxed()) {
+            QThread::msleep(100);
+        }
+
+        qint64 loadedLate = 0;
+        if (background.isFinished()) {
+            // 负载在稳定前就结束说明作业本身出错
+            ok = false;
+        } else {
+            ok = runProbe(result.loadedLatency, loadedLate, 50, 50, "后台负载下", errorMessage);
+            result.lateProbes += loadedLate;
+            // 探测正常结束时负载也随之到时，探测失败时提前停止负载
+            if (!ok) {
+                engine.cancel();
+            }
+        }
+
+        WorkloadRunResult run = background.result();
+        {
+            QMutexLocker locker(&m_engineMutex);
+            m_engine = nullptr;
+        }
+
+        if (!run.jobs.isEmpty()) {
+            const WorkloadJobResult &jobResult = run.jobs.first();
+            result.backgroundReadMBps = jobResult.readMBps();
+            result.backgroundWriteMBps = jobResult.writeMBps();
+            result.backgroundIops = jobResult.readIops() + jobResult.writeIops();
+        }
+        if (!run.success && !m_canceled.loadRelaxed() && errorMessage.isEmpty()) {
+            errorMessage = QString("后台负载运行失败: %1").arg(run.errorMessage);
+            ok = false;
+        }
+    }
+
+    if (!existed && QFile::exists(m_filePath) && !QFile::remove(m_filePath)) {
+        qDebug() << "删除负载下延迟测试文件失败:" << m_filePath;
+    }
+
+    if (m_canceled.loadRelaxed()) {
+        result.canceled = true;
+        result.errorMessage = "测试已取消";
+    } else if (!ok || !errorMessage.isEmpty()) {
+        result.errorMessage = errorMessage.isEmpty() ? QString("测试失败") : errorMessage;
+    } else {
+        result.success = true;
+        qDebug() << "负载下延迟测试完成: 空闲p99" << result.idleLatency.percentileNs(99) << "ns, 负载下p99"
+                 << result.loadedLatency.percentileNs(99) << "ns, 膨胀" << result.inflation(99) << "倍, 后台"
+                 << result.backgroundReadMBps + result.backgroundWriteMBps << "MB/s";
+    }
+
+    emit testCompleted(result);
+}
+
+bool QosTester::runProbe(LatencyHistogram &latency, qint64 &lateProbes, int percentBase, int percentSpan,
+                         const QString &phase, QString &errorMessage) {
+    // 直接I/O，探测结果不受页缓存影响
+    IoFile file;
+    if (!file.open(m_filePath, IoFile::ReadOnly | IoFile::Direct)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    AlignedBuffer buffer(kProbeSize);
+
+    const qint64 blocks = m_options.fileSize / kProbeSize;
+    const qint64 intervalNs = 1000000000LL / m_options.probeIops;
+    const qint64 durationNs = m_options.probeSeconds * 1000000000LL;
+    QRandomGenerator random(static_cast<quint32>(QRandomGenerator::global()->generate()));
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 nextNs = 0;
+    qint64 lastReportNs = 0;
+    LatencyHistogram interval;
+
+    while (nextNs < durationNs && !m_canceled.loadRelaxed()) {
+        qint64 nowNs = timer.nsecsElapsed();
+        if (nowNs < nextNs) {
+            QThread::usleep(static_cast<unsigned long>((nextNs - nowNs) / 1000));
+            continue;
+        }
+        if (nowNs - nextNs > intervalNs) {
+            ++lateProbes;
+        }
+
+        // Qt 5的bounded()没有64位重载，大容量文件的块数可能超过32位
+        const qint64 offset = static_cast<qint64>(random.generate64() % static_cast<quint64>(blocks)) * kProbeSize;
+        if (file.readAt(buffer.data(), kProbeSize, offset) != kProbeSize) {
+            errorMessage = QString("探测读取失败，偏移 %1: %2").arg(offset).arg(file.errorString());
+            return false;
+        }
+        // 从计划发出时刻计时
+        const qint64 latencyNs = timer.nsecsElapsed() - nextNs;
+        latency.record(latencyNs);
+        interval.record(latencyNs);
+        nextNs += intervalNs;
+
+        if (timer.nsecsElapsed() - lastReportNs >= kProgressIntervalMs * 1000000LL) {
+            lastReportNs = timer.nsecsElapsed();
+            int percent = percentBase + static_cast<int>(qMin<qint64>(durationNs, nextNs) * percentSpan / durationNs);
+            emit progressUpdated(percent, phase, interval.percentileNs(99) / 1000.0);
+            interval.clear();
+        }
+    }
+    return true;
+}
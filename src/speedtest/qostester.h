@@ -0,0 +1,87 @@
+#ifndef QOSTESTER_H
+#define QOSTESTER_H
+
+#include <QObject>
+#include <QString>
+#include <QMetaType>
+#include <QAtomicInt>
+#include <QMutex>
+
+#include "fiojob.h"
+#include "latencyhistogram.h"
+
+class WorkloadEngine;
+
+// 负载下延迟测试参数
+struct QosTestOptions {
+    FioJob background;      // 后台吞吐负载，filename、运行时间等由测试设置
+    int probeIops;          // 前台探测每秒发出的4K随机读次数
+    int probeSeconds;       // 空闲和负载两个阶段各自的探测时长
+    qint64 fileSize;        // 测试文件大小，后台负载和前台探测共用
+
+    QosTestOptions() : probeIops(50), probeSeconds(20), fileSize(1024LL * 1024 * 1024) {}
+};
+
+// 负载下延迟测试结果
+struct QosResult {
+    bool success;
+    bool canceled;
+    QString errorMessage;
+    QosTestOptions options;
+    LatencyHistogram idleLatency;       // 没有后台负载时的探测延迟
+    LatencyHistogram loadedLatency;     // 后台负载运行期间的探测延迟
+    double backgroundReadMBps;          // 探测期间后台负载的吞吐量
+    double backgroundWriteMBps;
+    double backgroundIops;
+    qint64 lateProbes;                  // 因上一个探测未完成而推迟发出的次数
+
+    QosResult()
+        : success(false), canceled(false), backgroundReadMBps(0), backgroundWriteMBps(0), backgroundIops(0),
+          lateProbes(0) {}
+
+    // 延迟膨胀系数：负载下与空闲时同一百分位延迟之比
+    double inflation(double percentile) const {
+        qint64 idle = idleLatency.percentileNs(percentile);
+        return idle > 0 ? static_cast<double>(loadedLatency.percentileNs(percentile)) / idle : 0;
+    }
+};
+
+Q_DECLARE_METATYPE(QosResult)
+
+// 负载下延迟(QoS)测试
+// 业务感受到的是备份、压缩等后台任务把磁盘占满时的读延迟，而不是空闲时的延迟。
+// 先在空闲状态下以固定速率发出4K随机直接读得到基线，再用WorkloadEngine运行后台吞吐负载，
+// 等负载稳定后以同样速率探测，两组延迟百分位之比即延迟膨胀系数，
+// 可以按磁盘跟踪固件、I/O调度器等变化带来的影响。
+// 探测按固定时间表发出，延迟从计划发出时刻算起：上一个探测被阻塞时后续探测的排队时间也计入，
+// 避免只统计到"恰好没被阻塞"的请求。
+class QosTester : public QObject
+{
+    Q_OBJECT
+
+public:
+    QosTester(const QString &testDirectory, const QosTestOptions &options, QObject *parent = nullptr);
+
+    void cancel();
+
+public slots:
+    void startTest();
+
+signals:
+    void progressUpdated(int percent, const QString &phase, double probeLatencyUs);
+    void testCompleted(const QosResult &result);
+
+private:
+    // 按固定速率探测probeSeconds秒，percentBase/percentSpan用于进度显示
+    bool runProbe(LatencyHistogram &latency, qint64 &lateProbes, int percentBase, int percentSpan,
+                  const QString &phase, QString &errorMessage);
+
+    QString m_testDirectory;
+    QString m_filePath;
+    QosTestOptions m_options;
+    QAtomicInt m_canceled;
+    QMutex m_engineMutex;
+    WorkloadEngine *m_engine;
+};
+
+#endif // QOSTESTER_H
@@ -0,0 +1,164 @@
+#include "rawdevicetester.h"
+#include "iocore.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QDebug>
+
+namespace {
+// 每个区域占设备容量的比例
+const double kZoneFraction = 0.10;
+// 随机读取的块大小和每个区域的持续时间
+const int kRandomBlockSize = 4096;
+const qint64 kRandomDurationMs = 3000;
+// 顺序读取时最小的单次读取长度
+const int kMinSequentialBlock = 64 * 1024;
+}
+
+RawDeviceTester::RawDeviceTester(const QString &devicePath, int blockSizeKB, int readSizeMB, QObject *parent)
+    : QObject(parent), m_devicePath(devicePath), m_canceled(0) {
+    m_blockSize = static_cast<int>(IoFile::alignUp(qMax(blockSizeKB * 1024, kMinSequentialBlock)));
+    m_readBytesPerZone = static_cast<qint64>(readSizeMB) * 1024 * 1024;
+    qRegisterMetaType<ZoneResult>("ZoneResult");
+    qRegisterMetaType<RawDeviceResult>("RawDeviceResult");
+}
+
+void RawDeviceTester::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+void RawDeviceTester::startTest() {
+    RawDeviceResult result;
+
+    // 只读打开，此类不提供任何写入路径
+    IoFile device;
+    if (!device.open(m_devicePath, IoFile::ReadOnly | IoFile::Direct)) {
+        result.errorMessage = device.errorString() + "\n读取物理磁盘需要管理员/root权限";
+        emit testCompleted(result);
+        return;
+    }
+
+    result.directIo = device.isDirect();
+    result.deviceSize = device.size();
+    if (!result.directIo) {
+        qDebug() << "原始设备未能以直接I/O打开，结果可能受系统缓存影响:" << m_devicePath;
+    }
+
+    // 区域太小时无法分出外/中/内三段
+    qint64 zoneLength = IoFile::alignDown(static_cast<qint64>(result.deviceSize * kZoneFraction));
+    if (result.deviceSize <= 0 || zoneLength < kRandomBlockSize * 16) {
+        result.errorMessage = QString("无法获取设备容量或设备过小: %1").arg(m_devicePath);
+        emit testCompleted(result);
+        return;
+    }
+
+    qDebug() << "原始设备测速开始:" << m_devicePath << "容量" << result.deviceSize << "区域长度" << zoneLength;
+
+    struct ZoneDef { const char *name; double position; };
+    const ZoneDef zoneDefs[] = {
+        { "外圈 (起始LBA)", 0.0 },
+        { "中圈", 0.45 },
+        { "内圈 (末尾LBA)", 1.0 - kZoneFraction }
+    };
+    const int zoneCount = sizeof(zoneDefs) / sizeof(zoneDefs[0]);
+
+    QString error;
+    for (int i = 0; i < zoneCount && !m_canceled.loadRelaxed(); ++i) {
+        ZoneResult zone;
+        zone.zoneName = zoneDefs[i].name;
+        zone.startOffset = IoFile::alignDown(static_cast<qint64>(result.deviceSize * zoneDefs[i].position));
+        zone.length = qMin(zoneLength, IoFile::alignDown(result.deviceSize - zone.startOffset));
+
+        emit progressUpdated(i * 100 / zoneCount, QString("正在顺序读取%1...").arg(zone.zoneName));
+        if (!runSequentialRead(device, zone, error)) {
+            break;
+        }
+
+        emit progressUpdated((i * 2 + 1) * 100 / (zoneCount * 2), QString("正在随机读取%1...").arg(zone.zoneName));
+        if (!runRandomRead(device, zone, error)) {
+            break;
+        }
+
+        qDebug() << "区域" << zone.zoneName << "顺序读" << zone.seqReadSpeed << "MB/s, 随机4K"
+                 << zone.randomReadIops << "IOPS, 延迟" << zone.avgLatencyMs << "ms";
+
+        result.zones.append(zone);
+        emit zoneCompleted(zone);
+    }
+
+    device.close();
+
+    if (m_canceled.loadRelaxed()) {
+        result.errorMessage = "测试已取消";
+    } else if (!error.isEmpty()) {
+        result.errorMessage = error;
+    } else {
+        result.success = true;
+    }
+
+    emit testCompleted(result);
+}
+
+bool RawDeviceTester::runSequentialRead(IoFile &device, ZoneResult &zone, QString &error) {
+    AlignedBuffer buffer(m_blockSize);
+    if (!buffer.data()) {
+        error = "分配读取缓冲区失败";
+        return false;
+    }
+
+    const qint64 total = IoFile::alignDown(qMin(m_readBytesPerZone, zone.length));
+    qint64 done = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (done < total && !m_canceled.loadRelaxed()) {
+        qint64 length = qMin<qint64>(m_blockSize, total - done);
+        qint64 read = device.readAt(buffer.data(), length, zone.startOffset + done);
+        if (read <= 0) {
+            error = read < 0 ? device.errorString() : QString("读取到设备末尾");
+            return false;
+        }
+        done += read;
+    }
+
+    qint64 elapsedNs = timer.nsecsElapsed();
+    if (elapsedNs > 0) {
+        zone.seqReadSpeed = (done / (1024.0 * 1024.0)) / (elapsedNs / 1e9);
+    }
+    return true;
+}
+
+bool RawDeviceTester::runRandomRead(IoFile &device, ZoneResult &zone, QString &error) {
+    AlignedBuffer buffer(kRandomBlockSize);
+    if (!buffer.data()) {
+        error = "分配读取缓冲区失败";
+        return false;
+    }
+
+    const qint64 blockCount = zone.length / kRandomBlockSize;
+    QRandomGenerator random(static_cast<quint32>(zone.startOffset / kRandomBlockSize + 1));
+
+    qint64 operations = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < kRandomDurationMs && !m_canceled.loadRelaxed()) {
+        // Qt 5的bounded()没有64位重载，整盘区域的块数可能超过32位
+        qint64 offset = zone.startOffset + static_cast<qint64>(random.generate64() % static_cast<quint64>(blockCount)) * kRandomBlockSize;
+        qint64 read = device.readAt(buffer.data(), kRandomBlockSize, offset);
+        if (read != kRandomBlockSize) {
+            error = read < 0 ? device.errorString() : QString("随机读取不完整");
+            return false;
+        }
+        ++operations;
+    }
+
+    double elapsedSec = timer.nsecsElapsed() / 1e9;
+    if (operations > 0 && elapsedSec > 0) {
+        zone.randomReadIops = operations / elapsedSec;
+        zone.randomReadSpeed = zone.randomReadIops * kRandomBlockSize / (1024.0 * 1024.0);
+        zone.avgLatencyMs = elapsedSec * 1000.0 / operations;
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef RAWDEVICETESTER_H
+#define RAWDEVICETESTER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMetaType>
+#include <QAtomicInt>
+
+class IoFile;
+
+// 单个区域（外圈/中圈/内圈）的测速结果
+struct ZoneResult {
+    QString zoneName;       // 区域名称
+    qint64 startOffset;     // 区域起始偏移（字节）
+    qint64 length;          // 区域长度（字节）
+    double seqReadSpeed;    // 顺序读取速度(MB/s)
+    double randomReadIops;  // 随机4K读取IOPS
+    double randomReadSpeed; // 随机4K读取速度(MB/s)
+    double avgLatencyMs;    // 随机读取平均延迟(毫秒)
+
+    ZoneResult()
+        : startOffset(0), length(0), seqReadSpeed(0), randomReadIops(0),
+          randomReadSpeed(0), avgLatencyMs(0) {}
+};
+
+struct RawDeviceResult {
+    bool success;
+    bool directIo;          // 是否绕过了系统缓存
+    qint64 deviceSize;      // 设备容量
+    QString errorMessage;
+    QList<ZoneResult> zones;
+
+    RawDeviceResult() : success(false), directIo(false), deviceSize(0) {}
+};
+
+Q_DECLARE_METATYPE(ZoneResult)
+Q_DECLARE_METATYPE(RawDeviceResult)
+
+// 原始块设备只读测速
+// 直接打开物理磁盘（/dev/sdX、/dev/nvmeXnY 或 \\.\PhysicalDriveN），不经过文件系统，
+// 在外圈、中圈、内圈分别做顺序读和随机4K读，用于观察机械硬盘的分区速度衰减。
+// 设备只以只读方式打开，整个测试过程中不会发出任何写操作。
+class RawDeviceTester : public QObject
+{
+    Q_OBJECT
+
+public:
+    RawDeviceTester(const QString &devicePath, int blockSizeKB, int readSizeMB, QObject *parent = nullptr);
+
+    void cancel();
+
+public slots:
+    void startTest();
+
+signals:
+    void progressUpdated(int percent, const QString &status);
+    void zoneCompleted(const ZoneResult &zone);
+    void testCompleted(const RawDeviceResult &result);
+
+private:
+    bool runSequentialRead(IoFile &device, ZoneResult &zone, QString &error);
+    bool runRandomRead(IoFile &device, ZoneResult &zone, QString &error);
+
+    QString m_devicePath;
+    int m_blockSize;
+    qint64 m_readBytesPerZone;
+    QAtomicInt m_canceled;
+};
+
+#endif // RAWDEVICETESTER_H
@@ -0,0 +1,419 @@
+#include "resultstore.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QJsonDocument>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QDir>
+#include <QDebug>
+
+namespace {
+// 表结构有变化时递增，保存在PRAGMA user_version中
+const int kSchemaVersion = 1;
+
+// 负数表示不适用，存为NULL
+QVariant optionalValue(double value) {
+    return value < 0 ? QVariant() : QVariant(value);
+}
+
+double optionalDouble(const QVariant &value) {
+    return value.isNull() ? -1 : value.toDouble();
+}
+
+// 直方图按稀疏格式保存：非零桶的(序号, 计数)
+QByteArray encodeHistogram(const LatencyHistogram &histogram) {
+    const QVector<quint64> &buckets = histogram.buckets();
+    quint32 used = 0;
+    for (quint64 count : buckets) {
+        if (count) {
+            ++used;
+        }
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << quint32(buckets.size()) << used;
+    for (int i = 0; i < buckets.size(); ++i) {
+        if (buckets[i]) {
+            out << quint32(i) << buckets[i];
+        }
+    }
+    return data;
+}
+
+bool decodeHistogram(const QByteArray &data, LatencyHistogram &histogram) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_15);
+    quint32 bucketCount = 0;
+    quint32 used = 0;
+    in >> bucketCount >> used;
+    if (in.status() != QDataStream::Ok || static_cast<int>(bucketCount) != LatencyHistogram::bucketCount()) {
+        return false;
+    }
+
+    QVector<quint64> buckets(LatencyHistogram::bucketCount(), 0);
+    for (quint32 i = 0; i < used; ++i) {
+        quint32 index = 0;
+        quint64 count = 0;
+        in >> index >> count;
+        if (in.status() != QDataStream::Ok || index >= bucketCount) {
+            return false;
+        }
+        buckets[index] = count;
+    }
+    return histogram.setBuckets(buckets);
+}
+
+QByteArray encodeSeries(const QList<WorkloadSample> &samples) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << quint32(samples.size());
+    for (const WorkloadSample &sample : samples) {
+        out << sample.elapsedSec << sample.readMBps << sample.writeMBps << sample.iops;
+    }
+    return data;
+}
+
+bool decodeSeries(const QByteArray &data, QList<WorkloadSample> &samples) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_15);
+    quint32 count = 0;
+    in >> count;
+    samples.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        WorkloadSample sample;
+        in >> sample.elapsedSec >> sample.readMBps >> sample.writeMBps >> sample.iops;
+        samples.append(sample);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool openConnection(const QString &connectionName, const QString &databasePath, QString &errorMessage) {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(databasePath);
+    if (!db.open()) {
+        errorMessage = QString("无法打开结果数据库 %1: %2").arg(databasePath).arg(db.lastError().text());
+        return false;
+    }
+
+    // WAL模式下后台写入不会阻塞界面线程的查询；NORMAL同步级别在WAL下不会损坏数据库
+    QSqlQuery query(db);
+    query.exec("PRAGMA journal_mode=WAL");
+    query.exec("PRAGMA synchronous=NORMAL");
+    query.exec("PRAGMA busy_timeout=5000");
+    query.exec("PRAGMA foreign_keys=ON");
+    return ResultStore::createSchema(connectionName, errorMessage);
+}
+
+void closeConnection(const QString &connectionName) {
+    if (!QSqlDatabase::contains(connectionName)) {
+        return;
+    }
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+}
+
+ResultStoreWriter::ResultStoreWriter(const QString &databasePath, QObject *parent)
+    : QObject(parent), m_databasePath(databasePath), m_open(false) {
+    m_connectionName = QString("resultstore_writer_%1").arg(reinterpret_cast<quintptr>(this));
+}
+
+bool ResultStoreWriter::ensureOpen(QString &errorMessage) {
+    if (m_open) {
+        return true;
+    }
+    // 连接在写线程上创建，之后只在该线程使用
+    m_open = openConnection(m_connectionName, m_databasePath, errorMessage);
+    if (!m_open) {
+        closeConnection(m_connectionName);
+    }
+    return m_open;
+}
+
+void ResultStoreWriter::write(const SpeedTestRecord &record) {
+    QString error;
+    if (!ensureOpen(error)) {
+        qDebug() << "保存测试结果失败:" << error;
+        emit failed(error);
+        return;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+    db.transaction();
+
+    QSqlQuery query(db);
+    query.prepare("INSERT INTO runs (timestamp, disk_serial, disk_model, firmware, disk_name, test_type, label, "
+                  "block_size, file_size, read_mbps, write_mbps, read_iops, write_iops, read_p99_us, write_p99_us, parameters) "
+                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    query.addBindValue(record.timestamp.toMSecsSinceEpoch());
+    query.addBindValue(record.diskSerial.trimmed());
+    query.addBindValue(record.diskModel);
+    query.addBindValue(record.firmware);
+    query.addBindValue(record.diskName);
+    query.addBindValue(record.testType);
+    query.addBindValue(record.label);
+    query.addBindValue(record.blockSize);
+    query.addBindValue(record.fileSize);
+    query.addBindValue(optionalValue(record.readMBps));
+    query.addBindValue(optionalValue(record.writeMBps));
+    query.addBindValue(optionalValue(record.readIops));
+    query.addBindValue(optionalValue(record.writeIops));
+    query.addBindValue(optionalValue(record.readP99Us));
+    query.addBindValue(optionalValue(record.writeP99Us));
+    query.addBindValue(QString::fromUtf8(QJsonDocument(record.parameters).toJson(QJsonDocument::Compact)));
+
+    bool ok = query.exec();
+    QString sqlError = ok ? QString() : query.lastError().text();
+    qint64 runId = ok ? query.lastInsertId().toLongLong() : -1;
+
+    // 直方图和时间序列放在单独的表里，历史列表查询不会读到这些大字段
+    if (ok) {
+        QSqlQuery histogramQuery(db);
+        histogramQuery.prepare("INSERT INTO histograms (run_id, direction, buckets) VALUES (?, ?, ?)");
+        const LatencyHistogram *histograms[] = {&record.readLatency, &record.writeLatency, &record.syncLatency};
+        const char *directions[] = {"read", "write", "sync"};
+        for (int i = 0; i < 3 && ok; ++i) {
+            if (histograms[i]->count() == 0) {
+                continue;
+            }
+            histogramQuery.addBindValue(runId);
+            histogramQuery.addBindValue(QString(directions[i]));
+            histogramQuery.addBindValue(encodeHistogram(*histograms[i]));
+            ok = histogramQuery.exec();
+            if (!ok) {
+                sqlError = histogramQuery.lastError().text();
+            }
+        }
+    }
+    if (ok && !record.series.isEmpty()) {
+        QSqlQuery seriesQuery(db);
+        seriesQuery.prepare("INSERT INTO series (run_id, samples) VALUES (?, ?)");
+        seriesQuery.addBindValue(runId);
+        seriesQuery.addBindValue(encodeSeries(record.series));
+        ok = seriesQuery.exec();
+        if (!ok) {
+            sqlError = seriesQuery.lastError().text();
+        }
+    }
+
+    if (!ok || !db.commit()) {
+        error = QString("保存测试结果失败: %1").arg(ok ? db.lastError().text() : sqlError);
+        db.rollback();
+        qDebug() << error;
+        emit failed(error);
+        return;
+    }
+
+    SpeedTestRecord saved = record;
+    saved.id = runId;
+    qDebug() << "测试结果已保存到数据库, id:" << runId << "类型:" << record.testType << "磁盘:" << record.diskSerial;
+    emit written(saved);
+}
+
+void ResultStoreWriter::close() {
+    if (m_open) {
+        closeConnection(m_connectionName);
+        m_open = false;
+    }
+}
+
+ResultStore::ResultStore(const QString &databasePath, QObject *parent)
+    : QObject(parent), m_databasePath(databasePath) {
+    qRegisterMetaType<SpeedTestRecord>("SpeedTestRecord");
+
+    if (m_databasePath.isEmpty()) {
+        QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(dir);
+        m_databasePath = QDir(dir).filePath("speedtest_results.db");
+    }
+    m_readerConnection = QString("resultstore_reader_%1").arg(reinterpret_cast<quintptr>(this));
+
+    m_writerThread = new QThread(this);
+    m_writer = new ResultStoreWriter(m_databasePath);
+    m_writer->moveToThread(m_writerThread);
+    connect(m_writer, &ResultStoreWriter::written, this, &ResultStore::recordSaved);
+    connect(m_writer, &ResultStoreWriter::failed, this, &ResultStore::saveFailed);
+    m_writerThread->start();
+
+    // 读连接负责首次建表，这样还没有任何写入时查询也不会失败
+    openReader();
+}
+
+ResultStore::~ResultStore() {
+    // 排队中的写入先全部完成，再关闭写连接
+    QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection);
+    m_writerThread->quit();
+    m_writerThread->wait();
+    delete m_writer;
+
+    closeConnection(m_readerConnection);
+}
+
+void ResultStore::submit(const SpeedTestRecord &record) {
+    QMetaObject::invokeMethod(m_writer, "write", Qt::QueuedConnection, Q_ARG(SpeedTestRecord, record));
+}
+
+bool ResultStore::openReader() const {
+    if (QSqlDatabase::contains(m_readerConnection)) {
+        return QSqlDatabase::database(m_readerConnection).isOpen();
+    }
+
+    QString error;
+    if (!openConnection(m_readerConnection, m_databasePath, error)) {
+        qDebug() << error;
+        return false;
+    }
+    return true;
+}
+
+bool ResultStore::createSchema(const QString &connectionName, QString &errorMessage) {
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    QSqlQuery query(db);
+
+    query.exec("PRAGMA user_version");
+    int version = query.next() ? query.value(0).toInt() : 0;
+    if (version >= kSchemaVersion) {
+        return true;
+    }
+
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS runs ("
+        "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "  timestamp INTEGER NOT NULL,"          // 毫秒时间戳
+        "  disk_serial TEXT NOT NULL DEFAULT '',"
+        "  disk_model TEXT,"
+        "  firmware TEXT,"
+        "  disk_name TEXT,"
+        "  test_type TEXT NOT NULL,"
+        "  label TEXT,"
+        "  block_size INTEGER,"
+        "  file_size INTEGER,"
+        "  read_mbps REAL,"
+        "  write_mbps REAL,"
+        "  read_iops REAL,"
+        "  write_iops REAL,"
+        "  read_p99_us REAL,"
+        "  write_p99_us REAL,"
+        "  parameters TEXT)",
+        "CREATE INDEX IF NOT EXISTS idx_runs_serial_time ON runs (disk_serial, timestamp)",
+        "CREATE INDEX IF NOT EXISTS idx_runs_time ON runs (timestamp)",
+        "CREATE TABLE IF NOT EXISTS histograms ("
+        "  run_id INTEGER NOT NULL REFERENCES runs (id) ON DELETE CASCADE,"
+        "  direction TEXT NOT NULL,"
+        "  buckets BLOB NOT NULL,"
+        "  PRIMARY KEY (run_id, direction))",
+        "CREATE TABLE IF NOT EXISTS series ("
+        "  run_id INTEGER PRIMARY KEY REFERENCES runs (id) ON DELETE CASCADE,"
+        "  samples BLOB NOT NULL)",
+        QString("PRAGMA user_version = %1").arg(kSchemaVersion)
+    };
+
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            errorMessage = QString("创建结果数据库表失败: %1").arg(query.lastError().text());
+            return false;
+        }
+    }
+    return true;
+}
+
+QList<SpeedTestRecord> ResultStore::queryRuns(const QString &diskSerial, const QDateTime &since, int limit) const {
+    QList<SpeedTestRecord> records;
+    if (!openReader()) {
+        return records;
+    }
+
+    // 只取摘要列；按序列号过滤时走(disk_serial, timestamp)索引，不需要排序
+    QString sql = "SELECT id, timestamp, disk_serial, disk_model, firmware, disk_name, test_type, label, block_size, "
+                  "file_size, read_mbps, write_mbps, read_iops, write_iops, read_p99_us, write_p99_us, parameters "
+                  "FROM runs WHERE timestamp >= ?";
+    if (!diskSerial.isEmpty()) {
+        sql += " AND disk_serial = ?";
+    }
+    sql += " ORDER BY timestamp DESC LIMIT ?";
+
+    QSqlQuery query(QSqlDatabase::database(m_readerConnection));
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.addBindValue(since.isValid() ? since.toMSecsSinceEpoch() : 0);
+    if (!diskSerial.isEmpty()) {
+        query.addBindValue(diskSerial.trimmed());
+    }
+    query.addBindValue(limit > 0 ? limit : -1);
+
+    if (!query.exec()) {
+        qDebug() << "查询测试历史失败:" << query.lastError().text();
+        return records;
+    }
+
+    while (query.next()) {
+        SpeedTestRecord record;
+        record.id = query.value(0).toLongLong();
+        record.timestamp = QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong());
+        record.diskSerial = query.value(2).toString();
+        record.diskModel = query.value(3).toString();
+        record.firmware = query.value(4).toString();
+        record.diskName = query.value(5).toString();
+        record.testType = query.value(6).toString();
+        record.label = query.value(7).toString();
+        record.blockSize = query.value(8).toLongLong();
+        record.fileSize = query.value(9).toLongLong();
+        record.readMBps = optionalDouble(query.value(10));
+        record.writeMBps = optionalDouble(query.value(11));
+        record.readIops = optionalDouble(query.value(12));
+        record.writeIops = optionalDouble(query.value(13));
+        record.readP99Us = optionalDouble(query.value(14));
+        record.writeP99Us = optionalDouble(query.value(15));
+        record.parameters = QJsonDocument::fromJson(query.value(16).toString().toUtf8()).object();
+        records.append(record);
+    }
+    return records;
+}
+
+bool ResultStore::loadDetails(SpeedTestRecord &record) const {
+    if (record.id < 0 || !openReader()) {
+        return false;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(m_readerConnection);
+    QSqlQuery query(db);
+    query.prepare("SELECT direction, buckets FROM histograms WHERE run_id = ?");
+    query.addBindValue(record.id);
+    if (!query.exec()) {
+        qDebug() << "加载延迟直方图失败:" << query.lastError().text();
+        return false;
+    }
+
+    record.readLatency.clear();
+    record.writeLatency.clear();
+    record.syncLatency.clear();
+    while (query.next()) {
+        const QString direction = query.value(0).toString();
+        LatencyHistogram &histogram = direction == "read" ? record.readLatency
+                                    : direction == "sync" ? record.syncLatency : record.writeLatency;
+        if (!decodeHistogram(query.value(1).toByteArray(), histogram)) {
+            qDebug() << "延迟直方图数据无效, id:" << record.id;
+        }
+    }
+
+    query.prepare("SELECT samples FROM series WHERE run_id = ?");
+    query.addBindValue(record.id);
+    if (!query.exec()) {
+        qDebug() << "加载吞吐量时间序列失败:" << query.lastError().text();
+        return false;
+    }
+    record.series.clear();
+    if (query.next() && !decodeSeries(query.value(0).toByteArray(), record.series)) {
+        qDebug() << "吞吐量时间序列数据无效, id:" << record.id;
+    }
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef RESULTSTORE_H
+#define RESULTSTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QThread>
+
+#include "latencyhistogram.h"
+#include "workloadengine.h"
+
+// 一次速度测试的持久化记录
+struct SpeedTestRecord {
+    qint64 id;                  // 数据库主键，未保存时为-1
+    QDateTime timestamp;        // 测试开始时间
+    QString diskSerial;
+    QString diskModel;
+    QString firmware;
+    QString diskName;
+    QString testType;           // standard / benchmark / sustained / raw / fio
+    QString label;              // 附加说明，如fio作业名、重复次数
+    qint64 blockSize;           // 字节
+    qint64 fileSize;            // 字节，持续写入为实际写入量
+    double readMBps;            // 不适用时为-1
+    double writeMBps;
+    double readIops;            // 不适用时为-1
+    double writeIops;
+    double readP99Us;           // 99%延迟（微秒），没有延迟统计时为-1
+    double writeP99Us;
+    QJsonObject parameters;     // 测试参数和模式相关的附加结果
+
+    // 以下明细只在loadDetails后才有
+    LatencyHistogram readLatency;
+    LatencyHistogram writeLatency;
+    LatencyHistogram syncLatency; // 写入测试中fsync/fdatasync的耗时
+    QList<WorkloadSample> series; // 吞吐量时间序列
+
+    SpeedTestRecord()
+        : id(-1), blockSize(0), fileSize(0), readMBps(-1), writeMBps(-1), readIops(-1), writeIops(-1),
+          readP99Us(-1), writeP99Us(-1) {}
+};
+
+Q_DECLARE_METATYPE(SpeedTestRecord)
+
+// 后台写线程上的数据库连接，只由ResultStore使用
+class ResultStoreWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResultStoreWriter(const QString &databasePath, QObject *parent = nullptr);
+
+public slots:
+    void write(const SpeedTestRecord &record);
+    void close();
+
+signals:
+    void written(const SpeedTestRecord &record);
+    void failed(const QString &message);
+
+private:
+    bool ensureOpen(QString &errorMessage);
+
+    QString m_databasePath;
+    QString m_connectionName;
+    bool m_open;
+};
+
+// 速度测试结果库（SQLite）
+// 每次测试保存磁盘序列号、固件、测试参数、完整延迟直方图和吞吐量时间序列。
+// 写入通过后台线程上的独立连接排队执行（WAL模式，不阻塞界面和读取），
+// 查询使用创建者线程上的只读连接；runs表按(disk_serial, timestamp)建索引，
+// 历史列表只取摘要列，直方图和时间序列在需要时再用loadDetails加载。
+class ResultStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    // databasePath为空时使用应用数据目录下的speedtest_results.db
+    explicit ResultStore(const QString &databasePath = QString(), QObject *parent = nullptr);
+    ~ResultStore();
+
+    QString databasePath() const { return m_databasePath; }
+
+    // 异步保存，完成后发出recordSaved（带数据库id）
+    void submit(const SpeedTestRecord &record);
+
+    // 按时间倒序查询摘要；diskSerial为空时查询所有磁盘，since无效时不限开始时间
+    QList<SpeedTestRecord> queryRuns(const QString &diskSerial = QString(), const QDateTime &since = QDateTime(),
+                                     int limit = 500) const;
+
+    // 加载直方图和时间序列明细
+    bool loadDetails(SpeedTestRecord &record) const;
+
+    // 建表和索引，读写两个连接共用
+    static bool createSchema(const QString &connectionName, QString &errorMessage);
+
+signals:
+    void recordSaved(const SpeedTestRecord &record);
+    void saveFailed(const QString &message);
+
+private:
+    bool openReader() const;
+
+    QString m_databasePath;
+    QString m_readerConnection;
+    QThread *m_writerThread;
+    ResultStoreWriter *m_writer;
+};
+
+#endif // RESULTSTORE_H
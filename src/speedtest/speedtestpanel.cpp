@@ -0,0 +1,32 @@
+#include "speedtestpanel.h"
+
+SpeedTestPanel::SpeedTestPanel(const QString &title, QWidget *parent)
+    : QGroupBox(title, parent), m_thread(nullptr) {
+}
+
+SpeedTestPanel::~SpeedTestPanel() {
+    if (m_thread) {
+        cancel();
+        m_thread->quit();
+        m_thread->wait();
+    }
+}
+
+void SpeedTestPanel::cancel() {
+    if (m_cancelWorker) {
+        m_cancelWorker();
+    }
+}
+
+SpeedTestRecord SpeedTestPanel::newRecord(const QString &testType) const {
+    SpeedTestRecord record;
+    record.timestamp = m_parameters.startTime.isValid() ? m_parameters.startTime : QDateTime::currentDateTime();
+    record.diskSerial = m_parameters.disk.serialNumber.trimmed();
+    record.diskModel = m_parameters.disk.model;
+    record.firmware = m_parameters.disk.firmwareVersion;
+    record.diskName = m_parameters.disk.diskName;
+    record.testType = testType;
+    record.blockSize = m_parameters.blockSize;
+    record.fileSize = m_parameters.fileSize;
+    return record;
+}
@@ -0,0 +1,83 @@
+#ifndef SPEEDTESTPANEL_H
+#define SPEEDTESTPANEL_H
+
+#include <QGroupBox>
+#include <QThread>
+#include <QDateTime>
+#include <functional>
+
+#include "../core/diskutils.h"
+#include "resultstore.h"
+
+// 开始测试时由SpeedTestWidget传给模式面板的公共参数
+struct SpeedTestParameters {
+    DiskInfo disk;              // 所选磁盘
+    QString testDirectory;      // 所选磁盘上的测试目录
+    qint64 blockSize;           // 设置中的块大小（字节）
+    qint64 fileSize;            // 设置中的文件大小（字节）
+    int targetAmount;           // 写入总量
+    bool targetIsPercent;       // 写入总量是否按可用空间百分比计算
+    QDateTime startTime;        // 历史记录使用测试开始的时间
+
+    SpeedTestParameters() : blockSize(0), fileSize(0), targetAmount(0), targetIsPercent(true) {}
+};
+
+// 速度测试中单个测试模式的面板
+// 面板持有本模式的选项和结果视图，在独立线程上运行自己的测试对象；
+// 进度、状态和结果记录通过信号交给SpeedTestWidget，由它统一显示和保存。
+class SpeedTestPanel : public QGroupBox
+{
+    Q_OBJECT
+
+public:
+    explicit SpeedTestPanel(const QString &title, QWidget *parent = nullptr);
+    ~SpeedTestPanel();
+
+    // 参数不合适时提示用户并返回false
+    virtual bool start(const SpeedTestParameters &parameters) = 0;
+    // 测试运行期间禁用本模式的选项
+    virtual void setOptionsEnabled(bool enabled) = 0;
+
+    void cancel();
+    bool isRunning() const { return m_thread != nullptr; }
+
+signals:
+    void progressChanged(int percent);
+    void statusChanged(const QString &status);
+    // 结果区显示的读写速度，小于0的一项不更新
+    void speedsMeasured(double readMBps, double writeMBps);
+    void recordReady(const SpeedTestRecord &record);
+    void testFinished();
+
+protected:
+    // 按本次测试的磁盘和参数预填一条测试记录
+    SpeedTestRecord newRecord(const QString &testType) const;
+
+    // 把测试对象移到独立线程运行，completed发出后线程退出并释放测试对象
+    template <typename Worker, typename Completed>
+    void runWorker(Worker *worker, void (Worker::*startSlot)(), Completed completed) {
+        m_thread = new QThread(this);
+        worker->moveToThread(m_thread);
+        m_cancelWorker = [worker]() { worker->cancel(); };
+
+        connect(m_thread, &QThread::started, worker, startSlot);
+        connect(worker, completed, m_thread, &QThread::quit);
+        connect(m_thread, &QThread::finished, this, [this, worker]() {
+            worker->deleteLater();
+            m_cancelWorker = nullptr;
+            m_thread->deleteLater();
+            m_thread = nullptr;
+            emit testFinished();
+        });
+
+        m_thread->start();
+    }
+
+    SpeedTestParameters m_parameters;
+
+private:
+    QThread *m_thread;
+    std::function<void()> m_cancelWorker;
+};
+
+#endif // SPEEDTESTPANEL_H
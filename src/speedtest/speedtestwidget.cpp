@@ -1,5 +1,8 @@
 #include "speedtestwidget.h"
+#include "patterngenerator.h"
+#include "iocore.h"
 #include "../core/diskutils.h"
+#include "../core/diskinventory.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -23,6 +26,8 @@
 #include <QDebug>
 #include <QTimer>
 #include <QRandomGenerator>
+#include <QDir>
+#include <QJsonArray>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
@@ -42,24 +47,28 @@ class SpeedTester : public QObject {
     Q_OBJECT
     
 public:
-    SpeedTester(const QString& diskPath, const QString& testFilePath, int blockSizeKB, int fileSizeMB)
+    SpeedTester(const QString& diskPath, const QString& testFilePath, int blockSizeKB, int fileSizeMB,
+                FioJob::Durability durability, qint64 syncIntervalBytes)
         : m_diskPath(diskPath), m_testFilePath(testFilePath), 
-          m_blockSizeKB(blockSizeKB), m_fileSizeMB(fileSizeMB), m_canceled(false) {}
+          m_blockSizeKB(blockSizeKB), m_fileSizeMB(fileSizeMB), m_durability(durability),
+          m_syncIntervalBytes(syncIntervalBytes), m_canceled(false) {
+        qRegisterMetaType<LatencyHistogram>("LatencyHistogram");
+    }
     
     void startTest() {
         double readSpeed = performReadTest();
         if (m_canceled) {
-            emit testCompleted(0, 0);
+            emit testCompleted(0, 0, LatencyHistogram());
             return;
         }
         
         double writeSpeed = performWriteTest();
         if (m_canceled) {
-            emit testCompleted(0, 0);
+            emit testCompleted(0, 0, LatencyHistogram());
             return;
         }
         
-        emit testCompleted(readSpeed, writeSpeed);
+        emit testCompleted(readSpeed, writeSpeed, m_syncLatency);
     }
     
     void cancel() {
@@ -68,7 +77,7 @@ public:
     
 signals:
     void progressUpdated(int percent, double currentSpeed, bool isRead);
-    void testCompleted(double readSpeed, double writeSpeed);
+    void testCompleted(double readSpeed, double writeSpeed, const LatencyHistogram &syncLatency);
     
 private:
     double performReadTest() {
@@ -120,34 +129,59 @@ private:
     }
     
     double performWriteTest() {
-        QFile file(m_testFilePath);
-        if (!file.open(QIODevice::WriteOnly)) {
-            qDebug() << "无法打开测试文件进行写测试";
+        // 通过IoFile写入，才能按所选方式执行fdatasync或以O_DSYNC打开
+        int flags = IoFile::WriteOnly | IoFile::Create | IoFile::Truncate;
+        if (m_durability == FioJob::DsyncWrites) {
+            flags |= IoFile::Dsync;
+        }
+        IoFile file;
+        if (!file.open(m_testFilePath, flags)) {
+            qDebug() << "无法打开测试文件进行写测试:" << file.errorString();
             return 0;
         }
         
-        const int totalBytes = m_fileSizeMB * 1024 * 1024;
+        const qint64 totalBytes = static_cast<qint64>(m_fileSizeMB) * 1024 * 1024;
         const int blockSize = m_blockSizeKB * 1024;
+        const qint64 syncInterval = m_durability == FioJob::PeriodicSync ? qMax<qint64>(blockSize, m_syncIntervalBytes) : 0;
         char* buffer = new char[blockSize];
         
-        for (int i = 0; i < blockSize; i++) {
-            buffer[i] = static_cast<char>(QRandomGenerator::global()->bounded(256));
-        }
+        // 计时前生成不可压缩数据；循环内每次写入前只给每个4K块打唯一标记，
+        // 避免同一块数据反复写入被主控压缩或去重
+        PatternGenerator pattern(QRandomGenerator::global()->generate64());
+        pattern.fill(buffer, blockSize);
+        quint64 sequence = 0;
         
         QElapsedTimer timer;
         timer.start();
         
         qint64 bytesWritten = 0;
+        qint64 bytesSinceSync = 0;
         int lastPercent = 0;
+        bool ok = true;
         
         while (bytesWritten < totalBytes && !m_canceled) {
-            qint64 written = file.write(buffer, blockSize);
+            pattern.refresh(buffer, blockSize, sequence++);
+            qint64 writeStartNs = timer.nsecsElapsed();
+            qint64 written = file.writeAt(buffer, blockSize, bytesWritten);
             if (written <= 0) {
-                qDebug() << "写入失败";
+                qDebug() << "写入失败:" << file.errorString();
+                ok = false;
                 break;
             }
+            // O_DSYNC下每次写入都等数据落盘，写入耗时就是刷盘延迟
+            if (m_durability == FioJob::DsyncWrites) {
+                m_syncLatency.record(timer.nsecsElapsed() - writeStartNs);
+            }
             
             bytesWritten += written;
+            bytesSinceSync += written;
+            if (syncInterval > 0 && bytesSinceSync >= syncInterval) {
+                bytesSinceSync = 0;
+                if (!timedSync(file, true, timer)) {
+                    ok = false;
+                    break;
+                }
+            }
             
             int percent = static_cast<int>((bytesWritten * 100) / totalBytes);
             if (percent > lastPercent) {
@@ -158,37 +192,71 @@ private:
             }
         }
         
+        // 结束时的同步计入总耗时，否则得到的只是写进系统缓存的速度
+        bool finalSync = m_durability == FioJob::PeriodicSync || m_durability == FioJob::FinalSync;
+        if (ok && finalSync && !m_canceled) {
+            ok = timedSync(file, false, timer);
+        }
+        double elapsedSec = timer.nsecsElapsed() / 1e9;
+        
         file.close();
-        file.remove();
+        QFile::remove(m_testFilePath);
         delete[] buffer;
         
-        if (m_canceled) {
+        if (m_canceled || !ok || elapsedSec <= 0) {
             return 0;
         }
         
-        double elapsedSec = timer.elapsed() / 1000.0;
-        double mbPerSec = (totalBytes / (1024.0 * 1024.0)) / elapsedSec;
+        double mbPerSec = (bytesWritten / (1024.0 * 1024.0)) / elapsedSec;
         
         return mbPerSec;
     }
     
+    bool timedSync(IoFile &file, bool dataOnly, const QElapsedTimer &timer) {
+        qint64 startNs = timer.nsecsElapsed();
+        if (!(dataOnly ? file.dataSync() : file.sync())) {
+            qDebug() << "刷新写入数据失败:" << file.errorString();
+            return false;
+        }
+        m_syncLatency.record(timer.nsecsElapsed() - startNs);
+        return true;
+    }
+    
     QString m_diskPath;
     QString m_testFilePath;
     int m_blockSizeKB;
     int m_fileSizeMB;
+    FioJob::Durability m_durability;
+    qint64 m_syncIntervalBytes;
+    LatencyHistogram m_syncLatency;     // 刷盘耗时：fsync/fdatasync，或O_DSYNC下的每次写入
     bool m_canceled;
 };
 
 SpeedTestWidget::SpeedTestWidget(QWidget *parent) : QWidget(parent) {
     setupUI();
+    
+    m_resultStore = new ResultStore(QString(), this);
+    connect(m_resultStore, &ResultStore::saveFailed, this, [this](const QString &message) {
+        m_testStatusLabel->setText(message);
+    });
+    
+    // 选中磁盘时会按磁盘加载历史记录，没有磁盘时直接加载全部
     refreshDiskList();
+    if (m_diskComboBox->count() == 0) {
+        loadHistory();
+    }
     
     m_tester = nullptr;
     m_testerThread = nullptr;
+    m_sustainedTester = nullptr;
+    m_rawTester = nullptr;
+    m_workloadEngine = nullptr;
+    m_benchmarkRunner = nullptr;
     
     QTimer::singleShot(500, this, [this]() {
         // 初始化图表
         createChart();
+        createSustainedChart();
     });
 }
 
@@ -197,6 +265,18 @@ SpeedTestWidget::~SpeedTestWidget() {
         if (m_tester) {
             m_tester->cancel();
         }
+        if (m_sustainedTester) {
+            m_sustainedTester->cancel();
+        }
+        if (m_rawTester) {
+            m_rawTester->cancel();
+        }
+        if (m_workloadEngine) {
+            m_workloadEngine->cancel();
+        }
+        if (m_benchmarkRunner) {
+            m_benchmarkRunner->cancel();
+        }
         m_testerThread->quit();
         m_testerThread->wait();
     }
@@ -245,10 +325,80 @@ void SpeedTestWidget::setupUI() {
     m_fileSizeComboBox->addItem("4 GB", 4096);
     m_fileSizeComboBox->setCurrentIndex(1); // 500MB默认
     
+    QLabel *testModeLabel = new QLabel("测试模式:", this);
+    m_testModeComboBox = new QComboBox(this);
+    m_testModeComboBox->addItem("标准读写", 0);
+    m_testModeComboBox->addItem("持续写入 (SLC缓存检测)", 1);
+    m_testModeComboBox->addItem("原始设备只读 (绕过文件系统)", 2);
+    m_testModeComboBox->addItem("fio作业文件 (自定义负载)", 3);
+    m_testModeComboBox->addItem("数据校验 (扩容/假容量检测)", 4);
+    m_testModeComboBox->addItem("元数据 (小文件创建/删除)", 5);
+    m_testModeComboBox->addItem("多盘并发 (控制器瓶颈)", 6);
+    m_testModeComboBox->addItem("块大小/队列深度扫描", 7);
+    m_testModeComboBox->addItem("内存映射 (mmap)", 8);
+    m_testModeComboBox->addItem("负载下延迟 (QoS)", 9);
+    
+    // 持续写入和数据校验的目标写入量，可按可用空间百分比或固定大小设置
+    QLabel *targetLabel = new QLabel("写入总量:", this);
+    m_targetAmountSpinBox = new QSpinBox(this);
+    m_targetUnitComboBox = new QComboBox(this);
+    m_targetUnitComboBox->addItem("% 可用空间", 0);
+    m_targetUnitComboBox->addItem("GB", 1);
+    m_targetAmountSpinBox->setRange(1, 90);
+    m_targetAmountSpinBox->setValue(50);
+    m_targetAmountSpinBox->setEnabled(false);
+    m_targetUnitComboBox->setEnabled(false);
+    
+    // 标准读写：预热若干次后重复测试，给出均值和置信区间
+    QLabel *repetitionLabel = new QLabel("预热/重复次数:", this);
+    m_warmupSpinBox = new QSpinBox(this);
+    m_warmupSpinBox->setRange(0, 5);
+    m_warmupSpinBox->setValue(1);
+    m_warmupSpinBox->setPrefix("预热 ");
+    m_repetitionSpinBox = new QSpinBox(this);
+    m_repetitionSpinBox->setRange(1, 20);
+    m_repetitionSpinBox->setValue(5);
+    m_repetitionSpinBox->setPrefix("重复 ");
+    m_repetitionSpinBox->setToolTip("重复1次且不预热时按单次测试进行");
+    
+    QHBoxLayout *repetitionLayout = new QHBoxLayout();
+    repetitionLayout->addWidget(m_warmupSpinBox);
+    repetitionLayout->addWidget(m_repetitionSpinBox);
+    
+    // 写入数据的持久化方式：不同步时写入速度包含系统写缓存
+    QLabel *durabilityLabel = new QLabel("写入同步:", this);
+    m_durabilityComboBox = new QComboBox(this);
+    m_durabilityComboBox->addItem("结束时 fsync (计入耗时)", FioJob::FinalSync);
+    m_durabilityComboBox->addItem("定期 fdatasync", FioJob::PeriodicSync);
+    m_durabilityComboBox->addItem("O_DSYNC (每次写入落盘)", FioJob::DsyncWrites);
+    m_durabilityComboBox->addItem("不同步 (含系统缓存)", FioJob::NoSync);
+    m_syncIntervalSpinBox = new QSpinBox(this);
+    m_syncIntervalSpinBox->setRange(1, 4096);
+    m_syncIntervalSpinBox->setValue(64);
+    m_syncIntervalSpinBox->setPrefix("每 ");
+    m_syncIntervalSpinBox->setSuffix(" MB");
+    m_syncIntervalSpinBox->setEnabled(false);
+    
+    QHBoxLayout *durabilityLayout = new QHBoxLayout();
+    durabilityLayout->addWidget(m_durabilityComboBox);
+    durabilityLayout->addWidget(m_syncIntervalSpinBox);
+    
+    QHBoxLayout *targetLayout = new QHBoxLayout();
+    targetLayout->addWidget(m_targetAmountSpinBox);
+    targetLayout->addWidget(m_targetUnitComboBox);
+    
     settingsLayout->addWidget(blockSizeLabel, 0, 0);
     settingsLayout->addWidget(m_blockSizeComboBox, 0, 1);
     settingsLayout->addWidget(fileSizeLabel, 1, 0);
     settingsLayout->addWidget(m_fileSizeComboBox, 1, 1);
+    settingsLayout->addWidget(testModeLabel, 2, 0);
+    settingsLayout->addWidget(m_testModeComboBox, 2, 1);
+    settingsLayout->addWidget(targetLabel, 3, 0);
+    settingsLayout->addLayout(targetLayout, 3, 1);
+    settingsLayout->addWidget(repetitionLabel, 4, 0);
+    settingsLayout->addLayout(repetitionLayout, 4, 1);
+    settingsLayout->addWidget(durabilityLabel, 5, 0);
+    settingsLayout->addLayout(durabilityLayout, 5, 1);
     
     // === 控制按钮区域 ===
     QHBoxLayout *controlLayout = new QHBoxLayout();
@@ -303,16 +453,129 @@ void SpeedTestWidget::setupUI() {
     resultsLayout->addWidget(m_chartView);
     resultsLayout->addLayout(speedLayout);
     
+    // === 统计结果区域 ===
+    m_statsGroup = new QGroupBox("统计结果 (均值 ± 95%置信区间)", this);
+    QVBoxLayout *statsLayout = new QVBoxLayout(m_statsGroup);
+    
+    m_statsLabel = new QLabel("尚未进行重复测试", this);
+    m_statsLabel->setWordWrap(true);
+    m_statsLabel->setTextFormat(Qt::RichText);
+    
+    m_setBaselineButton = new QPushButton("设为该磁盘的基准", this);
+    m_setBaselineButton->setEnabled(false);
+    m_setBaselineButton->setToolTip("固件升级或更换系统后，确认性能正常时可把本次结果作为新的比较基准");
+    
+    QHBoxLayout *baselineLayout = new QHBoxLayout();
+    baselineLayout->addStretch();
+    baselineLayout->addWidget(m_setBaselineButton);
+    
+    statsLayout->addWidget(m_statsLabel);
+    statsLayout->addLayout(baselineLayout);
+    
+    // === 持续写入曲线区域 ===
+    m_sustainedGroup = new QGroupBox("持续写入曲线", this);
+    QVBoxLayout *sustainedLayout = new QVBoxLayout(m_sustainedGroup);
+    
+    m_sustainedChartView = new QtCharts::QChartView(this);
+    m_sustainedChartView->setRenderHint(QPainter::Antialiasing);
+    m_sustainedChartView->setMinimumHeight(200);
+    m_sustainedSeries = nullptr;
+    m_sustainedMaxSpeed = 0;
+    m_sustainedMaxTime = 0;
+    
+    m_sustainedResultLabel = new QLabel("尚未进行持续写入测试", this);
+    m_sustainedResultLabel->setWordWrap(true);
+    
+    sustainedLayout->addWidget(m_sustainedChartView);
+    sustainedLayout->addWidget(m_sustainedResultLabel);
+    m_sustainedGroup->setVisible(false);
+    
+    // === 数据校验区域 ===
+    m_integrityPanel = new IntegrityPanel(this);
+    m_integrityPanel->setVisible(false);
+    addPanel(m_integrityPanel);
+    
+    // === 元数据测试区域 ===
+    m_metadataPanel = new MetadataPanel(this);
+    m_metadataPanel->setVisible(false);
+    addPanel(m_metadataPanel);
+    
+    // === 内存映射测试区域 ===
+    m_mmapPanel = new MmapPanel(this);
+    m_mmapPanel->setVisible(false);
+    addPanel(m_mmapPanel);
+    
+    // === 负载下延迟测试区域 ===
+    m_qosPanel = new QosPanel(this);
+    m_qosPanel->setVisible(false);
+    addPanel(m_qosPanel);
+    
+    // === 多盘并发测试区域 ===
+    m_multiDiskPanel = new MultiDiskPanel(this);
+    m_multiDiskPanel->setVisible(false);
+    addPanel(m_multiDiskPanel);
+    
+    // === 块大小/队列深度扫描区域 ===
+    m_sweepPanel = new SweepPanel(this);
+    m_sweepPanel->setVisible(false);
+    addPanel(m_sweepPanel);
+    
+    // === 原始设备分区测速区域 ===
+    m_rawGroup = new QGroupBox("分区测速结果 (只读)", this);
+    QVBoxLayout *rawLayout = new QVBoxLayout(m_rawGroup);
+    
+    m_zoneTable = new QTableWidget(0, 5, this);
+    m_zoneTable->setHorizontalHeaderLabels({"区域", "起始位置", "顺序读取", "随机4K读取", "平均延迟"});
+    m_zoneTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_zoneTable->setEditTriggers(QTableWidget::NoEditTriggers);
+    
+    rawLayout->addWidget(m_zoneTable);
+    m_rawGroup->setVisible(false);
+    
+    // === fio作业区域 ===
+    m_workloadGroup = new QGroupBox("fio作业", this);
+    QVBoxLayout *workloadLayout = new QVBoxLayout(m_workloadGroup);
+    
+    m_jobEditor = new QPlainTextEdit(this);
+    m_jobEditor->setPlainText(FioJobParser::sampleJobText());
+    m_jobEditor->setMinimumHeight(160);
+    QFont editorFont("Consolas");
+    editorFont.setStyleHint(QFont::Monospace);
+    m_jobEditor->setFont(editorFont);
+    
+    QHBoxLayout *jobButtonLayout = new QHBoxLayout();
+    m_loadJobButton = new QPushButton("加载作业文件...", this);
+    QLabel *jobHintLabel = new QLabel("支持rw/bs/size/iodepth/numjobs/runtime/ramp_time/time_based/direct/ioengine/random_distribution/buffer_compress_percentage/dedupe_percentage等参数；"
+                                      "未指定filename时在所选磁盘上创建测试文件", this);
+    jobHintLabel->setWordWrap(true);
+    jobButtonLayout->addWidget(m_loadJobButton);
+    jobButtonLayout->addWidget(jobHintLabel, 1);
+    
+    m_workloadTable = new QTableWidget(0, 7, this);
+    m_workloadTable->setHorizontalHeaderLabels({"作业", "读取速度", "读取IOPS", "读延迟 p50/p99", "写入速度", "写入IOPS", "写延迟 p50/p99"});
+    m_workloadTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_workloadTable->setEditTriggers(QTableWidget::NoEditTriggers);
+    
+    workloadLayout->addWidget(m_jobEditor);
+    workloadLayout->addLayout(jobButtonLayout);
+    workloadLayout->addWidget(m_workloadTable);
+    m_workloadGroup->setVisible(false);
+    
     // === 历史记录区域 ===
     QGroupBox *historyGroupBox = new QGroupBox("测试历史", this);
     QVBoxLayout *historyLayout = new QVBoxLayout(historyGroupBox);
     
-    m_historyTable = new QTableWidget(0, 5, this);
-    m_historyTable->setHorizontalHeaderLabels({"磁盘", "块大小", "文件大小", "读取速度", "写入速度"});
+    // 历史记录保存在本地数据库中，默认只显示所选磁盘的结果
+    m_historyFilterCheckBox = new QCheckBox("仅显示所选磁盘", this);
+    m_historyFilterCheckBox->setChecked(true);
+    
+    m_historyTable = new QTableWidget(0, 7, this);
+    m_historyTable->setHorizontalHeaderLabels({"测试时间", "磁盘", "类型", "块大小", "文件大小", "读取速度", "写入速度"});
     m_historyTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     m_historyTable->setAlternatingRowColors(true);
     m_historyTable->setEditTriggers(QTableWidget::NoEditTriggers);
     
+    historyLayout->addWidget(m_historyFilterCheckBox);
     historyLayout->addWidget(m_historyTable);
     
     // 添加所有区域到主布局
@@ -321,6 +584,16 @@ void SpeedTestWidget::setupUI() {
     mainLayout->addLayout(controlLayout);
     mainLayout->addWidget(statusGroupBox);
     mainLayout->addWidget(resultsGroupBox);
+    mainLayout->addWidget(m_statsGroup);
+    mainLayout->addWidget(m_sustainedGroup);
+    mainLayout->addWidget(m_integrityPanel);
+    mainLayout->addWidget(m_metadataPanel);
+    mainLayout->addWidget(m_mmapPanel);
+    mainLayout->addWidget(m_qosPanel);
+    mainLayout->addWidget(m_multiDiskPanel);
+    mainLayout->addWidget(m_sweepPanel);
+    mainLayout->addWidget(m_rawGroup);
+    mainLayout->addWidget(m_workloadGroup);
     mainLayout->addWidget(historyGroupBox);
     
     // 信号连接
@@ -331,16 +604,26 @@ void SpeedTestWidget::setupUI() {
     connect(m_exportButton, &QPushButton::clicked, this, &SpeedTestWidget::onExportResultsClicked);
     connect(m_blockSizeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SpeedTestWidget::onBlockSizeChanged);
     connect(m_fileSizeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SpeedTestWidget::onFileSizeChanged);
+    connect(m_testModeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SpeedTestWidget::onTestModeChanged);
+    connect(m_targetUnitComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SpeedTestWidget::onTargetUnitChanged);
+    connect(m_loadJobButton, &QPushButton::clicked, this, &SpeedTestWidget::onLoadJobFileClicked);
+    connect(m_setBaselineButton, &QPushButton::clicked, this, &SpeedTestWidget::onSetBaselineClicked);
+    connect(m_historyFilterCheckBox, &QCheckBox::toggled, this, &SpeedTestWidget::loadHistory);
+    connect(m_durabilityComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_syncIntervalSpinBox->setEnabled(m_durabilityComboBox->currentData().toInt() == FioJob::PeriodicSync);
+    });
 }
 
 void SpeedTestWidget::refreshDiskList() {
     m_diskComboBox->clear();
-    m_diskList = DiskUtils::getAllDisks();
+    // 硬盘列表由DiskInventory统一枚举并随热插拔更新，这里只取当前快照
+    m_diskList = DiskInventory::instance()->disks();
     
     for (const DiskInfo &disk : m_diskList) {
         QString displayName = QString("%1 (%2)").arg(disk.diskName).arg(disk.model);
         m_diskComboBox->addItem(displayName);
     }
+    m_multiDiskPanel->setDisks(m_diskList);
     
     if (m_diskComboBox->count() > 0) {
         m_diskComboBox->setCurrentIndex(0);
@@ -357,6 +640,10 @@ void SpeedTestWidget::onDiskSelectionChanged(int index) {
                                                       .arg(m_selectedDisk.model)
                                                       .arg(DiskUtils::formatSize(m_selectedDisk.diskSize));
         m_testStatusLabel->setText(diskInfo);
+        
+        if (m_historyFilterCheckBox->isChecked()) {
+            loadHistory();
+        }
     }
 }
 
@@ -366,6 +653,59 @@ void SpeedTestWidget::onStartTestClicked() {
         return;
     }
     
+    // 历史记录使用测试开始的时间
+    m_testStartTime = QDateTime::currentDateTime();
+    
+    if (m_testModeComboBox->currentData().toInt() == 1) {
+        startSustainedTest();
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 2) {
+        startRawDeviceTest();
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 3) {
+        startWorkloadTest();
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 4) {
+        startPanel(m_integrityPanel);
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 5) {
+        startPanel(m_metadataPanel);
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 6) {
+        startPanel(m_multiDiskPanel);
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 7) {
+        startPanel(m_sweepPanel);
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 8) {
+        startPanel(m_mmapPanel);
+        return;
+    }
+    
+    if (m_testModeComboBox->currentData().toInt() == 9) {
+        startPanel(m_qosPanel);
+        return;
+    }
+    
+    if (m_warmupSpinBox->value() > 0 || m_repetitionSpinBox->value() > 1) {
+        startBenchmarkTest();
+        return;
+    }
+    
     // 获取测试参数
     int blockSizeKB = m_blockSizeComboBox->currentData().toInt();
     int fileSizeMB = m_fileSizeComboBox->currentData().toInt();
@@ -385,22 +725,21 @@ void SpeedTestWidget::onStartTestClicked() {
     }
     
     // 更新UI状态
-    m_startButton->setEnabled(false);
-    m_cancelButton->setEnabled(true);
-    m_diskComboBox->setEnabled(false);
-    m_blockSizeComboBox->setEnabled(false);
-    m_fileSizeComboBox->setEnabled(false);
+    setSettingsEnabled(false);
     m_progressBar->setValue(0);
     m_testStatusLabel->setText("正在准备测试...");
     
     // 创建测试线程
     m_testerThread = new QThread(this);
-    m_tester = new SpeedTester(m_selectedDisk.diskPath, testFilePath, blockSizeKB, fileSizeMB);
+    m_tester = new SpeedTester(m_selectedDisk.diskPath, testFilePath, blockSizeKB, fileSizeMB,
+                               static_cast<FioJob::Durability>(m_durabilityComboBox->currentData().toInt()),
+                               static_cast<qint64>(m_syncIntervalSpinBox->value()) * 1024 * 1024);
     m_tester->moveToThread(m_testerThread);
     
     connect(m_testerThread, &QThread::started, m_tester, &SpeedTester::startTest);
     connect(m_tester, &SpeedTester::progressUpdated, this, &SpeedTestWidget::updateProgress);
     connect(m_tester, &SpeedTester::testCompleted, this, &SpeedTestWidget::onTestCompleted);
+    connect(m_tester, &SpeedTester::testCompleted, m_testerThread, &QThread::quit);
     
     connect(m_testerThread, &QThread::finished, [this]() {
         m_tester->deleteLater();
@@ -409,24 +748,623 @@ void SpeedTestWidget::onStartTestClicked() {
         m_testerThread = nullptr;
         
         // 恢复UI状态
-        m_startButton->setEnabled(true);
-        m_cancelButton->setEnabled(false);
-        m_diskComboBox->setEnabled(true);
-        m_blockSizeComboBox->setEnabled(true);
-        m_fileSizeComboBox->setEnabled(true);
+        setSettingsEnabled(true);
+    });
+    
+    m_testerThread->start();
+}
+
+void SpeedTestWidget::startSustainedTest() {
+    int blockSizeKB = m_blockSizeComboBox->currentData().toInt();
+    
+    // 测试文件必须写在所选磁盘上，否则测到的是其他磁盘的缓存
+    QString testDir = testDirectory();
+    QString testFilePath = QDir(testDir).filePath("disktoolbox_sustained.dat");
+    
+    DiskUsage usage = DiskUtils::getDiskUsage(testDir);
+    qint64 freeSpace = usage.freeSpace;
+    
+    qint64 targetBytes = 0;
+    if (m_targetUnitComboBox->currentData().toInt() == 0) {
+        targetBytes = freeSpace / 100 * m_targetAmountSpinBox->value();
+    } else {
+        targetBytes = static_cast<qint64>(m_targetAmountSpinBox->value()) * 1024 * 1024 * 1024;
+    }
+    
+    // 至少保留1GB可用空间，避免把系统盘写满
+    const qint64 reserveBytes = 1024LL * 1024 * 1024;
+    if (targetBytes <= 0 || targetBytes > freeSpace - reserveBytes) {
+        QMessageBox::warning(this, "错误", QString("磁盘空间不足，无法进行测试\n可用空间: %1，计划写入: %2")
+                             .arg(DiskUtils::formatSize(freeSpace))
+                             .arg(DiskUtils::formatSize(targetBytes)));
+        return;
+    }
+    
+    qDebug() << "开始持续写入测试，目录:" << testDir << "写入量:" << targetBytes;
+    
+    // 更新UI状态
+    setSettingsEnabled(false);
+    m_progressBar->setValue(0);
+    m_testStatusLabel->setText(QString("正在进行持续写入测试，计划写入 %1...").arg(DiskUtils::formatSize(targetBytes)));
+    
+    // 清空上一次的曲线
+    m_sustainedMaxSpeed = 0;
+    m_sustainedMaxTime = 0;
+    if (m_sustainedSeries) {
+        m_sustainedSeries->clear();
+    }
+    m_sustainedResultLabel->setText("测试进行中...");
+    
+    m_testerThread = new QThread(this);
+    m_sustainedTester = new SustainedWriteTester(testFilePath, targetBytes, blockSizeKB);
+    m_sustainedTester->moveToThread(m_testerThread);
+    
+    connect(m_testerThread, &QThread::started, m_sustainedTester, &SustainedWriteTester::startTest);
+    connect(m_sustainedTester, &SustainedWriteTester::progressUpdated, this, [this](int percent, double currentSpeed) {
+        updateProgress(percent, currentSpeed, false);
+    });
+    connect(m_sustainedTester, &SustainedWriteTester::sampleRecorded, this, &SpeedTestWidget::onSustainedSampleRecorded);
+    connect(m_sustainedTester, &SustainedWriteTester::testCompleted, this, &SpeedTestWidget::onSustainedTestCompleted);
+    connect(m_sustainedTester, &SustainedWriteTester::testCompleted, m_testerThread, &QThread::quit);
+    
+    connect(m_testerThread, &QThread::finished, [this]() {
+        m_sustainedTester->deleteLater();
+        m_sustainedTester = nullptr;
+        m_testerThread->deleteLater();
+        m_testerThread = nullptr;
+        
+        // 恢复UI状态
+        setSettingsEnabled(true);
+    });
+    
+    m_testerThread->start();
+}
+
+void SpeedTestWidget::onSustainedSampleRecorded(double elapsedSec, double speedMBps) {
+    if (!m_sustainedSeries) {
+        return;
+    }
+    
+    m_sustainedSeries->append(elapsedSec, speedMBps);
+    m_sustainedMaxSpeed = qMax(m_sustainedMaxSpeed, speedMBps);
+    m_sustainedMaxTime = qMax(m_sustainedMaxTime, elapsedSec);
+    
+    QtCharts::QChart *chart = m_sustainedChartView->chart();
+    QList<QtCharts::QAbstractAxis*> xAxes = chart->axes(Qt::Horizontal);
+    QList<QtCharts::QAbstractAxis*> yAxes = chart->axes(Qt::Vertical);
+    if (!xAxes.isEmpty()) {
+        xAxes.first()->setRange(0, qMax(10.0, m_sustainedMaxTime));
+    }
+    if (!yAxes.isEmpty()) {
+        yAxes.first()->setRange(0, qMax(100.0, m_sustainedMaxSpeed * 1.2));
+    }
+}
+
+void SpeedTestWidget::onSustainedTestCompleted(const SustainedWriteResult &result) {
+    if (result.totalBytes == 0) {
+        QString message = result.errorMessage.isEmpty() ? QString("测试失败") : result.errorMessage;
+        m_testStatusLabel->setText(message);
+        m_sustainedResultLabel->setText(message);
+        return;
+    }
+    
+    QString summary = QString("共写入 %1，耗时 %2 秒，平均速度 %3 MB/s")
+                          .arg(DiskUtils::formatSize(result.totalBytes))
+                          .arg(result.elapsedSec, 0, 'f', 1)
+                          .arg(result.averageSpeed, 0, 'f', 2);
+    
+    if (result.kneeDetected) {
+        summary += QString("\n缓存内速度: %1 MB/s，缓存耗尽后速度: %2 MB/s\n估算缓存大小: %3（第 %4 秒出现拐点）")
+                       .arg(result.preKneeSpeed, 0, 'f', 2)
+                       .arg(result.postKneeSpeed, 0, 'f', 2)
+                       .arg(DiskUtils::formatSize(result.cacheSizeBytes))
+                       .arg(result.kneeTimeSec, 0, 'f', 1);
+    } else {
+        summary += "\n未检测到速度拐点：缓存大于本次写入量，或磁盘没有SLC缓存";
+    }
+    
+    if (!result.success) {
+        summary += QString("\n测试未完成: %1").arg(result.errorMessage);
+    }
+    
+    m_sustainedResultLabel->setText(summary);
+    m_writeSpeedLabel->setText(QString("%1 MB/s").arg(result.averageSpeed, 0, 'f', 2));
+    m_testStatusLabel->setText(result.success ? QString("持续写入测试完成") : result.errorMessage);
+    
+    if (result.success) {
+        m_progressBar->setValue(100);
+        // 读取速度一栏不适用于持续写入模式
+        SpeedTestRecord record = newRecord("sustained");
+        record.fileSize = result.totalBytes;
+        record.writeMBps = result.averageSpeed;
+        record.parameters["elapsedSec"] = result.elapsedSec;
+        record.parameters["kneeDetected"] = result.kneeDetected;
+        if (result.kneeDetected) {
+            record.parameters["preKneeSpeed"] = result.preKneeSpeed;
+            record.parameters["postKneeSpeed"] = result.postKneeSpeed;
+            record.parameters["cacheSizeBytes"] = result.cacheSizeBytes;
+            record.parameters["kneeTimeSec"] = result.kneeTimeSec;
+        }
+        for (const ThroughputSample &sample : result.samples) {
+            record.series.append({sample.elapsedSec, 0, sample.speedMBps, 0});
+        }
+        addResultToHistory(record);
+        m_exportButton->setEnabled(true);
+    }
+}
+
+void SpeedTestWidget::startRawDeviceTest() {
+    int blockSizeKB = m_blockSizeComboBox->currentData().toInt();
+    // 原始设备模式下“文件大小”表示每个区域的顺序读取量
+    int readSizeMB = m_fileSizeComboBox->currentData().toInt();
+    QString devicePath = m_selectedDisk.diskPath;
+    
+    if (devicePath.isEmpty()) {
+        QMessageBox::warning(this, "错误", "所选磁盘没有可用的设备路径");
+        return;
+    }
+    
+    qDebug() << "开始原始设备只读测试，设备:" << devicePath << "块大小:" << blockSizeKB << "KB 每区读取:" << readSizeMB << "MB";
+    
+    setSettingsEnabled(false);
+    m_progressBar->setValue(0);
+    m_testStatusLabel->setText(QString("正在以只读方式打开 %1...").arg(devicePath));
+    m_zoneTable->setRowCount(0);
+    
+    m_testerThread = new QThread(this);
+    m_rawTester = new RawDeviceTester(devicePath, blockSizeKB, readSizeMB);
+    m_rawTester->moveToThread(m_testerThread);
+    
+    connect(m_testerThread, &QThread::started, m_rawTester, &RawDeviceTester::startTest);
+    connect(m_rawTester, &RawDeviceTester::progressUpdated, this, [this](int percent, const QString &status) {
+        m_progressBar->setValue(percent);
+        m_testStatusLabel->setText(status);
+    });
+    connect(m_rawTester, &RawDeviceTester::zoneCompleted, this, &SpeedTestWidget::onRawZoneCompleted);
+    connect(m_rawTester, &RawDeviceTester::testCompleted, this, &SpeedTestWidget::onRawTestCompleted);
+    connect(m_rawTester, &RawDeviceTester::testCompleted, m_testerThread, &QThread::quit);
+    
+    connect(m_testerThread, &QThread::finished, [this]() {
+        m_rawTester->deleteLater();
+        m_rawTester = nullptr;
+        m_testerThread->deleteLater();
+        m_testerThread = nullptr;
+        
+        // 恢复UI状态
+        setSettingsEnabled(true);
+    });
+    
+    m_testerThread->start();
+}
+
+void SpeedTestWidget::startBenchmarkTest() {
+    BenchmarkConfig config;
+    config.blockSizeKB = m_blockSizeComboBox->currentData().toInt();
+    config.fileSizeMB = m_fileSizeComboBox->currentData().toInt();
+    config.warmupRuns = m_warmupSpinBox->value();
+    config.repetitions = m_repetitionSpinBox->value();
+    config.durability = static_cast<FioJob::Durability>(m_durabilityComboBox->currentData().toInt());
+    config.syncIntervalBytes = static_cast<qint64>(m_syncIntervalSpinBox->value()) * 1024 * 1024;
+    config.diskSerial = m_selectedDisk.serialNumber;
+    
+    // 测试文件写在所选磁盘上
+    QString testDir = testDirectory();
+    config.testFilePath = QDir(testDir).filePath("disktoolbox_benchmark.dat");
+    
+    DiskUsage usage = DiskUtils::getDiskUsage(testDir);
+    if (usage.freeSpace > 0 && usage.freeSpace < static_cast<qint64>(config.fileSizeMB) * 1024 * 1024) {
+        QMessageBox::warning(this, "错误", "磁盘空间不足，无法进行测试");
+        return;
+    }
+    
+    setSettingsEnabled(false);
+    m_progressBar->setValue(0);
+    m_testStatusLabel->setText("正在准备测试...");
+    m_statsLabel->setText(QString("正在进行 %1 次预热和 %2 次重复测试...").arg(config.warmupRuns).arg(config.repetitions));
+    m_setBaselineButton->setEnabled(false);
+    
+    m_testerThread = new QThread(this);
+    m_benchmarkRunner = new BenchmarkRunner(config);
+    m_benchmarkRunner->moveToThread(m_testerThread);
+    
+    connect(m_testerThread, &QThread::started, m_benchmarkRunner, &BenchmarkRunner::startTest);
+    connect(m_benchmarkRunner, &BenchmarkRunner::progressUpdated, this, [this](int percent, const QString &status) {
+        m_progressBar->setValue(percent);
+        m_testStatusLabel->setText(status);
+    });
+    connect(m_benchmarkRunner, &BenchmarkRunner::passCompleted, this, &SpeedTestWidget::onBenchmarkPassCompleted);
+    connect(m_benchmarkRunner, &BenchmarkRunner::testCompleted, this, &SpeedTestWidget::onBenchmarkCompleted);
+    connect(m_benchmarkRunner, &BenchmarkRunner::testCompleted, m_testerThread, &QThread::quit);
+    
+    connect(m_testerThread, &QThread::finished, [this]() {
+        m_benchmarkRunner->deleteLater();
+        m_benchmarkRunner = nullptr;
+        m_testerThread->deleteLater();
+        m_testerThread = nullptr;
+        
+        // 恢复UI状态
+        setSettingsEnabled(true);
+    });
+    
+    m_testerThread->start();
+}
+
+void SpeedTestWidget::onBenchmarkPassCompleted(int pass, bool warmup, double readSpeed, double writeSpeed) {
+    Q_UNUSED(pass);
+    m_readSpeedLabel->setText(QString("%1 MB/s").arg(readSpeed, 0, 'f', 2));
+    m_writeSpeedLabel->setText(QString("%1 MB/s").arg(writeSpeed, 0, 'f', 2));
+    if (!warmup) {
+        updateChart(readSpeed, writeSpeed);
+    }
+}
+
+QString SpeedTestWidget::formatStatistics(const QString &name, const SampleStatistics &stats,
+                                          const BaselineComparison &comparison) const {
+    QString text = QString("<b>%1</b>: %2 ± %3 MB/s（标准差 %4，CV %5%，n=%6")
+                       .arg(name)
+                       .arg(stats.mean, 0, 'f', 1)
+                       .arg(stats.ciHalfWidth(), 0, 'f', 1)
+                       .arg(stats.stddev, 0, 'f', 2)
+                       .arg(stats.cv(), 0, 'f', 1)
+                       .arg(stats.count);
+    if (!stats.outliers.isEmpty()) {
+        text += QString("，剔除离群值 %1 个").arg(stats.outliers.size());
+    }
+    text += "）";
+    
+    if (comparison.available) {
+        QString color = comparison.significantSlowdown ? "#F44336" : "#4CAF50";
+        text += QString("<br>&nbsp;&nbsp;对比基准 %1 MB/s（%2）: <span style=\"color:%3;\">%4%5%</span>，p=%6")
+                    .arg(comparison.baselineMean, 0, 'f', 1)
+                    .arg(comparison.baselineTime.toString("yyyy-MM-dd"))
+                    .arg(color)
+                    .arg(comparison.changePercent >= 0 ? "+" : "")
+                    .arg(comparison.changePercent, 0, 'f', 1)
+                    .arg(comparison.pValue, 0, 'g', 3);
+        if (comparison.significantSlowdown) {
+            text += QString(" <span style=\"color:#F44336;\"><b>显著下降</b></span>");
+        }
+    }
+    return text;
+}
+
+void SpeedTestWidget::onBenchmarkCompleted(const BenchmarkResult &result) {
+    if (!result.success) {
+        m_testStatusLabel->setText(result.errorMessage);
+        m_statsLabel->setText(result.errorMessage);
+        if (result.errorMessage != "测试已取消") {
+            QMessageBox::warning(this, "测试失败", result.errorMessage);
+        }
+        return;
+    }
+    
+    m_lastBenchmark = result;
+    
+    m_readSpeedLabel->setText(QString("%1 MB/s").arg(result.read.mean, 0, 'f', 2));
+    m_writeSpeedLabel->setText(QString("%1 MB/s").arg(result.write.mean, 0, 'f', 2));
+    updateChart(result.read.mean, result.write.mean);
+    
+    QString text = formatStatistics("读取", result.read, result.readComparison) + "<br>"
+                 + formatStatistics("写入", result.write, result.writeComparison);
+    if (result.syncLatency.count() > 0) {
+        text += "<br>" + formatSyncLatency(result.syncLatency);
+    }
+    if (result.baselineCreated) {
+        text += "<br>该磁盘在此参数下还没有基准，已将本次结果保存为基准";
+    } else if (result.config.diskSerial.isEmpty()) {
+        text += "<br>无法获取磁盘序列号，不进行基准比较";
+    }
+    m_statsLabel->setText(text);
+    m_setBaselineButton->setEnabled(!result.config.diskSerial.isEmpty());
+    
+    SpeedTestRecord record = newRecord("benchmark");
+    record.label = QString("×%1").arg(result.config.repetitions);
+    record.readMBps = result.read.mean;
+    record.writeMBps = result.write.mean;
+    record.parameters["warmupRuns"] = result.config.warmupRuns;
+    record.parameters["repetitions"] = result.config.repetitions;
+    record.parameters["readStddev"] = result.read.stddev;
+    record.parameters["writeStddev"] = result.write.stddev;
+    record.parameters["readCiHalfWidth"] = result.read.ciHalfWidth();
+    record.parameters["writeCiHalfWidth"] = result.write.ciHalfWidth();
+    QJsonArray readSamples;
+    QJsonArray writeSamples;
+    for (double value : result.read.values) {
+        readSamples.append(value);
+    }
+    for (double value : result.write.values) {
+        writeSamples.append(value);
+    }
+    record.parameters["readSamples"] = readSamples;
+    record.parameters["writeSamples"] = writeSamples;
+    record.parameters["slowdown"] = result.hasSlowdown();
+    addDurabilityParameters(record, result.config.durability, result.config.syncIntervalBytes, result.syncLatency);
+    addResultToHistory(record);
+    
+    if (result.hasSlowdown()) {
+        m_testStatusLabel->setText("测试完成：与基准相比出现统计显著的性能下降");
+        QMessageBox::warning(this, "性能下降", "与该磁盘保存的基准相比，本次测试结果出现统计显著的性能下降，详见统计结果。");
+    } else {
+        m_testStatusLabel->setText(QString("测试完成！读取: %1 ± %2 MB/s, 写入: %3 ± %4 MB/s")
+                                   .arg(result.read.mean, 0, 'f', 1).arg(result.read.ciHalfWidth(), 0, 'f', 1)
+                                   .arg(result.write.mean, 0, 'f', 1).arg(result.write.ciHalfWidth(), 0, 'f', 1));
+    }
+    m_progressBar->setValue(100);
+    m_exportButton->setEnabled(true);
+}
+
+void SpeedTestWidget::onSetBaselineClicked() {
+    if (!m_lastBenchmark.success) {
+        return;
+    }
+    
+    int ret = QMessageBox::question(this, "设为基准", "确定用本次结果替换该磁盘在当前参数下的基准吗？");
+    if (ret != QMessageBox::Yes) {
+        return;
+    }
+    
+    BenchmarkRunner::saveBaseline(m_lastBenchmark);
+    m_setBaselineButton->setEnabled(false);
+    m_testStatusLabel->setText("已将本次结果设为基准");
+}
+
+void SpeedTestWidget::startWorkloadTest() {
+    QList<FioJob> jobs;
+    QString errorMessage;
+    QStringList warnings;
+    if (!FioJobParser::parse(m_jobEditor->toPlainText(), jobs, errorMessage, &warnings)) {
+        QMessageBox::warning(this, "作业文件错误", errorMessage);
+        return;
+    }
+    
+    for (const QString &warning : warnings) {
+        qDebug() << "fio作业:" << warning;
+    }
+    
+    QString testDir = testDirectory();
+    qDebug() << "开始运行fio作业，作业数:" << jobs.size() << "测试目录:" << testDir;
+    
+    setSettingsEnabled(false);
+    m_progressBar->setValue(0);
+    m_testStatusLabel->setText(warnings.isEmpty() ? QString("正在准备作业...")
+                                                  : QString("正在准备作业...（%1）").arg(warnings.join("；")));
+    m_workloadTable->setRowCount(0);
+    
+    m_testerThread = new QThread(this);
+    m_workloadEngine = new WorkloadEngine(jobs, testDir);
+    m_workloadEngine->moveToThread(m_testerThread);
+    
+    connect(m_testerThread, &QThread::started, m_workloadEngine, &WorkloadEngine::startRun);
+    connect(m_workloadEngine, &WorkloadEngine::progressUpdated, this, &SpeedTestWidget::onWorkloadProgress);
+    connect(m_workloadEngine, &WorkloadEngine::jobCompleted, this, &SpeedTestWidget::onWorkloadJobCompleted);
+    connect(m_workloadEngine, &WorkloadEngine::runCompleted, this, &SpeedTestWidget::onWorkloadRunCompleted);
+    connect(m_workloadEngine, &WorkloadEngine::runCompleted, m_testerThread, &QThread::quit);
+    
+    connect(m_testerThread, &QThread::finished, [this]() {
+        m_workloadEngine->deleteLater();
+        m_workloadEngine = nullptr;
+        m_testerThread->deleteLater();
+        m_testerThread = nullptr;
+        
+        // 恢复UI状态
+        setSettingsEnabled(true);
     });
     
     m_testerThread->start();
 }
 
+void SpeedTestWidget::onLoadJobFileClicked() {
+    QString filePath = QFileDialog::getOpenFileName(
+        this,
+        "加载fio作业文件",
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+        "fio作业文件 (*.fio *.ini *.job);;所有文件 (*.*)"
+    );
+    
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "错误", "无法打开作业文件: " + filePath);
+        return;
+    }
+    
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    m_jobEditor->setPlainText(in.readAll());
+}
+
+void SpeedTestWidget::onWorkloadProgress(int percent, const QString &jobName, double readMBps, double writeMBps) {
+    m_progressBar->setValue(percent);
+    m_testStatusLabel->setText(QString("正在运行作业 %1: 读取 %2 MB/s, 写入 %3 MB/s")
+                               .arg(jobName)
+                               .arg(readMBps, 0, 'f', 1)
+                               .arg(writeMBps, 0, 'f', 1));
+}
+
+void SpeedTestWidget::onWorkloadJobCompleted(const WorkloadJobResult &result) {
+    int row = m_workloadTable->rowCount();
+    m_workloadTable->insertRow(row);
+    
+    auto latencyText = [](const LatencyHistogram &histogram) {
+        if (histogram.count() == 0) {
+            return QString("-");
+        }
+        return QString("%1 / %2 ms")
+            .arg(histogram.percentileNs(50) / 1e6, 0, 'f', 3)
+            .arg(histogram.percentileNs(99) / 1e6, 0, 'f', 3);
+    };
+    
+    QString name = QString("%1 (%2, %3, QD%4×%5)").arg(result.jobName).arg(result.rw)
+                       .arg(DiskUtils::formatSize(result.blockSize)).arg(result.ioDepth).arg(result.numJobs);
+    m_workloadTable->setItem(row, 0, new QTableWidgetItem(name));
+    
+    if (!result.success) {
+        m_workloadTable->setItem(row, 1, new QTableWidgetItem(result.errorMessage));
+        m_workloadTable->setSpan(row, 1, 1, 6);
+        return;
+    }
+    
+    bool hasRead = result.readIos > 0;
+    bool hasWrite = result.writeIos > 0;
+    m_workloadTable->setItem(row, 1, new QTableWidgetItem(hasRead ? QString("%1 MB/s").arg(result.readMBps(), 0, 'f', 1) : QString("-")));
+    m_workloadTable->setItem(row, 2, new QTableWidgetItem(hasRead ? QString::number(result.readIops(), 'f', 0) : QString("-")));
+    m_workloadTable->setItem(row, 3, new QTableWidgetItem(latencyText(result.readLatency)));
+    m_workloadTable->setItem(row, 4, new QTableWidgetItem(hasWrite ? QString("%1 MB/s").arg(result.writeMBps(), 0, 'f', 1) : QString("-")));
+    m_workloadTable->setItem(row, 5, new QTableWidgetItem(hasWrite ? QString::number(result.writeIops(), 'f', 0) : QString("-")));
+    m_workloadTable->setItem(row, 6, new QTableWidgetItem(latencyText(result.writeLatency)));
+    
+    SpeedTestRecord record = newRecord("fio");
+    record.label = QString("fio: %1").arg(result.jobName);
+    record.blockSize = result.blockSize;
+    record.fileSize = result.readBytes + result.writeBytes;
+    if (hasRead) {
+        record.readMBps = result.readMBps();
+        record.readIops = result.readIops();
+        record.readP99Us = result.readLatency.percentileNs(99) / 1000.0;
+    }
+    if (hasWrite) {
+        record.writeMBps = result.writeMBps();
+        record.writeIops = result.writeIops();
+        record.writeP99Us = result.writeLatency.percentileNs(99) / 1000.0;
+    }
+    record.parameters["rw"] = result.rw;
+    record.parameters["ioDepth"] = result.ioDepth;
+    record.parameters["numJobs"] = result.numJobs;
+    record.parameters["directIo"] = result.directIo;
+    record.parameters["nativeAio"] = result.nativeAio;
+    record.parameters["elapsedSec"] = result.elapsedSec;
+    record.readLatency = result.readLatency;
+    record.writeLatency = result.writeLatency;
+    record.series = result.samples;
+    addResultToHistory(record);
+}
+
+void SpeedTestWidget::onWorkloadRunCompleted(const WorkloadRunResult &result) {
+    if (result.canceled) {
+        m_testStatusLabel->setText("测试已取消");
+        return;
+    }
+    
+    if (!result.success) {
+        m_testStatusLabel->setText(result.errorMessage);
+        QMessageBox::warning(this, "fio作业失败", result.errorMessage);
+        return;
+    }
+    
+    // 汇总所有作业的带宽显示在图表中
+    double readSpeed = 0;
+    double writeSpeed = 0;
+    for (const WorkloadJobResult &job : result.jobs) {
+        readSpeed = qMax(readSpeed, job.readMBps());
+        writeSpeed = qMax(writeSpeed, job.writeMBps());
+    }
+    m_readSpeedLabel->setText(QString("%1 MB/s").arg(readSpeed, 0, 'f', 2));
+    m_writeSpeedLabel->setText(QString("%1 MB/s").arg(writeSpeed, 0, 'f', 2));
+    updateChart(readSpeed, writeSpeed);
+    
+    m_testStatusLabel->setText(QString("全部 %1 个作业运行完成").arg(result.jobs.size()));
+    m_progressBar->setValue(100);
+    m_exportButton->setEnabled(true);
+}
+
+void SpeedTestWidget::onRawZoneCompleted(const ZoneResult &zone) {
+    int row = m_zoneTable->rowCount();
+    m_zoneTable->insertRow(row);
+    
+    m_zoneTable->setItem(row, 0, new QTableWidgetItem(zone.zoneName));
+    m_zoneTable->setItem(row, 1, new QTableWidgetItem(DiskUtils::formatSize(zone.startOffset)));
+    m_zoneTable->setItem(row, 2, new QTableWidgetItem(QString("%1 MB/s").arg(zone.seqReadSpeed, 0, 'f', 1)));
+    m_zoneTable->setItem(row, 3, new QTableWidgetItem(QString("%1 IOPS (%2 MB/s)")
+                                                      .arg(zone.randomReadIops, 0, 'f', 0)
+                                                      .arg(zone.randomReadSpeed, 0, 'f', 2)));
+    m_zoneTable->setItem(row, 4, new QTableWidgetItem(QString("%1 ms").arg(zone.avgLatencyMs, 0, 'f', 3)));
+}
+
+void SpeedTestWidget::onRawTestCompleted(const RawDeviceResult &result) {
+    if (!result.success) {
+        QString message = result.errorMessage.isEmpty() ? QString("测试失败") : result.errorMessage;
+        m_testStatusLabel->setText(message);
+        if (result.zones.isEmpty() && message != "测试已取消") {
+            QMessageBox::warning(this, "原始设备测试失败", message);
+        }
+        return;
+    }
+    
+    // 以各区域顺序读取的平均值作为读取速度
+    double totalSpeed = 0;
+    for (const ZoneResult &zone : result.zones) {
+        totalSpeed += zone.seqReadSpeed;
+    }
+    double averageSpeed = result.zones.isEmpty() ? 0 : totalSpeed / result.zones.size();
+    
+    m_readSpeedLabel->setText(QString("%1 MB/s").arg(averageSpeed, 0, 'f', 2));
+    m_writeSpeedLabel->setText("-");
+    updateChart(averageSpeed, 0);
+    
+    QString status = QString("原始设备测试完成，设备容量 %1").arg(DiskUtils::formatSize(result.deviceSize));
+    if (result.zones.size() >= 2 && result.zones.first().seqReadSpeed > 0) {
+        double falloff = (1.0 - result.zones.last().seqReadSpeed / result.zones.first().seqReadSpeed) * 100.0;
+        status += QString("，内圈相对外圈速度下降 %1%").arg(falloff, 0, 'f', 1);
+    }
+    if (!result.directIo) {
+        status += "（未能绕过系统缓存，结果仅供参考）";
+    }
+    m_testStatusLabel->setText(status);
+    
+    m_progressBar->setValue(100);
+    SpeedTestRecord record = newRecord("raw");
+    record.label = "每区域";
+    record.readMBps = averageSpeed;
+    record.parameters["deviceSize"] = result.deviceSize;
+    record.parameters["directIo"] = result.directIo;
+    QJsonArray zones;
+    for (const ZoneResult &zone : result.zones) {
+        QJsonObject zoneObject;
+        zoneObject["name"] = zone.zoneName;
+        zoneObject["startOffset"] = zone.startOffset;
+        zoneObject["seqReadSpeed"] = zone.seqReadSpeed;
+        zoneObject["randomReadIops"] = zone.randomReadIops;
+        zoneObject["avgLatencyMs"] = zone.avgLatencyMs;
+        zones.append(zoneObject);
+    }
+    record.parameters["zones"] = zones;
+    addResultToHistory(record);
+    m_exportButton->setEnabled(true);
+}
+
 void SpeedTestWidget::onCancelTestClicked() {
     if (m_tester) {
         m_tester->cancel();
         m_testStatusLabel->setText("已取消测试");
     }
+    if (m_sustainedTester) {
+        m_sustainedTester->cancel();
+        m_testStatusLabel->setText("已取消测试");
+    }
+    for (SpeedTestPanel *panel : m_panels) {
+        if (panel->isRunning()) {
+            panel->cancel();
+            m_testStatusLabel->setText("已取消测试");
+        }
+    }
+    if (m_rawTester) {
+        m_rawTester->cancel();
+        m_testStatusLabel->setText("已取消测试");
+    }
+    if (m_workloadEngine) {
+        m_workloadEngine->cancel();
+        m_testStatusLabel->setText("已取消测试");
+    }
+    if (m_benchmarkRunner) {
+        m_benchmarkRunner->cancel();
+        m_testStatusLabel->setText("已取消测试");
+    }
 }
 
-void SpeedTestWidget::onTestCompleted(double readSpeed, double writeSpeed) {
+void SpeedTestWidget::onTestCompleted(double readSpeed, double writeSpeed, const LatencyHistogram &syncLatency) {
     if (readSpeed == 0 && writeSpeed == 0) {
         m_testStatusLabel->setText("测试已取消");
         return;
@@ -436,16 +1374,49 @@ void SpeedTestWidget::onTestCompleted(double readSpeed, double writeSpeed) {
     m_writeSpeedLabel->setText(QString("%1 MB/s").arg(writeSpeed, 0, 'f', 2));
     
     updateChart(readSpeed, writeSpeed);
-    addResultToHistory(readSpeed, writeSpeed);
     
-    m_testStatusLabel->setText(QString("测试完成！读取: %1 MB/s, 写入: %2 MB/s")
+    SpeedTestRecord record = newRecord("standard");
+    record.readMBps = readSpeed;
+    record.writeMBps = writeSpeed;
+    addDurabilityParameters(record, static_cast<FioJob::Durability>(m_durabilityComboBox->currentData().toInt()),
+                            static_cast<qint64>(m_syncIntervalSpinBox->value()) * 1024 * 1024, syncLatency);
+    addResultToHistory(record);
+    
+    QString text = QString("测试完成！读取: %1 MB/s, 写入: %2 MB/s")
                        .arg(readSpeed, 0, 'f', 2)
-                       .arg(writeSpeed, 0, 'f', 2));
+                       .arg(writeSpeed, 0, 'f', 2);
+    if (syncLatency.count() > 0) {
+        text += "\n" + formatSyncLatency(syncLatency);
+    }
+    m_testStatusLabel->setText(text);
     
     m_progressBar->setValue(100);
     m_exportButton->setEnabled(true);
 }
 
+QString SpeedTestWidget::formatSyncLatency(const LatencyHistogram &latency) const {
+    return QString("刷盘 %1 次，延迟 平均 %2 ms / p99 %3 ms / 最大 %4 ms")
+        .arg(latency.count())
+        .arg(latency.meanNs() / 1e6, 0, 'f', 2)
+        .arg(latency.percentileNs(99) / 1e6, 0, 'f', 2)
+        .arg(latency.maxNs() / 1e6, 0, 'f', 2);
+}
+
+void SpeedTestWidget::addDurabilityParameters(SpeedTestRecord &record, FioJob::Durability durability,
+                                              qint64 syncIntervalBytes, const LatencyHistogram &syncLatency) const {
+    record.parameters["durability"] = FioJob::durabilityName(durability);
+    if (durability == FioJob::PeriodicSync) {
+        record.parameters["syncIntervalMB"] = syncIntervalBytes / (1024 * 1024);
+    }
+    if (syncLatency.count() > 0) {
+        record.parameters["syncCount"] = static_cast<qint64>(syncLatency.count());
+        record.parameters["syncMeanUs"] = syncLatency.meanNs() / 1000.0;
+        record.parameters["syncP99Us"] = syncLatency.percentileNs(99) / 1000.0;
+        record.parameters["syncMaxUs"] = syncLatency.maxNs() / 1000.0;
+        record.syncLatency = syncLatency;
+    }
+}
+
 void SpeedTestWidget::updateProgress(int percent, double currentSpeed, bool isRead) {
     m_progressBar->setValue(percent);
     
@@ -460,7 +1431,7 @@ void SpeedTestWidget::updateProgress(int percent, double currentSpeed, bool isRe
 }
 
 void SpeedTestWidget::onExportResultsClicked() {
-    if (m_historyTable->rowCount() == 0) {
+    if (m_testHistory.isEmpty()) {
         QMessageBox::warning(this, "警告", "没有测试结果可以导出");
         return;
     }
@@ -485,37 +1456,31 @@ void SpeedTestWidget::onExportResultsClicked() {
     QTextStream out(&file);
     out.setCodec("UTF-8");
     
+    auto optionalText = [](double value, int precision) {
+        return value < 0 ? QString() : QString::number(value, 'f', precision);
+    };
+    
     // 写入CSV头
-    out << "磁盘,型号,块大小,文件大小,读取速度(MB/s),写入速度(MB/s),测试时间\n";
-    
-    // 写入所有历史记录
-    for (int i = 0; i < m_historyTable->rowCount(); ++i) {
-        QTableWidgetItem *diskItem = m_historyTable->item(i, 0);
-        QTableWidgetItem *blockSizeItem = m_historyTable->item(i, 1);
-        QTableWidgetItem *fileSizeItem = m_historyTable->item(i, 2);
-        QTableWidgetItem *readSpeedItem = m_historyTable->item(i, 3);
-        QTableWidgetItem *writeSpeedItem = m_historyTable->item(i, 4);
-        
-        if (diskItem && blockSizeItem && fileSizeItem && readSpeedItem && writeSpeedItem) {
-            QString diskName = diskItem->text();
-            QString diskModel;
-            
-            // 尝试提取型号信息
-            int startPos = diskName.indexOf('(');
-            int endPos = diskName.indexOf(')');
-            if (startPos >= 0 && endPos > startPos) {
-                diskModel = diskName.mid(startPos + 1, endPos - startPos - 1);
-                diskName = diskName.left(startPos).trimmed();
-            }
-            
-            out << diskName << ","
-                << diskModel << ","
-                << blockSizeItem->text() << ","
-                << fileSizeItem->text() << ","
-                << readSpeedItem->text().replace(" MB/s", "") << ","
-                << writeSpeedItem->text().replace(" MB/s", "") << ","
-                << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") << "\n";
-        }
+    out << "测试时间,磁盘,型号,序列号,固件,测试类型,说明,块大小(字节),文件大小(字节),"
+           "读取速度(MB/s),写入速度(MB/s),读取IOPS,写入IOPS,读延迟p99(us),写延迟p99(us)\n";
+    
+    // 写入当前历史列表中的记录，时间为测试实际进行的时间
+    for (const SpeedTestRecord &record : m_testHistory) {
+        out << record.timestamp.toString("yyyy-MM-dd HH:mm:ss") << ","
+            << record.diskName << ","
+            << record.diskModel << ","
+            << record.diskSerial << ","
+            << record.firmware << ","
+            << record.testType << ","
+            << record.label << ","
+            << record.blockSize << ","
+            << record.fileSize << ","
+            << optionalText(record.readMBps, 2) << ","
+            << optionalText(record.writeMBps, 2) << ","
+            << optionalText(record.readIops, 0) << ","
+            << optionalText(record.writeIops, 0) << ","
+            << optionalText(record.readP99Us, 1) << ","
+            << optionalText(record.writeP99Us, 1) << "\n";
     }
     
     file.close();
@@ -564,6 +1529,31 @@ void SpeedTestWidget::createChart() {
     m_chartView->setChart(m_chart);
 }
 
+void SpeedTestWidget::createSustainedChart() {
+    QtCharts::QChart *chart = new QtCharts::QChart();
+    chart->setTitle("持续写入速度曲线");
+    chart->legend()->setVisible(false);
+    
+    m_sustainedSeries = new QtCharts::QLineSeries(chart);
+    m_sustainedSeries->setColor(QColor("#4CAF50"));
+    chart->addSeries(m_sustainedSeries);
+    
+    QtCharts::QValueAxis *axisX = new QtCharts::QValueAxis();
+    axisX->setRange(0, 10);
+    axisX->setTitleText("时间(秒)");
+    axisX->setLabelFormat("%d");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    m_sustainedSeries->attachAxis(axisX);
+    
+    QtCharts::QValueAxis *axisY = new QtCharts::QValueAxis();
+    axisY->setRange(0, 1000);
+    axisY->setTitleText("速度(MB/s)");
+    chart->addAxis(axisY, Qt::AlignLeft);
+    m_sustainedSeries->attachAxis(axisY);
+    
+    m_sustainedChartView->setChart(chart);
+}
+
 void SpeedTestWidget::updateChart(double readSpeed, double writeSpeed) {
     if (!m_chart || !m_barSeries) {
         return;
@@ -583,25 +1573,77 @@ void SpeedTestWidget::updateChart(double readSpeed, double writeSpeed) {
     }
 }
 
-void SpeedTestWidget::addResultToHistory(double readSpeed, double writeSpeed) {
-    int row = m_historyTable->rowCount();
-    m_historyTable->insertRow(row);
+SpeedTestRecord SpeedTestWidget::newRecord(const QString &testType) const {
+    SpeedTestRecord record;
+    record.timestamp = m_testStartTime.isValid() ? m_testStartTime : QDateTime::currentDateTime();
+    record.diskSerial = m_selectedDisk.serialNumber.trimmed();
+    record.diskModel = m_selectedDisk.model;
+    record.firmware = m_selectedDisk.firmwareVersion;
+    record.diskName = m_selectedDisk.diskName;
+    record.testType = testType;
+    record.blockSize = static_cast<qint64>(m_blockSizeComboBox->currentData().toInt()) * 1024;
+    record.fileSize = static_cast<qint64>(m_fileSizeComboBox->currentData().toInt()) * 1024 * 1024;
+    return record;
+}
+
+void SpeedTestWidget::addResultToHistory(const SpeedTestRecord &record) {
+    m_resultStore->submit(record);
     
-    // 设置单元格数据
-    QTableWidgetItem *diskItem = new QTableWidgetItem(QString("%1 (%2)").arg(m_selectedDisk.diskName).arg(m_selectedDisk.model));
-    QTableWidgetItem *blockSizeItem = new QTableWidgetItem(m_blockSizeComboBox->currentText());
-    QTableWidgetItem *fileSizeItem = new QTableWidgetItem(m_fileSizeComboBox->currentText());
-    QTableWidgetItem *readSpeedItem = new QTableWidgetItem(QString("%1 MB/s").arg(readSpeed, 0, 'f', 1));
-    QTableWidgetItem *writeSpeedItem = new QTableWidgetItem(QString("%1 MB/s").arg(writeSpeed, 0, 'f', 1));
+    m_testHistory.prepend(record);
+    m_historyTable->insertRow(0);
+    setHistoryRow(0, record);
+    m_historyTable->scrollToTop();
+}
+
+void SpeedTestWidget::setHistoryRow(int row, const SpeedTestRecord &record) {
+    static const QMap<QString, QString> typeNames = {
+        {"standard", "标准读写"}, {"benchmark", "重复测试"}, {"sustained", "持续写入"},
+        {"raw", "原始设备"}, {"fio", "fio作业"}, {"verify", "数据校验"},
+        {"metadata", "元数据"}, {"multidisk", "多盘并发"}, {"sweep", "参数扫描"}, {"mmap", "内存映射"},
+        {"qos", "负载下延迟"}
+    };
+    
+    // 整数单位显示为"64 KB"这样的简写，与设置中的选项一致
+    auto sizeText = [](qint64 bytes) {
+        const qint64 units[] = {1024LL * 1024 * 1024, 1024LL * 1024, 1024LL};
+        const char *names[] = {"GB", "MB", "KB"};
+        for (int i = 0; i < 3; ++i) {
+            if (bytes >= units[i] && bytes % units[i] == 0) {
+                return QString("%1 %2").arg(bytes / units[i]).arg(names[i]);
+            }
+        }
+        return DiskUtils::formatSize(bytes);
+    };
+    auto speedText = [](double speed) {
+        return speed < 0 ? QString("-") : QString("%1 MB/s").arg(speed, 0, 'f', 1);
+    };
+    
+    QString fileSizeText = record.fileSize > 0 ? sizeText(record.fileSize) : QString();
+    if (!record.label.isEmpty()) {
+        fileSizeText = fileSizeText.isEmpty() ? record.label : fileSizeText + " " + record.label;
+    }
     
-    m_historyTable->setItem(row, 0, diskItem);
-    m_historyTable->setItem(row, 1, blockSizeItem);
-    m_historyTable->setItem(row, 2, fileSizeItem);
-    m_historyTable->setItem(row, 3, readSpeedItem);
-    m_historyTable->setItem(row, 4, writeSpeedItem);
+    m_historyTable->setItem(row, 0, new QTableWidgetItem(record.timestamp.toString("yyyy-MM-dd HH:mm:ss")));
+    m_historyTable->setItem(row, 1, new QTableWidgetItem(QString("%1 (%2)").arg(record.diskName).arg(record.diskModel)));
+    m_historyTable->setItem(row, 2, new QTableWidgetItem(typeNames.value(record.testType, record.testType)));
+    m_historyTable->setItem(row, 3, new QTableWidgetItem(record.blockSize > 0 ? sizeText(record.blockSize) : QString("-")));
+    m_historyTable->setItem(row, 4, new QTableWidgetItem(fileSizeText));
+    m_historyTable->setItem(row, 5, new QTableWidgetItem(speedText(record.readMBps)));
+    m_historyTable->setItem(row, 6, new QTableWidgetItem(speedText(record.writeMBps)));
+}
+
+void SpeedTestWidget::loadHistory() {
+    // 序列号为空的磁盘无法区分，此时显示全部记录
+    QString serial = m_historyFilterCheckBox->isChecked() ? m_selectedDisk.serialNumber.trimmed() : QString();
+    m_testHistory = m_resultStore->queryRuns(serial, QDateTime(), 500);
+    
+    m_historyTable->setRowCount(m_testHistory.size());
+    for (int row = 0; row < m_testHistory.size(); ++row) {
+        setHistoryRow(row, m_testHistory[row]);
+    }
+    m_exportButton->setEnabled(!m_testHistory.isEmpty());
     
-    // 滚动到新行
-    m_historyTable->scrollToItem(diskItem);
+    qDebug() << "已加载测试历史:" << m_testHistory.size() << "条, 磁盘序列号:" << (serial.isEmpty() ? "全部" : serial);
 }
 
 void SpeedTestWidget::onBlockSizeChanged(int index) {
@@ -614,4 +1656,126 @@ void SpeedTestWidget::onFileSizeChanged(int index) {
     // 可以在这里添加一些逻辑来处理文件大小变化
 }
 
+void SpeedTestWidget::onTestModeChanged(int index) {
+    Q_UNUSED(index);
+    int mode = m_testModeComboBox->currentData().toInt();
+    bool sustained = mode == 1;
+    bool workload = mode == 3;
+    bool integrity = mode == 4;
+    bool metadata = mode == 5;
+    bool sweep = mode == 7;
+    
+    // 持续写入和数据校验使用写入总量代替文件大小；fio作业的块大小和文件大小由作业文件决定，
+    // 数据校验固定按4K块校验，元数据测试使用自己的参数，扫描模式遍历所有块大小
+    m_blockSizeComboBox->setEnabled(!workload && !integrity && !metadata && !sweep);
+    m_fileSizeComboBox->setEnabled(!sustained && !workload && !integrity && !metadata);
+    m_targetAmountSpinBox->setEnabled(sustained || integrity);
+    m_targetUnitComboBox->setEnabled(sustained || integrity);
+    if (m_targetUnitComboBox->currentData().toInt() == 0) {
+        // 数据校验允许写满整个可用空间
+        m_targetAmountSpinBox->setMaximum(integrity ? 100 : 90);
+    }
+    m_sustainedGroup->setVisible(sustained);
+    m_integrityPanel->setVisible(integrity);
+    m_metadataPanel->setVisible(metadata);
+    m_mmapPanel->setVisible(mode == 8);
+    m_qosPanel->setVisible(mode == 9);
+    m_multiDiskPanel->setVisible(mode == 6);
+    m_sweepPanel->setVisible(sweep);
+    m_rawGroup->setVisible(mode == 2);
+    m_workloadGroup->setVisible(workload);
+    m_statsGroup->setVisible(mode == 0);
+    m_warmupSpinBox->setEnabled(mode == 0);
+    m_repetitionSpinBox->setEnabled(mode == 0);
+    m_durabilityComboBox->setEnabled(mode == 0);
+    m_syncIntervalSpinBox->setEnabled(mode == 0 && m_durabilityComboBox->currentData().toInt() == FioJob::PeriodicSync);
+}
+
+void SpeedTestWidget::onTargetUnitChanged(int index) {
+    Q_UNUSED(index);
+    if (m_targetUnitComboBox->currentData().toInt() == 0) {
+        m_targetAmountSpinBox->setRange(1, m_testModeComboBox->currentData().toInt() == 4 ? 100 : 90);
+        m_targetAmountSpinBox->setValue(50);
+    } else {
+        m_targetAmountSpinBox->setRange(1, 16384);
+        m_targetAmountSpinBox->setValue(64);
+    }
+}
+
+void SpeedTestWidget::setSettingsEnabled(bool enabled) {
+    int mode = m_testModeComboBox->currentData().toInt();
+    bool sustained = mode == 1;
+    bool workload = mode == 3;
+    bool integrity = mode == 4;
+    bool metadata = mode == 5;
+    bool sweep = mode == 7;
+    
+    m_startButton->setEnabled(enabled);
+    m_cancelButton->setEnabled(!enabled);
+    m_diskComboBox->setEnabled(enabled);
+    m_blockSizeComboBox->setEnabled(enabled && !workload && !integrity && !metadata && !sweep);
+    m_fileSizeComboBox->setEnabled(enabled && !sustained && !workload && !integrity && !metadata);
+    m_testModeComboBox->setEnabled(enabled);
+    m_targetAmountSpinBox->setEnabled(enabled && (sustained || integrity));
+    m_targetUnitComboBox->setEnabled(enabled && (sustained || integrity));
+    m_warmupSpinBox->setEnabled(enabled && mode == 0);
+    m_repetitionSpinBox->setEnabled(enabled && mode == 0);
+    m_durabilityComboBox->setEnabled(enabled && mode == 0);
+    m_syncIntervalSpinBox->setEnabled(enabled && mode == 0
+                                      && m_durabilityComboBox->currentData().toInt() == FioJob::PeriodicSync);
+    m_jobEditor->setReadOnly(!enabled);
+    m_loadJobButton->setEnabled(enabled);
+    for (SpeedTestPanel *panel : m_panels) {
+        panel->setOptionsEnabled(enabled);
+    }
+}
+
+QString SpeedTestWidget::testDirectory() const {
+    // 优先使用所选磁盘的主分区，找不到时退回系统临时目录
+    if (!m_selectedDisk.volumePath.isEmpty() && QDir(m_selectedDisk.volumePath).exists()) {
+        return QDir::fromNativeSeparators(m_selectedDisk.volumePath);
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+}
+
+void SpeedTestWidget::addPanel(SpeedTestPanel *panel) {
+    m_panels.append(panel);
+    
+    connect(panel, &SpeedTestPanel::progressChanged, m_progressBar, &QProgressBar::setValue);
+    connect(panel, &SpeedTestPanel::statusChanged, m_testStatusLabel, &QLabel::setText);
+    connect(panel, &SpeedTestPanel::speedsMeasured, this, [this](double readMBps, double writeMBps) {
+        if (readMBps >= 0) {
+            m_readSpeedLabel->setText(QString("%1 MB/s").arg(readMBps, 0, 'f', 2));
+        }
+        if (writeMBps >= 0) {
+            m_writeSpeedLabel->setText(QString("%1 MB/s").arg(writeMBps, 0, 'f', 2));
+        }
+    });
+    connect(panel, &SpeedTestPanel::recordReady, this, [this](const SpeedTestRecord &record) {
+        addResultToHistory(record);
+        m_exportButton->setEnabled(true);
+    });
+    connect(panel, &SpeedTestPanel::testFinished, this, [this]() {
+        // 恢复UI状态
+        setSettingsEnabled(true);
+    });
+}
+
+void SpeedTestWidget::startPanel(SpeedTestPanel *panel) {
+    SpeedTestParameters parameters;
+    parameters.disk = m_selectedDisk;
+    parameters.testDirectory = testDirectory();
+    parameters.blockSize = static_cast<qint64>(m_blockSizeComboBox->currentData().toInt()) * 1024;
+    parameters.fileSize = static_cast<qint64>(m_fileSizeComboBox->currentData().toInt()) * 1024 * 1024;
+    parameters.targetAmount = m_targetAmountSpinBox->value();
+    parameters.targetIsPercent = m_targetUnitComboBox->currentData().toInt() == 0;
+    parameters.startTime = m_testStartTime;
+    
+    setSettingsEnabled(false);
+    m_progressBar->setValue(0);
+    if (!panel->start(parameters)) {
+        setSettingsEnabled(true);
+    }
+}
+
 #include "speedtestwidget.moc" 
\ No newline at end of file
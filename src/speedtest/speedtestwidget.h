@@ -11,29 +11,33 @@
 #include <QTableWidget>
 #include <QGroupBox>
 #include <QProgressBar>
+#include <QPlainTextEdit>
+#include <QCheckBox>
 #include <QThread>
 #include <QtCharts/QChartView>
 #include <QtCharts/QBarSeries>
 #include <QtCharts/QBarSet>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QBarCategoryAxis>
+#include <QtCharts/QLineSeries>
 #include <QDateTime>
 #include "../core/diskutils.h"
+#include "sustainedwritetester.h"
+#include "integritypanel.h"
+#include "metadatapanel.h"
+#include "mmappanel.h"
+#include "multidiskpanel.h"
+#include "qospanel.h"
+#include "sweeppanel.h"
+#include "rawdevicetester.h"
+#include "workloadengine.h"
+#include "benchmarkrunner.h"
+#include "resultstore.h"
 
 QT_CHARTS_USE_NAMESPACE
 
 class SpeedTester;
 
-// 重命名为SpeedTestHistoryItem避免冲突
-struct SpeedTestHistoryItem {
-    double readSpeed;
-    double writeSpeed;
-    QString diskName;
-    int blockSizeKB;
-    int fileSizeMB;
-    QDateTime timestamp;
-};
-
 class SpeedTestWidget : public QWidget
 {
     Q_OBJECT
@@ -49,15 +53,48 @@ private slots:
     void onExportResultsClicked();
     void onBlockSizeChanged(int index);
     void onFileSizeChanged(int index);
-    void onTestCompleted(double readSpeed, double writeSpeed);
+    void onTestCompleted(double readSpeed, double writeSpeed, const LatencyHistogram &syncLatency);
+    void onTestModeChanged(int index);
+    void onTargetUnitChanged(int index);
+    void onSustainedSampleRecorded(double elapsedSec, double speedMBps);
+    void onSustainedTestCompleted(const SustainedWriteResult &result);
+    void onRawZoneCompleted(const ZoneResult &zone);
+    void onRawTestCompleted(const RawDeviceResult &result);
+    void onLoadJobFileClicked();
+    void onWorkloadProgress(int percent, const QString &jobName, double readMBps, double writeMBps);
+    void onWorkloadJobCompleted(const WorkloadJobResult &result);
+    void onWorkloadRunCompleted(const WorkloadRunResult &result);
+    void onBenchmarkPassCompleted(int pass, bool warmup, double readSpeed, double writeSpeed);
+    void onBenchmarkCompleted(const BenchmarkResult &result);
+    void onSetBaselineClicked();
 
 private:
     void setupUI();
     void refreshDiskList();
     void createChart();
+    void createSustainedChart();
     void updateChart(double readSpeed, double writeSpeed);
-    void addResultToHistory(double readSpeed, double writeSpeed);
+    // 按当前所选磁盘和界面参数预填一条测试记录
+    SpeedTestRecord newRecord(const QString &testType) const;
+    // 保存到结果库并显示在历史列表顶部
+    void addResultToHistory(const SpeedTestRecord &record);
+    void setHistoryRow(int row, const SpeedTestRecord &record);
+    void loadHistory();
     void updateProgress(int percent, double currentSpeed, bool isRead);
+    void startSustainedTest();
+    QString formatSyncLatency(const LatencyHistogram &latency) const;
+    void addDurabilityParameters(SpeedTestRecord &record, FioJob::Durability durability, qint64 syncIntervalBytes,
+                                 const LatencyHistogram &syncLatency) const;
+    void startRawDeviceTest();
+    void startWorkloadTest();
+    void startBenchmarkTest();
+    QString formatStatistics(const QString &name, const SampleStatistics &stats, const BaselineComparison &comparison) const;
+    void setSettingsEnabled(bool enabled);
+    QString testDirectory() const;
+    // 连接模式面板的进度、状态和结果信号
+    void addPanel(SpeedTestPanel *panel);
+    // 用界面上的公共参数启动模式面板中的测试
+    void startPanel(SpeedTestPanel *panel);
 
     QVBoxLayout *m_mainLayout;
     QLabel *m_diskLabel;
@@ -68,6 +105,17 @@ private:
     
     QLabel *m_fileSizeLabel;
     QComboBox *m_fileSizeComboBox;
+
+    // 测试模式：标准读写 / 持续写入 / 原始设备 / fio作业 / 数据校验 / 元数据 / 多盘并发 / 参数扫描 / 内存映射
+    QComboBox *m_testModeComboBox;
+    QSpinBox *m_targetAmountSpinBox;
+    QComboBox *m_targetUnitComboBox;
+
+    // 标准读写的预热和重复次数
+    QSpinBox *m_warmupSpinBox;
+    QSpinBox *m_repetitionSpinBox;
+    QComboBox *m_durabilityComboBox;
+    QSpinBox *m_syncIntervalSpinBox;
     
     QPushButton *m_startButton;
     QPushButton *m_cancelButton;
@@ -82,15 +130,56 @@ private:
     QLabel *m_writeSpeedLabel;
     QChartView *m_chartView;
 
+    // 重复测试的统计结果
+    QGroupBox *m_statsGroup;
+    QLabel *m_statsLabel;
+    QPushButton *m_setBaselineButton;
+    BenchmarkResult m_lastBenchmark;
+
+    // 持续写入结果
+    QGroupBox *m_sustainedGroup;
+    QChartView *m_sustainedChartView;
+    QLineSeries *m_sustainedSeries;
+    QLabel *m_sustainedResultLabel;
+    double m_sustainedMaxSpeed;
+    double m_sustainedMaxTime;
+
+    // 各测试模式的面板，按模式显示其中一个
+    QList<SpeedTestPanel*> m_panels;
+    IntegrityPanel *m_integrityPanel;
+    MetadataPanel *m_metadataPanel;
+    MultiDiskPanel *m_multiDiskPanel;
+    SweepPanel *m_sweepPanel;
+    MmapPanel *m_mmapPanel;
+    QosPanel *m_qosPanel;
+
+    // 原始设备分区测速结果
+    QGroupBox *m_rawGroup;
+    QTableWidget *m_zoneTable;
+
+    // fio作业负载
+    QGroupBox *m_workloadGroup;
+    QPlainTextEdit *m_jobEditor;
+    QPushButton *m_loadJobButton;
+    QTableWidget *m_workloadTable;
+
     QGroupBox *m_historyGroup;
     QTableWidget *m_historyTable;
+    QCheckBox *m_historyFilterCheckBox;
 
     QList<DiskInfo> m_diskList;
     DiskInfo m_selectedDisk;
-    QList<SpeedTestHistoryItem> m_testHistory;
+    // 与历史列表逐行对应（最新的在前）
+    QList<SpeedTestRecord> m_testHistory;
+    ResultStore *m_resultStore;
+    QDateTime m_testStartTime;
     
     SpeedTester *m_tester;
     QThread *m_testerThread;
+    SustainedWriteTester *m_sustainedTester;
+    RawDeviceTester *m_rawTester;
+    WorkloadEngine *m_workloadEngine;
+    BenchmarkRunner *m_benchmarkRunner;
     bool m_testRunning;
 };
 
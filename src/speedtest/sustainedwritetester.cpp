@@ -0,0 +1,212 @@
+#include "sustainedwritetester.h"
+#include "iocore.h"
+#include "patterngenerator.h"
+
+#include <QFile>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QDebug>
+#include <QtConcurrent>
+
+namespace {
+// 采样间隔（毫秒）
+const qint64 kSampleIntervalMs = 500;
+// 单次写入的最小长度，小块写入测不出持续带宽
+const int kMinChunkSize = 1024 * 1024;
+// 拐点后速度低于拐点前的该比例才认为是缓存耗尽
+const double kKneeDropRatio = 0.75;
+}
+
+SustainedWriteTester::SustainedWriteTester(const QString &testFilePath, qint64 targetBytes, int blockSizeKB, QObject *parent)
+    : QObject(parent), m_testFilePath(testFilePath), m_canceled(0) {
+    m_chunkSize = static_cast<int>(IoFile::alignUp(qMax(blockSizeKB * 1024, kMinChunkSize)));
+    // 直接I/O要求写入长度按扇区对齐
+    m_targetBytes = IoFile::alignDown(targetBytes);
+    qRegisterMetaType<SustainedWriteResult>("SustainedWriteResult");
+}
+
+void SustainedWriteTester::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+void SustainedWriteTester::startTest() {
+    SustainedWriteResult result = runWrite();
+
+    // 无论成功与否都删除测试文件
+    if (QFile::exists(m_testFilePath) && !QFile::remove(m_testFilePath)) {
+        qDebug() << "删除持续写入测试文件失败:" << m_testFilePath;
+    }
+
+    if (!result.samples.isEmpty()) {
+        detectKnee(result.samples, result);
+    }
+
+    qDebug() << "持续写入测试结束: 写入" << result.totalBytes << "字节, 平均" << result.averageSpeed << "MB/s,"
+             << "拐点" << result.kneeDetected << "缓存估算" << result.cacheSizeBytes;
+
+    emit testCompleted(result);
+}
+
+SustainedWriteResult SustainedWriteTester::runWrite() {
+    SustainedWriteResult result;
+
+    if (m_targetBytes <= 0) {
+        result.errorMessage = "写入目标大小无效";
+        return result;
+    }
+
+    IoFile file;
+    if (!file.open(m_testFilePath, IoFile::WriteOnly | IoFile::Create | IoFile::Truncate | IoFile::Direct)) {
+        result.errorMessage = file.errorString();
+        return result;
+    }
+    if (!file.isDirect()) {
+        qDebug() << "持续写入测试未能使用直接I/O，结果会受系统缓存影响";
+    }
+
+    // 双缓冲：一个缓冲区在后台写入时填充另一个
+    AlignedBuffer buffers[2];
+    buffers[0].resize(m_chunkSize);
+    buffers[1].resize(m_chunkSize);
+    if (!buffers[0].data() || !buffers[1].data()) {
+        result.errorMessage = "分配写入缓冲区失败";
+        return result;
+    }
+
+    // 每块都是新生成的不可压缩数据，主控压缩和去重都无法让结果虚高
+    PatternGenerator pattern(QRandomGenerator::global()->generate64());
+    pattern.fill(buffers[0].data(), m_chunkSize);
+
+    qDebug() << "持续写入测试开始:" << m_testFilePath << "目标" << m_targetBytes << "字节, 单次写入" << m_chunkSize << "字节";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 offset = 0;
+    qint64 lastSampleMs = 0;
+    qint64 lastSampleBytes = 0;
+    int current = 0;
+    IoFile *filePtr = &file;
+
+    while (offset < m_targetBytes && !m_canceled.loadRelaxed()) {
+        const char *data = buffers[current].data();
+        const qint64 length = qMin<qint64>(m_chunkSize, m_targetBytes - offset);
+        const qint64 writeOffset = offset;
+
+        QFuture<qint64> pending = QtConcurrent::run([filePtr, data, length, writeOffset]() {
+            return filePtr->writeAt(data, length, writeOffset);
+        });
+
+        // 写入进行时生成下一块数据，保证数据生成不占用计时
+        pattern.fill(buffers[1 - current].data(), m_chunkSize);
+
+        qint64 written = pending.result();
+        if (written != length) {
+            result.errorMessage = written < 0 ? file.errorString() : QString("写入不完整，可能磁盘已满");
+            break;
+        }
+
+        offset += written;
+        current = 1 - current;
+
+        qint64 nowMs = timer.elapsed();
+        if (nowMs - lastSampleMs >= kSampleIntervalMs) {
+            double speed = ((offset - lastSampleBytes) / (1024.0 * 1024.0)) / ((nowMs - lastSampleMs) / 1000.0);
+            ThroughputSample sample;
+            sample.elapsedSec = nowMs / 1000.0;
+            sample.bytesWritten = offset;
+            sample.speedMBps = speed;
+            result.samples.append(sample);
+
+            emit sampleRecorded(sample.elapsedSec, speed);
+            emit progressUpdated(static_cast<int>((offset * 100) / m_targetBytes), speed);
+
+            lastSampleMs = nowMs;
+            lastSampleBytes = offset;
+        }
+    }
+
+    // 刷盘时间计入总耗时，避免系统缓存未落盘的数据虚高结果
+    file.sync();
+    qint64 totalMs = timer.elapsed();
+    file.close();
+
+    if (offset > lastSampleBytes && totalMs > lastSampleMs) {
+        ThroughputSample sample;
+        sample.elapsedSec = totalMs / 1000.0;
+        sample.bytesWritten = offset;
+        sample.speedMBps = ((offset - lastSampleBytes) / (1024.0 * 1024.0)) / ((totalMs - lastSampleMs) / 1000.0);
+        result.samples.append(sample);
+        emit sampleRecorded(sample.elapsedSec, sample.speedMBps);
+    }
+
+    result.totalBytes = offset;
+    result.elapsedSec = totalMs / 1000.0;
+    if (totalMs > 0) {
+        result.averageSpeed = (offset / (1024.0 * 1024.0)) / result.elapsedSec;
+    }
+
+    if (m_canceled.loadRelaxed()) {
+        result.errorMessage = "测试已取消";
+    } else if (result.errorMessage.isEmpty()) {
+        result.success = true;
+    }
+
+    return result;
+}
+
+bool SustainedWriteTester::detectKnee(const QList<ThroughputSample> &samples, SustainedWriteResult &result) {
+    const int n = samples.size();
+    // 每段至少要有足够的采样点，避免开头的抖动被当成拐点
+    const int minSegment = qMax(2, n / 20);
+
+    result.kneeDetected = false;
+    result.preKneeSpeed = result.averageSpeed;
+    result.postKneeSpeed = result.averageSpeed;
+    result.cacheSizeBytes = 0;
+    result.kneeTimeSec = 0;
+
+    if (n < minSegment * 2) {
+        return false;
+    }
+
+    // 前缀和，使每个候选拐点的两段均值和残差都能O(1)计算
+    QVector<double> prefix(n + 1, 0.0);
+    QVector<double> prefixSq(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) {
+        double speed = samples[i].speedMBps;
+        prefix[i + 1] = prefix[i] + speed;
+        prefixSq[i + 1] = prefixSq[i] + speed * speed;
+    }
+
+    int bestSplit = -1;
+    double bestError = 0;
+    for (int k = minSegment; k <= n - minSegment; ++k) {
+        double preSum = prefix[k];
+        double postSum = prefix[n] - prefix[k];
+        // 两段分别取均值时的残差平方和
+        double error = prefixSq[n] - (preSum * preSum) / k - (postSum * postSum) / (n - k);
+        if (bestSplit < 0 || error < bestError) {
+            bestSplit = k;
+            bestError = error;
+        }
+    }
+
+    if (bestSplit < 0) {
+        return false;
+    }
+
+    double preMean = prefix[bestSplit] / bestSplit;
+    double postMean = (prefix[n] - prefix[bestSplit]) / (n - bestSplit);
+    if (preMean <= 0 || postMean > preMean * kKneeDropRatio) {
+        return false;
+    }
+
+    result.kneeDetected = true;
+    result.preKneeSpeed = preMean;
+    result.postKneeSpeed = postMean;
+    result.cacheSizeBytes = samples[bestSplit - 1].bytesWritten;
+    result.kneeTimeSec = samples[bestSplit - 1].elapsedSec;
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef SUSTAINEDWRITETESTER_H
+#define SUSTAINEDWRITETESTER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMetaType>
+#include <QAtomicInt>
+
+// 持续写入测试的单个采样点
+struct ThroughputSample {
+    double elapsedSec;      // 采样时刻（秒，从测试开始计）
+    qint64 bytesWritten;    // 截至该时刻累计写入字节数
+    double speedMBps;       // 本采样区间内的写入速度
+};
+
+// 持续写入测试结果
+struct SustainedWriteResult {
+    bool success;
+    bool kneeDetected;      // 是否检测到缓存耗尽拐点
+    double averageSpeed;    // 全程平均速度(MB/s)
+    double preKneeSpeed;    // 拐点前（SLC缓存内）平均速度
+    double postKneeSpeed;   // 拐点后（直写TLC/QLC）平均速度
+    qint64 cacheSizeBytes;  // 估算的缓存大小（拐点前写入量）
+    double kneeTimeSec;     // 拐点出现时间
+    qint64 totalBytes;      // 实际写入字节数
+    double elapsedSec;      // 总耗时（含最后的刷盘）
+    QString errorMessage;
+    QList<ThroughputSample> samples;
+
+    SustainedWriteResult()
+        : success(false), kneeDetected(false), averageSpeed(0), preKneeSpeed(0),
+          postKneeSpeed(0), cacheSizeBytes(0), kneeTimeSec(0), totalBytes(0), elapsedSec(0) {}
+};
+
+Q_DECLARE_METATYPE(SustainedWriteResult)
+
+// 持续写入（SLC缓存耗尽）测试
+// 以直接I/O写入目标数据量，双缓冲流水线：后台写一个缓冲区的同时填充下一个，
+// 按固定间隔记录吞吐量曲线，结束后自动检测速度拐点并删除测试文件。
+class SustainedWriteTester : public QObject
+{
+    Q_OBJECT
+
+public:
+    SustainedWriteTester(const QString &testFilePath, qint64 targetBytes, int blockSizeKB, QObject *parent = nullptr);
+
+    void cancel();
+
+    // 对吞吐量曲线做两段式分段拟合，找出缓存耗尽拐点
+    // 检测成功时填写result中的拐点相关字段
+    static bool detectKnee(const QList<ThroughputSample> &samples, SustainedWriteResult &result);
+
+public slots:
+    void startTest();
+
+signals:
+    void progressUpdated(int percent, double currentSpeed);
+    void sampleRecorded(double elapsedSec, double speedMBps);
+    void testCompleted(const SustainedWriteResult &result);
+
+private:
+    SustainedWriteResult runWrite();
+
+    QString m_testFilePath;
+    qint64 m_targetBytes;
+    int m_chunkSize;
+    QAtomicInt m_canceled;
+};
+
+#endif // SUSTAINEDWRITETESTER_H
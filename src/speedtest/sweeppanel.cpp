@@ -0,0 +1,319 @@
+#include "sweeppanel.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QDir>
+#include <QDebug>
+#include <QJsonArray>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QScatterSeries>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QLogValueAxis>
+
+SweepPanel::SweepPanel(QWidget *parent) : SpeedTestPanel("块大小/队列深度扫描", parent) {
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_patternComboBox = new QComboBox(this);
+    m_patternComboBox->addItem("随机读取", "randread");
+    m_patternComboBox->addItem("随机写入", "randwrite");
+    m_patternComboBox->addItem("顺序读取", "read");
+    m_patternComboBox->addItem("顺序写入", "write");
+    m_runtimeSpinBox = new QSpinBox(this);
+    m_runtimeSpinBox->setRange(1, 30);
+    m_runtimeSpinBox->setValue(3);
+    m_runtimeSpinBox->setPrefix("每点 ");
+    m_runtimeSpinBox->setSuffix(" 秒");
+    m_maxDepthComboBox = new QComboBox(this);
+    for (int depth : {16, 32, 64, 128, 256}) {
+        m_maxDepthComboBox->addItem(QString("最大QD %1").arg(depth), depth);
+    }
+    m_maxDepthComboBox->setCurrentIndex(4);
+    m_rawCheckBox = new QCheckBox("直接读取块设备 (只读)", this);
+    m_metricComboBox = new QComboBox(this);
+    m_metricComboBox->addItem("带宽 (MB/s)", 0);
+    m_metricComboBox->addItem("IOPS", 1);
+    m_metricComboBox->addItem("平均延迟 (us)", 2);
+    m_metricComboBox->addItem("p99延迟 (us)", 3);
+
+    QHBoxLayout *optionsLayout = new QHBoxLayout();
+    optionsLayout->addWidget(m_patternComboBox);
+    optionsLayout->addWidget(m_runtimeSpinBox);
+    optionsLayout->addWidget(m_maxDepthComboBox);
+    optionsLayout->addWidget(m_rawCheckBox);
+    optionsLayout->addStretch();
+    optionsLayout->addWidget(new QLabel("显示:", this));
+    optionsLayout->addWidget(m_metricComboBox);
+
+    // 行为块大小，列为队列深度
+    m_heatmap = new HeatmapWidget(this);
+    m_heatmap->setShowValues(true);
+    m_heatmap->setLogScale(true);
+    m_heatmap->setMinimumHeight(180);
+    m_heatmap->setToolTipProvider([this](int index, double value) {
+        const int columns = m_result.ioDepths.size();
+        if (columns == 0 || index >= m_result.blockSizes.size() * columns || !qIsFinite(value)) {
+            return QString();
+        }
+        const SweepPoint &point = index < m_result.points.size() ? m_result.points[index] : SweepPoint();
+        return QString("块大小 %1, QD %2\n%3 MB/s, %4 IOPS\n延迟 平均 %5 us / p99 %6 us")
+            .arg(DiskUtils::formatSize(m_result.blockSizes[index / columns]))
+            .arg(m_result.ioDepths[index % columns])
+            .arg(point.mbps, 0, 'f', 1)
+            .arg(point.iops, 0, 'f', 0)
+            .arg(point.meanLatencyUs, 0, 'f', 1)
+            .arg(point.p99LatencyUs, 0, 'f', 1);
+    });
+
+    m_chartView = new QtCharts::QChartView(this);
+    m_chartView->setRenderHint(QPainter::Antialiasing);
+    m_chartView->setMinimumHeight(220);
+
+    m_kneeLabel = new QLabel("尚未进行扫描", this);
+    m_kneeLabel->setWordWrap(true);
+
+    layout->addLayout(optionsLayout);
+    layout->addWidget(m_heatmap);
+    layout->addWidget(m_chartView);
+    layout->addWidget(m_kneeLabel);
+
+    connect(m_metricComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SweepPanel::updateViews);
+}
+
+bool SweepPanel::start(const SpeedTestParameters &parameters) {
+    const bool raw = m_rawCheckBox->isChecked();
+    const QString rw = m_patternComboBox->currentData().toString();
+
+    FioJob job;
+    job.rw = rw;
+    job.random = rw.startsWith("rand");
+    job.readPercent = rw.endsWith("read") ? 100 : 0;
+    job.engine = FioJob::NativeAio;
+    job.direct = true;
+    job.timeBased = true;
+    job.runtimeMs = m_runtimeSpinBox->value() * 1000LL;
+    job.rampTimeMs = 500;
+
+    if (raw) {
+        if (job.hasWrites()) {
+            QMessageBox::warning(this, "错误", "直接访问块设备时只能进行读取测试");
+            return false;
+        }
+        if (parameters.disk.diskPath.isEmpty()) {
+            QMessageBox::warning(this, "错误", "所选磁盘没有可用的设备路径");
+            return false;
+        }
+        job.filename = parameters.disk.diskPath;
+    } else {
+        // 所有测试点共用一个测试文件，只铺设一次
+        job.filename = QDir(parameters.testDirectory).filePath("disktoolbox_sweep.dat");
+        job.size = parameters.fileSize;
+    }
+
+    QList<qint64> blockSizes = SweepRunner::defaultBlockSizes();
+    QList<int> ioDepths = SweepRunner::defaultIoDepths(m_maxDepthComboBox->currentData().toInt());
+
+    qDebug() << "开始块大小/队列深度扫描，目标:" << job.filename << "模式:" << rw
+             << "测试点:" << blockSizes.size() * ioDepths.size();
+
+    m_parameters = parameters;
+    emit statusChanged(QString("正在扫描 %1 个测试点，预计 %2 秒...")
+                       .arg(blockSizes.size() * ioDepths.size())
+                       .arg(blockSizes.size() * ioDepths.size() * (job.runtimeMs + job.rampTimeMs) / 1000));
+    m_kneeLabel->setText("测试进行中...");
+
+    m_result = SweepResult();
+    m_result.blockSizes = blockSizes;
+    m_result.ioDepths = ioDepths;
+    updateViews();
+
+    SweepRunner *runner = new SweepRunner(job, blockSizes, ioDepths, !raw);
+    connect(runner, &SweepRunner::progressUpdated, this, [this](int percent, const QString &status) {
+        emit progressChanged(percent);
+        emit statusChanged(QString("扫描中 - %1").arg(status));
+    });
+    connect(runner, &SweepRunner::pointCompleted, this, &SweepPanel::onPointCompleted);
+    connect(runner, &SweepRunner::runCompleted, this, &SweepPanel::onRunCompleted);
+    runWorker(runner, &SweepRunner::startRun, &SweepRunner::runCompleted);
+    return true;
+}
+
+void SweepPanel::setOptionsEnabled(bool enabled) {
+    // 显示指标在运行中也可以切换
+    m_patternComboBox->setEnabled(enabled);
+    m_runtimeSpinBox->setEnabled(enabled);
+    m_maxDepthComboBox->setEnabled(enabled);
+    m_rawCheckBox->setEnabled(enabled);
+}
+
+void SweepPanel::onPointCompleted(int index, const SweepPoint &point) {
+    if (index != m_result.points.size()) {
+        return;
+    }
+    m_result.points.append(point);
+    m_result.knees = SweepRunner::findKnees(m_result);
+    updateViews();
+}
+
+void SweepPanel::onRunCompleted(const SweepResult &result) {
+    m_result = result;
+    updateViews();
+
+    if (!result.success) {
+        emit statusChanged(result.errorMessage);
+        if (!result.canceled) {
+            QMessageBox::warning(this, "扫描失败", result.errorMessage);
+        }
+        return;
+    }
+
+    emit progressChanged(100);
+    emit statusChanged("块大小/队列深度扫描完成");
+
+    // 整个矩阵保存为一条记录，读/写速度取各测试点中的最高值
+    double bestMBps = 0;
+    double bestIops = 0;
+    QJsonArray points;
+    for (const SweepPoint &point : result.points) {
+        QJsonObject object;
+        object["blockSize"] = point.blockSize;
+        object["ioDepth"] = point.ioDepth;
+        object["mbps"] = point.mbps;
+        object["iops"] = point.iops;
+        object["meanUs"] = point.meanLatencyUs;
+        object["p99Us"] = point.p99LatencyUs;
+        points.append(object);
+        bestMBps = qMax(bestMBps, point.mbps);
+        bestIops = qMax(bestIops, point.iops);
+    }
+    QJsonArray knees;
+    for (const SweepKnee &knee : result.knees) {
+        QJsonObject object;
+        object["blockSize"] = knee.blockSize;
+        object["ioDepth"] = knee.ioDepth;
+        object["mbps"] = knee.mbps;
+        object["peakMBps"] = knee.peakMBps;
+        object["p99Us"] = knee.p99LatencyUs;
+        knees.append(object);
+    }
+
+    const QString rw = m_patternComboBox->currentData().toString();
+    SpeedTestRecord record = newRecord("sweep");
+    record.blockSize = 0;
+    record.fileSize = 0;
+    record.label = QString("%1 %2×%3").arg(rw).arg(result.blockSizes.size()).arg(result.ioDepths.size());
+    if (rw.endsWith("read")) {
+        record.readMBps = bestMBps;
+        record.readIops = bestIops;
+    } else {
+        record.writeMBps = bestMBps;
+        record.writeIops = bestIops;
+    }
+    record.parameters["rw"] = rw;
+    record.parameters["runtimeSec"] = m_runtimeSpinBox->value();
+    record.parameters["points"] = points;
+    record.parameters["knees"] = knees;
+    emit recordReady(record);
+}
+
+void SweepPanel::updateViews() {
+    const int metric = m_metricComboBox->currentData().toInt();
+    const int rows = m_result.blockSizes.size();
+    const int columns = m_result.ioDepths.size();
+
+    auto metricValue = [metric](const SweepPoint &point) {
+        switch (metric) {
+        case 1: return point.iops;
+        case 2: return point.meanLatencyUs;
+        case 3: return point.p99LatencyUs;
+        default: return point.mbps;
+        }
+    };
+
+    // 热力图：尚未运行的点无数据，失败的点标为错误
+    QVector<double> values(rows * columns, qQNaN());
+    for (int i = 0; i < m_result.points.size() && i < values.size(); ++i) {
+        const SweepPoint &point = m_result.points[i];
+        values[i] = point.success ? metricValue(point) : qInf();
+    }
+    QStringList rowLabels;
+    for (qint64 blockSize : m_result.blockSizes) {
+        rowLabels.append(DiskUtils::formatSize(blockSize));
+    }
+    QStringList columnLabels;
+    for (int depth : m_result.ioDepths) {
+        columnLabels.append(QString("QD%1").arg(depth));
+    }
+    // 带宽和IOPS越高越好，延迟越低越好
+    m_heatmap->setInverted(metric <= 1);
+    m_heatmap->setRowLabels(rowLabels);
+    m_heatmap->setColumnLabels(columnLabels);
+    m_heatmap->setData(rows, columns, values);
+
+    // 曲线：每种块大小一条，横轴为队列深度（对数刻度），拐点单独标出
+    QtCharts::QChart *chart = new QtCharts::QChart();
+    chart->setTitle(QString("%1 随队列深度的变化").arg(m_metricComboBox->currentText()));
+
+    QtCharts::QLogValueAxis *axisX = new QtCharts::QLogValueAxis();
+    axisX->setBase(2);
+    axisX->setLabelFormat("%d");
+    axisX->setTitleText("队列深度");
+    axisX->setRange(1, qMax(2, columns > 0 ? m_result.ioDepths.last() : 2));
+    chart->addAxis(axisX, Qt::AlignBottom);
+
+    QtCharts::QValueAxis *axisY = new QtCharts::QValueAxis();
+    axisY->setTitleText(m_metricComboBox->currentText());
+    chart->addAxis(axisY, Qt::AlignLeft);
+
+    double maxValue = 0;
+    for (int row = 0; row < rows; ++row) {
+        QtCharts::QLineSeries *series = new QtCharts::QLineSeries(chart);
+        series->setName(rowLabels[row]);
+        series->setPointsVisible(true);
+        for (int column = 0; column < columns; ++column) {
+            int index = row * columns + column;
+            if (index < m_result.points.size() && m_result.points[index].success) {
+                double value = metricValue(m_result.points[index]);
+                series->append(m_result.ioDepths[column], value);
+                maxValue = qMax(maxValue, value);
+            }
+        }
+        chart->addSeries(series);
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+
+    QtCharts::QScatterSeries *kneeSeries = new QtCharts::QScatterSeries(chart);
+    kneeSeries->setName("拐点");
+    kneeSeries->setMarkerSize(12);
+    kneeSeries->setColor(QColor("#F44336"));
+    QStringList kneeTexts;
+    for (const SweepKnee &knee : m_result.knees) {
+        int row = m_result.blockSizes.indexOf(knee.blockSize);
+        int column = m_result.ioDepths.indexOf(knee.ioDepth);
+        int index = row * columns + column;
+        if (row >= 0 && column >= 0 && index < m_result.points.size()) {
+            kneeSeries->append(knee.ioDepth, metricValue(m_result.points[index]));
+        }
+        kneeTexts.append(QString("%1: QD%2 达到 %3 MB/s（峰值 %4 MB/s），p99 %5 us")
+                             .arg(DiskUtils::formatSize(knee.blockSize))
+                             .arg(knee.ioDepth)
+                             .arg(knee.mbps, 0, 'f', 1)
+                             .arg(knee.peakMBps, 0, 'f', 1)
+                             .arg(knee.p99LatencyUs, 0, 'f', 0));
+    }
+    chart->addSeries(kneeSeries);
+    kneeSeries->attachAxis(axisX);
+    kneeSeries->attachAxis(axisY);
+    axisY->setRange(0, qMax(1.0, maxValue * 1.1));
+
+    QtCharts::QChart *oldChart = m_chartView->chart();
+    m_chartView->setChart(chart);
+    delete oldChart;
+
+    if (!kneeTexts.isEmpty()) {
+        m_kneeLabel->setText(QString("拐点（带宽达到峰值%1%，继续加深队列只会增加延迟）:\n%2")
+                             .arg(static_cast<int>(SweepRunner::kKneeFraction * 100))
+                             .arg(kneeTexts.join("\n")));
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef SWEEPPANEL_H
+#define SWEEPPANEL_H
+
+#include <QComboBox>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QtCharts/QChartView>
+
+#include "speedtestpanel.h"
+#include "sweeprunner.h"
+#include "../widgets/heatmapwidget.h"
+
+// 块大小×队列深度扫描模式面板
+class SweepPanel : public SpeedTestPanel
+{
+    Q_OBJECT
+
+public:
+    explicit SweepPanel(QWidget *parent = nullptr);
+
+    bool start(const SpeedTestParameters &parameters) override;
+    void setOptionsEnabled(bool enabled) override;
+
+private slots:
+    void onPointCompleted(int index, const SweepPoint &point);
+    void onRunCompleted(const SweepResult &result);
+    void updateViews();
+
+private:
+    QComboBox *m_patternComboBox;
+    QSpinBox *m_runtimeSpinBox;
+    QComboBox *m_maxDepthComboBox;
+    QCheckBox *m_rawCheckBox;
+    QComboBox *m_metricComboBox;
+    HeatmapWidget *m_heatmap;
+    QtCharts::QChartView *m_chartView;
+    QLabel *m_kneeLabel;
+    SweepResult m_result;       // 运行中逐点累积，切换指标时重绘
+};
+
+#endif // SWEEPPANEL_H
@@ -0,0 +1,150 @@
+#include "sweeprunner.h"
+
+#include <QFile>
+#include <QDebug>
+
+SweepRunner::SweepRunner(const FioJob &baseJob, const QList<qint64> &blockSizes, const QList<int> &ioDepths,
+                         bool removeTargetFile, QObject *parent)
+    : QObject(parent), m_baseJob(baseJob), m_blockSizes(blockSizes), m_ioDepths(ioDepths),
+      m_removeTargetFile(removeTargetFile), m_engine(nullptr), m_canceled(0) {
+    qRegisterMetaType<SweepPoint>("SweepPoint");
+    qRegisterMetaType<SweepResult>("SweepResult");
+}
+
+void SweepRunner::cancel() {
+    m_canceled.storeRelaxed(1);
+    // 引擎是本对象的子对象，运行期间不会被释放
+    WorkloadEngine *engine = m_engine.loadAcquire();
+    if (engine) {
+        engine->cancel();
+    }
+}
+
+QList<qint64> SweepRunner::defaultBlockSizes() {
+    return { 4096, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+}
+
+QList<int> SweepRunner::defaultIoDepths(int maxDepth) {
+    QList<int> depths;
+    for (int depth = 1; depth <= maxDepth; depth *= 2) {
+        depths.append(depth);
+    }
+    return depths;
+}
+
+SweepPoint SweepRunner::pointFromJob(const WorkloadJobResult &job) {
+    SweepPoint point;
+    point.blockSize = job.blockSize;
+    point.ioDepth = job.ioDepth;
+    point.success = job.success;
+    point.errorMessage = job.errorMessage;
+    if (!job.success) {
+        return point;
+    }
+
+    LatencyHistogram latency = job.readLatency;
+    latency.merge(job.writeLatency);
+    point.mbps = job.readMBps() + job.writeMBps();
+    point.iops = job.readIops() + job.writeIops();
+    point.meanLatencyUs = latency.meanNs() / 1000.0;
+    point.p50LatencyUs = latency.percentileNs(50) / 1000.0;
+    point.p99LatencyUs = latency.percentileNs(99) / 1000.0;
+    return point;
+}
+
+QList<SweepKnee> SweepRunner::findKnees(const SweepResult &result) {
+    QList<SweepKnee> knees;
+    const int columns = result.ioDepths.size();
+
+    for (int row = 0; row < result.blockSizes.size(); ++row) {
+        double peak = 0;
+        for (int column = 0; column < columns; ++column) {
+            int index = row * columns + column;
+            if (index < result.points.size() && result.points[index].success) {
+                peak = qMax(peak, result.points[index].mbps);
+            }
+        }
+        if (peak <= 0) {
+            continue;
+        }
+
+        // 队列深度从小到大，第一个接近峰值的点就是拐点
+        for (int column = 0; column < columns; ++column) {
+            int index = row * columns + column;
+            if (index >= result.points.size()) {
+                break;
+            }
+            const SweepPoint &point = result.points[index];
+            if (point.success && point.mbps >= peak * kKneeFraction) {
+                SweepKnee knee;
+                knee.blockSize = point.blockSize;
+                knee.ioDepth = point.ioDepth;
+                knee.mbps = point.mbps;
+                knee.peakMBps = peak;
+                knee.p99LatencyUs = point.p99LatencyUs;
+                knees.append(knee);
+                break;
+            }
+        }
+    }
+    return knees;
+}
+
+void SweepRunner::startRun() {
+    SweepResult result;
+    result.blockSizes = m_blockSizes;
+    result.ioDepths = m_ioDepths;
+
+    // 按块大小为行、队列深度为列展开成作业列表
+    QList<FioJob> jobs;
+    for (qint64 blockSize : m_blockSizes) {
+        for (int ioDepth : m_ioDepths) {
+            FioJob job = m_baseJob;
+            job.blockSize = blockSize;
+            job.ioDepth = ioDepth;
+            job.numJobs = 1;
+            job.name = QString("bs=%1K,qd=%2").arg(blockSize / 1024).arg(ioDepth);
+            jobs.append(job);
+        }
+    }
+
+    qDebug() << "块大小/队列深度扫描开始:" << m_baseJob.rw << m_baseJob.filename << "共" << jobs.size() << "个测试点";
+
+    WorkloadEngine *engine = new WorkloadEngine(jobs, QString(), this);
+    m_engine.storeRelease(engine);
+    if (m_canceled.loadRelaxed()) {
+        engine->cancel();
+    }
+
+    int completed = 0;
+    connect(engine, &WorkloadEngine::progressUpdated, this, [this](int percent, const QString &jobName, double readMBps, double writeMBps) {
+        emit progressUpdated(percent, QString("%1: %2 MB/s").arg(jobName).arg(readMBps + writeMBps, 0, 'f', 1));
+    });
+    connect(engine, &WorkloadEngine::jobCompleted, this, [this, &completed, &result](const WorkloadJobResult &job) {
+        SweepPoint point = pointFromJob(job);
+        result.points.append(point);
+        emit pointCompleted(completed++, point);
+    });
+
+    WorkloadRunResult run = engine->run();
+
+    if (m_removeTargetFile && !m_baseJob.filename.isEmpty() && QFile::exists(m_baseJob.filename)) {
+        QFile::remove(m_baseJob.filename);
+    }
+
+    result.knees = findKnees(result);
+    result.canceled = run.canceled;
+    if (run.canceled) {
+        result.errorMessage = "测试已取消";
+    } else if (!run.success) {
+        result.errorMessage = run.errorMessage;
+    } else {
+        result.success = true;
+    }
+
+    for (const SweepKnee &knee : result.knees) {
+        qDebug() << "扫描拐点: bs" << knee.blockSize << "qd" << knee.ioDepth << knee.mbps << "MB/s, 峰值" << knee.peakMBps;
+    }
+
+    emit runCompleted(result);
+}
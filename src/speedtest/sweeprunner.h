@@ -0,0 +1,102 @@
+#ifndef SWEEPRUNNER_H
+#define SWEEPRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QMetaType>
+#include <QAtomicPointer>
+
+#include "fiojob.h"
+#include "workloadengine.h"
+
+// 扫描矩阵中的一个测试点
+struct SweepPoint {
+    qint64 blockSize;
+    int ioDepth;
+    bool success;
+    double mbps;            // 读写合计带宽
+    double iops;
+    double meanLatencyUs;
+    double p50LatencyUs;
+    double p99LatencyUs;
+    QString errorMessage;
+
+    SweepPoint()
+        : blockSize(0), ioDepth(0), success(false), mbps(0), iops(0), meanLatencyUs(0), p50LatencyUs(0),
+          p99LatencyUs(0) {}
+};
+
+// 某一块大小下增加队列深度不再明显提升性能的拐点
+struct SweepKnee {
+    qint64 blockSize;
+    int ioDepth;            // 拐点队列深度
+    double mbps;            // 拐点处带宽
+    double peakMBps;        // 该块大小下的最高带宽
+    double p99LatencyUs;    // 拐点处p99延迟
+
+    SweepKnee() : blockSize(0), ioDepth(0), mbps(0), peakMBps(0), p99LatencyUs(0) {}
+};
+
+// 扫描结果，points按块大小为行、队列深度为列的行优先顺序排列
+struct SweepResult {
+    bool success;
+    bool canceled;
+    QString errorMessage;
+    QList<qint64> blockSizes;
+    QList<int> ioDepths;
+    QList<SweepPoint> points;
+    QList<SweepKnee> knees;
+
+    SweepResult() : success(false), canceled(false) {}
+};
+
+Q_DECLARE_METATYPE(SweepPoint)
+Q_DECLARE_METATYPE(SweepResult)
+
+// 块大小×队列深度扫描
+// 把整个矩阵展开成一组短时间的fio作业交给WorkloadEngine依次运行，
+// 所有作业共用同一个测试文件（只铺设一次）。
+// 每种块大小按队列深度从小到大排列，带宽首次达到该行峰值kKneeFraction的位置即为拐点，
+// 再往上加深队列只会增加延迟。
+class SweepRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 带宽达到峰值的该比例即认为已饱和
+    static constexpr double kKneeFraction = 0.9;
+
+    // baseJob提供读写模式、运行时间、引擎和目标文件，块大小和队列深度由矩阵决定
+    SweepRunner(const FioJob &baseJob, const QList<qint64> &blockSizes, const QList<int> &ioDepths,
+                bool removeTargetFile, QObject *parent = nullptr);
+
+    void cancel();
+
+    static QList<qint64> defaultBlockSizes();
+    static QList<int> defaultIoDepths(int maxDepth = 256);
+
+    // 按行找出每种块大小的拐点
+    static QList<SweepKnee> findKnees(const SweepResult &result);
+
+public slots:
+    void startRun();
+
+signals:
+    void progressUpdated(int percent, const QString &status);
+    void pointCompleted(int index, const SweepPoint &point);
+    void runCompleted(const SweepResult &result);
+
+private:
+    static SweepPoint pointFromJob(const WorkloadJobResult &job);
+
+    FioJob m_baseJob;
+    QList<qint64> m_blockSizes;
+    QList<int> m_ioDepths;
+    bool m_removeTargetFile;
+    QAtomicPointer<WorkloadEngine> m_engine;
+    QAtomicInt m_canceled;
+};
+
+#endif // SWEEPRUNNER_H
@@ -0,0 +1,863 @@
+#include "workloadengine.h"
+#include "iocore.h"
+#include "patterngenerator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutexLocker>
+#include <QDebug>
+#include <QtConcurrent>
+#include <QtMath>
+#include <vector>
+#include <cmath>
+
+#ifdef Q_OS_LINUX
+#include <linux/aio_abi.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+namespace {
+// 进度刷新/吞吐量采样间隔（毫秒）
+const int kProgressIntervalMs = 500;
+// 同步引擎模拟队列深度时，单个作业允许的最大线程数
+const int kMaxSyncThreads = 256;
+// 铺设测试文件时每次写入的大小
+const qint64 kLayoutChunk = 1024 * 1024;
+
+quint64 splitMix64(quint64 value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// 每个工作线程独立的随机数发生器(xorshift64*)
+class WorkerRandom {
+public:
+    explicit WorkerRandom(quint64 seed) : m_state(splitMix64(seed) | 1) {}
+
+    quint64 next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
+    // (0, 1]区间的均匀分布
+    double nextDouble() {
+        return ((next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    quint64 m_state;
+};
+
+// Zipf分布采样（拒绝-反演法，Hörmann & Derflinger）
+// 不需要按元素数建表，可以直接用于TB级设备的块数
+class ZipfSampler {
+public:
+    ZipfSampler(qint64 count, double exponent)
+        : m_count(qMax<qint64>(1, count)), m_exponent(exponent) {
+        m_hIntegralX1 = hIntegral(1.5) - 1.0;
+        m_hIntegralN = hIntegral(m_count + 0.5);
+        m_s = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+    }
+
+    // 返回排名[1, count]，排名越小被访问越频繁
+    qint64 sample(WorkerRandom &random) const {
+        while (true) {
+            double u = m_hIntegralN + random.nextDouble() * (m_hIntegralX1 - m_hIntegralN);
+            double x = hIntegralInverse(u);
+            qint64 k = static_cast<qint64>(x + 0.5);
+            k = qBound<qint64>(1, k, m_count);
+            if (k - x <= m_s || u >= hIntegral(k + 0.5) - h(static_cast<double>(k))) {
+                return k;
+            }
+        }
+    }
+
+private:
+    double h(double x) const { return qExp(-m_exponent * qLn(x)); }
+
+    double hIntegral(double x) const {
+        double logX = qLn(x);
+        return helper2((1.0 - m_exponent) * logX) * logX;
+    }
+
+    double hIntegralInverse(double x) const {
+        double t = x * (1.0 - m_exponent);
+        if (t < -1.0) {
+            t = -1.0;
+        }
+        return qExp(helper1(t) * x);
+    }
+
+    static double helper1(double x) {
+        return qAbs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    static double helper2(double x) {
+        return qAbs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+    }
+
+    qint64 m_count;
+    double m_exponent;
+    double m_hIntegralX1;
+    double m_hIntegralN;
+    double m_s;
+};
+
+// 按作业的分布生成块号
+class OffsetGenerator {
+public:
+    OffsetGenerator(const FioJob &job, qint64 blockCount)
+        : m_distribution(job.distribution), m_blockCount(qMax<qint64>(1, blockCount)),
+          m_seed(job.randSeed), m_zipf(m_blockCount, job.distribution == FioJob::Zipf ? job.distributionParam : 1.0),
+          m_paretoPower(0) {
+        if (job.distribution == FioJob::Pareto) {
+            // 与fio相同的参数含义：h越接近0访问越集中
+            m_paretoPower = qLn(job.distributionParam) / qLn(1.0 - job.distributionParam);
+        }
+    }
+
+    qint64 randomBlock(WorkerRandom &random) const {
+        qint64 rank = 0;
+        switch (m_distribution) {
+        case FioJob::Zipf:
+            rank = m_zipf.sample(random) - 1;
+            break;
+        case FioJob::Pareto:
+            rank = static_cast<qint64>((m_blockCount - 1) * qPow(random.nextDouble(), m_paretoPower));
+            break;
+        case FioJob::Uniform:
+        default:
+            return static_cast<qint64>(random.next() % static_cast<quint64>(m_blockCount));
+        }
+        // 热点排名打散到整个范围，避免热区都集中在文件开头
+        return static_cast<qint64>(splitMix64(static_cast<quint64>(rank) ^ m_seed) % static_cast<quint64>(m_blockCount));
+    }
+
+private:
+    FioJob::Distribution m_distribution;
+    qint64 m_blockCount;
+    quint64 m_seed;
+    ZipfSampler m_zipf;
+    double m_paretoPower;
+};
+
+#ifdef Q_OS_LINUX
+// glibc没有封装内核AIO接口，直接使用系统调用，不依赖libaio
+int aioSetup(unsigned int depth, aio_context_t *context) {
+    return static_cast<int>(syscall(SYS_io_setup, depth, context));
+}
+
+int aioDestroy(aio_context_t context) {
+    return static_cast<int>(syscall(SYS_io_destroy, context));
+}
+
+int aioSubmit(aio_context_t context, long count, struct iocb **iocbs) {
+    return static_cast<int>(syscall(SYS_io_submit, context, count, iocbs));
+}
+
+int aioGetEvents(aio_context_t context, long minCount, long maxCount, struct io_event *events, struct timespec *timeout) {
+    return static_cast<int>(syscall(SYS_io_getevents, context, minCount, maxCount, events, timeout));
+}
+
+bool nativeAioAvailable(int depth) {
+    aio_context_t context = 0;
+    if (aioSetup(static_cast<unsigned int>(depth), &context) < 0) {
+        qDebug() << "内核AIO不可用，改用多线程同步I/O:" << strerror(errno);
+        return false;
+    }
+    aioDestroy(context);
+    return true;
+}
+#endif
+}
+
+// 一个作业运行期间所有工作线程共享的状态
+struct WorkloadEngine::JobContext {
+    // numjobs中的一个实例
+    struct Instance {
+        QString path;
+        qint64 rangeStart;
+        qint64 blockCount;
+        QAtomicInteger<qint64> cursor;  // 顺序读写的下一个块号
+        QAtomicInteger<qint64> budget;  // 剩余可传输字节数（非time_based）
+
+        Instance() : rangeStart(0), blockCount(0), cursor(0), budget(0) {}
+    };
+
+    FioJob job;
+    QList<Instance*> instances;
+    QElapsedTimer timer;
+    qint64 rampNs;
+    qint64 endNs;                       // 0表示不限时
+    QAtomicInt stop;
+    QAtomicInteger<qint64> readBytes;   // 含预热阶段，只用于进度显示
+    QAtomicInteger<qint64> writeBytes;
+    QAtomicInteger<qint64> ios;
+    QMutex mutex;
+    QString errorMessage;
+
+    JobContext() : rampNs(0), endNs(0), stop(0), readBytes(0), writeBytes(0), ios(0) {}
+    ~JobContext() { qDeleteAll(instances); }
+
+    bool shouldStop() const {
+        return stop.loadRelaxed() || (endNs > 0 && timer.nsecsElapsed() >= endNs);
+    }
+
+    // 非time_based时按块领取传输额度，额度用完即结束
+    bool claimBudget(Instance *instance) {
+        if (job.timeBased) {
+            return true;
+        }
+        return instance->budget.fetchAndAddRelaxed(-job.blockSize) >= job.blockSize;
+    }
+
+    qint64 nextBlock(Instance *instance, const OffsetGenerator &generator, WorkerRandom &random) {
+        if (job.random) {
+            return generator.randomBlock(random);
+        }
+        return instance->cursor.fetchAndAddRelaxed(1) % instance->blockCount;
+    }
+
+    bool nextIsRead(WorkerRandom &random) const {
+        if (job.readPercent >= 100) {
+            return true;
+        }
+        if (job.readPercent <= 0) {
+            return false;
+        }
+        return static_cast<int>(random.next() % 100) < job.readPercent;
+    }
+
+    void fail(const QString &message) {
+        QMutexLocker locker(&mutex);
+        if (errorMessage.isEmpty()) {
+            errorMessage = message;
+        }
+        stop.storeRelaxed(1);
+    }
+};
+
+// 每个工作线程自己的统计，结束后合并，运行中不需要加锁
+struct WorkloadEngine::WorkerStats {
+    LatencyHistogram readLatency;
+    LatencyHistogram writeLatency;
+    LatencyHistogram syncLatency;
+    qint64 readBytes;
+    qint64 writeBytes;
+    qint64 readIos;
+    qint64 writeIos;
+    qint64 endNs;
+    bool directIo;
+    bool nativeAio;
+
+    WorkerStats() : readBytes(0), writeBytes(0), readIos(0), writeIos(0), endNs(0), directIo(true), nativeAio(false) {}
+
+    void record(bool isRead, qint64 bytes, qint64 latencyNs) {
+        if (isRead) {
+            readLatency.record(latencyNs);
+            readBytes += bytes;
+            ++readIos;
+        } else {
+            writeLatency.record(latencyNs);
+            writeBytes += bytes;
+            ++writeIos;
+        }
+    }
+};
+
+WorkloadEngine::WorkloadEngine(const QList<FioJob> &jobs, const QString &defaultDirectory, QObject *parent)
+    : QObject(parent), m_jobs(jobs), m_defaultDirectory(defaultDirectory), m_canceled(0) {
+    qRegisterMetaType<WorkloadJobResult>("WorkloadJobResult");
+    qRegisterMetaType<WorkloadRunResult>("WorkloadRunResult");
+}
+
+void WorkloadEngine::cancel() {
+    m_canceled.storeRelaxed(1);
+}
+
+void WorkloadEngine::startRun() {
+    WorkloadRunResult result = run();
+    emit runCompleted(result);
+}
+
+WorkloadRunResult WorkloadEngine::run() {
+    WorkloadRunResult result;
+    m_createdFiles.clear();
+
+    for (int i = 0; i < m_jobs.size(); ++i) {
+        if (m_canceled.loadRelaxed()) {
+            break;
+        }
+
+        WorkloadJobResult jobResult = runJob(m_jobs[i], i);
+        result.jobs.append(jobResult);
+        emit jobCompleted(jobResult);
+
+        if (!jobResult.success && !m_canceled.loadRelaxed()) {
+            result.errorMessage = QString("作业 %1 失败: %2").arg(jobResult.jobName).arg(jobResult.errorMessage);
+            break;
+        }
+    }
+
+    // 只删除本次自动创建的测试文件，用户指定的filename保持原样
+    for (const QString &path : m_createdFiles) {
+        QFile::remove(path);
+    }
+    m_createdFiles.clear();
+
+    result.canceled = m_canceled.loadRelaxed() != 0;
+    result.success = result.errorMessage.isEmpty() && !result.canceled;
+    return result;
+}
+
+bool WorkloadEngine::layoutFile(const QString &path, qint64 size, QString &errorMessage, const QAtomicInt *canceled) {
+    // 读测试需要文件里已有数据，不足时用随机数据补齐
+    IoFile file;
+    if (!file.open(path, IoFile::WriteOnly | IoFile::Create)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    // 铺设会覆盖原有内容，块设备上的数据不能动
+    if (file.isBlockDevice()) {
+        errorMessage = QString("为防止破坏数据，不允许在块设备上铺设测试数据: %1").arg(path);
+        return false;
+    }
+
+    qint64 existing = qMax<qint64>(0, file.size());
+    if (existing >= size) {
+        return true;
+    }
+
+    qDebug() << "铺设测试文件:" << path << "从" << existing << "到" << size;
+
+    AlignedBuffer buffer(kLayoutChunk);
+    qint64 position = existing;
+    while (position < size && !(canceled && canceled->loadRelaxed())) {
+        qint64 length = qMin(kLayoutChunk, size - position);
+        PatternGenerator::fillRandom(buffer.data(), kLayoutChunk, static_cast<quint64>(position));
+        if (file.writeAt(buffer.data(), length, position) != length) {
+            errorMessage = file.errorString();
+            return false;
+        }
+        position += length;
+    }
+
+    file.sync();
+    return !(canceled && canceled->loadRelaxed());
+}
+
+bool WorkloadEngine::prepareTarget(const FioJob &job, int instance, QString &path, qint64 &rangeStart,
+                                   qint64 &rangeLength, QString &errorMessage) {
+    bool autoNamed = job.filename.isEmpty();
+    if (autoNamed) {
+        // 与fio相同的命名方式：作业名.实例号.文件号
+        QString directory = job.directory.isEmpty() ? m_defaultDirectory : job.directory;
+        QDir().mkpath(directory);
+        path = QDir(directory).filePath(QString("%1.%2.0").arg(job.name).arg(instance));
+    } else {
+        path = job.filename;
+    }
+
+    // 先探测目标是否为块设备以及现有容量
+    // \\.\PhysicalDriveN这类设备路径QFileInfo::exists()返回false，不能据此跳过探测
+    qint64 capacity = 0;
+    bool blockDevice = false;
+    bool existed = QFileInfo::exists(path);
+    IoFile probe;
+    if (probe.open(path, IoFile::ReadOnly)) {
+        existed = true;
+        capacity = qMax<qint64>(0, probe.size());
+        blockDevice = probe.isBlockDevice();
+        probe.close();
+    } else if (existed || path.startsWith("\\\\.\\")) {
+        errorMessage = probe.errorString();
+        return false;
+    }
+
+    if (blockDevice && job.hasWrites()) {
+        errorMessage = QString("为防止破坏数据，不允许对块设备执行写入作业: %1").arg(path);
+        return false;
+    }
+
+    qint64 size = job.size;
+    if (job.sizePercent > 0) {
+        size = capacity * job.sizePercent / 100;
+    } else if (size <= 0) {
+        size = capacity - job.offset;
+    }
+
+    rangeStart = IoFile::alignDown(job.offset);
+    rangeLength = size - size % job.blockSize;
+    if (blockDevice && rangeStart + rangeLength > capacity) {
+        rangeLength = capacity - rangeStart;
+        rangeLength -= rangeLength % job.blockSize;
+    }
+
+    if (rangeLength < job.blockSize) {
+        errorMessage = QString("I/O范围小于块大小，请检查size/offset: %1").arg(path);
+        return false;
+    }
+
+    if (!blockDevice && capacity < rangeStart + rangeLength) {
+        if (!layoutFile(path, rangeStart + rangeLength, errorMessage, &m_canceled)) {
+            if (!existed) {
+                QFile::remove(path);
+            }
+            return false;
+        }
+        if (!existed && !m_createdFiles.contains(path)) {
+            m_createdFiles.append(path);
+        }
+    } else if (autoNamed && !m_createdFiles.contains(path)) {
+        m_createdFiles.append(path);
+    }
+    return true;
+}
+
+WorkloadJobResult WorkloadEngine::runJob(const FioJob &job, int jobIndex) {
+    WorkloadJobResult result;
+    result.jobName = job.name;
+    result.rw = job.rw;
+    result.blockSize = job.blockSize;
+    result.ioDepth = job.ioDepth;
+    result.numJobs = job.numJobs;
+
+    JobContext context;
+    context.job = job;
+
+    emit progressUpdated(jobIndex * 100 / m_jobs.size(), job.name + " (准备测试文件)", 0, 0);
+
+    qint64 totalBudget = 0;
+    for (int i = 0; i < job.numJobs; ++i) {
+        JobContext::Instance *instance = new JobContext::Instance();
+        context.instances.append(instance);
+
+        qint64 rangeLength = 0;
+        QString error;
+        if (!prepareTarget(job, i, instance->path, instance->rangeStart, rangeLength, error)) {
+            result.errorMessage = error;
+            return result;
+        }
+        instance->blockCount = rangeLength / job.blockSize;
+        qint64 budget = job.ioLimit > 0 ? job.ioLimit : rangeLength;
+        instance->budget.storeRelaxed(budget);
+        totalBudget += budget;
+    }
+
+    if (m_canceled.loadRelaxed()) {
+        result.errorMessage = "测试已取消";
+        return result;
+    }
+
+    // 与fio默认的invalidate=1一致：缓冲I/O作业开始前清掉测试文件的页缓存
+    if (!job.direct) {
+        for (JobContext::Instance *instance : context.instances) {
+            IoFile file;
+            if (file.open(instance->path, IoFile::ReadOnly)) {
+                file.dropCache();
+            }
+        }
+    }
+
+    bool useAio = false;
+#ifdef Q_OS_LINUX
+    useAio = job.engine == FioJob::NativeAio && nativeAioAvailable(job.ioDepth);
+#endif
+    result.nativeAio = useAio;
+
+    const int threadsPerInstance = useAio ? 1 : job.ioDepth;
+    const int totalThreads = job.numJobs * threadsPerInstance;
+    if (totalThreads > kMaxSyncThreads) {
+        result.errorMessage = QString("线程数过多（numjobs×iodepth=%1），请减小iodepth或在Linux上使用libaio引擎").arg(totalThreads);
+        return result;
+    }
+
+    context.rampNs = job.rampTimeMs * 1000000LL;
+    context.endNs = job.runtimeMs > 0 ? (job.rampTimeMs + job.runtimeMs) * 1000000LL : 0;
+
+    qDebug() << "开始运行作业:" << job.name << "rw=" << job.rw << "bs=" << job.blockSize << "iodepth=" << job.ioDepth
+             << "numjobs=" << job.numJobs << (useAio ? "内核AIO" : "同步线程");
+
+    std::vector<WorkerStats> stats(static_cast<size_t>(totalThreads));
+
+    // 独立线程池，保证每个工作线程都能同时运行
+    QThreadPool pool;
+    pool.setMaxThreadCount(totalThreads);
+
+    context.timer.start();
+    QList<QFuture<void>> workers;
+    for (int i = 0; i < job.numJobs; ++i) {
+        for (int t = 0; t < threadsPerInstance; ++t) {
+            WorkerStats *workerStats = &stats[static_cast<size_t>(i * threadsPerInstance + t)];
+            workers.append(QtConcurrent::run(&pool, [this, &context, i, t, useAio, workerStats]() {
+                if (useAio) {
+                    runAioWorker(&context, i, workerStats);
+                } else {
+                    runSyncWorker(&context, i, t, workerStats);
+                }
+            }));
+        }
+    }
+
+    qint64 lastBytes[2] = { 0, 0 };
+    qint64 lastIos = 0;
+    qint64 lastNs = 0;
+    bool running = true;
+    while (running) {
+        QThread::msleep(kProgressIntervalMs);
+
+        if (m_canceled.loadRelaxed()) {
+            context.stop.storeRelaxed(1);
+        }
+
+        running = false;
+        for (const QFuture<void> &worker : workers) {
+            if (!worker.isFinished()) {
+                running = true;
+                break;
+            }
+        }
+
+        qint64 nowNs = context.timer.nsecsElapsed();
+        qint64 readBytes = context.readBytes.loadRelaxed();
+        qint64 writeBytes = context.writeBytes.loadRelaxed();
+        qint64 ios = context.ios.loadRelaxed();
+        double intervalSec = (nowNs - lastNs) / 1e9;
+        double readMBps = intervalSec > 0 ? (readBytes - lastBytes[0]) / (1024.0 * 1024.0) / intervalSec : 0;
+        double writeMBps = intervalSec > 0 ? (writeBytes - lastBytes[1]) / (1024.0 * 1024.0) / intervalSec : 0;
+        double iops = intervalSec > 0 ? (ios - lastIos) / intervalSec : 0;
+
+        // 预热期间只显示进度，不记录曲线
+        if (lastNs >= context.rampNs) {
+            WorkloadSample sample;
+            sample.elapsedSec = (nowNs - context.rampNs) / 1e9;
+            sample.readMBps = readMBps;
+            sample.writeMBps = writeMBps;
+            sample.iops = iops;
+            result.samples.append(sample);
+        }
+
+        double fraction = 0;
+        if (context.endNs > 0) {
+            fraction = static_cast<double>(nowNs) / context.endNs;
+        }
+        if (!job.timeBased && totalBudget > 0) {
+            fraction = qMax(fraction, static_cast<double>(readBytes + writeBytes) / totalBudget);
+        }
+        int percent = static_cast<int>((jobIndex + qMin(fraction, 1.0)) * 100 / m_jobs.size());
+        emit progressUpdated(percent, job.name, readMBps, writeMBps);
+
+        lastBytes[0] = readBytes;
+        lastBytes[1] = writeBytes;
+        lastIos = ios;
+        lastNs = nowNs;
+    }
+
+    // 合并所有工作线程的统计
+    qint64 endNs = 0;
+    result.directIo = true;
+    for (const WorkerStats &workerStats : stats) {
+        result.readLatency.merge(workerStats.readLatency);
+        result.writeLatency.merge(workerStats.writeLatency);
+        result.syncLatency.merge(workerStats.syncLatency);
+        result.readBytes += workerStats.readBytes;
+        result.writeBytes += workerStats.writeBytes;
+        result.readIos += workerStats.readIos;
+        result.writeIos += workerStats.writeIos;
+        result.directIo = result.directIo && workerStats.directIo;
+        endNs = qMax(endNs, workerStats.endNs);
+    }
+    result.elapsedSec = qMax<qint64>(0, endNs - context.rampNs) / 1e9;
+
+    if (!context.errorMessage.isEmpty()) {
+        result.errorMessage = context.errorMessage;
+    } else if (m_canceled.loadRelaxed()) {
+        result.errorMessage = "测试已取消";
+    } else if (result.readIos + result.writeIos == 0) {
+        result.errorMessage = "作业在预热阶段内就已结束，没有可统计的数据，请减小ramp_time或增大size";
+    } else {
+        result.success = true;
+    }
+
+    qDebug() << "作业" << job.name << "完成: 读" << result.readMBps() << "MB/s" << result.readIops() << "IOPS, 写"
+             << result.writeMBps() << "MB/s" << result.writeIops() << "IOPS";
+    return result;
+}
+
+void WorkloadEngine::runSyncWorker(JobContext *context, int instanceIndex, int thread, WorkerStats *stats) {
+    const FioJob &job = context->job;
+    JobContext::Instance *instance = context->instances[instanceIndex];
+
+    IoFile file;
+    int flags = job.hasWrites() ? IoFile::ReadWrite : IoFile::ReadOnly;
+    if (job.direct) {
+        flags |= IoFile::Direct;
+    }
+    if (job.syncWrites) {
+        flags |= IoFile::Dsync;
+    }
+    if (!file.open(instance->path, flags)) {
+        context->fail(file.errorString());
+        stats->endNs = context->timer.nsecsElapsed();
+        return;
+    }
+    stats->directIo = !job.direct || file.isDirect();
+
+    const quint64 seed = job.randSeed + static_cast<quint64>(instanceIndex) * 1000003ULL + static_cast<quint64>(thread);
+    WorkerRandom random(seed);
+    OffsetGenerator generator(job, instance->blockCount);
+
+    // 读写使用各自的缓冲区，混合读写时读到的数据不会破坏写入数据的压缩/去重特征
+    AlignedBuffer readBuffer(job.hasReads() ? job.blockSize : 0);
+    AlignedBuffer writeBuffer(job.hasWrites() ? job.blockSize : 0);
+    PatternGenerator pattern(seed, job.bufferCompressPercent, job.dedupePercent);
+    if (job.hasWrites()) {
+        pattern.fill(writeBuffer.data(), job.blockSize);
+    }
+    quint64 writeSequence = 0;
+
+    int writesSinceSync = 0;
+    int writesSinceDataSync = 0;
+    while (!context->shouldStop() && context->claimBudget(instance)) {
+        bool isRead = context->nextIsRead(random);
+        qint64 offset = instance->rangeStart + context->nextBlock(instance, generator, random) * job.blockSize;
+
+        // 数据更新在计时之外完成，每次写入的内容都不同
+        if (!isRead) {
+            if (job.refillBuffers) {
+                pattern.fill(writeBuffer.data(), job.blockSize);
+            } else if (job.scrambleBuffers) {
+                pattern.refresh(writeBuffer.data(), job.blockSize, writeSequence++);
+            }
+        }
+
+        qint64 startNs = context->timer.nsecsElapsed();
+        qint64 transferred = isRead ? file.readAt(readBuffer.data(), job.blockSize, offset)
+                                    : file.writeAt(writeBuffer.data(), job.blockSize, offset);
+        qint64 latencyNs = context->timer.nsecsElapsed() - startNs;
+
+        if (transferred != job.blockSize) {
+            context->fail(QString("%1失败，偏移 %2: %3").arg(isRead ? "读取" : "写入").arg(offset).arg(file.errorString()));
+            break;
+        }
+
+        (isRead ? context->readBytes : context->writeBytes).fetchAndAddRelaxed(job.blockSize);
+        context->ios.fetchAndAddRelaxed(1);
+        if (startNs >= context->rampNs) {
+            stats->record(isRead, job.blockSize, latencyNs);
+        }
+
+        if (!isRead && job.fsyncInterval > 0 && ++writesSinceSync >= job.fsyncInterval) {
+            writesSinceSync = 0;
+            if (!syncFile(context, file, false, stats)) {
+                break;
+            }
+        }
+        if (!isRead && job.fdatasyncInterval > 0 && ++writesSinceDataSync >= job.fdatasyncInterval) {
+            writesSinceDataSync = 0;
+            if (!syncFile(context, file, true, stats)) {
+                break;
+            }
+        }
+    }
+
+    if (job.endFsync && job.hasWrites() && !context->stop.loadRelaxed()) {
+        syncFile(context, file, false, stats);
+    }
+    stats->endNs = context->timer.nsecsElapsed();
+}
+
+bool WorkloadEngine::syncFile(JobContext *context, IoFile &file, bool dataOnly, WorkerStats *stats) {
+    qint64 startNs = context->timer.nsecsElapsed();
+    if (!(dataOnly ? file.dataSync() : file.sync())) {
+        context->fail(QString("%1失败: %2").arg(dataOnly ? "fdatasync" : "fsync").arg(file.errorString()));
+        return false;
+    }
+    if (startNs >= context->rampNs) {
+        stats->syncLatency.record(context->timer.nsecsElapsed() - startNs);
+    }
+    return true;
+}
+
+void WorkloadEngine::runAioWorker(JobContext *context, int instanceIndex, WorkerStats *stats) {
+#ifdef Q_OS_LINUX
+    const FioJob &job = context->job;
+    JobContext::Instance *instance = context->instances[instanceIndex];
+    const int depth = job.ioDepth;
+
+    IoFile file;
+    int flags = job.hasWrites() ? IoFile::ReadWrite : IoFile::ReadOnly;
+    if (job.direct) {
+        flags |= IoFile::Direct;
+    }
+    if (job.syncWrites) {
+        flags |= IoFile::Dsync;
+    }
+    if (!file.open(instance->path, flags)) {
+        context->fail(file.errorString());
+        stats->endNs = context->timer.nsecsElapsed();
+        return;
+    }
+    stats->directIo = !job.direct || file.isDirect();
+    stats->nativeAio = true;
+
+    aio_context_t aioContext = 0;
+    if (aioSetup(static_cast<unsigned int>(depth), &aioContext) < 0) {
+        context->fail(QString("初始化内核AIO失败: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        stats->endNs = context->timer.nsecsElapsed();
+        return;
+    }
+
+    const quint64 seed = job.randSeed + static_cast<quint64>(instanceIndex) * 1000003ULL;
+    WorkerRandom random(seed);
+    OffsetGenerator generator(job, instance->blockCount);
+
+    // 每个在途请求一个槽位
+    struct Slot {
+        struct iocb control;
+        qint64 submitNs;
+        bool isRead;
+    };
+    std::vector<Slot> ioSlots(static_cast<size_t>(depth));
+    AlignedBuffer readBuffers(job.hasReads() ? job.blockSize * depth : 0);
+    AlignedBuffer writeBuffers(job.hasWrites() ? job.blockSize * depth : 0);
+    PatternGenerator pattern(seed, job.bufferCompressPercent, job.dedupePercent);
+    if (job.hasWrites()) {
+        pattern.fill(writeBuffers.data(), job.blockSize * depth);
+    }
+    quint64 writeSequence = 0;
+
+    std::vector<struct iocb*> pending;
+    pending.reserve(static_cast<size_t>(depth));
+    std::vector<struct io_event> events(static_cast<size_t>(depth));
+
+    // 为槽位准备下一个请求，返回false表示不再提交
+    auto prepare = [&](int index) -> bool {
+        if (context->shouldStop() || !context->claimBudget(instance)) {
+            return false;
+        }
+        Slot &slot = ioSlots[static_cast<size_t>(index)];
+        slot.isRead = context->nextIsRead(random);
+        char *data = (slot.isRead ? readBuffers.data() : writeBuffers.data()) + static_cast<qint64>(index) * job.blockSize;
+        // 槽位空闲时更新写入数据，提交时刻之后才开始计时
+        if (!slot.isRead) {
+            if (job.refillBuffers) {
+                pattern.fill(data, job.blockSize);
+            } else if (job.scrambleBuffers) {
+                pattern.refresh(data, job.blockSize, writeSequence++);
+            }
+        }
+        memset(&slot.control, 0, sizeof(slot.control));
+        slot.control.aio_fildes = static_cast<__u32>(file.nativeHandle());
+        slot.control.aio_lio_opcode = slot.isRead ? IOCB_CMD_PREAD : IOCB_CMD_PWRITE;
+        slot.control.aio_buf = reinterpret_cast<__u64>(data);
+        slot.control.aio_nbytes = static_cast<__u64>(job.blockSize);
+        slot.control.aio_offset = instance->rangeStart + context->nextBlock(instance, generator, random) * job.blockSize;
+        slot.control.aio_data = static_cast<__u64>(index);
+        pending.push_back(&slot.control);
+        return true;
+    };
+
+    int inflight = 0;
+    auto submitPending = [&]() {
+        size_t done = 0;
+        while (done < pending.size()) {
+            qint64 now = context->timer.nsecsElapsed();
+            for (size_t i = done; i < pending.size(); ++i) {
+                ioSlots[static_cast<size_t>(pending[i]->aio_data)].submitNs = now;
+            }
+            int submitted = aioSubmit(aioContext, static_cast<long>(pending.size() - done), pending.data() + done);
+            if (submitted < 0) {
+                if (errno == EAGAIN || errno == EINTR) {
+                    continue;
+                }
+                context->fail(QString("提交异步I/O失败: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+                break;
+            }
+            inflight += submitted;
+            done += static_cast<size_t>(submitted);
+        }
+        pending.clear();
+    };
+
+    for (int i = 0; i < depth; ++i) {
+        if (!prepare(i)) {
+            break;
+        }
+    }
+    submitPending();
+
+    int writesSinceSync = 0;
+    int writesSinceDataSync = 0;
+    while (inflight > 0) {
+        struct timespec timeout = { 0, 100 * 1000000L };
+        int count = aioGetEvents(aioContext, 1, depth, events.data(), &timeout);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            context->fail(QString("等待异步I/O完成失败: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+            break;
+        }
+
+        qint64 nowNs = context->timer.nsecsElapsed();
+        for (int e = 0; e < count; ++e) {
+            int index = static_cast<int>(events[static_cast<size_t>(e)].data);
+            Slot &slot = ioSlots[static_cast<size_t>(index)];
+            --inflight;
+
+            qint64 res = static_cast<qint64>(events[static_cast<size_t>(e)].res);
+            if (res != job.blockSize) {
+                QString reason = res < 0 ? QString::fromLocal8Bit(strerror(static_cast<int>(-res))) : QString("传输长度不足");
+                context->fail(QString("%1失败，偏移 %2: %3").arg(slot.isRead ? "读取" : "写入")
+                              .arg(static_cast<qint64>(slot.control.aio_offset)).arg(reason));
+                continue;
+            }
+
+            (slot.isRead ? context->readBytes : context->writeBytes).fetchAndAddRelaxed(job.blockSize);
+            context->ios.fetchAndAddRelaxed(1);
+            if (slot.submitNs >= context->rampNs) {
+                stats->record(slot.isRead, job.blockSize, nowNs - slot.submitNs);
+            }
+            // 同步只等待已完成的写入，与fio的行为一致
+            if (!slot.isRead && job.fsyncInterval > 0 && ++writesSinceSync >= job.fsyncInterval) {
+                writesSinceSync = 0;
+                if (!syncFile(context, file, false, stats)) {
+                    continue;
+                }
+            }
+            if (!slot.isRead && job.fdatasyncInterval > 0 && ++writesSinceDataSync >= job.fdatasyncInterval) {
+                writesSinceDataSync = 0;
+                if (!syncFile(context, file, true, stats)) {
+                    continue;
+                }
+            }
+
+            prepare(index);
+        }
+        submitPending();
+    }
+
+    // 出错退出时可能还有在途请求，销毁上下文会等待它们结束
+    aioDestroy(aioContext);
+
+    if (job.endFsync && job.hasWrites() && !context->stop.loadRelaxed()) {
+        syncFile(context, file, false, stats);
+    }
+    stats->endNs = context->timer.nsecsElapsed();
+#else
+    // 其他平台不会选择这条路径，保留同步实现兜底
+    runSyncWorker(context, instanceIndex, 0, stats);
+#endif
+}
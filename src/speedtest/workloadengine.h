@@ -0,0 +1,119 @@
+#ifndef WORKLOADENGINE_H
+#define WORKLOADENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMetaType>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include "fiojob.h"
+#include "latencyhistogram.h"
+
+class IoFile;
+
+// 作业运行中的吞吐量采样（预热结束后开始记录）
+struct WorkloadSample {
+    double elapsedSec;      // 从统计开始计的时间
+    double readMBps;
+    double writeMBps;
+    double iops;
+};
+
+// 单个fio作业的运行结果（numjobs个实例合并统计）
+struct WorkloadJobResult {
+    bool success;
+    QString jobName;
+    QString rw;
+    qint64 blockSize;
+    int ioDepth;
+    int numJobs;
+    bool directIo;          // 是否实际以直接I/O运行
+    bool nativeAio;         // 是否使用了内核异步I/O
+    qint64 readBytes;       // 以下统计均不含预热阶段
+    qint64 writeBytes;
+    qint64 readIos;
+    qint64 writeIos;
+    double elapsedSec;      // 统计时长
+    LatencyHistogram readLatency;
+    LatencyHistogram writeLatency;
+    LatencyHistogram syncLatency;   // fsync/fdatasync（含结束时的同步）耗时
+    QList<WorkloadSample> samples;
+    QString errorMessage;
+
+    WorkloadJobResult()
+        : success(false), blockSize(0), ioDepth(0), numJobs(0), directIo(false), nativeAio(false),
+          readBytes(0), writeBytes(0), readIos(0), writeIos(0), elapsedSec(0) {}
+
+    double readMBps() const { return elapsedSec > 0 ? readBytes / (1024.0 * 1024.0) / elapsedSec : 0; }
+    double writeMBps() const { return elapsedSec > 0 ? writeBytes / (1024.0 * 1024.0) / elapsedSec : 0; }
+    double readIops() const { return elapsedSec > 0 ? readIos / elapsedSec : 0; }
+    double writeIops() const { return elapsedSec > 0 ? writeIos / elapsedSec : 0; }
+};
+
+Q_DECLARE_METATYPE(WorkloadJobResult)
+
+// 整个作业文件的运行结果
+struct WorkloadRunResult {
+    bool success;
+    bool canceled;
+    QString errorMessage;
+    QList<WorkloadJobResult> jobs;
+
+    WorkloadRunResult() : success(false), canceled(false) {}
+};
+
+Q_DECLARE_METATYPE(WorkloadRunResult)
+
+// fio作业驱动的负载引擎
+// 作业按顺序执行（相当于每个作业都带stonewall），每个作业启动numjobs个实例：
+// libaio引擎在Linux上用一个线程通过内核AIO维持iodepth个在途请求，
+// sync引擎或其他平台用iodepth个线程各自同步读写来模拟队列深度。
+// 所有读写都通过IoFile完成，与速度测试的其他模式一致。
+class WorkloadEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    // defaultDirectory：作业未指定filename/directory时创建测试文件的目录
+    WorkloadEngine(const QList<FioJob> &jobs, const QString &defaultDirectory, QObject *parent = nullptr);
+
+    void cancel();
+
+    // 同步运行所有作业（CLI等不需要线程的场景直接调用）
+    WorkloadRunResult run();
+
+    // 创建/补齐测试文件到指定大小（随机数据），canceled置位时中止并返回false
+    static bool layoutFile(const QString &path, qint64 size, QString &errorMessage, const QAtomicInt *canceled = nullptr);
+
+public slots:
+    void startRun();
+
+signals:
+    // percent为整个作业文件的进度
+    void progressUpdated(int percent, const QString &jobName, double readMBps, double writeMBps);
+    void jobCompleted(const WorkloadJobResult &result);
+    void runCompleted(const WorkloadRunResult &result);
+
+private:
+    struct JobContext;
+    struct WorkerStats;
+
+    WorkloadJobResult runJob(const FioJob &job, int jobIndex);
+    bool prepareTarget(const FioJob &job, int instance, QString &path, qint64 &rangeStart,
+                       qint64 &rangeLength, QString &errorMessage);
+    void runSyncWorker(JobContext *context, int instance, int thread, WorkerStats *stats);
+    void runAioWorker(JobContext *context, int instance, WorkerStats *stats);
+    // 执行一次fsync/fdatasync并记录耗时，失败时终止作业
+    bool syncFile(JobContext *context, IoFile &file, bool dataOnly, WorkerStats *stats);
+
+    QList<FioJob> m_jobs;
+    QString m_defaultDirectory;
+    QStringList m_createdFiles;
+    QAtomicInt m_canceled;
+};
+
+#endif // WORKLOADENGINE_H
@@ -0,0 +1,161 @@
+#include "surfacescanmap.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+
+namespace {
+const quint32 kMapMagic = 0x4454534D;   // "DTSM"
+const quint16 kMapVersion = 1;
+}
+
+SurfaceScanMap::SurfaceScanMap()
+    : m_deviceSize(0), m_regionSize(0), m_regionCount(0), m_chunkSize(0),
+      m_scannedCount(0), m_createdTime(0), m_updatedTime(0) {
+}
+
+void SurfaceScanMap::reset(qint64 deviceSize, int chunkSize, int targetRegions) {
+    m_deviceSize = deviceSize;
+    m_chunkSize = chunkSize;
+
+    // 区域大小取整到块大小的整数倍，保证每个区域由完整的块组成
+    qint64 regionSize = (deviceSize + targetRegions - 1) / targetRegions;
+    regionSize = ((regionSize + chunkSize - 1) / chunkSize) * chunkSize;
+    m_regionSize = qMax<qint64>(regionSize, chunkSize);
+    m_regionCount = static_cast<int>((deviceSize + m_regionSize - 1) / m_regionSize);
+
+    m_records.fill(RegionRecord(), m_regionCount);
+    m_scannedCount = 0;
+    m_createdTime = QDateTime::currentMSecsSinceEpoch();
+    m_updatedTime = m_createdTime;
+}
+
+bool SurfaceScanMap::load(const QString &filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != kMapMagic || version != kMapVersion) {
+        qDebug() << "表面扫描结果文件格式不匹配:" << filePath;
+        return false;
+    }
+
+    qint64 deviceSize = 0;
+    qint64 regionSize = 0;
+    qint32 regionCount = 0;
+    qint32 chunkSize = 0;
+    qint64 createdTime = 0;
+    qint64 updatedTime = 0;
+    in >> deviceSize >> regionSize >> regionCount >> chunkSize >> createdTime >> updatedTime;
+
+    if (in.status() != QDataStream::Ok || regionCount <= 0 || regionSize <= 0
+        || static_cast<qint64>(regionCount) * regionSize < deviceSize) {
+        qDebug() << "表面扫描结果文件头损坏:" << filePath;
+        return false;
+    }
+
+    QVector<RegionRecord> records(regionCount);
+    int scanned = 0;
+    for (int i = 0; i < regionCount; ++i) {
+        in >> records[i].avgLatency >> records[i].maxLatency;
+        if (records[i].maxLatency != 0) {
+            ++scanned;
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "表面扫描结果文件不完整:" << filePath;
+        return false;
+    }
+
+    m_deviceSize = deviceSize;
+    m_regionSize = regionSize;
+    m_regionCount = regionCount;
+    m_chunkSize = chunkSize;
+    m_createdTime = createdTime;
+    m_updatedTime = updatedTime;
+    m_records = records;
+    m_scannedCount = scanned;
+    return true;
+}
+
+bool SurfaceScanMap::save(const QString &filePath) const {
+    // 先写临时文件再替换，扫描中途断电也不会留下损坏的检查点
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "无法写入表面扫描结果文件:" << filePath << file.errorString();
+        return false;
+    }
+
+    m_updatedTime = QDateTime::currentMSecsSinceEpoch();
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << kMapMagic << kMapVersion
+        << m_deviceSize << m_regionSize << static_cast<qint32>(m_regionCount) << static_cast<qint32>(m_chunkSize)
+        << m_createdTime << m_updatedTime;
+
+    for (const RegionRecord &record : m_records) {
+        out << record.avgLatency << record.maxLatency;
+    }
+
+    return file.commit();
+}
+
+bool SurfaceScanMap::isCompatible(qint64 deviceSize, int chunkSize) const {
+    return isValid() && m_deviceSize == deviceSize && m_chunkSize == chunkSize;
+}
+
+qint64 SurfaceScanMap::regionLength(int region) const {
+    qint64 offset = regionOffset(region);
+    return qMin(m_regionSize, m_deviceSize - offset);
+}
+
+void SurfaceScanMap::setRecord(int region, const RegionRecord &record) {
+    if (region < 0 || region >= m_regionCount) {
+        return;
+    }
+
+    bool wasScanned = isScanned(region);
+    m_records[region] = record;
+    if (!wasScanned && record.maxLatency != 0) {
+        ++m_scannedCount;
+    } else if (wasScanned && record.maxLatency == 0) {
+        --m_scannedCount;
+    }
+}
+
+qint64 SurfaceScanMap::scannedBytes() const {
+    qint64 total = 0;
+    for (int i = 0; i < m_regionCount; ++i) {
+        if (isScanned(i)) {
+            total += regionLength(i);
+        }
+    }
+    return total;
+}
+
+quint16 SurfaceScanMap::encodeLatency(qint64 latencyNs) {
+    qint64 units = latencyNs / (kLatencyUnitUs * 1000);
+    // 0保留给“未扫描”，极快的读取也至少记为1
+    if (units < 1) {
+        return 1;
+    }
+    if (units >= kLatencySaturated) {
+        return kLatencySaturated;
+    }
+    return static_cast<quint16>(units);
+}
+
+double SurfaceScanMap::decodeLatencyMs(quint16 value) {
+    return value * kLatencyUnitUs / 1000.0;
+}
@@ -0,0 +1,75 @@
+#ifndef SURFACESCANMAP_H
+#define SURFACESCANMAP_H
+
+#include <QString>
+#include <QVector>
+#include <QMetaType>
+
+// 单个LBA区域的扫描记录，每条4字节
+// 延迟以10微秒为单位保存，超出范围时饱和为kLatencySaturated
+struct RegionRecord {
+    quint16 avgLatency;     // 区域内各块读取的平均延迟
+    quint16 maxLatency;     // 区域内最慢一次读取的延迟，0表示尚未扫描
+
+    RegionRecord() : avgLatency(0), maxLatency(0) {}
+};
+
+// 表面扫描结果图
+// 记录每个区域的读取延迟，同时作为断点续扫的检查点保存在磁盘上。
+// 4TB磁盘约6.5万个区域，整个文件约256KB。
+class SurfaceScanMap
+{
+public:
+    static constexpr quint16 kLatencySaturated = 0xFFFE;  // 延迟超过约655毫秒
+    static constexpr quint16 kLatencyError = 0xFFFF;      // 区域内出现读取错误
+    static constexpr int kLatencyUnitUs = 10;
+
+    SurfaceScanMap();
+
+    // 按设备容量和目标区域数初始化空白结果图，区域大小按chunkSize对齐
+    void reset(qint64 deviceSize, int chunkSize, int targetRegions);
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+
+    bool isValid() const { return m_regionCount > 0; }
+
+    // 设备容量和区域划分一致时才能续扫
+    bool isCompatible(qint64 deviceSize, int chunkSize) const;
+
+    qint64 deviceSize() const { return m_deviceSize; }
+    qint64 regionSize() const { return m_regionSize; }
+    int regionCount() const { return m_regionCount; }
+    int chunkSize() const { return m_chunkSize; }
+
+    qint64 regionOffset(int region) const { return region * m_regionSize; }
+    qint64 regionLength(int region) const;
+
+    const RegionRecord &record(int region) const { return m_records[region]; }
+    void setRecord(int region, const RegionRecord &record);
+
+    bool isScanned(int region) const { return m_records[region].maxLatency != 0; }
+    int scannedCount() const { return m_scannedCount; }
+    qint64 scannedBytes() const;
+
+    // 延迟编码/解码（毫秒）
+    static quint16 encodeLatency(qint64 latencyNs);
+    static double decodeLatencyMs(quint16 value);
+
+    qint64 createdTime() const { return m_createdTime; }
+    qint64 updatedTime() const { return m_updatedTime; }
+
+private:
+    qint64 m_deviceSize;
+    qint64 m_regionSize;
+    int m_regionCount;
+    int m_chunkSize;
+    int m_scannedCount;
+    qint64 m_createdTime;
+    mutable qint64 m_updatedTime;
+    QVector<RegionRecord> m_records;
+};
+
+Q_DECLARE_METATYPE(SurfaceScanMap)
+
+#endif // SURFACESCANMAP_H
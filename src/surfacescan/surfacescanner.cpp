@@ -0,0 +1,226 @@
+#include "surfacescanner.h"
+#include "../speedtest/iocore.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutexLocker>
+#include <QDebug>
+#include <QtConcurrent>
+
+namespace {
+// 进度刷新间隔和检查点保存间隔（毫秒）
+const int kProgressIntervalMs = 500;
+const qint64 kCheckpointIntervalMs = 5000;
+}
+
+SurfaceScanner::SurfaceScanner(const SurfaceScanConfig &config, QObject *parent)
+    : QObject(parent), m_config(config), m_nextRegion(0), m_stopped(0), m_bytesRead(0), m_throttleBytes(0) {
+    m_chunkSize = static_cast<int>(IoFile::alignUp(qMax(config.chunkSizeKB, 4) * 1024));
+    m_config.streamCount = qBound(1, config.streamCount, 16);
+    qRegisterMetaType<SurfaceScanMap>("SurfaceScanMap");
+}
+
+void SurfaceScanner::stop() {
+    m_stopped.storeRelaxed(1);
+}
+
+void SurfaceScanner::startScan() {
+    // 先探测设备容量，决定区域划分
+    IoFile probe;
+    if (!probe.open(m_config.devicePath, IoFile::ReadOnly | IoFile::Direct)) {
+        emit scanFinished(false, probe.errorString() + "\n读取物理磁盘需要管理员/root权限");
+        return;
+    }
+    qint64 deviceSize = probe.size();
+    probe.close();
+
+    if (deviceSize <= 0) {
+        emit scanFinished(false, QString("无法获取设备容量: %1").arg(m_config.devicePath));
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(m_config.mapFilePath).absolutePath());
+
+    bool resumed = false;
+    if (m_config.resume && m_map.load(m_config.mapFilePath) && m_map.isCompatible(deviceSize, m_chunkSize)) {
+        resumed = true;
+        qDebug() << "从检查点继续表面扫描，已完成区域:" << m_map.scannedCount() << "/" << m_map.regionCount();
+    } else {
+        m_map.reset(deviceSize, m_chunkSize, kTargetRegions);
+        qDebug() << "开始新的表面扫描，设备容量:" << deviceSize << "区域数:" << m_map.regionCount()
+                 << "区域大小:" << m_map.regionSize();
+    }
+
+    const qint64 previousBytes = m_map.scannedBytes();
+    emit mapUpdated(m_map);
+
+    m_nextRegion = 0;
+    m_rateTimer.start();
+
+    // 独立线程池，保证每个读取流都有自己的线程
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_config.streamCount);
+
+    QList<QFuture<void>> streams;
+    for (int i = 0; i < m_config.streamCount; ++i) {
+        streams.append(QtConcurrent::run(&pool, [this, i]() {
+            scanStream(i);
+        }));
+    }
+
+    QElapsedTimer checkpointTimer;
+    checkpointTimer.start();
+    qint64 lastBytes = 0;
+    qint64 lastMs = 0;
+
+    bool running = true;
+    while (running) {
+        QThread::msleep(kProgressIntervalMs);
+
+        running = false;
+        for (const QFuture<void> &stream : streams) {
+            if (!stream.isFinished()) {
+                running = true;
+                break;
+            }
+        }
+
+        qint64 bytes = m_bytesRead.loadRelaxed();
+        qint64 nowMs = m_rateTimer.elapsed();
+        double speed = nowMs > lastMs ? ((bytes - lastBytes) / (1024.0 * 1024.0)) / ((nowMs - lastMs) / 1000.0) : 0;
+        lastBytes = bytes;
+        lastMs = nowMs;
+
+        SurfaceScanMap current = snapshot();
+        emit progressUpdated(previousBytes + bytes, deviceSize, speed);
+        emit mapUpdated(current);
+
+        if (checkpointTimer.elapsed() >= kCheckpointIntervalMs) {
+            current.save(m_config.mapFilePath);
+            checkpointTimer.restart();
+        }
+    }
+
+    SurfaceScanMap finalMap = snapshot();
+    finalMap.save(m_config.mapFilePath);
+    emit mapUpdated(finalMap);
+
+    bool completed = finalMap.scannedCount() == finalMap.regionCount();
+    QString message;
+    if (!m_streamError.isEmpty()) {
+        message = m_streamError;
+    } else if (completed) {
+        message = resumed ? QString("续扫完成") : QString("扫描完成");
+    } else {
+        message = QString("扫描已暂停，已完成 %1/%2 个区域，可稍后继续")
+                      .arg(finalMap.scannedCount()).arg(finalMap.regionCount());
+    }
+
+    qDebug() << "表面扫描结束:" << message;
+    emit scanFinished(completed, message);
+}
+
+void SurfaceScanner::scanStream(int streamIndex) {
+    if (m_config.lowPriority) {
+        IoFile::setThreadBackgroundIo(true);
+    }
+
+    // 每个读取流使用独立句柄，互不争用文件偏移
+    IoFile device;
+    if (!device.open(m_config.devicePath, IoFile::ReadOnly | IoFile::Direct)) {
+        QMutexLocker locker(&m_mutex);
+        m_streamError = device.errorString();
+        m_stopped.storeRelaxed(1);
+    } else {
+        AlignedBuffer buffer(m_chunkSize);
+        int region = -1;
+
+        while (!m_stopped.loadRelaxed() && claimRegion(region)) {
+            const qint64 regionStart = m_map.regionOffset(region);
+            const qint64 regionLength = m_map.regionLength(region);
+
+            qint64 totalNs = 0;
+            qint64 maxNs = 0;
+            int reads = 0;
+            bool readError = false;
+            qint64 pos = 0;
+
+            while (pos < regionLength && !m_stopped.loadRelaxed()) {
+                qint64 length = IoFile::alignDown(qMin<qint64>(m_chunkSize, regionLength - pos));
+                if (length <= 0) {
+                    // 设备末尾不足一个对齐单位的部分直接跳过
+                    pos = regionLength;
+                    break;
+                }
+
+                QElapsedTimer timer;
+                timer.start();
+                qint64 read = device.readAt(buffer.data(), length, regionStart + pos);
+                qint64 elapsedNs = timer.nsecsElapsed();
+
+                if (read != length) {
+                    readError = true;
+                    qDebug() << "表面扫描读取错误，流" << streamIndex << "偏移" << (regionStart + pos) << device.errorString();
+                }
+
+                totalNs += elapsedNs;
+                maxNs = qMax(maxNs, elapsedNs);
+                ++reads;
+                pos += length;
+
+                m_bytesRead.fetchAndAddRelaxed(length);
+                throttle(length);
+            }
+
+            // 中途停止的区域不记录，续扫时重新读取
+            if (pos < regionLength) {
+                break;
+            }
+
+            RegionRecord record;
+            record.avgLatency = SurfaceScanMap::encodeLatency(reads > 0 ? totalNs / reads : 0);
+            record.maxLatency = readError ? SurfaceScanMap::kLatencyError : SurfaceScanMap::encodeLatency(maxNs);
+
+            QMutexLocker locker(&m_mutex);
+            m_map.setRecord(region, record);
+        }
+    }
+
+    if (m_config.lowPriority) {
+        IoFile::setThreadBackgroundIo(false);
+    }
+}
+
+bool SurfaceScanner::claimRegion(int &region) {
+    QMutexLocker locker(&m_mutex);
+    // 跳过检查点中已经完成的区域
+    while (m_nextRegion < m_map.regionCount() && m_map.isScanned(m_nextRegion)) {
+        ++m_nextRegion;
+    }
+    if (m_nextRegion >= m_map.regionCount()) {
+        return false;
+    }
+    region = m_nextRegion++;
+    return true;
+}
+
+void SurfaceScanner::throttle(qint64 bytes) {
+    if (m_config.maxRateMBps <= 0) {
+        return;
+    }
+
+    // 所有读取流共用一个速率上限：读得比预期快时休眠到预期时间
+    qint64 total = m_throttleBytes.fetchAndAddRelaxed(bytes) + bytes;
+    qint64 expectedMs = total * 1000 / (static_cast<qint64>(m_config.maxRateMBps) * 1024 * 1024);
+    qint64 aheadMs = expectedMs - m_rateTimer.elapsed();
+    if (aheadMs > 0) {
+        QThread::msleep(static_cast<unsigned long>(aheadMs));
+    }
+}
+
+SurfaceScanMap SurfaceScanner::snapshot() {
+    QMutexLocker locker(&m_mutex);
+    return m_map;
+}
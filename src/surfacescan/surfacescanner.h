@@ -0,0 +1,70 @@
+#ifndef SURFACESCANNER_H
+#define SURFACESCANNER_H
+
+#include <QObject>
+#include <QString>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+
+#include "surfacescanmap.h"
+
+// 表面扫描参数
+struct SurfaceScanConfig {
+    QString devicePath;     // 物理磁盘路径
+    QString mapFilePath;    // 结果图/检查点文件
+    int chunkSizeKB;        // 单次读取大小
+    int streamCount;        // 并行读取流数量
+    int maxRateMBps;        // 总读取速率上限，0表示不限速
+    bool lowPriority;       // 是否以后台I/O优先级运行
+    bool resume;            // 存在兼容的检查点时是否续扫
+
+    SurfaceScanConfig()
+        : chunkSizeKB(1024), streamCount(2), maxRateMBps(0), lowPriority(true), resume(true) {}
+};
+
+// 全盘表面扫描
+// 以只读方式顺序读取整个设备，按LBA区域记录读取延迟。多个读取流从共享的区域队列
+// 中领取区域，扫描过程中定期保存检查点，中断后可以从未完成的区域继续。
+class SurfaceScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 结果图的目标区域数，区域越多热力图越细
+    static const int kTargetRegions = 65536;
+
+    explicit SurfaceScanner(const SurfaceScanConfig &config, QObject *parent = nullptr);
+
+    void stop();
+
+public slots:
+    void startScan();
+
+signals:
+    void progressUpdated(qint64 scannedBytes, qint64 totalBytes, double speedMBps);
+    void mapUpdated(const SurfaceScanMap &map);
+    void scanFinished(bool completed, const QString &message);
+
+private:
+    void scanStream(int streamIndex);
+    bool claimRegion(int &region);
+    void throttle(qint64 bytes);
+    SurfaceScanMap snapshot();
+
+    SurfaceScanConfig m_config;
+    int m_chunkSize;
+
+    QMutex m_mutex;             // 保护m_map和m_nextRegion
+    SurfaceScanMap m_map;
+    int m_nextRegion;
+
+    QAtomicInt m_stopped;
+    QAtomicInteger<qint64> m_bytesRead;     // 本次运行读取的字节数
+    QAtomicInteger<qint64> m_throttleBytes;
+    QElapsedTimer m_rateTimer;
+    QString m_streamError;
+};
+
+#endif // SURFACESCANNER_H
@@ -0,0 +1,418 @@
+#include "surfacescanwidget.h"
+#include "../core/diskinventory.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QStandardPaths>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// 热力图每行显示的区域数
+const int kHeatmapColumns = 256;
+// 最大延迟超过中位数的该倍数视为慢区域
+const double kSlowFactor = 10.0;
+// 慢区域的最低阈值，避免SSD上的微小抖动被标记
+const double kMinSlowThresholdMs = 20.0;
+// 慢区域列表最多显示的条数
+const int kMaxSlowRegions = 50;
+}
+
+SurfaceScanWidget::SurfaceScanWidget(QWidget *parent)
+    : QWidget(parent), m_scanner(nullptr), m_scannerThread(nullptr) {
+    setupUI();
+    refreshDiskList();
+}
+
+SurfaceScanWidget::~SurfaceScanWidget() {
+    if (m_scannerThread) {
+        if (m_scanner) {
+            m_scanner->stop();
+        }
+        m_scannerThread->quit();
+        m_scannerThread->wait();
+    }
+}
+
+void SurfaceScanWidget::setupUI() {
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // === 磁盘选择区域 ===
+    QGroupBox *diskGroupBox = new QGroupBox("磁盘选择", this);
+    QHBoxLayout *diskLayout = new QHBoxLayout(diskGroupBox);
+
+    m_diskComboBox = new QComboBox(this);
+    m_diskComboBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    QPushButton *refreshButton = new QPushButton("刷新", this);
+
+    diskLayout->addWidget(new QLabel("磁盘:", this));
+    diskLayout->addWidget(m_diskComboBox);
+    diskLayout->addWidget(refreshButton);
+
+    // === 扫描设置区域 ===
+    QGroupBox *settingsGroupBox = new QGroupBox("扫描设置", this);
+    QGridLayout *settingsLayout = new QGridLayout(settingsGroupBox);
+
+    m_chunkSizeComboBox = new QComboBox(this);
+    m_chunkSizeComboBox->addItem("256 KB", 256);
+    m_chunkSizeComboBox->addItem("1 MB", 1024);
+    m_chunkSizeComboBox->addItem("4 MB", 4096);
+    m_chunkSizeComboBox->addItem("8 MB", 8192);
+    m_chunkSizeComboBox->setCurrentIndex(1);
+
+    m_streamSpinBox = new QSpinBox(this);
+    m_streamSpinBox->setRange(1, 16);
+    m_streamSpinBox->setValue(2);
+    m_streamSpinBox->setToolTip("机械硬盘建议1-2个，固态硬盘可以适当增加");
+
+    m_rateLimitSpinBox = new QSpinBox(this);
+    m_rateLimitSpinBox->setRange(0, 10000);
+    m_rateLimitSpinBox->setValue(0);
+    m_rateLimitSpinBox->setSuffix(" MB/s");
+    m_rateLimitSpinBox->setSpecialValueText("不限速");
+
+    m_lowPriorityCheckBox = new QCheckBox("后台I/O优先级（生产环境推荐）", this);
+    m_lowPriorityCheckBox->setChecked(true);
+
+    settingsLayout->addWidget(new QLabel("读取块大小:", this), 0, 0);
+    settingsLayout->addWidget(m_chunkSizeComboBox, 0, 1);
+    settingsLayout->addWidget(new QLabel("并行读取流:", this), 0, 2);
+    settingsLayout->addWidget(m_streamSpinBox, 0, 3);
+    settingsLayout->addWidget(new QLabel("速率上限:", this), 1, 0);
+    settingsLayout->addWidget(m_rateLimitSpinBox, 1, 1);
+    settingsLayout->addWidget(m_lowPriorityCheckBox, 1, 2, 1, 2);
+
+    // === 控制按钮区域 ===
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+    m_startButton = new QPushButton("开始扫描", this);
+    m_stopButton = new QPushButton("暂停", this);
+    m_stopButton->setEnabled(false);
+    m_rescanButton = new QPushButton("重新扫描", this);
+
+    controlLayout->addWidget(m_startButton);
+    controlLayout->addWidget(m_stopButton);
+    controlLayout->addWidget(m_rescanButton);
+
+    // === 扫描状态区域 ===
+    QGroupBox *statusGroupBox = new QGroupBox("扫描状态", this);
+    QVBoxLayout *statusLayout = new QVBoxLayout(statusGroupBox);
+
+    m_statusLabel = new QLabel("准备就绪（只读扫描，不会修改磁盘数据）", this);
+    m_progressBar = new QProgressBar(this);
+    m_progressBar->setRange(0, 1000);
+    m_progressBar->setValue(0);
+    m_progressBar->setFormat("%p%");
+    m_speedLabel = new QLabel(this);
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setWordWrap(true);
+
+    statusLayout->addWidget(m_statusLabel);
+    statusLayout->addWidget(m_progressBar);
+    statusLayout->addWidget(m_speedLabel);
+    statusLayout->addWidget(m_summaryLabel);
+
+    // === 延迟热力图 ===
+    QGroupBox *heatmapGroupBox = new QGroupBox("区域延迟热力图（每格为一个LBA区域的最大读取延迟，灰色为未扫描）", this);
+    QVBoxLayout *heatmapLayout = new QVBoxLayout(heatmapGroupBox);
+
+    m_heatmap = new HeatmapWidget(this);
+    m_heatmap->setLogScale(true);
+    m_heatmap->setMinimumHeight(220);
+    m_heatmap->setToolTipProvider([this](int index, double value) {
+        Q_UNUSED(value);
+        if (!m_lastMap.isValid() || index >= m_lastMap.regionCount()) {
+            return QString();
+        }
+        const RegionRecord &record = m_lastMap.record(index);
+        QString text = QString("区域 %1\n偏移: %2 - %3")
+                           .arg(index)
+                           .arg(DiskUtils::formatSize(m_lastMap.regionOffset(index)))
+                           .arg(DiskUtils::formatSize(m_lastMap.regionOffset(index) + m_lastMap.regionLength(index)));
+        if (!m_lastMap.isScanned(index)) {
+            return text + "\n尚未扫描";
+        }
+        if (record.maxLatency == SurfaceScanMap::kLatencyError) {
+            return text + "\n读取错误";
+        }
+        return text + QString("\n平均延迟: %1 ms\n最大延迟: %2 ms")
+                          .arg(SurfaceScanMap::decodeLatencyMs(record.avgLatency), 0, 'f', 2)
+                          .arg(SurfaceScanMap::decodeLatencyMs(record.maxLatency), 0, 'f', 2);
+    });
+    heatmapLayout->addWidget(m_heatmap);
+
+    // === 慢区域列表 ===
+    QGroupBox *slowGroupBox = new QGroupBox("慢区域 / 错误区域", this);
+    QVBoxLayout *slowLayout = new QVBoxLayout(slowGroupBox);
+
+    m_slowTable = new QTableWidget(0, 4, this);
+    m_slowTable->setHorizontalHeaderLabels({"区域", "起始偏移", "平均延迟", "最大延迟"});
+    m_slowTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_slowTable->setEditTriggers(QTableWidget::NoEditTriggers);
+    m_slowTable->setAlternatingRowColors(true);
+    slowLayout->addWidget(m_slowTable);
+
+    mainLayout->addWidget(diskGroupBox);
+    mainLayout->addWidget(settingsGroupBox);
+    mainLayout->addLayout(controlLayout);
+    mainLayout->addWidget(statusGroupBox);
+    mainLayout->addWidget(heatmapGroupBox, 2);
+    mainLayout->addWidget(slowGroupBox, 1);
+
+    connect(m_diskComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SurfaceScanWidget::onDiskSelectionChanged);
+    connect(refreshButton, &QPushButton::clicked, this, &SurfaceScanWidget::refreshDiskList);
+    connect(m_startButton, &QPushButton::clicked, this, &SurfaceScanWidget::onStartClicked);
+    connect(m_stopButton, &QPushButton::clicked, this, &SurfaceScanWidget::onStopClicked);
+    connect(m_rescanButton, &QPushButton::clicked, this, &SurfaceScanWidget::onRescanClicked);
+}
+
+void SurfaceScanWidget::refreshDiskList() {
+    m_diskComboBox->clear();
+    // 硬盘列表由DiskInventory统一枚举并随热插拔更新，这里只取当前快照
+    m_diskList = DiskInventory::instance()->disks();
+
+    for (const DiskInfo &disk : m_diskList) {
+        m_diskComboBox->addItem(QString("%1 (%2)").arg(disk.diskName).arg(disk.model));
+    }
+
+    if (m_diskComboBox->count() > 0) {
+        m_diskComboBox->setCurrentIndex(0);
+        onDiskSelectionChanged(0);
+    }
+}
+
+void SurfaceScanWidget::onDiskSelectionChanged(int index) {
+    if (index < 0 || index >= m_diskList.size()) {
+        return;
+    }
+
+    m_selectedDisk = m_diskList[index];
+    loadExistingMap();
+}
+
+QString SurfaceScanWidget::mapFilePath() const {
+    // 优先用序列号标识磁盘，盘符/设备号变化后仍能找到之前的扫描结果
+    QString key = m_selectedDisk.serialNumber.trimmed();
+    if (key.isEmpty()) {
+        key = m_selectedDisk.diskPath;
+    }
+    key.replace(QRegularExpression("[^A-Za-z0-9_-]"), "_");
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/surfacescan";
+    return dir + "/" + key + ".map";
+}
+
+void SurfaceScanWidget::loadExistingMap() {
+    SurfaceScanMap map;
+    if (map.load(mapFilePath())) {
+        onMapUpdated(map);
+        bool completed = map.scannedCount() == map.regionCount();
+        m_startButton->setText(completed ? "开始扫描" : "继续扫描");
+        m_statusLabel->setText(QString("上次扫描: %1，已完成 %2/%3 个区域")
+                                   .arg(QDateTime::fromMSecsSinceEpoch(map.updatedTime()).toString("yyyy-MM-dd HH:mm"))
+                                   .arg(map.scannedCount())
+                                   .arg(map.regionCount()));
+        m_progressBar->setValue(map.regionCount() > 0 ? map.scannedCount() * 1000 / map.regionCount() : 0);
+    } else {
+        m_lastMap = SurfaceScanMap();
+        m_heatmap->clear();
+        m_slowTable->setRowCount(0);
+        m_summaryLabel->clear();
+        m_startButton->setText("开始扫描");
+        m_statusLabel->setText("准备就绪（只读扫描，不会修改磁盘数据）");
+        m_progressBar->setValue(0);
+    }
+}
+
+void SurfaceScanWidget::onStartClicked() {
+    // 已完成的扫描再次开始时从头扫描
+    bool resume = m_lastMap.isValid() && m_lastMap.scannedCount() < m_lastMap.regionCount();
+    startScan(resume);
+}
+
+void SurfaceScanWidget::onRescanClicked() {
+    if (m_lastMap.isValid() && m_lastMap.scannedCount() > 0) {
+        int ret = QMessageBox::question(this, "重新扫描", "将丢弃该磁盘已有的扫描进度和结果，确定重新扫描吗？");
+        if (ret != QMessageBox::Yes) {
+            return;
+        }
+    }
+    startScan(false);
+}
+
+void SurfaceScanWidget::startScan(bool resume) {
+    if (m_diskComboBox->currentIndex() < 0 || m_selectedDisk.diskPath.isEmpty()) {
+        QMessageBox::warning(this, "警告", "请先选择一个磁盘");
+        return;
+    }
+
+    SurfaceScanConfig config;
+    config.devicePath = m_selectedDisk.diskPath;
+    config.mapFilePath = mapFilePath();
+    config.chunkSizeKB = m_chunkSizeComboBox->currentData().toInt();
+    config.streamCount = m_streamSpinBox->value();
+    config.maxRateMBps = m_rateLimitSpinBox->value();
+    config.lowPriority = m_lowPriorityCheckBox->isChecked();
+    config.resume = resume;
+
+    qDebug() << "启动表面扫描:" << config.devicePath << "结果文件:" << config.mapFilePath
+             << "块大小:" << config.chunkSizeKB << "KB 读取流:" << config.streamCount << "续扫:" << resume;
+
+    setControlsEnabled(false);
+    m_statusLabel->setText(resume ? "正在继续扫描..." : "正在扫描...");
+
+    m_scannerThread = new QThread(this);
+    m_scanner = new SurfaceScanner(config);
+    m_scanner->moveToThread(m_scannerThread);
+
+    connect(m_scannerThread, &QThread::started, m_scanner, &SurfaceScanner::startScan);
+    connect(m_scanner, &SurfaceScanner::progressUpdated, this, &SurfaceScanWidget::onProgressUpdated);
+    connect(m_scanner, &SurfaceScanner::mapUpdated, this, &SurfaceScanWidget::onMapUpdated);
+    connect(m_scanner, &SurfaceScanner::scanFinished, this, &SurfaceScanWidget::onScanFinished);
+    connect(m_scanner, &SurfaceScanner::scanFinished, m_scannerThread, &QThread::quit);
+
+    connect(m_scannerThread, &QThread::finished, [this]() {
+        m_scanner->deleteLater();
+        m_scanner = nullptr;
+        m_scannerThread->deleteLater();
+        m_scannerThread = nullptr;
+
+        setControlsEnabled(true);
+    });
+
+    m_scannerThread->start();
+}
+
+void SurfaceScanWidget::onStopClicked() {
+    if (m_scanner) {
+        m_scanner->stop();
+        m_statusLabel->setText("正在暂停，保存检查点...");
+        m_stopButton->setEnabled(false);
+    }
+}
+
+void SurfaceScanWidget::setControlsEnabled(bool enabled) {
+    m_diskComboBox->setEnabled(enabled);
+    m_chunkSizeComboBox->setEnabled(enabled);
+    m_streamSpinBox->setEnabled(enabled);
+    m_rateLimitSpinBox->setEnabled(enabled);
+    m_lowPriorityCheckBox->setEnabled(enabled);
+    m_startButton->setEnabled(enabled);
+    m_rescanButton->setEnabled(enabled);
+    m_stopButton->setEnabled(!enabled);
+}
+
+void SurfaceScanWidget::onProgressUpdated(qint64 scannedBytes, qint64 totalBytes, double speedMBps) {
+    if (totalBytes > 0) {
+        m_progressBar->setValue(static_cast<int>(scannedBytes * 1000 / totalBytes));
+    }
+    m_speedLabel->setText(QString("已扫描 %1 / %2，当前速度 %3 MB/s")
+                              .arg(DiskUtils::formatSize(scannedBytes))
+                              .arg(DiskUtils::formatSize(totalBytes))
+                              .arg(speedMBps, 0, 'f', 1));
+}
+
+void SurfaceScanWidget::onMapUpdated(const SurfaceScanMap &map) {
+    m_lastMap = map;
+    if (!map.isValid()) {
+        return;
+    }
+
+    const int regionCount = map.regionCount();
+    QVector<double> values(regionCount);
+    QVector<double> scanned;
+    scanned.reserve(map.scannedCount());
+    int errorCount = 0;
+
+    for (int i = 0; i < regionCount; ++i) {
+        const RegionRecord &record = map.record(i);
+        if (record.maxLatency == 0) {
+            values[i] = qQNaN();
+        } else if (record.maxLatency == SurfaceScanMap::kLatencyError) {
+            values[i] = qInf();
+            ++errorCount;
+        } else {
+            values[i] = SurfaceScanMap::decodeLatencyMs(record.maxLatency);
+            scanned.append(values[i]);
+        }
+    }
+
+    // 以中位数作为该盘的正常延迟基准
+    double median = 0;
+    if (!scanned.isEmpty()) {
+        std::nth_element(scanned.begin(), scanned.begin() + scanned.size() / 2, scanned.end());
+        median = scanned[scanned.size() / 2];
+    }
+    double thresholdMs = qMax(median * kSlowFactor, kMinSlowThresholdMs);
+
+    int rows = (regionCount + kHeatmapColumns - 1) / kHeatmapColumns;
+    m_heatmap->setData(rows, kHeatmapColumns, values);
+    if (median > 0) {
+        m_heatmap->setValueRange(median, qMax(thresholdMs, median * 2));
+    }
+
+    int slowCount = 0;
+    for (double value : scanned) {
+        if (value >= thresholdMs) {
+            ++slowCount;
+        }
+    }
+
+    m_summaryLabel->setText(QString("区域大小 %1，共 %2 个区域 | 延迟中位数 %3 ms，慢区域阈值 %4 ms | 慢区域 %5 个，读取错误 %6 个")
+                                .arg(DiskUtils::formatSize(map.regionSize()))
+                                .arg(regionCount)
+                                .arg(median, 0, 'f', 2)
+                                .arg(thresholdMs, 0, 'f', 1)
+                                .arg(slowCount)
+                                .arg(errorCount));
+
+    updateSlowRegions(map, thresholdMs);
+}
+
+void SurfaceScanWidget::updateSlowRegions(const SurfaceScanMap &map, double thresholdMs) {
+    // 错误区域排在最前，其余按最大延迟从高到低
+    QVector<QPair<quint16, int>> slowRegions;
+    for (int i = 0; i < map.regionCount(); ++i) {
+        const RegionRecord &record = map.record(i);
+        if (record.maxLatency != 0 && SurfaceScanMap::decodeLatencyMs(record.maxLatency) >= thresholdMs) {
+            slowRegions.append(qMakePair(record.maxLatency, i));
+        }
+    }
+    std::sort(slowRegions.begin(), slowRegions.end(), [](const QPair<quint16, int> &a, const QPair<quint16, int> &b) {
+        return a.first > b.first;
+    });
+
+    int rowCount = qMin(slowRegions.size(), kMaxSlowRegions);
+    m_slowTable->setRowCount(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        int region = slowRegions[row].second;
+        const RegionRecord &record = map.record(region);
+        bool error = record.maxLatency == SurfaceScanMap::kLatencyError;
+
+        m_slowTable->setItem(row, 0, new QTableWidgetItem(QString::number(region)));
+        m_slowTable->setItem(row, 1, new QTableWidgetItem(DiskUtils::formatSize(map.regionOffset(region))));
+        m_slowTable->setItem(row, 2, new QTableWidgetItem(QString("%1 ms").arg(SurfaceScanMap::decodeLatencyMs(record.avgLatency), 0, 'f', 2)));
+        QTableWidgetItem *maxItem = new QTableWidgetItem(error ? QString("读取错误")
+                                                               : QString("%1 ms").arg(SurfaceScanMap::decodeLatencyMs(record.maxLatency), 0, 'f', 2));
+        if (error) {
+            maxItem->setForeground(QColor("#F44336"));
+        }
+        m_slowTable->setItem(row, 3, maxItem);
+    }
+}
+
+void SurfaceScanWidget::onScanFinished(bool completed, const QString &message) {
+    m_statusLabel->setText(message);
+    m_startButton->setText(completed || !m_lastMap.isValid() ? "开始扫描" : "继续扫描");
+    if (completed) {
+        m_progressBar->setValue(1000);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SURFACESCANWIDGET_H
+#define SURFACESCANWIDGET_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QTableWidget>
+#include <QThread>
+
+#include "../core/diskutils.h"
+#include "../widgets/heatmapwidget.h"
+#include "surfacescanner.h"
+
+class SurfaceScanWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SurfaceScanWidget(QWidget *parent = nullptr);
+    ~SurfaceScanWidget();
+
+private slots:
+    void refreshDiskList();
+    void onDiskSelectionChanged(int index);
+    void onStartClicked();
+    void onStopClicked();
+    void onRescanClicked();
+    void onProgressUpdated(qint64 scannedBytes, qint64 totalBytes, double speedMBps);
+    void onMapUpdated(const SurfaceScanMap &map);
+    void onScanFinished(bool completed, const QString &message);
+
+private:
+    void setupUI();
+    void startScan(bool resume);
+    void setControlsEnabled(bool enabled);
+    void updateSlowRegions(const SurfaceScanMap &map, double thresholdMs);
+    void loadExistingMap();
+    QString mapFilePath() const;
+
+    QComboBox *m_diskComboBox;
+    QComboBox *m_chunkSizeComboBox;
+    QSpinBox *m_streamSpinBox;
+    QSpinBox *m_rateLimitSpinBox;
+    QCheckBox *m_lowPriorityCheckBox;
+
+    QPushButton *m_startButton;
+    QPushButton *m_stopButton;
+    QPushButton *m_rescanButton;
+
+    QProgressBar *m_progressBar;
+    QLabel *m_statusLabel;
+    QLabel *m_speedLabel;
+    QLabel *m_summaryLabel;
+
+    HeatmapWidget *m_heatmap;
+    QTableWidget *m_slowTable;
+
+    QList<DiskInfo> m_diskList;
+    DiskInfo m_selectedDisk;
+    SurfaceScanMap m_lastMap;
+
+    SurfaceScanner *m_scanner;
+    QThread *m_scannerThread;
+};
+
+#endif // SURFACESCANWIDGET_H
@@ -0,0 +1,302 @@
+#include "heatmapwidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QToolTip>
+#include <QFontMetrics>
+#include <QtMath>
+#include <limits>
+
+namespace {
+const int kMargin = 4;
+const int kLegendWidth = 14;
+const int kLegendTextWidth = 56;
+}
+
+HeatmapWidget::HeatmapWidget(QWidget *parent)
+    : QWidget(parent), m_rows(0), m_columns(0), m_hasRange(false), m_minValue(0), m_maxValue(1),
+      m_logScale(false), m_inverted(false), m_showValues(false) {
+    setMouseTracking(true);
+    setMinimumHeight(120);
+}
+
+void HeatmapWidget::setData(int rows, int columns, const QVector<double> &values) {
+    m_rows = qMax(0, rows);
+    m_columns = qMax(0, columns);
+    m_values = values;
+    rebuildImage();
+    update();
+}
+
+void HeatmapWidget::setValueRange(double minValue, double maxValue) {
+    m_hasRange = true;
+    m_minValue = minValue;
+    m_maxValue = qMax(maxValue, minValue);
+    rebuildImage();
+    update();
+}
+
+void HeatmapWidget::clearValueRange() {
+    m_hasRange = false;
+    rebuildImage();
+    update();
+}
+
+void HeatmapWidget::setLogScale(bool enabled) {
+    m_logScale = enabled;
+    rebuildImage();
+    update();
+}
+
+void HeatmapWidget::setInverted(bool inverted) {
+    m_inverted = inverted;
+    rebuildImage();
+    update();
+}
+
+void HeatmapWidget::setRowLabels(const QStringList &labels) {
+    m_rowLabels = labels;
+    update();
+}
+
+void HeatmapWidget::setColumnLabels(const QStringList &labels) {
+    m_columnLabels = labels;
+    update();
+}
+
+void HeatmapWidget::setShowValues(bool show) {
+    m_showValues = show;
+    update();
+}
+
+void HeatmapWidget::setToolTipProvider(std::function<QString(int index, double value)> provider) {
+    m_toolTipProvider = provider;
+}
+
+void HeatmapWidget::clear() {
+    m_rows = 0;
+    m_columns = 0;
+    m_values.clear();
+    m_image = QImage();
+    update();
+}
+
+QSize HeatmapWidget::sizeHint() const {
+    return QSize(600, 300);
+}
+
+QSize HeatmapWidget::minimumSizeHint() const {
+    return QSize(200, 120);
+}
+
+QColor HeatmapWidget::colorForRatio(double ratio) {
+    // 绿 -> 黄 -> 红
+    ratio = qBound(0.0, ratio, 1.0);
+    if (ratio < 0.5) {
+        double t = ratio / 0.5;
+        return QColor(static_cast<int>(76 + t * (255 - 76)), static_cast<int>(175 + t * (193 - 175)), static_cast<int>(80 - t * 73));
+    }
+    double t = (ratio - 0.5) / 0.5;
+    return QColor(255, static_cast<int>(193 - t * (193 - 67)), static_cast<int>(7 + t * (54 - 7)));
+}
+
+QColor HeatmapWidget::colorForValueRatio(double ratio) const {
+    return colorForRatio(m_inverted ? 1.0 - ratio : ratio);
+}
+
+double HeatmapWidget::normalizedValue(double value) const {
+    double low = m_minValue;
+    double high = m_maxValue;
+    if (m_logScale) {
+        // 对数刻度下非正数无法取对数，按下限处理
+        double floor = low > 0 ? low : 1e-9;
+        low = qLn(floor);
+        high = qLn(qMax(high, floor));
+        value = qLn(qMax(value, floor));
+    }
+    if (high <= low) {
+        return 0;
+    }
+    return (value - low) / (high - low);
+}
+
+void HeatmapWidget::rebuildImage() {
+    if (m_rows <= 0 || m_columns <= 0) {
+        m_image = QImage();
+        return;
+    }
+
+    if (!m_hasRange) {
+        // 自动范围只统计有效数值
+        double minValue = std::numeric_limits<double>::max();
+        double maxValue = std::numeric_limits<double>::lowest();
+        for (double value : m_values) {
+            if (qIsFinite(value)) {
+                minValue = qMin(minValue, value);
+                maxValue = qMax(maxValue, value);
+            }
+        }
+        if (minValue > maxValue) {
+            minValue = 0;
+            maxValue = 1;
+        }
+        m_minValue = minValue;
+        m_maxValue = maxValue;
+    }
+
+    const QRgb noData = QColor("#9E9E9E").rgb();
+    const QRgb error = QColor("#4A0000").rgb();
+
+    m_image = QImage(m_columns, m_rows, QImage::Format_RGB32);
+    for (int row = 0; row < m_rows; ++row) {
+        QRgb *line = reinterpret_cast<QRgb*>(m_image.scanLine(row));
+        for (int column = 0; column < m_columns; ++column) {
+            int index = row * m_columns + column;
+            double value = index < m_values.size() ? m_values[index] : qQNaN();
+            if (qIsNaN(value)) {
+                line[column] = noData;
+            } else if (qIsInf(value)) {
+                line[column] = error;
+            } else {
+                line[column] = colorForValueRatio(normalizedValue(value)).rgb();
+            }
+        }
+    }
+}
+
+QRect HeatmapWidget::gridRect() const {
+    QFontMetrics metrics(font());
+
+    int left = kMargin;
+    if (!m_rowLabels.isEmpty()) {
+        int labelWidth = 0;
+        for (const QString &label : m_rowLabels) {
+            labelWidth = qMax(labelWidth, metrics.horizontalAdvance(label));
+        }
+        left += labelWidth + kMargin;
+    }
+
+    int bottom = kMargin;
+    if (!m_columnLabels.isEmpty()) {
+        bottom += metrics.height() + kMargin;
+    }
+
+    int right = kMargin + kLegendWidth + kLegendTextWidth;
+    return QRect(left, kMargin, qMax(1, width() - left - right), qMax(1, height() - kMargin - bottom));
+}
+
+int HeatmapWidget::cellIndexAt(const QPoint &pos) const {
+    QRect grid = gridRect();
+    if (m_rows <= 0 || m_columns <= 0 || !grid.contains(pos)) {
+        return -1;
+    }
+
+    int column = (pos.x() - grid.left()) * m_columns / grid.width();
+    int row = (pos.y() - grid.top()) * m_rows / grid.height();
+    column = qBound(0, column, m_columns - 1);
+    row = qBound(0, row, m_rows - 1);
+    return row * m_columns + column;
+}
+
+void HeatmapWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    QRect grid = gridRect();
+
+    if (m_image.isNull()) {
+        painter.setPen(palette().color(QPalette::Mid));
+        painter.drawRect(grid.adjusted(0, 0, -1, -1));
+        painter.setPen(palette().color(QPalette::WindowText));
+        painter.drawText(grid, Qt::AlignCenter, "暂无数据");
+        return;
+    }
+
+    // 不做平滑缩放，保持每个格子边界清晰
+    painter.drawImage(grid, m_image);
+
+    QFontMetrics metrics(font());
+    double cellWidth = static_cast<double>(grid.width()) / m_columns;
+    double cellHeight = static_cast<double>(grid.height()) / m_rows;
+
+    if (m_showValues && cellWidth >= 30 && cellHeight >= metrics.height()) {
+        painter.setPen(Qt::black);
+        for (int row = 0; row < m_rows; ++row) {
+            for (int column = 0; column < m_columns; ++column) {
+                int index = row * m_columns + column;
+                if (index >= m_values.size() || !qIsFinite(m_values[index])) {
+                    continue;
+                }
+                QRectF cell(grid.left() + column * cellWidth, grid.top() + row * cellHeight, cellWidth, cellHeight);
+                painter.drawText(cell, Qt::AlignCenter, QString::number(m_values[index], 'g', 4));
+            }
+        }
+    }
+
+    painter.setPen(palette().color(QPalette::WindowText));
+
+    // 标签放不下时按间隔抽样显示
+    if (!m_rowLabels.isEmpty()) {
+        int step = qMax(1, static_cast<int>(qCeil(metrics.height() / qMax(cellHeight, 1.0))));
+        for (int row = 0; row < m_rows && row < m_rowLabels.size(); row += step) {
+            QRectF labelRect(0, grid.top() + row * cellHeight, grid.left() - kMargin, cellHeight);
+            painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, m_rowLabels[row]);
+        }
+    }
+
+    if (!m_columnLabels.isEmpty()) {
+        int labelWidth = 0;
+        for (const QString &label : m_columnLabels) {
+            labelWidth = qMax(labelWidth, metrics.horizontalAdvance(label));
+        }
+        int step = qMax(1, static_cast<int>(qCeil((labelWidth + kMargin) / qMax(cellWidth, 1.0))));
+        for (int column = 0; column < m_columns && column < m_columnLabels.size(); column += step) {
+            QRectF labelRect(grid.left() + column * cellWidth, grid.bottom() + kMargin, cellWidth, metrics.height());
+            painter.drawText(labelRect, Qt::AlignHCenter | Qt::AlignTop, m_columnLabels[column]);
+        }
+    }
+
+    // 右侧色标
+    QRect legend(grid.right() + kMargin * 2, grid.top(), kLegendWidth, grid.height());
+    for (int y = 0; y < legend.height(); ++y) {
+        double ratio = 1.0 - static_cast<double>(y) / qMax(1, legend.height() - 1);
+        painter.fillRect(legend.left(), legend.top() + y, legend.width(), 1, colorForValueRatio(ratio));
+    }
+    painter.drawText(QRect(legend.right() + kMargin, legend.top(), kLegendTextWidth, metrics.height()),
+                     Qt::AlignLeft | Qt::AlignTop, QString::number(m_maxValue, 'g', 4));
+    painter.drawText(QRect(legend.right() + kMargin, legend.bottom() - metrics.height(), kLegendTextWidth, metrics.height()),
+                     Qt::AlignLeft | Qt::AlignBottom, QString::number(m_minValue, 'g', 4));
+}
+
+void HeatmapWidget::mouseMoveEvent(QMouseEvent *event) {
+    int index = cellIndexAt(event->pos());
+    if (index < 0) {
+        QToolTip::hideText();
+        return;
+    }
+
+    double value = index < m_values.size() ? m_values[index] : qQNaN();
+    QString text;
+    if (m_toolTipProvider) {
+        text = m_toolTipProvider(index, value);
+    } else {
+        int row = index / m_columns;
+        int column = index % m_columns;
+        QString rowText = row < m_rowLabels.size() ? m_rowLabels[row] : QString::number(row);
+        QString columnText = column < m_columnLabels.size() ? m_columnLabels[column] : QString::number(column);
+        QString valueText = qIsNaN(value) ? QString("无数据") : (qIsInf(value) ? QString("错误") : QString::number(value, 'g', 6));
+        text = QString("%1 / %2: %3").arg(rowText).arg(columnText).arg(valueText);
+    }
+
+    QToolTip::showText(event->globalPos(), text, this);
+}
+
+void HeatmapWidget::mousePressEvent(QMouseEvent *event) {
+    int index = cellIndexAt(event->pos());
+    if (index >= 0) {
+        double value = index < m_values.size() ? m_values[index] : qQNaN();
+        emit cellClicked(index / m_columns, index % m_columns, value);
+    }
+    QWidget::mousePressEvent(event);
+}
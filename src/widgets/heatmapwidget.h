@@ -0,0 +1,83 @@
+#ifndef HEATMAPWIDGET_H
+#define HEATMAPWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QStringList>
+#include <QImage>
+#include <functional>
+
+// 通用热力图控件
+// 按行优先顺序显示一组数值，颜色从绿(低)经黄到红(高)。
+// NaN表示无数据（灰色），正无穷表示错误（深红）。
+// 单元格很多时先渲染到一张每格一像素的图片再缩放，数万个格子也能流畅重绘。
+class HeatmapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HeatmapWidget(QWidget *parent = nullptr);
+
+    // 设置网格大小和数据，values长度不足的格子按无数据处理
+    void setData(int rows, int columns, const QVector<double> &values);
+
+    // 设置颜色映射范围；未设置时使用数据的最小/最大值
+    void setValueRange(double minValue, double maxValue);
+    void clearValueRange();
+
+    // 对数刻度适合跨越数量级的延迟数据
+    void setLogScale(bool enabled);
+
+    // 行/列标签，设置后在左侧和下方显示
+    void setRowLabels(const QStringList &labels);
+    void setColumnLabels(const QStringList &labels);
+
+    // 反转颜色：高值显示为绿色，适合吞吐量这类越高越好的数据
+    void setInverted(bool inverted);
+
+    // 每个单元格显示数值（适合格子较少的场景）
+    void setShowValues(bool show);
+
+    // 自定义鼠标悬停提示，参数为格子序号和数值
+    void setToolTipProvider(std::function<QString(int index, double value)> provider);
+
+    void clear();
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+    static QColor colorForRatio(double ratio);
+
+signals:
+    void cellClicked(int row, int column, double value);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    void rebuildImage();
+    QRect gridRect() const;
+    int cellIndexAt(const QPoint &pos) const;
+    double normalizedValue(double value) const;
+    QColor colorForValueRatio(double ratio) const;
+
+    int m_rows;
+    int m_columns;
+    QVector<double> m_values;
+    QImage m_image;
+
+    bool m_hasRange;
+    double m_minValue;
+    double m_maxValue;
+    bool m_logScale;
+    bool m_inverted;
+    bool m_showValues;
+
+    QStringList m_rowLabels;
+    QStringList m_columnLabels;
+    std::function<QString(int, double)> m_toolTipProvider;
+};
+
+#endif // HEATMAPWIDGET_H